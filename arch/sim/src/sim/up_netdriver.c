@@ -84,9 +84,18 @@ struct timer
 
 static struct timer g_periodic_timer;
 
+#ifdef CONFIG_NETDEV_BURST
+/* A burst of packet buffers is used.  uint16_t keeps them 16-bit aligned. */
+
+#define SIM_PKTBUF_SIZE ((MAX_NETDEV_PKTSIZE + CONFIG_NET_GUARDSIZE + 1) / 2)
+
+static uint16_t g_pktbufs[CONFIG_NETDEV_BURST_SIZE][SIM_PKTBUF_SIZE];
+static struct netdev_pkt_s g_pkts[CONFIG_NETDEV_BURST_SIZE];
+#else
 /* A single packet buffer is used */
 
 static uint8_t g_pktbuf[MAX_NETDEV_PKTSIZE + CONFIG_NET_GUARDSIZE];
+#endif
 
 /* Ethernet peripheral state */
 
@@ -112,6 +121,30 @@ void timer_reset(struct timer *t)
   t->start += t->interval;
 }
 
+#ifdef CONFIG_NETDEV_BURST
+static void sim_txburst(bool timer)
+{
+  int ntx;
+  int i;
+
+  /* Keep polling while the network fills every buffer of the burst */
+
+  do
+    {
+      ntx = netdev_txburst(&g_sim_dev, g_pkts, CONFIG_NETDEV_BURST_SIZE,
+                           timer);
+      timer = false;
+
+      for (i = 0; i < ntx; i++)
+        {
+          NETDEV_TXPACKETS(&g_sim_dev);
+          netdev_send(g_pkts[i].p_buf, g_pkts[i].p_len);
+          NETDEV_TXDONE(&g_sim_dev);
+        }
+    }
+  while (ntx == CONFIG_NETDEV_BURST_SIZE);
+}
+#else
 static int sim_txpoll(struct net_driver_s *dev)
 {
   /* If the polling resulted in data that should be sent out on the network,
@@ -158,11 +191,70 @@ static int sim_txpoll(struct net_driver_s *dev)
 
   return 0;
 }
+#endif /* CONFIG_NETDEV_BURST */
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_NETDEV_BURST
+void netdriver_loop(void)
+{
+  unsigned int len;
+  int nrx;
+  int i;
+
+  /* Send everything that the network has queued */
+
+  sim_txburst(false);
+
+  /* Read frames until there are no more or all buffers are full.
+   * netdev_read will return 0 on a timeout event.
+   */
+
+  for (nrx = 0; nrx < CONFIG_NETDEV_BURST_SIZE; nrx++)
+    {
+      len = netdev_read(g_pkts[nrx].p_buf, CONFIG_NET_ETH_PKTSIZE);
+      if (len == 0)
+        {
+          break;
+        }
+
+      g_pkts[nrx].p_len = len;
+    }
+
+  /* Disable preemption through to the following so that it behaves a
+   * little more like an interrupt.
+   */
+
+  sched_lock();
+  if (nrx > 0)
+    {
+      /* Process the whole burst and send any replies left in place */
+
+      if (netdev_rxburst(&g_sim_dev, g_pkts, nrx) > 0)
+        {
+          for (i = 0; i < nrx; i++)
+            {
+              if (g_pkts[i].p_len > 0)
+                {
+                  netdev_send(g_pkts[i].p_buf, g_pkts[i].p_len);
+                }
+            }
+        }
+    }
+
+  /* Otherwise, it must be a timeout event */
+
+  else if (timer_expired(&g_periodic_timer))
+    {
+      timer_reset(&g_periodic_timer);
+      sim_txburst(true);
+    }
+
+  sched_unlock();
+}
+#else
 void netdriver_loop(void)
 {
   FAR struct eth_hdr_s *eth;
@@ -327,6 +419,7 @@ void netdriver_loop(void)
 
   sched_unlock();
 }
+#endif /* CONFIG_NETDEV_BURST */
 
 int netdriver_ifup(struct net_driver_s *dev)
 {
@@ -342,6 +435,10 @@ int netdriver_ifdown(struct net_driver_s *dev)
 
 int netdriver_init(void)
 {
+#ifdef CONFIG_NETDEV_BURST
+  int i;
+#endif
+
   /* Internal initialization */
 
   timer_set(&g_periodic_timer, 500);
@@ -349,7 +446,16 @@ int netdriver_init(void)
 
   /* Set callbacks */
 
+#ifdef CONFIG_NETDEV_BURST
+  for (i = 0; i < CONFIG_NETDEV_BURST_SIZE; i++)
+    {
+      g_pkts[i].p_buf = (FAR uint8_t *)g_pktbufs[i];
+    }
+
+  g_sim_dev.d_buf    = g_pkts[0].p_buf;  /* Used outside of bursts */
+#else
   g_sim_dev.d_buf    = g_pktbuf;         /* Single packet buffer */
+#endif
   g_sim_dev.d_ifup   = netdriver_ifup;
   g_sim_dev.d_ifdown = netdriver_ifdown;
 
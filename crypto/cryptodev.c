@@ -46,10 +46,14 @@
 #include <errno.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/drivers/drivers.h>
 
 #include <nuttx/crypto/crypto.h>
 #include <nuttx/crypto/cryptodev.h>
+#ifdef CONFIG_CRYPTO_AES_GCM
+#  include <nuttx/crypto/aes.h>
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -162,6 +166,62 @@ static int cryptodev_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     }
 #endif
 
+#ifdef CONFIG_CRYPTO_AES_GCM
+  case CIOCAUTHCRYPT:
+    {
+      FAR struct crypt_auth_op *op = (FAR struct crypt_auth_op *)arg;
+      FAR struct session_op *ses   = (FAR struct session_op *)op->ses;
+      FAR struct aes_gcm_s *gcm;
+      int ret;
+
+      if (ses->cipher != CRYPTO_AES_GCM ||
+          (op->op != COP_ENCRYPT && op->op != COP_DECRYPT))
+        {
+          return -EINVAL;
+        }
+
+      /* The context holds the key schedule and the GHASH tables, too large
+       * for the stack.
+       */
+
+      gcm = (FAR struct aes_gcm_s *)kmm_malloc(sizeof(struct aes_gcm_s));
+      if (gcm == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      ret = aes_gcm_setkey(gcm, (FAR const uint8_t *)ses->key, ses->keylen);
+      if (ret >= 0)
+        {
+          if (op->op == COP_ENCRYPT)
+            {
+              ret = aes_gcm_encrypt(gcm, (FAR const uint8_t *)op->iv,
+                                    op->iv_len,
+                                    (FAR const uint8_t *)op->auth_src,
+                                    op->auth_len,
+                                    (FAR const uint8_t *)op->src,
+                                    (FAR uint8_t *)op->dst, op->len,
+                                    (FAR uint8_t *)op->tag, op->tag_len);
+            }
+          else
+            {
+              ret = aes_gcm_decrypt(gcm, (FAR const uint8_t *)op->iv,
+                                    op->iv_len,
+                                    (FAR const uint8_t *)op->auth_src,
+                                    op->auth_len,
+                                    (FAR const uint8_t *)op->src,
+                                    (FAR uint8_t *)op->dst, op->len,
+                                    (FAR const uint8_t *)op->tag,
+                                    op->tag_len);
+            }
+        }
+
+      memset(gcm, 0, sizeof(struct aes_gcm_s));
+      kmm_free(gcm);
+      return ret;
+    }
+#endif
+
   default:
     return -ENOTTY;
   }
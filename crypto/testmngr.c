@@ -49,6 +49,9 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/crypto/crypto.h>
+#ifdef CONFIG_CRYPTO_AES_GCM
+#  include <nuttx/crypto/aes.h>
+#endif
 
 #ifdef CONFIG_CRYPTO_ALGTEST
 
@@ -121,6 +124,74 @@ static int test_aes(void)
 }
 #endif
 
+#if defined(CONFIG_CRYPTO_AES_GCM)
+static int do_test_aes_gcm(FAR struct aead_testvec *test)
+{
+  FAR struct aes_gcm_s *gcm;
+  FAR uint8_t *out;
+  uint8_t tag[16];
+  int res = -ENOMEM;
+
+  gcm = kmm_malloc(sizeof(struct aes_gcm_s));
+  out = kmm_zalloc(test->ilen);
+  if (gcm == NULL || out == NULL)
+    {
+      goto errout;
+    }
+
+  res = aes_gcm_setkey(gcm, (FAR const uint8_t *)test->key, test->klen);
+  if (res < 0)
+    {
+      goto errout;
+    }
+
+  res = aes_gcm_encrypt(gcm, (FAR const uint8_t *)test->iv, test->ivlen,
+                        (FAR const uint8_t *)test->assoc, test->alen,
+                        (FAR const uint8_t *)test->input, out, test->ilen,
+                        tag, test->taglen);
+  if (res == OK)
+    {
+      res = memcmp(out, test->result, test->ilen) ||
+            memcmp(tag, test->tag, test->taglen);
+    }
+
+  if (res == OK)
+    {
+      res = aes_gcm_decrypt(gcm, (FAR const uint8_t *)test->iv, test->ivlen,
+                            (FAR const uint8_t *)test->assoc, test->alen,
+                            (FAR const uint8_t *)test->result, out,
+                            test->ilen, (FAR const uint8_t *)test->tag,
+                            test->taglen);
+    }
+
+  if (res == OK)
+    {
+      res = memcmp(out, test->input, test->ilen);
+    }
+
+errout:
+  kmm_free(out);
+  kmm_free(gcm);
+  return res;
+}
+
+static int test_aes_gcm(void)
+{
+  int i;
+
+  for (i = 0; i < ARRAY_SIZE(aes_gcm_tv_template); i++)
+    {
+      if (do_test_aes_gcm(aes_gcm_tv_template + i))
+        {
+          crypterr("ERROR: Failed GCM test #%i\n", i);
+          return -1;
+        }
+    }
+
+  return OK;
+}
+#endif
+
 int crypto_test(void)
 {
 #if defined(CONFIG_CRYPTO_AES)
@@ -130,6 +201,13 @@ int crypto_test(void)
     }
 #endif
 
+#if defined(CONFIG_CRYPTO_AES_GCM)
+  if (test_aes_gcm())
+    {
+      return -1;
+    }
+#endif
+
   return OK;
 }
 
@@ -55,10 +55,49 @@
 #define bchlib_semgive(d) nxsem_post(&(d)->sem)  /* To match bchlib_semtake */
 #define MAX_OPENCNT       (255)                  /* Limit of uint8_t */
 
+/* Multi-sector cache */
+
+#ifdef CONFIG_BCH_SECTORCACHE
+#  ifndef CONFIG_BCH_SECTORCACHE_NSECTORS
+#    define CONFIG_BCH_SECTORCACHE_NSECTORS 8
+#  endif
+#  ifndef CONFIG_BCH_SECTORCACHE_READAHEAD
+#    define CONFIG_BCH_SECTORCACHE_READAHEAD 1
+#  endif
+
+#  if CONFIG_BCH_SECTORCACHE_NSECTORS < 1 || \
+      CONFIG_BCH_SECTORCACHE_NSECTORS > 255
+#    error CONFIG_BCH_SECTORCACHE_NSECTORS out of range
+#  endif
+
+/* Read-ahead cannot exceed the size of the cache */
+
+#  if CONFIG_BCH_SECTORCACHE_READAHEAD > CONFIG_BCH_SECTORCACHE_NSECTORS
+#    define BCH_READAHEAD CONFIG_BCH_SECTORCACHE_NSECTORS
+#  else
+#    define BCH_READAHEAD CONFIG_BCH_SECTORCACHE_READAHEAD
+#  endif
+
+/* Return the memory of cache entry 'i' */
+
+#  define BCH_CACHEBUFFER(b,i) (&(b)->cachemem[(size_t)(i) * (b)->sectsize])
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_BCH_SECTORCACHE
+/* This structure describes one entry in the multi-sector cache */
+
+struct bch_cache_s
+{
+  size_t sector;           /* Sector held in the entry ((size_t)-1: none) */
+  uint32_t stamp;          /* Time of last use, for LRU replacement */
+  bool dirty;              /* true: The entry must be written to the media */
+};
+#endif
+
 struct bchlib_s
 {
   FAR struct inode *inode; /* I-node of the block driver */
@@ -70,7 +109,14 @@ struct bchlib_s
   bool dirty;              /* true: Data has been written to the buffer */
   bool readonly;           /* true: Only read operations are supported */
   bool unlinked;           /* true: The driver has been unlinked */
-  FAR uint8_t *buffer;     /* One sector buffer */
+  FAR uint8_t *buffer;     /* Buffer of the current sector */
+
+#ifdef CONFIG_BCH_SECTORCACHE
+  uint8_t current;         /* Cache entry of the current sector */
+  uint32_t stamp;          /* Incremented on each change of sector */
+  FAR uint8_t *cachemem;   /* Memory for all cache entries */
+  struct bch_cache_s cache[CONFIG_BCH_SECTORCACHE_NSECTORS];
+#endif
 
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
@@ -98,6 +144,11 @@ EXTERN const struct file_operations bch_fops;
 EXTERN void bchlib_semtake(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN void bchlib_cacheoverlay(FAR struct bchlib_s *bch,
+                                FAR uint8_t *buffer, size_t sector,
+                                size_t nsectors);
+EXTERN void bchlib_cacheinvalidate(FAR struct bchlib_s *bch, size_t sector,
+                                   size_t nsectors);
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -41,6 +41,7 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -74,10 +75,11 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, FAR uint8_t *data,
+                      size_t sector, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)data;
   int i;
 
   for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
@@ -85,7 +87,7 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
       uint32_t T[4];
       uint32_t X[4] =
       {
-        bch->sector, 0, 0, i
+        sector, 0, 0, i
       };
 
       aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -103,6 +105,234 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 }
 #endif
 
+#ifdef CONFIG_BCH_SECTORCACHE
+/****************************************************************************
+ * Name: bchlib_cachesync
+ *
+ * Description:
+ *   Writes set bch->dirty for the current sector.  Move that state to the
+ *   cache entry of the current sector.
+ *
+ ****************************************************************************/
+
+static inline void bchlib_cachesync(FAR struct bchlib_s *bch)
+{
+  if (bch->dirty)
+    {
+      bch->cache[bch->current].dirty = true;
+      bch->dirty = false;
+    }
+}
+
+/****************************************************************************
+ * Name: bchlib_cachefind
+ *
+ * Description:
+ *   Return the index of the cache entry that holds the sector or -1 if the
+ *   sector is not cached.
+ *
+ ****************************************************************************/
+
+static int bchlib_cachefind(FAR struct bchlib_s *bch, size_t sector)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_BCH_SECTORCACHE_NSECTORS; i++)
+    {
+      if (bch->cache[i].sector == sector)
+        {
+          return i;
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: bchlib_cachevictim
+ *
+ * Description:
+ *   Return the index of an unused cache entry if there is one, otherwise
+ *   the index of the least recently used entry.
+ *
+ ****************************************************************************/
+
+static int bchlib_cachevictim(FAR struct bchlib_s *bch)
+{
+  uint32_t maxage = 0;
+  int victim = 0;
+  int i;
+
+  for (i = 0; i < CONFIG_BCH_SECTORCACHE_NSECTORS; i++)
+    {
+      uint32_t age;
+
+      if (bch->cache[i].sector == (size_t)-1)
+        {
+          return i;
+        }
+
+      age = bch->stamp - bch->cache[i].stamp;
+      if (age > maxage)
+        {
+          victim = i;
+          maxage = age;
+        }
+    }
+
+  return victim;
+}
+
+/****************************************************************************
+ * Name: bchlib_cachewrite
+ *
+ * Description:
+ *   Write 'count' adjacent cache entries that hold consecutive sectors to
+ *   the media with a single request.
+ *
+ ****************************************************************************/
+
+static int bchlib_cachewrite(FAR struct bchlib_s *bch, int index, int count)
+{
+  FAR struct inode *inode = bch->inode;
+  size_t sector = bch->cache[index].sector;
+  ssize_t ret;
+  int i;
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+  /* Encrypt data as necessary */
+
+  for (i = 0; i < count; i++)
+    {
+      bch_cypher(bch, BCH_CACHEBUFFER(bch, index + i), sector + i,
+                 CYPHER_ENCRYPT);
+    }
+#endif
+
+  /* Write the sectors to the media */
+
+  ret = inode->u.i_bops->write(inode, BCH_CACHEBUFFER(bch, index), sector,
+                               count);
+  if (ret < 0)
+    {
+      ferr("Write failed: %d\n", (int)ret);
+    }
+
+  for (i = 0; i < count; i++)
+    {
+#if defined(CONFIG_BCH_ENCRYPTION)
+      bch_cypher(bch, BCH_CACHEBUFFER(bch, index + i), sector + i,
+                 CYPHER_DECRYPT);
+#endif
+
+      /* The sector is now in sync with the media.  If the write failed,
+       * the entry stays dirty so that its data is not lost.
+       */
+
+      if (ret >= 0)
+        {
+          bch->cache[index + i].dirty = false;
+        }
+    }
+
+  return (int)ret;
+}
+
+/****************************************************************************
+ * Name: bchlib_cachemiss
+ *
+ * Description:
+ *   Read a sector that is not cached and return the index of its cache
+ *   entry.  If the access is sequential, the following sectors are read
+ *   into adjacent entries with the same request.
+ *
+ *   A negated errno value is returned if a dirty entry that would be
+ *   reused cannot be written back.  That entry is left in the cache, still
+ *   dirty.
+ *
+ ****************************************************************************/
+
+static int bchlib_cachemiss(FAR struct bchlib_s *bch, size_t sector)
+{
+  FAR struct inode *inode = bch->inode;
+  int nsectors = 1;
+  ssize_t ret;
+  int index;
+  int i;
+
+#if BCH_READAHEAD > 1
+  /* Read ahead only if the access follows the current sector.  Don't read
+   * past the end of the media or past a sector that is already cached.
+   */
+
+  if (sector == bch->sector + 1)
+    {
+      nsectors = BCH_READAHEAD;
+      if (sector + nsectors > bch->nsectors)
+        {
+          nsectors = (int)(bch->nsectors - sector);
+        }
+
+      for (i = 1; i < nsectors; i++)
+        {
+          if (bchlib_cachefind(bch, sector + i) >= 0)
+            {
+              break;
+            }
+        }
+
+      nsectors = i;
+    }
+#endif
+
+  /* The sectors are read into a run of adjacent entries starting near the
+   * least recently used entry.  Write back any dirty entries in the run.
+   */
+
+  index = bchlib_cachevictim(bch);
+  if (index + nsectors > CONFIG_BCH_SECTORCACHE_NSECTORS)
+    {
+      index = CONFIG_BCH_SECTORCACHE_NSECTORS - nsectors;
+    }
+
+  for (i = 0; i < nsectors; i++)
+    {
+      if (bch->cache[index + i].dirty)
+        {
+          ret = bchlib_cachewrite(bch, index + i, 1);
+          if (ret < 0)
+            {
+              return (int)ret;
+            }
+        }
+
+      bch->cache[index + i].sector = (size_t)-1;
+    }
+
+  ret = inode->u.i_bops->read(inode, BCH_CACHEBUFFER(bch, index), sector,
+                              nsectors);
+  if (ret < 0)
+    {
+      ferr("Read failed: %d\n", (int)ret);
+      return (int)ret;
+    }
+
+  for (i = 0; i < nsectors; i++)
+    {
+      FAR struct bch_cache_s *cache = &bch->cache[index + i];
+
+      cache->sector = sector + i;
+      cache->stamp  = bch->stamp;
+#if defined(CONFIG_BCH_ENCRYPTION)
+      bch_cypher(bch, BCH_CACHEBUFFER(bch, index + i), sector + i,
+                 CYPHER_DECRYPT);
+#endif
+    }
+
+  return index;
+}
+#endif /* CONFIG_BCH_SECTORCACHE */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -111,13 +341,55 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
  * Name: bchlib_flushsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Flush the current contents of the sector buffer (if dirty).  If the
+ *   multi-sector cache is enabled, all dirty cache entries are flushed.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
  *
  ****************************************************************************/
 
+#ifdef CONFIG_BCH_SECTORCACHE
+int bchlib_flushsector(FAR struct bchlib_s *bch)
+{
+  int ret = OK;
+  int count;
+  int i;
+
+  bchlib_cachesync(bch);
+
+  /* Entries filled by read-ahead hold consecutive sectors.  Write those
+   * that are dirty with a single request.
+   */
+
+  for (i = 0; i < CONFIG_BCH_SECTORCACHE_NSECTORS; i += count)
+    {
+      FAR struct bch_cache_s *cache = &bch->cache[i];
+      int result;
+
+      count = 1;
+      if (!cache->dirty)
+        {
+          continue;
+        }
+
+      while (i + count < CONFIG_BCH_SECTORCACHE_NSECTORS &&
+             cache[count].dirty &&
+             cache[count].sector == cache->sector + count)
+        {
+          count++;
+        }
+
+      result = bchlib_cachewrite(bch, i, count);
+      if (result < 0)
+        {
+          ret = result;
+        }
+    }
+
+  return ret;
+}
+#else
 int bchlib_flushsector(FAR struct bchlib_s *bch)
 {
   FAR struct inode *inode;
@@ -134,7 +406,7 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
 #if defined(CONFIG_BCH_ENCRYPTION)
       /* Encrypt data as necessary */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+      bch_cypher(bch, bch->buffer, bch->sector, CYPHER_ENCRYPT);
 #endif
 
       /* Write the sector to the media */
@@ -150,7 +422,7 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
        * TODO: Add configuration switch for extra sector buffer
        */
 
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, bch->buffer, bch->sector, CYPHER_DECRYPT);
 #endif
 
       /* The sector is now in sync with the media */
@@ -160,18 +432,50 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
 
   return (int)ret;
 }
+#endif
 
 /****************************************************************************
  * Name: bchlib_readsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Make the specified sector the current sector in the sector buffer,
+ *   reading it from the media if necessary.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
  *
  ****************************************************************************/
 
+#ifdef CONFIG_BCH_SECTORCACHE
+int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
+{
+  int index;
+
+  if (bch->sector != sector)
+    {
+      bchlib_cachesync(bch);
+      bch->stamp++;
+
+      index = bchlib_cachefind(bch, sector);
+      if (index < 0)
+        {
+          index = bchlib_cachemiss(bch, sector);
+          if (index < 0)
+            {
+              bch->sector = (size_t)-1;
+              return index;
+            }
+        }
+
+      bch->cache[index].stamp = bch->stamp;
+      bch->current = index;
+      bch->buffer  = BCH_CACHEBUFFER(bch, index);
+      bch->sector  = sector;
+    }
+
+  return OK;
+}
+#else
 int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 {
   FAR struct inode *inode;
@@ -191,9 +495,89 @@ int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
         }
       bch->sector = sector;
 #if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, bch->buffer, bch->sector, CYPHER_DECRYPT);
 #endif
     }
   return (int)ret;
 }
+#endif
+
+/****************************************************************************
+ * Name: bchlib_cacheoverlay
+ *
+ * Description:
+ *   Sectors were read directly from the media into a caller buffer.  Copy
+ *   any newer data that is still in the cache over the data read.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
 
+void bchlib_cacheoverlay(FAR struct bchlib_s *bch, FAR uint8_t *buffer,
+                         size_t sector, size_t nsectors)
+{
+#ifdef CONFIG_BCH_SECTORCACHE
+  FAR struct bch_cache_s *cache;
+  int i;
+
+  bchlib_cachesync(bch);
+
+  for (i = 0; i < CONFIG_BCH_SECTORCACHE_NSECTORS; i++)
+    {
+      cache = &bch->cache[i];
+      if (cache->dirty && cache->sector >= sector &&
+          cache->sector < sector + nsectors)
+        {
+          memcpy(&buffer[(cache->sector - sector) * bch->sectsize],
+                 BCH_CACHEBUFFER(bch, i), bch->sectsize);
+        }
+    }
+#else
+  if (bch->dirty && bch->sector >= sector &&
+      bch->sector < sector + nsectors)
+    {
+      memcpy(&buffer[(bch->sector - sector) * bch->sectsize], bch->buffer,
+             bch->sectsize);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: bchlib_cacheinvalidate
+ *
+ * Description:
+ *   Sectors were written directly from a caller buffer to the media.
+ *   Discard any cached copies of those sectors.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_cacheinvalidate(FAR struct bchlib_s *bch, size_t sector,
+                            size_t nsectors)
+{
+#ifdef CONFIG_BCH_SECTORCACHE
+  FAR struct bch_cache_s *cache;
+  int i;
+
+  bchlib_cachesync(bch);
+
+  for (i = 0; i < CONFIG_BCH_SECTORCACHE_NSECTORS; i++)
+    {
+      cache = &bch->cache[i];
+      if (cache->sector >= sector && cache->sector < sector + nsectors)
+        {
+          cache->sector = (size_t)-1;
+          cache->dirty  = false;
+        }
+    }
+#endif
+
+  if (bch->sector >= sector && bch->sector < sector + nsectors)
+    {
+      bch->sector = (size_t)-1;
+      bch->dirty  = false;
+    }
+}
@@ -80,12 +80,16 @@
 ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t len)
 {
   FAR struct bchlib_s *bch = (FAR struct bchlib_s *)handle;
+#ifndef CONFIG_BCH_ENCRYPTION
   size_t   nsectors;
+#endif
   size_t   sector;
   uint16_t sectoffset;
   size_t   nbytes;
   size_t   bytesread;
+#ifndef CONFIG_BCH_ENCRYPTION
   int      ret;
+#endif
 
   /* Get rid of this special case right away */
 
@@ -143,9 +147,11 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
     }
 
   /* Then read all of the full sectors following the partial sector directly
-   * into the user buffer.
+   * into the user buffer.  Encrypted sectors must go through the sector
+   * buffer to be decrypted.
    */
 
+#ifndef CONFIG_BCH_ENCRYPTION
   if (len >= bch->sectsize)
     {
       nsectors = len / bch->sectsize;
@@ -162,6 +168,10 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
           return ret;
         }
 
+      /* The cache may hold newer data for some of the sectors */
+
+      bchlib_cacheoverlay(bch, (FAR uint8_t *)buffer, sector, nsectors);
+
       /* Adjust pointers and counts */
 
       sector    += nsectors;
@@ -176,10 +186,13 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
       buffer    += nbytes;
       len       -= nbytes;
     }
+#endif
 
-  /* Then read any partial final sector */
+  /* Then read any remaining sectors through the sector buffer (at most one
+   * partial final sector unless encryption is enabled).
+   */
 
-  if (len > 0)
+  while (len > 0)
     {
       /* Read the sector into the sector buffer */
 
@@ -187,11 +200,21 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
 
       /* Copy the head end of the sector to the user buffer */
 
-      memcpy(buffer, bch->buffer, len);
+      nbytes = len > bch->sectsize ? bch->sectsize : len;
+      memcpy(buffer, bch->buffer, nbytes);
 
-      /* Adjust counts */
+      /* Adjust pointers and counts */
+
+      bytesread += nbytes;
+      sector++;
 
-      bytesread += len;
+      if (sector >= bch->nsectors)
+        {
+          break;
+        }
+
+      buffer    += nbytes;
+      len       -= nbytes;
     }
 
   return bytesread;
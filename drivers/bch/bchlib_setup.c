@@ -71,6 +71,9 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
 {
   FAR struct bchlib_s *bch;
   struct geometry geo;
+#ifdef CONFIG_BCH_SECTORCACHE
+  int i;
+#endif
   int ret;
 
   DEBUGASSERT(blkdev);
@@ -124,6 +127,27 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
   bch->sector   = (size_t)-1;
   bch->readonly = readonly;
 
+#ifdef CONFIG_BCH_SECTORCACHE
+  /* Allocate the sector cache.  The entries are adjacent so that read-ahead
+   * can fill several of them with one request.
+   */
+
+  bch->cachemem = (FAR uint8_t *)
+    kmm_malloc(CONFIG_BCH_SECTORCACHE_NSECTORS * bch->sectsize);
+  if (!bch->cachemem)
+    {
+      ferr("ERROR: Failed to allocate sector cache\n");
+      ret = -ENOMEM;
+      goto errout_with_bch;
+    }
+
+  for (i = 0; i < CONFIG_BCH_SECTORCACHE_NSECTORS; i++)
+    {
+      bch->cache[i].sector = (size_t)-1;
+    }
+
+  bch->buffer = bch->cachemem;
+#else
   /* Allocate the sector I/O buffer */
 
   bch->buffer = (FAR uint8_t *)kmm_malloc(bch->sectsize);
@@ -133,6 +157,7 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
       ret = -ENOMEM;
       goto errout_with_bch;
     }
+#endif
 
   *handle = bch;
   return OK;
@@ -85,10 +85,17 @@ int bchlib_teardown(FAR void *handle)
 
   /* Free the BCH state structure */
 
+#ifdef CONFIG_BCH_SECTORCACHE
+  if (bch->cachemem)
+    {
+      kmm_free(bch->cachemem);
+    }
+#else
   if (bch->buffer)
     {
       kmm_free(bch->buffer);
     }
+#endif
 
   nxsem_destroy(&bch->sem);
   kmm_free(bch);
@@ -68,12 +68,16 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
         size_t len)
 {
   FAR struct bchlib_s *bch = (FAR struct bchlib_s *)handle;
+#ifndef CONFIG_BCH_ENCRYPTION
   size_t   nsectors;
+#endif
   size_t   sector;
   uint16_t sectoffset;
   size_t   nbytes;
   size_t   byteswritten;
+#if !defined(CONFIG_BCH_ENCRYPTION) || !defined(CONFIG_BCH_SECTORCACHE)
   int      ret;
+#endif
 
   /* Get rid of this special case right away */
 
@@ -130,9 +134,11 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
     }
 
   /* Then write all of the full sectors following the partial sector
-   * directly from the user buffer.
+   * directly from the user buffer.  Encrypted sectors must go through the
+   * sector buffer to be encrypted.
    */
 
+#ifndef CONFIG_BCH_ENCRYPTION
   if (len >= bch->sectsize)
     {
       nsectors = len / bch->sectsize;
@@ -151,6 +157,10 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
           return ret;
         }
 
+      /* Any cached copies of the sectors are now stale */
+
+      bchlib_cacheinvalidate(bch, sector, nsectors);
+
       /* Adjust pointers and counts */
 
       sector       += nsectors;
@@ -165,10 +175,13 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
       buffer    += nbytes;
       len       -= nbytes;
     }
+#endif
 
-  /* Then write any partial final sector */
+  /* Then write any remaining sectors through the sector buffer (at most one
+   * partial final sector unless encryption is enabled).
+   */
 
-  if (len > 0)
+  while (len > 0)
     {
       /* Read the sector into the sector buffer */
 
@@ -176,15 +189,29 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
 
       /* Copy the head end of the sector from the user buffer */
 
-      memcpy(bch->buffer, buffer, len);
+      nbytes = len > bch->sectsize ? bch->sectsize : len;
+      memcpy(bch->buffer, buffer, nbytes);
       bch->dirty = true;
 
-      /* Adjust counts */
+      /* Adjust pointers and counts */
+
+      byteswritten += nbytes;
+      sector++;
+
+      if (sector >= bch->nsectors)
+        {
+          break;
+        }
 
-      byteswritten += len;
+      buffer       += nbytes;
+      len          -= nbytes;
     }
 
-  /* Finally, flush any cached writes to the device as well */
+#ifndef CONFIG_BCH_SECTORCACHE
+  /* Finally, flush any cached writes to the device as well.  With the
+   * multi-sector cache, writes are combined until the sector is replaced,
+   * the device is closed, or BIOC_FLUSH is issued.
+   */
 
   ret = bchlib_flushsector(bch);
   if (ret < 0)
@@ -192,6 +219,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
       ferr("ERROR: Flush failed: %d\n", ret);
       return ret;
     }
+#endif
 
   return byteswritten;
 }
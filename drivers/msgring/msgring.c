@@ -0,0 +1,1115 @@
+/****************************************************************************
+ * drivers/msgring/msgring.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/drivers/msgring.h>
+
+#ifdef CONFIG_DEV_MSGRING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_DEV_MSGRING_NPOLLWAITERS
+#  define CONFIG_DEV_MSGRING_NPOLLWAITERS 2
+#endif
+
+/* Each message buffer is rounded up so that every message is 8-byte
+ * aligned.
+ */
+
+#define MSGRING_ALIGN(n)     (((n) + 7) & ~7)
+
+/* The length of a slot whose reservation was abandoned (see
+ * msgring_close()).  The reader skips such slots.
+ */
+
+#define MSGRING_ABANDONED    UINT32_MAX
+
+#define msgring_slot(r,pos)  (&(r)->slots[(pos) & (r)->mask])
+#define msgring_msg(r,pos) \
+  ((FAR void *)((r)->msgs + ((pos) & (r)->mask) * (r)->stride))
+
+/* The producer and consumer indices and the slot sequence numbers are
+ * accessed without any lock.
+ */
+
+#ifdef CONFIG_HAVE_BUILTIN_ATOMIC
+#  define msgring_load(p)    __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#  define msgring_store(p,v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#  define msgring_fence()    __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#  define msgring_load(p)    (*(p))
+#  define msgring_store(p,v) do { *(p) = (v); } while (0)
+#  define msgring_fence()
+#endif
+
+/* The compare-and-swap built-in is used only where the architecture has
+ * the instructions for it.  Elsewhere (e.g., ARMv6-M) GCC would emit a
+ * call into libatomic, so a critical section is used instead.
+ */
+
+#if defined(CONFIG_HAVE_BUILTIN_ATOMIC) && defined(CONFIG_ARCH_HAVE_TESTSET)
+#  define msgring_cmpxchg(p,o,n) \
+     __atomic_compare_exchange_n(p, &(o), n, false, __ATOMIC_ACQ_REL, \
+                                 __ATOMIC_ACQUIRE)
+#else
+#  define MSGRING_CAS_FALLBACK 1
+#  define msgring_cmpxchg(p,o,n) msgring_cas(p, &(o), n)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of one message slot.  seq holds the position of the slot
+ * while it is free and that position plus one once a message has been
+ * committed to it.  When the message is consumed, seq advances to the
+ * position of the slot in the next lap around the ring.
+ *
+ * The slot states are kept in kernel memory, apart from the messages
+ * themselves, so that user threads cannot corrupt them.
+ */
+
+struct msgring_slot_s
+{
+  volatile uint32_t seq;        /* Sequence number of the slot */
+  uint32_t len;                 /* Length of the committed message */
+  FAR struct file *owner;       /* File that reserved the slot or NULL */
+};
+
+/* The state of one message ring */
+
+struct msgring_s
+{
+  volatile uint32_t tail;       /* Next position to be reserved */
+  volatile uint32_t head;       /* Next position to be consumed */
+  uint32_t mask;                /* Number of slots minus one */
+  size_t stride;                /* Size of one slot in bytes */
+  size_t msgsize;               /* Maximum message size in bytes */
+  FAR struct msgring_slot_s *slots; /* The slot states */
+  FAR uint8_t *msgs;            /* The message buffers */
+  volatile uint8_t nrxwait;     /* Number of readers blocked on rxsem */
+  volatile uint8_t ntxwait;     /* Number of writers blocked on txsem */
+  volatile uint8_t npoll;       /* Number of poll waiters */
+  uint8_t nreaders;             /* Number of open readers (0 or 1) */
+  sem_t rxsem;                  /* Readers wait here while the ring is empty */
+  sem_t txsem;                  /* Writers wait here while the ring is full */
+
+  /* The following is a list if poll structures of threads waiting for
+   * driver events.
+   */
+
+  FAR struct pollfd *fds[CONFIG_DEV_MSGRING_NPOLLWAITERS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     msgring_open(FAR struct file *filep);
+static int     msgring_close(FAR struct file *filep);
+static ssize_t msgring_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t msgring_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
+static int     msgring_ioctl(FAR struct file *filep, int cmd,
+                 unsigned long arg);
+static int     msgring_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                 bool setup);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_msgring_fops =
+{
+  msgring_open,  /* open */
+  msgring_close, /* close */
+  msgring_read,  /* read */
+  msgring_write, /* write */
+  NULL,          /* seek */
+  msgring_ioctl, /* ioctl */
+  msgring_poll   /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL         /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: msgring_cas
+ *
+ * Description:
+ *   Compare-and-swap for toolchains or architectures without a native
+ *   compare-and-swap.
+ *
+ ****************************************************************************/
+
+#ifdef MSGRING_CAS_FALLBACK
+static bool msgring_cas(FAR volatile uint32_t *ptr, FAR uint32_t *expected,
+                        uint32_t desired)
+{
+  irqstate_t flags;
+  bool ret;
+
+  flags = enter_critical_section();
+  ret   = (*ptr == *expected);
+  if (ret)
+    {
+      *ptr = desired;
+    }
+  else
+    {
+      *expected = *ptr;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: msgring_tryreserve
+ *
+ * Description:
+ *   Claim the slot at the tail of the ring if it is free and return its
+ *   position in pos.  Returns false if the ring is full.
+ *
+ ****************************************************************************/
+
+static bool msgring_tryreserve(FAR struct msgring_s *ring,
+                               FAR uint32_t *pos)
+{
+  FAR struct msgring_slot_s *slot;
+  uint32_t tail = msgring_load(&ring->tail);
+  int32_t diff;
+
+  for (; ; )
+    {
+      slot = msgring_slot(ring, tail);
+      diff = (int32_t)(msgring_load(&slot->seq) - tail);
+
+      if (diff == 0)
+        {
+          /* The slot is free.  Claim it unless another producer got there
+           * first, in which case tail is reloaded with the new tail.
+           */
+
+          if (msgring_cmpxchg(&ring->tail, tail, tail + 1))
+            {
+              *pos = tail;
+              return true;
+            }
+        }
+      else if (diff < 0)
+        {
+          /* The slot still holds the message from the previous lap */
+
+          return false;
+        }
+      else
+        {
+          /* Another producer claimed the slot and so has already advanced
+           * the tail; try the new tail.
+           */
+
+          tail = msgring_load(&ring->tail);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: msgring_doreserve
+ *
+ * Description:
+ *   Reserve the next free slot of the ring, waiting for the reader to free
+ *   one unless nonblock is set, and return its position in pos.
+ *
+ ****************************************************************************/
+
+static int msgring_doreserve(FAR struct msgring_s *ring, FAR uint32_t *pos,
+                             bool nonblock)
+{
+  irqstate_t flags;
+  bool reserved;
+  int ret = OK;
+
+  /* The fast path does not touch any lock */
+
+  reserved = msgring_tryreserve(ring, pos);
+  while (!reserved)
+    {
+      if (nonblock)
+        {
+          return -EAGAIN;
+        }
+
+      /* The ring is full.  Announce that we are waiting before checking
+       * again so that msgring_consume() cannot miss us.
+       */
+
+      flags = enter_critical_section();
+      ring->ntxwait++;
+      msgring_fence();
+
+      reserved = msgring_tryreserve(ring, pos);
+      if (!reserved)
+        {
+          ret = nxsem_wait(&ring->txsem);
+        }
+
+      ring->ntxwait--;
+      leave_critical_section(flags);
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: msgring_trypeek
+ *
+ * Description:
+ *   Return the slot at the head of the ring if it holds a committed
+ *   message or NULL if the ring is empty.  Abandoned slots at the head are
+ *   consumed on the way.  Only the reader may call this.
+ *
+ ****************************************************************************/
+
+static FAR struct msgring_slot_s *
+msgring_trypeek(FAR struct msgring_s *ring)
+{
+  FAR struct msgring_slot_s *slot;
+  uint32_t pos;
+
+  for (; ; )
+    {
+      pos  = ring->head;
+      slot = msgring_slot(ring, pos);
+      if (msgring_load(&slot->seq) != pos + 1)
+        {
+          return NULL;
+        }
+
+      if (slot->len != MSGRING_ABANDONED)
+        {
+          return slot;
+        }
+
+      msgring_consume(ring);
+    }
+}
+
+/****************************************************************************
+ * Name: msgring_wakeup
+ *
+ * Description:
+ *   Wake up one thread waiting on sem and notify the poll waiters of the
+ *   events in eventset.
+ *
+ ****************************************************************************/
+
+static void msgring_wakeup(FAR struct msgring_s *ring, FAR sem_t *sem,
+                           pollevent_t eventset)
+{
+  FAR struct pollfd *fds;
+  irqstate_t flags;
+  int semcount;
+  int i;
+
+  flags = enter_critical_section();
+
+  if (nxsem_getvalue(sem, &semcount) >= 0 && semcount < 0)
+    {
+      nxsem_post(sem);
+    }
+
+  for (i = 0; i < CONFIG_DEV_MSGRING_NPOLLWAITERS; i++)
+    {
+      fds = ring->fds[i];
+      if (fds != NULL)
+        {
+          fds->revents |= (fds->events & eventset);
+          if (fds->revents != 0)
+            {
+              finfo("Report events: %02x\n", fds->revents);
+              poll_notify(fds);
+            }
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: msgring_findreserved
+ *
+ * Description:
+ *   Return the slot of a message buffer that was reserved but not yet
+ *   committed and its position in pos, or NULL if msg is not such a
+ *   message of this ring or if len is too large.
+ *
+ ****************************************************************************/
+
+static FAR struct msgring_slot_s *
+msgring_findreserved(FAR struct msgring_s *ring, FAR void *msg, size_t len,
+                     FAR uint32_t *pos)
+{
+  FAR struct msgring_slot_s *slot;
+  uintptr_t offset;
+  uint32_t index;
+  uint32_t tail;
+
+  /* Make sure that the message is really one of ours */
+
+  offset = (uintptr_t)msg - (uintptr_t)ring->msgs;
+  if ((FAR uint8_t *)msg < ring->msgs ||
+      offset >= (uintptr_t)(ring->mask + 1) * ring->stride ||
+      offset % ring->stride != 0 || len > ring->msgsize)
+    {
+      return NULL;
+    }
+
+  /* A reserved slot lies in [head, tail) and head is never more than one
+   * lap behind tail, so the position of the slot is the one in the last
+   * lap before tail.  The slot must still hold that position, i.e., it
+   * must have been reserved but not yet committed.  A slot that was never
+   * reserved in this lap, or that was already committed or consumed,
+   * holds a different sequence number.
+   */
+
+  index = (uint32_t)(offset / ring->stride);
+  tail  = msgring_load(&ring->tail);
+  *pos  = tail - 1 - ((tail - 1 - index) & ring->mask);
+  slot  = msgring_slot(ring, *pos);
+
+  if (msgring_load(&slot->seq) != *pos)
+    {
+      return NULL;
+    }
+
+  return slot;
+}
+
+/****************************************************************************
+ * Name: msgring_publish
+ *
+ * Description:
+ *   Commit the reserved slot at position pos with the message length len
+ *   and wake up the reader.
+ *
+ ****************************************************************************/
+
+static int msgring_publish(FAR struct msgring_s *ring,
+                           FAR struct msgring_slot_s *slot, uint32_t pos,
+                           size_t len)
+{
+  slot->len = len;
+
+  /* Advancing the sequence number by one hands the message to the reader.
+   * The compare-and-swap makes sure that only one commit does this.
+   */
+
+  if (!msgring_cmpxchg(&slot->seq, pos, pos + 1))
+    {
+      return -EINVAL;
+    }
+
+  msgring_fence();
+  if (ring->nrxwait > 0 || ring->npoll > 0)
+    {
+      msgring_wakeup(ring, &ring->rxsem, POLLIN);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: msgring_open
+ ****************************************************************************/
+
+static int msgring_open(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct msgring_s *ring = (FAR struct msgring_s *)inode->i_private;
+  irqstate_t flags;
+  int ret = OK;
+
+  /* Messages are consumed in place, so there can only be one reader */
+
+  if ((filep->f_oflags & O_RDOK) != 0)
+    {
+      flags = enter_critical_section();
+      if (ring->nreaders > 0)
+        {
+          ret = -EBUSY;
+        }
+      else
+        {
+          ring->nreaders++;
+        }
+
+      leave_critical_section(flags);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: msgring_close
+ *
+ * Description:
+ *   Messages reserved with MSGRINGIOC_RESERVE that were never committed
+ *   would keep the reader from ever getting past them, e.g. when the
+ *   producer exits.  Such reservations are abandoned when the file is
+ *   closed:  They are committed with a length that the reader skips.
+ *
+ ****************************************************************************/
+
+static int msgring_close(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct msgring_s *ring = (FAR struct msgring_s *)inode->i_private;
+  FAR struct msgring_slot_s *slot;
+  irqstate_t flags;
+  uint32_t tail;
+  uint32_t pos;
+  bool abandoned = false;
+
+  if ((filep->f_oflags & O_WROK) != 0)
+    {
+      /* MSGRINGIOC_COMMIT checks the owner of the slot in the same
+       * critical section, so a slot cannot be committed through another
+       * file while it is abandoned here.
+       */
+
+      flags = enter_critical_section();
+      tail  = msgring_load(&ring->tail);
+      for (pos = msgring_load(&ring->head); pos != tail; pos++)
+        {
+          slot = msgring_slot(ring, pos);
+          if (slot->owner == filep && msgring_load(&slot->seq) == pos)
+            {
+              slot->len = MSGRING_ABANDONED;
+              if (msgring_cmpxchg(&slot->seq, pos, pos + 1))
+                {
+                  abandoned = true;
+                }
+            }
+        }
+
+      msgring_fence();
+      if (abandoned && (ring->nrxwait > 0 || ring->npoll > 0))
+        {
+          msgring_wakeup(ring, &ring->rxsem, POLLIN);
+        }
+
+      leave_critical_section(flags);
+    }
+
+  if ((filep->f_oflags & O_RDOK) != 0)
+    {
+      DEBUGASSERT(ring->nreaders > 0);
+      ring->nreaders--;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: msgring_read
+ *
+ * Description:
+ *   Copy the oldest message out of the ring.  This is the conventional
+ *   interface; MSGRINGIOC_PEEK and MSGRINGIOC_CONSUME avoid the copy.
+ *
+ ****************************************************************************/
+
+static ssize_t msgring_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct msgring_s *ring = (FAR struct msgring_s *)inode->i_private;
+  FAR void *msg;
+  size_t len;
+  int ret;
+
+  ret = msgring_peek(ring, &msg, &len,
+                     (filep->f_oflags & O_NONBLOCK) != 0);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Leave the message in the ring if the caller's buffer is too small */
+
+  if (len > buflen)
+    {
+      return -EMSGSIZE;
+    }
+
+  memcpy(buffer, msg, len);
+  msgring_consume(ring);
+  return len;
+}
+
+/****************************************************************************
+ * Name: msgring_write
+ *
+ * Description:
+ *   Copy one message into the ring.
+ *
+ ****************************************************************************/
+
+static ssize_t msgring_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct msgring_s *ring = (FAR struct msgring_s *)inode->i_private;
+  FAR void *msg;
+  int ret;
+
+  if (buflen > ring->msgsize)
+    {
+      return -EMSGSIZE;
+    }
+
+  ret = msgring_reserve(ring, &msg, (filep->f_oflags & O_NONBLOCK) != 0);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memcpy(msg, buffer, buflen);
+
+  ret = msgring_commit(ring, msg, buflen);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: msgring_ioctl
+ ****************************************************************************/
+
+static int msgring_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct msgring_s *ring = (FAR struct msgring_s *)inode->i_private;
+  bool nonblock = (filep->f_oflags & O_NONBLOCK) != 0;
+  int ret = OK;
+
+  switch (cmd)
+    {
+      case MSGRINGIOC_RESERVE:
+        {
+          FAR void **msg = (FAR void **)((uintptr_t)arg);
+          uint32_t pos;
+
+          if (msg == NULL || (filep->f_oflags & O_WROK) == 0)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          /* Remember the file so that msgring_close() can abandon the
+           * reservation if it is never committed.
+           */
+
+          ret = msgring_doreserve(ring, &pos, nonblock);
+          if (ret >= 0)
+            {
+              msgring_slot(ring, pos)->owner = filep;
+              *msg = msgring_msg(ring, pos);
+            }
+        }
+        break;
+
+      case MSGRINGIOC_COMMIT:
+        {
+          FAR struct msgring_msg_s *desc =
+            (FAR struct msgring_msg_s *)((uintptr_t)arg);
+          FAR struct msgring_slot_s *slot;
+          irqstate_t flags;
+          uint32_t pos;
+
+          if (desc == NULL || (filep->f_oflags & O_WROK) == 0)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          /* Only the file that reserved the message may commit it.  This
+           * is checked in the same critical section as msgring_close()
+           * abandons the reservations of a file.
+           */
+
+          flags = enter_critical_section();
+          slot  = msgring_findreserved(ring, desc->buf, desc->len, &pos);
+          if (slot == NULL)
+            {
+              ret = -EINVAL;
+            }
+          else if (slot->owner != filep)
+            {
+              ret = -EPERM;
+            }
+          else
+            {
+              ret = msgring_publish(ring, slot, pos, desc->len);
+            }
+
+          leave_critical_section(flags);
+        }
+        break;
+
+      case MSGRINGIOC_PEEK:
+        {
+          FAR struct msgring_msg_s *desc =
+            (FAR struct msgring_msg_s *)((uintptr_t)arg);
+
+          if (desc == NULL || (filep->f_oflags & O_RDOK) == 0)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          ret = msgring_peek(ring, &desc->buf, &desc->len, nonblock);
+        }
+        break;
+
+      case MSGRINGIOC_CONSUME:
+        {
+          if ((filep->f_oflags & O_RDOK) == 0 ||
+              msgring_trypeek(ring) == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          msgring_consume(ring);
+        }
+        break;
+
+      case MSGRINGIOC_GETINFO:
+        {
+          FAR struct msgring_info_s *info =
+            (FAR struct msgring_info_s *)((uintptr_t)arg);
+
+          if (info == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          info->nslots  = ring->mask + 1;
+          info->msgsize = ring->msgsize;
+        }
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: msgring_poll
+ ****************************************************************************/
+
+static int msgring_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                        bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct msgring_s *ring = (FAR struct msgring_s *)inode->i_private;
+  FAR struct pollfd **slot;
+  pollevent_t eventset;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  /* The poll list is also walked by producers in interrupt handlers */
+
+  flags = enter_critical_section();
+  if (setup)
+    {
+      /* This is a request to set up the poll.  Find an available
+       * slot for the poll structure reference
+       */
+
+      for (i = 0; i < CONFIG_DEV_MSGRING_NPOLLWAITERS; i++)
+        {
+          if (ring->fds[i] == NULL)
+            {
+              /* Bind the poll structure and this slot */
+
+              ring->fds[i] = fds;
+              fds->priv    = &ring->fds[i];
+              ring->npoll++;
+              break;
+            }
+        }
+
+      if (i >= CONFIG_DEV_MSGRING_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+          goto errout;
+        }
+
+      /* Should we immediately notify on any of the requested events? */
+
+      eventset = 0;
+      if ((filep->f_oflags & O_RDOK) != 0 && msgring_trypeek(ring) != NULL)
+        {
+          eventset |= POLLIN;
+        }
+
+      if ((filep->f_oflags & O_WROK) != 0 &&
+          msgring_slot(ring, ring->tail)->seq == ring->tail)
+        {
+          eventset |= POLLOUT;
+        }
+
+      fds->revents |= (fds->events & eventset);
+      if (fds->revents != 0)
+        {
+          poll_notify(fds);
+        }
+    }
+  else
+    {
+      /* This is a request to tear down the poll. */
+
+      slot = (FAR struct pollfd **)fds->priv;
+      if (slot != NULL)
+        {
+          *slot     = NULL;
+          fds->priv = NULL;
+          ring->npoll--;
+        }
+    }
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: msgring_register
+ *
+ * Description:
+ *   Create a message ring and register it as a character driver.  See
+ *   include/nuttx/drivers/msgring.h.
+ *
+ ****************************************************************************/
+
+int msgring_register(FAR const char *path, uint32_t nslots, size_t msgsize,
+                     FAR struct msgring_s **ring)
+{
+  FAR struct msgring_s *priv;
+  size_t stride;
+  uint32_t i;
+  int ret;
+
+  /* Sequence numbers are compared as signed distances, so the number of
+   * slots must be a power of two well below 2^31.  The length of a message
+   * is kept in 32 bits and must not be MSGRING_ABANDONED.
+   */
+
+  if (path == NULL || nslots < 2 || nslots > (1 << 24) ||
+      (nslots & (nslots - 1)) != 0 || msgsize == 0 ||
+      msgsize > UINT32_MAX - 7)
+    {
+      return -EINVAL;
+    }
+
+  /* The message buffers must not be smaller than the slots imply */
+
+  stride = MSGRING_ALIGN(msgsize);
+  if (stride > SIZE_MAX / nslots)
+    {
+      return -EINVAL;
+    }
+
+  priv = (FAR struct msgring_s *)kmm_zalloc(sizeof(struct msgring_s));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  priv->mask    = nslots - 1;
+  priv->stride  = stride;
+  priv->msgsize = msgsize;
+
+  priv->slots = (FAR struct msgring_slot_s *)
+    kmm_malloc(nslots * sizeof(struct msgring_slot_s));
+  if (priv->slots == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_priv;
+    }
+
+  for (i = 0; i < nslots; i++)
+    {
+      priv->slots[i].seq   = i;
+      priv->slots[i].len   = 0;
+      priv->slots[i].owner = NULL;
+    }
+
+  /* The message buffers are allocated from the user heap so that, in the
+   * FLAT and PROTECTED builds, user threads can access the messages in
+   * place.
+   */
+
+  priv->msgs = (FAR uint8_t *)kumm_malloc((size_t)nslots * stride);
+  if (priv->msgs == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_slots;
+    }
+
+  /* The wait semaphores are used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_init(&priv->rxsem, 0, 0);
+  nxsem_init(&priv->txsem, 0, 0);
+  nxsem_setprotocol(&priv->rxsem, SEM_PRIO_NONE);
+  nxsem_setprotocol(&priv->txsem, SEM_PRIO_NONE);
+
+  ret = register_driver(path, &g_msgring_fops, 0666, priv);
+  if (ret < 0)
+    {
+      ferr("ERROR: register_driver(%s) failed: %d\n", path, ret);
+      goto errout_with_sem;
+    }
+
+  if (ring != NULL)
+    {
+      *ring = priv;
+    }
+
+  return OK;
+
+errout_with_sem:
+  nxsem_destroy(&priv->rxsem);
+  nxsem_destroy(&priv->txsem);
+  kumm_free(priv->msgs);
+
+errout_with_slots:
+  kmm_free(priv->slots);
+
+errout_with_priv:
+  kmm_free(priv);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: msgring_reserve
+ *
+ * Description:
+ *   Reserve the next free slot of the ring for a new message.  See
+ *   include/nuttx/drivers/msgring.h.
+ *
+ ****************************************************************************/
+
+int msgring_reserve(FAR struct msgring_s *ring, FAR void **msg,
+                    bool nonblock)
+{
+  uint32_t pos;
+  int ret;
+
+  DEBUGASSERT(ring != NULL && msg != NULL);
+
+  ret = msgring_doreserve(ring, &pos, nonblock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  *msg = msgring_msg(ring, pos);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: msgring_commit
+ *
+ * Description:
+ *   Publish a message reserved with msgring_reserve().  See
+ *   include/nuttx/drivers/msgring.h.
+ *
+ ****************************************************************************/
+
+int msgring_commit(FAR struct msgring_s *ring, FAR void *msg, size_t len)
+{
+  FAR struct msgring_slot_s *slot;
+  uint32_t pos;
+
+  DEBUGASSERT(ring != NULL);
+
+  slot = msgring_findreserved(ring, msg, len, &pos);
+  if (slot == NULL)
+    {
+      return -EINVAL;
+    }
+
+  return msgring_publish(ring, slot, pos, len);
+}
+
+/****************************************************************************
+ * Name: msgring_peek
+ *
+ * Description:
+ *   Return the oldest message in the ring without copying it.  See
+ *   include/nuttx/drivers/msgring.h.
+ *
+ ****************************************************************************/
+
+int msgring_peek(FAR struct msgring_s *ring, FAR void **msg,
+                 FAR size_t *len, bool nonblock)
+{
+  FAR struct msgring_slot_s *slot;
+  irqstate_t flags;
+  int ret = OK;
+
+  DEBUGASSERT(ring != NULL && msg != NULL && len != NULL);
+
+  slot = msgring_trypeek(ring);
+  while (slot == NULL)
+    {
+      if (nonblock)
+        {
+          return -EAGAIN;
+        }
+
+      /* The ring is empty.  Announce that we are waiting before checking
+       * again so that msgring_commit() cannot miss us.
+       */
+
+      flags = enter_critical_section();
+      ring->nrxwait++;
+      msgring_fence();
+
+      slot = msgring_trypeek(ring);
+      if (slot == NULL)
+        {
+          ret = nxsem_wait(&ring->rxsem);
+        }
+
+      ring->nrxwait--;
+      leave_critical_section(flags);
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  *msg = msgring_msg(ring, ring->head);
+  *len = slot->len;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: msgring_consume
+ *
+ * Description:
+ *   Release the message returned by msgring_peek().  See
+ *   include/nuttx/drivers/msgring.h.
+ *
+ ****************************************************************************/
+
+void msgring_consume(FAR struct msgring_s *ring)
+{
+  FAR struct msgring_slot_s *slot;
+  uint32_t pos;
+
+  DEBUGASSERT(ring != NULL);
+
+  pos  = ring->head;
+  slot = msgring_slot(ring, pos);
+  DEBUGASSERT(slot->seq == pos + 1);
+
+  /* Free the slot for the producers' next lap around the ring */
+
+  slot->owner = NULL;
+  ring->head  = pos + 1;
+  msgring_store(&slot->seq, pos + ring->mask + 1);
+
+  msgring_fence();
+  if (ring->ntxwait > 0 || ring->npoll > 0)
+    {
+      msgring_wakeup(ring, &ring->txsem, POLLOUT);
+    }
+}
+
+#endif /* CONFIG_DEV_MSGRING */
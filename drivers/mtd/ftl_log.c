@@ -0,0 +1,2403 @@
+/****************************************************************************
+ * drivers/mtd/ftl_log.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <limits.h>
+#include <string.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <crc32.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/mtd/mtd.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_FTL_LOG_NRESERVED
+#  define CONFIG_FTL_LOG_NRESERVED 8
+#endif
+
+#if CONFIG_FTL_LOG_NRESERVED < 6
+#  error "CONFIG_FTL_LOG_NRESERVED must be at least 6"
+#endif
+
+#ifndef CONFIG_FTL_LOG_CKPTINTERVAL
+#  define CONFIG_FTL_LOG_CKPTINTERVAL 16
+#endif
+
+#ifndef CONFIG_FTL_LOG_ERASEDSTATE
+#  define CONFIG_FTL_LOG_ERASEDSTATE 0xff
+#endif
+
+#ifdef CONFIG_FTL_LOG_BGGC
+#  ifndef CONFIG_FTL_LOG_GCTHRESHOLD
+#    define CONFIG_FTL_LOG_GCTHRESHOLD 4
+#  endif
+#  ifndef CONFIG_FTL_LOG_WLTHRESHOLD
+#    define CONFIG_FTL_LOG_WLTHRESHOLD 64
+#  endif
+#  ifdef CONFIG_SCHED_LPWORK
+#    define FTL_WORK LPWORK
+#  else
+#    define FTL_WORK HPWORK
+#  endif
+#endif
+
+/* The maximum length of the device name paths is the maximum length of a
+ * name plus 5 for the the length of "/dev/" and a NUL terminator.
+ */
+
+#define DEV_NAME_MAX      (NAME_MAX + 5)
+
+/* Magic numbers that identify the FTL meta-data pages */
+
+#define FTL_MAGIC_HEADER  0x48544c46  /* "FLTH" */
+#define FTL_MAGIC_SUMMARY 0x53544c46  /* "FLTS" */
+#define FTL_MAGIC_COMMIT  0x43544c46  /* "FLTC" */
+
+/* Types of erase blocks recorded in the block header */
+
+#define FTL_TYPE_DATA     1           /* Holds data pages and summaries */
+#define FTL_TYPE_CKPT     2           /* Holds a checkpoint */
+
+/* States of an erase block */
+
+#define FTL_BLOCK_FREE    0           /* Erased and ready to be opened */
+#define FTL_BLOCK_DIRTY   1           /* Must be erased before use */
+#define FTL_BLOCK_OPEN    2           /* Data pages are being appended */
+#define FTL_BLOCK_DATA    3           /* Closed block of data pages */
+#define FTL_BLOCK_CKPT    4           /* Holds a checkpoint */
+#define FTL_BLOCK_EMPTIED 5           /* Collected, not yet erased */
+
+/* Free erase blocks that only garbage collection and checkpoints may use */
+
+#define FTL_GCRESERVE     2
+
+/* Special values */
+
+#define FTL_NOBLOCK       0xffff      /* No erase block */
+#define FTL_UNMAPPED      0xffffffff  /* Logical sector has no page */
+
+/* Helpers */
+
+#define FTL_BLOCK(d,p)    ((p) / (d)->blkper)
+#define FTL_PAGE(d,b,i)   ((uint32_t)(b) * (d)->blkper + (i))
+#define FTL_NENTRIES(d)   \
+  (((d)->geo.blocksize - sizeof(struct ftl_summary_s)) / sizeof(uint32_t))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The first page of every erase block that is in use */
+
+struct ftl_header_s
+{
+  uint32_t magic;                  /* FTL_MAGIC_HEADER */
+  uint32_t seq;                    /* Sequence number of the block */
+  uint32_t erasecount;             /* Number of times the block was erased */
+  uint32_t type;                   /* FTL_TYPE_DATA or FTL_TYPE_CKPT */
+  uint32_t crc;                    /* CRC32 of the preceding fields */
+};
+
+/* Data pages are written in segments.  Each segment is closed by a summary
+ * page that records the logical sector held by each of its data pages.
+ * The summary is followed by 'npages' 32-bit logical sector numbers.
+ */
+
+struct ftl_summary_s
+{
+  uint32_t magic;                  /* FTL_MAGIC_SUMMARY */
+  uint32_t seq;                    /* Sequence number of the block */
+  uint16_t first;                  /* First data page of the segment */
+  uint16_t npages;                 /* Number of data pages in the segment */
+  uint32_t crc;                    /* CRC32 of the summary and its entries */
+};
+
+/* A checkpoint is a chain of erase blocks with consecutive sequence
+ * numbers.  After the header of each block, the chain holds a copy of the
+ * sector map followed by one ftl_ckptblock_s for each erase block and,
+ * finally, the commit page in the last block of the chain.
+ */
+
+struct ftl_ckptblock_s
+{
+  uint32_t erasecount;             /* Number of times the block was erased */
+  uint16_t lastsum;                /* Page of the last summary in the block */
+  uint16_t reserved;
+};
+
+struct ftl_commit_s
+{
+  uint32_t magic;                  /* FTL_MAGIC_COMMIT */
+  uint32_t seq;                    /* Sequence number of the first block */
+  uint32_t crc;                    /* CRC32 of the checkpoint pages */
+};
+
+/* Used while a checkpoint is written to or read from the media */
+
+struct ftl_ckptio_s
+{
+  uint32_t page;                   /* Next page to transfer */
+  uint32_t offset;                 /* Offset into the page buffer */
+  uint32_t crc;                    /* CRC32 of the pages transferred */
+};
+
+/* In-memory state of one erase block */
+
+struct ftl_eblock_s
+{
+  uint32_t seq;                    /* Sequence number of the block */
+  uint32_t erasecount;             /* Number of times the block was erased */
+  uint16_t nlive;                  /* Number of pages mapped to a sector */
+  uint16_t lastsum;                /* Page of the last summary or zero */
+  uint8_t  state;                  /* See FTL_BLOCK_* definitions */
+};
+
+struct ftl_struct_s
+{
+  FAR struct mtd_dev_s *mtd;       /* Contained MTD interface */
+  struct mtd_geometry_s geo;       /* Device geometry */
+  sem_t                 exclsem;   /* Assures mutually exclusive access */
+  FAR struct ftl_eblock_s *eblocks; /* State of each erase block */
+  FAR uint32_t         *map;       /* Logical sector to physical page */
+  FAR uint32_t         *segment;   /* Sectors of the open segment */
+  FAR uint32_t         *gcsum;     /* Sectors of the segment being collected */
+  FAR uint8_t          *pgbuf;     /* One page I/O buffer */
+  FAR uint8_t          *gcbuf;     /* Page being moved by the collector */
+  uint32_t              nsectors;  /* Number of logical sectors */
+  uint32_t              seq;       /* Next block sequence number */
+  uint32_t              ckptseq;   /* First sequence number of checkpoint */
+  uint16_t              blkper;    /* R/W blocks per erase block */
+  uint16_t              maxseg;    /* Maximum data pages in a segment */
+  uint32_t              ckptpages; /* Pages of map and block table */
+  uint16_t              ckptblocks; /* Erase blocks in a checkpoint chain */
+  uint16_t              nfree;     /* Number of free erase blocks */
+  uint16_t              curblk;    /* Erase block being written */
+  uint16_t              curpage;   /* Next page to write in curblk */
+  uint16_t              segfirst;  /* First data page of the open segment */
+  uint16_t              nclosed;   /* Blocks closed since the checkpoint */
+  uint16_t              refs;      /* Number of references */
+  bool                  unlinked;  /* The driver has been unlinked */
+  bool                  discarded; /* Sectors discarded since checkpoint */
+#ifdef CONFIG_FTL_LOG_BGGC
+  struct work_s         work;      /* Background garbage collection */
+#endif
+  struct ftl_log_stats_s stats;    /* Write amplification and wear stats */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     ftl_open(FAR struct inode *inode);
+static int     ftl_close(FAR struct inode *inode);
+static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
+                 size_t start_sector, unsigned int nsectors);
+static ssize_t ftl_write(FAR struct inode *inode, const unsigned char *buffer,
+                 size_t start_sector, unsigned int nsectors);
+static int     ftl_geometry(FAR struct inode *inode,
+                 struct geometry *geometry);
+static int     ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg);
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int     ftl_unlink(FAR struct inode *inode);
+#endif
+
+static int     ftl_reserve(FAR struct ftl_struct_s *dev, uint16_t nblocks);
+static int     ftl_append(FAR struct ftl_struct_s *dev, uint32_t sector,
+                 FAR const uint8_t *buffer, size_t nsectors, bool host);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct block_operations g_bops =
+{
+  ftl_open,     /* open     */
+  ftl_close,    /* close    */
+  ftl_read,     /* read     */
+  ftl_write,    /* write    */
+  ftl_geometry, /* geometry */
+  ftl_ioctl     /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , ftl_unlink  /* unlink   */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ftl_isblank
+ *
+ * Description: Check if a buffer holds only erased bytes
+ *
+ ****************************************************************************/
+
+static bool ftl_isblank(FAR const uint8_t *buffer, size_t len)
+{
+  while (len-- > 0)
+    {
+      if (*buffer++ != CONFIG_FTL_LOG_ERASEDSTATE)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: ftl_readpages and ftl_writepages
+ *
+ * Description: Transfer pages to or from the media
+ *
+ ****************************************************************************/
+
+static int ftl_readpages(FAR struct ftl_struct_s *dev, uint32_t page,
+                         size_t npages, FAR uint8_t *buffer)
+{
+  ssize_t nread;
+
+  nread = MTD_BREAD(dev->mtd, page, npages, buffer);
+  if (nread != npages)
+    {
+      ferr("ERROR: Read %d pages at page %lu failed: %d\n",
+           (int)npages, (unsigned long)page, (int)nread);
+      return nread < 0 ? (int)nread : -EIO;
+    }
+
+  return OK;
+}
+
+static int ftl_writepages(FAR struct ftl_struct_s *dev, uint32_t page,
+                          size_t npages, FAR const uint8_t *buffer)
+{
+  ssize_t nwritten;
+
+  nwritten = MTD_BWRITE(dev->mtd, page, npages, buffer);
+  if (nwritten != npages)
+    {
+      ferr("ERROR: Write %d pages at page %lu failed: %d\n",
+           (int)npages, (unsigned long)page, (int)nwritten);
+      return nwritten < 0 ? (int)nwritten : -EIO;
+    }
+
+  dev->stats.nprogrammed += npages;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_remap
+ *
+ * Description:
+ *   Map a logical sector to a new physical page (or to no page at all) and
+ *   update the live page counts of the erase blocks involved.
+ *
+ ****************************************************************************/
+
+static void ftl_remap(FAR struct ftl_struct_s *dev, uint32_t sector,
+                      uint32_t page)
+{
+  uint32_t oldpage = dev->map[sector];
+
+  if (oldpage != FTL_UNMAPPED)
+    {
+      DEBUGASSERT(dev->eblocks[FTL_BLOCK(dev, oldpage)].nlive > 0);
+      dev->eblocks[FTL_BLOCK(dev, oldpage)].nlive--;
+    }
+
+  if (page != FTL_UNMAPPED)
+    {
+      dev->eblocks[FTL_BLOCK(dev, page)].nlive++;
+    }
+
+  dev->map[sector] = page;
+}
+
+/****************************************************************************
+ * Name: ftl_erase
+ *
+ * Description: Erase a block that holds no live pages and make it free
+ *
+ ****************************************************************************/
+
+static int ftl_erase(FAR struct ftl_struct_s *dev, uint16_t block)
+{
+  FAR struct ftl_eblock_s *eblock = &dev->eblocks[block];
+  int ret;
+
+  DEBUGASSERT(eblock->nlive == 0 && eblock->state != FTL_BLOCK_FREE);
+
+  ret = MTD_ERASE(dev->mtd, block, 1);
+  if (ret < 0)
+    {
+      ferr("ERROR: Erase block=%d failed: %d\n", block, ret);
+      return ret;
+    }
+
+  eblock->seq     = 0;
+  eblock->lastsum = 0;
+  eblock->state   = FTL_BLOCK_FREE;
+  eblock->erasecount++;
+
+  dev->nfree++;
+  dev->stats.nerased++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_openblock
+ *
+ * Description:
+ *   Take the least worn free erase block and write its header.  This is
+ *   the dynamic part of wear leveling.
+ *
+ ****************************************************************************/
+
+static int ftl_openblock(FAR struct ftl_struct_s *dev, uint32_t type)
+{
+  FAR struct ftl_header_s *hdr;
+  FAR struct ftl_eblock_s *eblock;
+  uint16_t block = FTL_NOBLOCK;
+  uint16_t i;
+  int ret;
+
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      if (dev->eblocks[i].state == FTL_BLOCK_FREE &&
+          (block == FTL_NOBLOCK ||
+           dev->eblocks[i].erasecount < dev->eblocks[block].erasecount))
+        {
+          block = i;
+        }
+    }
+
+  if (block == FTL_NOBLOCK)
+    {
+      ferr("ERROR: No free erase block\n");
+      return -ENOSPC;
+    }
+
+  eblock = &dev->eblocks[block];
+
+  memset(dev->pgbuf, CONFIG_FTL_LOG_ERASEDSTATE, dev->geo.blocksize);
+  hdr             = (FAR struct ftl_header_s *)dev->pgbuf;
+  hdr->magic      = FTL_MAGIC_HEADER;
+  hdr->seq        = dev->seq;
+  hdr->erasecount = eblock->erasecount;
+  hdr->type       = type;
+  hdr->crc        = crc32((FAR const uint8_t *)hdr,
+                          offsetof(struct ftl_header_s, crc));
+
+  ret = ftl_writepages(dev, FTL_PAGE(dev, block, 0), 1, dev->pgbuf);
+  if (ret < 0)
+    {
+      /* The block is in an unknown state now */
+
+      eblock->state = FTL_BLOCK_DIRTY;
+      dev->nfree--;
+      return ret;
+    }
+
+  eblock->seq     = dev->seq++;
+  eblock->nlive   = 0;
+  eblock->lastsum = 0;
+  eblock->state   = type == FTL_TYPE_CKPT ? FTL_BLOCK_CKPT : FTL_BLOCK_OPEN;
+  dev->nfree--;
+  return block;
+}
+
+/****************************************************************************
+ * Name: ftl_closesegment
+ *
+ * Description:
+ *   Write the summary of the open segment.  The data pages written so far
+ *   can be recovered after a power loss once this returns.
+ *
+ ****************************************************************************/
+
+static int ftl_closesegment(FAR struct ftl_struct_s *dev)
+{
+  FAR struct ftl_summary_s *sum;
+  uint16_t npages;
+  uint32_t crc;
+  int ret;
+
+  if (dev->curblk == FTL_NOBLOCK || dev->curpage == dev->segfirst)
+    {
+      return OK;
+    }
+
+  npages = dev->curpage - dev->segfirst;
+
+  memset(dev->pgbuf, CONFIG_FTL_LOG_ERASEDSTATE, dev->geo.blocksize);
+  sum         = (FAR struct ftl_summary_s *)dev->pgbuf;
+  sum->magic  = FTL_MAGIC_SUMMARY;
+  sum->seq    = dev->eblocks[dev->curblk].seq;
+  sum->first  = dev->segfirst;
+  sum->npages = npages;
+  sum->crc    = 0;
+  memcpy(sum + 1, dev->segment, npages * sizeof(uint32_t));
+
+  crc = crc32(dev->pgbuf,
+              sizeof(struct ftl_summary_s) + npages * sizeof(uint32_t));
+  sum->crc = crc;
+
+  ret = ftl_writepages(dev, FTL_PAGE(dev, dev->curblk, dev->curpage), 1,
+                       dev->pgbuf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  dev->eblocks[dev->curblk].lastsum = dev->curpage;
+  dev->curpage++;
+  dev->segfirst = dev->curpage;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_closeblock
+ *
+ * Description: Close the open segment and the erase block that holds it
+ *
+ ****************************************************************************/
+
+static int ftl_closeblock(FAR struct ftl_struct_s *dev)
+{
+  int ret;
+
+  if (dev->curblk == FTL_NOBLOCK)
+    {
+      return OK;
+    }
+
+  ret = ftl_closesegment(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  dev->eblocks[dev->curblk].state = FTL_BLOCK_DATA;
+  dev->curblk = FTL_NOBLOCK;
+  dev->nclosed++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_ckptfind
+ *
+ * Description: Find the checkpoint block with a given sequence number
+ *
+ ****************************************************************************/
+
+static uint16_t ftl_ckptfind(FAR struct ftl_struct_s *dev, uint32_t seq)
+{
+  uint16_t i;
+
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      if (dev->eblocks[i].state == FTL_BLOCK_CKPT &&
+          dev->eblocks[i].seq == seq)
+        {
+          return i;
+        }
+    }
+
+  return FTL_NOBLOCK;
+}
+
+/****************************************************************************
+ * Name: ftl_ckptnext
+ *
+ * Description:
+ *   Move on to the next block of the checkpoint chain when all pages of the
+ *   current one have been transferred.  A new block is opened for writing;
+ *   for reading, the block with the next sequence number is looked up.
+ *
+ ****************************************************************************/
+
+static int ftl_ckptnext(FAR struct ftl_struct_s *dev,
+                        FAR struct ftl_ckptio_s *io, bool write)
+{
+  uint16_t block;
+  int ret;
+
+  if (io->page % dev->blkper != 0)
+    {
+      return OK;
+    }
+
+  if (write)
+    {
+      ret = ftl_openblock(dev, FTL_TYPE_CKPT);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      block = ret;
+    }
+  else
+    {
+      block = ftl_ckptfind(dev,
+                           dev->eblocks[FTL_BLOCK(dev, io->page - 1)].seq + 1);
+      if (block == FTL_NOBLOCK)
+        {
+          return -EINVAL;
+        }
+    }
+
+  io->page = FTL_PAGE(dev, block, 1);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_ckptput and ftl_ckptget
+ *
+ * Description:
+ *   Stream checkpoint data to or from the checkpoint pages.  A writer
+ *   starts with page zero so that the first block of the chain is opened
+ *   with the first page.  A NULL destination only reads the pages to
+ *   compute their CRC.
+ *
+ ****************************************************************************/
+
+static int ftl_ckptput(FAR struct ftl_struct_s *dev,
+                       FAR struct ftl_ckptio_s *io,
+                       FAR const void *data, size_t len)
+{
+  FAR const uint8_t *src = (FAR const uint8_t *)data;
+  size_t nbytes;
+  int ret;
+
+  while (len > 0 || (data == NULL && io->offset > 0))
+    {
+      /* Opening a block overwrites the page buffer with its header */
+
+      if (io->offset == 0)
+        {
+          ret = ftl_ckptnext(dev, io, true);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      /* A NULL data pointer pads and writes out the last partial page */
+
+      if (data == NULL)
+        {
+          nbytes = dev->geo.blocksize - io->offset;
+          memset(dev->pgbuf + io->offset, CONFIG_FTL_LOG_ERASEDSTATE,
+                 nbytes);
+        }
+      else
+        {
+          nbytes = dev->geo.blocksize - io->offset;
+          if (nbytes > len)
+            {
+              nbytes = len;
+            }
+
+          memcpy(dev->pgbuf + io->offset, src, nbytes);
+          src += nbytes;
+          len -= nbytes;
+        }
+
+      io->offset += nbytes;
+      if (io->offset == dev->geo.blocksize)
+        {
+          io->crc = crc32part(dev->pgbuf, dev->geo.blocksize, io->crc);
+          ret = ftl_writepages(dev, io->page, 1, dev->pgbuf);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          io->page++;
+          io->offset = 0;
+        }
+    }
+
+  return OK;
+}
+
+static int ftl_ckptget(FAR struct ftl_struct_s *dev,
+                       FAR struct ftl_ckptio_s *io,
+                       FAR void *data, size_t len)
+{
+  FAR uint8_t *dest = (FAR uint8_t *)data;
+  size_t nbytes;
+  int ret;
+
+  while (len > 0)
+    {
+      if (io->offset == 0)
+        {
+          ret = ftl_ckptnext(dev, io, false);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          ret = ftl_readpages(dev, io->page, 1, dev->pgbuf);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          io->crc = crc32part(dev->pgbuf, dev->geo.blocksize, io->crc);
+          io->page++;
+        }
+
+      nbytes = dev->geo.blocksize - io->offset;
+      if (nbytes > len)
+        {
+          nbytes = len;
+        }
+
+      if (dest != NULL)
+        {
+          memcpy(dest, dev->pgbuf + io->offset, nbytes);
+          dest += nbytes;
+        }
+
+      len        -= nbytes;
+      io->offset += nbytes;
+
+      if (io->offset == dev->geo.blocksize)
+        {
+          io->offset = 0;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_checkpoint
+ *
+ * Description:
+ *   Write the sector map and the erase block table to a new checkpoint
+ *   chain.  The previous checkpoint stays valid until the commit page of
+ *   the new one has been written, so a power loss at any time leaves a
+ *   usable checkpoint on the media.
+ *
+ ****************************************************************************/
+
+static int ftl_checkpoint(FAR struct ftl_struct_s *dev)
+{
+  struct ftl_ckptblock_s entry;
+  struct ftl_ckptio_s io;
+  FAR struct ftl_commit_s *commit;
+  uint32_t seq;
+  uint16_t i;
+  int ret;
+
+  /* The chain must not eat into the blocks kept for garbage collection */
+
+  ret = ftl_reserve(dev, FTL_GCRESERVE + dev->ckptblocks - 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Blocks older than the checkpoint are never appended to */
+
+  ret = ftl_closeblock(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The blocks of the chain are opened as the pages are written */
+
+  seq       = dev->seq;
+  io.page   = 0;
+  io.offset = 0;
+  io.crc    = 0;
+
+  ret = ftl_ckptput(dev, &io, dev->map, dev->nsectors * sizeof(uint32_t));
+  for (i = 0; ret >= 0 && i < dev->geo.neraseblocks; i++)
+    {
+      entry.erasecount = dev->eblocks[i].erasecount;
+      entry.lastsum    = dev->eblocks[i].lastsum;
+      entry.reserved   = 0;
+
+      ret = ftl_ckptput(dev, &io, &entry, sizeof(struct ftl_ckptblock_s));
+    }
+
+  if (ret >= 0)
+    {
+      ret = ftl_ckptput(dev, &io, NULL, 0);
+    }
+
+  if (ret >= 0)
+    {
+      ret = ftl_ckptnext(dev, &io, true);
+    }
+
+  if (ret < 0)
+    {
+      goto errout_with_chain;
+    }
+
+  DEBUGASSERT(dev->eblocks[FTL_BLOCK(dev, io.page)].seq ==
+              seq + dev->ckptblocks - 1);
+
+  memset(dev->pgbuf, CONFIG_FTL_LOG_ERASEDSTATE, dev->geo.blocksize);
+  commit        = (FAR struct ftl_commit_s *)dev->pgbuf;
+  commit->magic = FTL_MAGIC_COMMIT;
+  commit->seq   = seq;
+  commit->crc   = io.crc;
+
+  ret = ftl_writepages(dev, io.page, 1, dev->pgbuf);
+  if (ret < 0)
+    {
+      goto errout_with_chain;
+    }
+
+  /* The new checkpoint is committed.  The old one may be erased now. */
+
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      if (dev->eblocks[i].state == FTL_BLOCK_CKPT &&
+          dev->eblocks[i].seq < seq)
+        {
+          dev->eblocks[i].state = FTL_BLOCK_DIRTY;
+        }
+    }
+
+  dev->ckptseq   = seq;
+  dev->nclosed   = 0;
+  dev->discarded = false;
+  dev->stats.ncheckpoints++;
+  return OK;
+
+errout_with_chain:
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      if (dev->eblocks[i].state == FTL_BLOCK_CKPT &&
+          dev->eblocks[i].seq >= seq)
+        {
+          dev->eblocks[i].state = FTL_BLOCK_DIRTY;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_victim
+ *
+ * Description:
+ *   Select the erase block to collect:  Normally the block with the fewest
+ *   live pages.  If 'wearlevel' is true and the erase counts have drifted
+ *   too far apart, the least worn block is selected instead so that the
+ *   static data that it holds moves to a more worn block.
+ *
+ ****************************************************************************/
+
+static uint16_t ftl_victim(FAR struct ftl_struct_s *dev, bool wearlevel)
+{
+  FAR struct ftl_eblock_s *eblock;
+  uint16_t victim = FTL_NOBLOCK;
+#ifdef CONFIG_FTL_LOG_BGGC
+  uint16_t coldest = FTL_NOBLOCK;
+  uint32_t maxerase = 0;
+#endif
+  uint16_t i;
+
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      eblock = &dev->eblocks[i];
+#ifdef CONFIG_FTL_LOG_BGGC
+      if (eblock->erasecount > maxerase)
+        {
+          maxerase = eblock->erasecount;
+        }
+#endif
+
+      if (eblock->state != FTL_BLOCK_DATA && eblock->state != FTL_BLOCK_DIRTY)
+        {
+          continue;
+        }
+
+      if (victim == FTL_NOBLOCK ||
+          eblock->nlive < dev->eblocks[victim].nlive ||
+          (eblock->nlive == dev->eblocks[victim].nlive &&
+           eblock->erasecount < dev->eblocks[victim].erasecount))
+        {
+          victim = i;
+        }
+
+#ifdef CONFIG_FTL_LOG_BGGC
+      if (coldest == FTL_NOBLOCK ||
+          eblock->erasecount < dev->eblocks[coldest].erasecount)
+        {
+          coldest = i;
+        }
+#endif
+    }
+
+#ifdef CONFIG_FTL_LOG_BGGC
+  if (wearlevel && coldest != FTL_NOBLOCK &&
+      maxerase - dev->eblocks[coldest].erasecount >
+      CONFIG_FTL_LOG_WLTHRESHOLD)
+    {
+      return coldest;
+    }
+#endif
+
+  return victim;
+}
+
+/****************************************************************************
+ * Name: ftl_relocate
+ *
+ * Description:
+ *   Copy the live pages of an erase block to the open block.  The summaries
+ *   of the block are visited from the last one backward:  Each one records
+ *   the first data page of its segment and the previous summary lies just
+ *   before that page.
+ *
+ ****************************************************************************/
+
+static int ftl_relocate(FAR struct ftl_struct_s *dev, uint16_t block)
+{
+  FAR struct ftl_summary_s *sum;
+  uint32_t sector;
+  uint32_t page;
+  uint32_t crc;
+  uint16_t sumpage;
+  uint16_t first;
+  uint16_t npages;
+  uint16_t i;
+  int ret;
+
+  sumpage = dev->eblocks[block].lastsum;
+  while (sumpage > 0 && dev->eblocks[block].nlive > 0)
+    {
+      ret = ftl_readpages(dev, FTL_PAGE(dev, block, sumpage), 1, dev->pgbuf);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      sum    = (FAR struct ftl_summary_s *)dev->pgbuf;
+      first  = sum->first;
+      npages = sum->npages;
+      crc    = sum->crc;
+      sum->crc = 0;
+
+      if (sum->magic != FTL_MAGIC_SUMMARY ||
+          sum->seq != dev->eblocks[block].seq ||
+          first < 1 || first + npages != sumpage ||
+          npages > FTL_NENTRIES(dev) ||
+          crc != crc32(dev->pgbuf, sizeof(struct ftl_summary_s) +
+                       npages * sizeof(uint32_t)))
+        {
+          ferr("ERROR: Bad summary at block=%d page=%d\n", block, sumpage);
+          return -EIO;
+        }
+
+      memcpy(dev->gcsum, sum + 1, npages * sizeof(uint32_t));
+
+      for (i = 0; i < npages; i++)
+        {
+          sector = dev->gcsum[i];
+          page   = FTL_PAGE(dev, block, first + i);
+
+          if (sector < dev->nsectors && dev->map[sector] == page)
+            {
+              ret = ftl_readpages(dev, page, 1, dev->gcbuf);
+              if (ret >= 0)
+                {
+                  ret = ftl_append(dev, sector, dev->gcbuf, 1, false);
+                }
+
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              dev->stats.nrelocated++;
+            }
+        }
+
+      sumpage = first - 1;
+    }
+
+  return dev->eblocks[block].nlive == 0 ? OK : -EIO;
+}
+
+/****************************************************************************
+ * Name: ftl_collect
+ *
+ * Description: Reclaim one or more erase blocks
+ *
+ ****************************************************************************/
+
+static int ftl_collect(FAR struct ftl_struct_s *dev, bool wearlevel)
+{
+  FAR struct ftl_eblock_s *eblock;
+  uint16_t nemptied = 0;
+  uint16_t victim;
+  uint16_t room;
+  uint16_t i;
+  int ret;
+
+  victim = ftl_victim(dev, wearlevel);
+  if (victim == FTL_NOBLOCK)
+    {
+      return -ENOSPC;
+    }
+
+  /* Every collection must write a summary before the victims are erased.
+   * Keep collecting while the live pages of the next victim fit into the
+   * open segment so that one summary serves several victims and the
+   * relocated pages are packed densely.  While too few blocks would be
+   * free, the next victim may also spill over into a new block.
+   */
+
+  for (; ; )
+    {
+      eblock = &dev->eblocks[victim];
+      if (eblock->nlive > 0)
+        {
+          ret = ftl_relocate(dev, victim);
+          if (ret < 0)
+            {
+              goto errout;
+            }
+        }
+
+      eblock->state = FTL_BLOCK_EMPTIED;
+      nemptied++;
+
+      if (dev->curblk == FTL_NOBLOCK || dev->curpage == dev->segfirst)
+        {
+          break;
+        }
+
+      victim = ftl_victim(dev, false);
+      if (victim == FTL_NOBLOCK)
+        {
+          break;
+        }
+
+      room = 0;
+      if (dev->curpage < dev->blkper - 1)
+        {
+          room = dev->blkper - 1 - dev->curpage;
+          if (room > dev->maxseg - (dev->curpage - dev->segfirst))
+            {
+              room = dev->maxseg - (dev->curpage - dev->segfirst);
+            }
+        }
+
+      if (dev->eblocks[victim].nlive > room &&
+          (dev->nfree < 2 || dev->nfree + nemptied > FTL_GCRESERVE + 1))
+        {
+          break;
+        }
+    }
+
+  /* The pages that replaced those of the victims (moved here or written by
+   * the host) must be recoverable before the victims are erased.
+   */
+
+  ret = ftl_closesegment(dev);
+
+errout:
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      if (dev->eblocks[i].state != FTL_BLOCK_EMPTIED)
+        {
+          continue;
+        }
+
+      if (ret >= 0)
+        {
+          ret = ftl_erase(dev, i);
+        }
+
+      /* Blocks that could not be erased are collected again later */
+
+      if (ret < 0)
+        {
+          dev->eblocks[i].state = FTL_BLOCK_DATA;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_reserve
+ *
+ * Description:
+ *   Collect garbage in the foreground until more than 'nblocks' erase
+ *   blocks are free.  Host writes keep FTL_GCRESERVE blocks back for
+ *   garbage collection and checkpoints.
+ *
+ ****************************************************************************/
+
+static int ftl_reserve(FAR struct ftl_struct_s *dev, uint16_t nblocks)
+{
+  int limit = 2 * dev->geo.neraseblocks;
+  int ret;
+
+  while (dev->nfree <= nblocks)
+    {
+      if (limit-- <= 0)
+        {
+          return -ENOSPC;
+        }
+
+      ret = ftl_collect(dev, false);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_append
+ *
+ * Description:
+ *   Append consecutive logical sectors to the log, opening new erase blocks
+ *   as needed.  'host' is false when garbage collection moves pages:  It may
+ *   then use the reserved blocks but must not collect garbage itself.
+ *
+ ****************************************************************************/
+
+static int ftl_append(FAR struct ftl_struct_s *dev, uint32_t sector,
+                      FAR const uint8_t *buffer, size_t nsectors, bool host)
+{
+  uint32_t page;
+  size_t room;
+  size_t i;
+  int block;
+  int ret;
+
+  while (nsectors > 0)
+    {
+      if (host)
+        {
+          if (dev->curblk == FTL_NOBLOCK &&
+              dev->nclosed >= CONFIG_FTL_LOG_CKPTINTERVAL)
+            {
+              ret = ftl_checkpoint(dev);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+
+          /* The reserve may also be short while a block is open, e.g. when
+           * the block that was open at a power loss has been reopened.
+           */
+
+          ret = ftl_reserve(dev, FTL_GCRESERVE);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      /* Garbage collection may have opened a block already */
+
+      if (dev->curblk == FTL_NOBLOCK)
+        {
+          block = ftl_openblock(dev, FTL_TYPE_DATA);
+          if (block < 0)
+            {
+              return block;
+            }
+
+          dev->curblk   = block;
+          dev->curpage  = 1;
+          dev->segfirst = 1;
+        }
+
+      /* The last page of the block is kept for the final summary.  A flush
+       * may have used it already.
+       */
+
+      room = 0;
+      if (dev->curpage < dev->blkper - 1)
+        {
+          room = dev->blkper - 1 - dev->curpage;
+          if (room > (size_t)(dev->maxseg - (dev->curpage - dev->segfirst)))
+            {
+              room = dev->maxseg - (dev->curpage - dev->segfirst);
+            }
+        }
+
+      if (room == 0)
+        {
+          if (dev->curpage < dev->blkper - 1)
+            {
+              ret = ftl_closesegment(dev);
+            }
+          else
+            {
+              ret = ftl_closeblock(dev);
+            }
+
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          continue;
+        }
+
+      if (room > nsectors)
+        {
+          room = nsectors;
+        }
+
+      page = FTL_PAGE(dev, dev->curblk, dev->curpage);
+      ret  = ftl_writepages(dev, page, room, buffer);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      for (i = 0; i < room; i++)
+        {
+          dev->segment[dev->curpage - dev->segfirst] = sector;
+          ftl_remap(dev, sector, page + i);
+          dev->curpage++;
+          sector++;
+        }
+
+      buffer   += room * dev->geo.blocksize;
+      nsectors -= room;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_gcworker
+ *
+ * Description:
+ *   Collect garbage on the work queue so that writes seldom have to wait
+ *   for it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOG_BGGC
+static void ftl_gcworker(FAR void *arg)
+{
+  FAR struct ftl_struct_s *dev = (FAR struct ftl_struct_s *)arg;
+  int limit = dev->geo.neraseblocks;
+  int ret;
+
+  /* Collect one block at a time so that I/O is not locked out for long */
+
+  while (limit-- > 0)
+    {
+      ret = nxsem_wait(&dev->exclsem);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      if (dev->unlinked || dev->nfree > CONFIG_FTL_LOG_GCTHRESHOLD)
+        {
+          nxsem_post(&dev->exclsem);
+          break;
+        }
+
+      /* Moving a block for wear leveling may take a whole free block */
+
+      ret = ftl_collect(dev, dev->nfree > FTL_GCRESERVE + 1);
+      nxsem_post(&dev->exclsem);
+
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+}
+
+static void ftl_gcschedule(FAR struct ftl_struct_s *dev)
+{
+  if (dev->nfree <= CONFIG_FTL_LOG_GCTHRESHOLD &&
+      work_available(&dev->work))
+    {
+      work_queue(FTL_WORK, &dev->work, ftl_gcworker, dev, 0);
+    }
+}
+#else
+#  define ftl_gcschedule(dev)
+#endif
+
+/****************************************************************************
+ * Name: ftl_loadckpt
+ *
+ * Description:
+ *   Verify the checkpoint chain that ends with an erase block and, if it is
+ *   intact, load the sector map and erase block information from it.
+ *
+ ****************************************************************************/
+
+static int ftl_loadckpt(FAR struct ftl_struct_s *dev, uint16_t last)
+{
+  FAR struct ftl_eblock_s *eblock;
+  FAR struct ftl_commit_s *commit;
+  struct ftl_ckptblock_s entry;
+  struct ftl_ckptio_s io;
+  uint32_t seq;
+  uint32_t crc;
+  uint32_t i;
+  uint16_t first;
+  int ret;
+
+  if (dev->eblocks[last].seq < dev->ckptblocks)
+    {
+      return -EINVAL;
+    }
+
+  seq   = dev->eblocks[last].seq - (dev->ckptblocks - 1);
+  first = ftl_ckptfind(dev, seq);
+  if (first == FTL_NOBLOCK)
+    {
+      return -EINVAL;
+    }
+
+  /* Compute the CRC of the checkpoint pages and check the commit page that
+   * follows them first.
+   */
+
+  io.page   = FTL_PAGE(dev, first, 1);
+  io.offset = 0;
+  io.crc    = 0;
+
+  ret = ftl_ckptget(dev, &io, NULL,
+                    (size_t)dev->ckptpages * dev->geo.blocksize);
+  if (ret >= 0)
+    {
+      ret = ftl_ckptnext(dev, &io, false);
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (FTL_BLOCK(dev, io.page) != last)
+    {
+      return -EINVAL;
+    }
+
+  crc = io.crc;
+  ret = ftl_readpages(dev, io.page, 1, dev->pgbuf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  commit = (FAR struct ftl_commit_s *)dev->pgbuf;
+  if (commit->magic != FTL_MAGIC_COMMIT || commit->seq != seq ||
+      commit->crc != crc)
+    {
+      return -EINVAL;
+    }
+
+  /* Then load it */
+
+  io.page   = FTL_PAGE(dev, first, 1);
+  io.offset = 0;
+
+  ret = ftl_ckptget(dev, &io, dev->map, dev->nsectors * sizeof(uint32_t));
+  for (i = 0; ret >= 0 && i < dev->geo.neraseblocks; i++)
+    {
+      ret = ftl_ckptget(dev, &io, &entry, sizeof(struct ftl_ckptblock_s));
+      if (ret < 0)
+        {
+          break;
+        }
+
+      /* Blocks written before the checkpoint have not changed since.  The
+       * erase count of blocks without a valid header is only known from
+       * the checkpoint.
+       */
+
+      eblock = &dev->eblocks[i];
+      if (eblock->state == FTL_BLOCK_DATA && eblock->seq < seq)
+        {
+          eblock->lastsum = entry.lastsum;
+        }
+      else if (eblock->state == FTL_BLOCK_FREE ||
+               eblock->state == FTL_BLOCK_DIRTY)
+        {
+          eblock->erasecount = entry.erasecount;
+        }
+    }
+
+  if (ret >= 0)
+    {
+      dev->ckptseq = seq;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_scanblock
+ *
+ * Description:
+ *   Replay the segments of a data block written after the checkpoint.
+ *   Pages written after the last complete segment are lost.
+ *
+ ****************************************************************************/
+
+static int ftl_scanblock(FAR struct ftl_struct_s *dev, uint16_t block)
+{
+  FAR struct ftl_eblock_s *eblock = &dev->eblocks[block];
+  FAR struct ftl_summary_s *sum;
+  FAR uint32_t *entries;
+  uint16_t segfirst = 1;
+  uint16_t page;
+  uint16_t i;
+  uint32_t crc;
+  int ret;
+
+  for (page = 1; page < dev->blkper; page++)
+    {
+      ret = ftl_readpages(dev, FTL_PAGE(dev, block, page), 1, dev->pgbuf);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* Data pages (even blank ones) are simply skipped */
+
+      sum = (FAR struct ftl_summary_s *)dev->pgbuf;
+      if (sum->magic != FTL_MAGIC_SUMMARY || sum->seq != eblock->seq ||
+          sum->first != segfirst || sum->first + sum->npages != page ||
+          sum->npages > FTL_NENTRIES(dev))
+        {
+          continue;
+        }
+
+      crc      = sum->crc;
+      sum->crc = 0;
+      if (crc != crc32(dev->pgbuf, sizeof(struct ftl_summary_s) +
+                       sum->npages * sizeof(uint32_t)))
+        {
+          continue;
+        }
+
+      entries = (FAR uint32_t *)(sum + 1);
+      for (i = 0; i < sum->npages; i++)
+        {
+          if (entries[i] < dev->nsectors)
+            {
+              dev->map[entries[i]] = FTL_PAGE(dev, block, segfirst + i);
+            }
+        }
+
+      eblock->lastsum = page;
+      segfirst        = page + 1;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_reopen
+ *
+ * Description:
+ *   Continue to append to the newest data block after a power loss.  The
+ *   pages after its last summary may hold data that was never summarized
+ *   and a page whose programming was interrupted.  The first blank page
+ *   may have been programmed partially as well.  A summary that maps no
+ *   sectors is written after these pages and the rest of the block is
+ *   used again.
+ *
+ ****************************************************************************/
+
+static int ftl_reopen(FAR struct ftl_struct_s *dev, uint16_t block)
+{
+  FAR struct ftl_eblock_s *eblock = &dev->eblocks[block];
+  FAR struct ftl_summary_s *sum;
+  FAR uint32_t *entries;
+  uint16_t first = eblock->lastsum + 1;
+  uint16_t page;
+  uint16_t i;
+  int ret;
+
+  /* Find the first page of the blank end of the block */
+
+  for (page = dev->blkper; page > first; page--)
+    {
+      ret = ftl_readpages(dev, FTL_PAGE(dev, block, page - 1), 1,
+                          dev->pgbuf);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (!ftl_isblank(dev->pgbuf, dev->geo.blocksize))
+        {
+          break;
+        }
+    }
+
+  if (page > first)
+    {
+      /* The summary goes after the first blank page.  There must be room
+       * for a data page and the final summary after it.
+       */
+
+      page++;
+      if (page + 2 >= dev->blkper || page - first > FTL_NENTRIES(dev))
+        {
+          return OK;
+        }
+
+      memset(dev->pgbuf, CONFIG_FTL_LOG_ERASEDSTATE, dev->geo.blocksize);
+      sum         = (FAR struct ftl_summary_s *)dev->pgbuf;
+      sum->magic  = FTL_MAGIC_SUMMARY;
+      sum->seq    = eblock->seq;
+      sum->first  = first;
+      sum->npages = page - first;
+      sum->crc    = 0;
+
+      entries = (FAR uint32_t *)(sum + 1);
+      for (i = 0; i < sum->npages; i++)
+        {
+          entries[i] = FTL_UNMAPPED;
+        }
+
+      sum->crc = crc32(dev->pgbuf, sizeof(struct ftl_summary_s) +
+                       sum->npages * sizeof(uint32_t));
+
+      ret = ftl_writepages(dev, FTL_PAGE(dev, block, page), 1, dev->pgbuf);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      eblock->lastsum = page;
+      first = page + 1;
+    }
+
+  if (first + 1 >= dev->blkper)
+    {
+      return OK;
+    }
+
+  eblock->state = FTL_BLOCK_OPEN;
+  dev->curblk   = block;
+  dev->curpage  = first;
+  dev->segfirst = first;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_mount
+ *
+ * Description:
+ *   Rebuild the in-memory state from the media:  Read the header of every
+ *   erase block, load the newest intact checkpoint and then replay the data
+ *   blocks written after it in sequence order.  Blank or foreign media
+ *   needs no formatting:  Unrecognized blocks are simply erased when they
+ *   are needed.
+ *
+ ****************************************************************************/
+
+static int ftl_mount(FAR struct ftl_struct_s *dev)
+{
+  FAR struct ftl_header_s *hdr;
+  FAR struct ftl_eblock_s *eblock;
+  uint64_t totalerase = 0;
+  uint32_t nknown = 0;
+  uint32_t lastseq;
+  uint32_t page;
+  uint32_t i;
+  uint16_t newest = FTL_NOBLOCK;
+  uint16_t block;
+  uint16_t j;
+  int ret;
+
+  dev->seq     = 1;
+  dev->ckptseq = 0;
+  dev->curblk  = FTL_NOBLOCK;
+  dev->nfree   = 0;
+
+  for (i = 0; i < dev->nsectors; i++)
+    {
+      dev->map[i] = FTL_UNMAPPED;
+    }
+
+  /* Read the header of each erase block */
+
+  for (j = 0; j < dev->geo.neraseblocks; j++)
+    {
+      eblock = &dev->eblocks[j];
+      memset(eblock, 0, sizeof(struct ftl_eblock_s));
+
+      ret = ftl_readpages(dev, FTL_PAGE(dev, j, 0), 1, dev->pgbuf);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      hdr = (FAR struct ftl_header_s *)dev->pgbuf;
+      if (hdr->magic == FTL_MAGIC_HEADER &&
+          hdr->crc == crc32(dev->pgbuf, offsetof(struct ftl_header_s, crc)) &&
+          (hdr->type == FTL_TYPE_DATA || hdr->type == FTL_TYPE_CKPT))
+        {
+          eblock->seq        = hdr->seq;
+          eblock->erasecount = hdr->erasecount;
+          eblock->state      = hdr->type == FTL_TYPE_DATA ?
+                               FTL_BLOCK_DATA : FTL_BLOCK_CKPT;
+
+          if (hdr->seq >= dev->seq)
+            {
+              dev->seq = hdr->seq + 1;
+            }
+
+          totalerase += hdr->erasecount;
+          nknown++;
+        }
+      else if (ftl_isblank(dev->pgbuf, dev->geo.blocksize))
+        {
+          eblock->state = FTL_BLOCK_FREE;
+          dev->nfree++;
+        }
+      else
+        {
+          eblock->state = FTL_BLOCK_DIRTY;
+        }
+    }
+
+  /* Blocks without a header get the average erase count unless the
+   * checkpoint knows better.
+   */
+
+  for (j = 0; nknown > 0 && j < dev->geo.neraseblocks; j++)
+    {
+      eblock = &dev->eblocks[j];
+      if (eblock->state == FTL_BLOCK_FREE || eblock->state == FTL_BLOCK_DIRTY)
+        {
+          eblock->erasecount = (uint32_t)(totalerase / nknown);
+        }
+    }
+
+  /* Load the newest intact checkpoint.  Older ones are garbage.  The
+   * newest checkpoint block ends the newest chain unless writing that
+   * chain was interrupted.
+   */
+
+  for (; ; )
+    {
+      block = FTL_NOBLOCK;
+      for (j = 0; j < dev->geo.neraseblocks; j++)
+        {
+          if (dev->eblocks[j].state == FTL_BLOCK_CKPT &&
+              (block == FTL_NOBLOCK ||
+               dev->eblocks[j].seq > dev->eblocks[block].seq))
+            {
+              block = j;
+            }
+        }
+
+      if (block == FTL_NOBLOCK)
+        {
+          break;
+        }
+
+      ret = ftl_loadckpt(dev, block);
+      if (ret >= 0)
+        {
+          break;
+        }
+
+      finfo("Checkpoint in block %d is not usable: %d\n", block, ret);
+
+      for (i = 0; i < dev->nsectors; i++)
+        {
+          dev->map[i] = FTL_UNMAPPED;
+        }
+
+      dev->eblocks[block].state = FTL_BLOCK_DIRTY;
+    }
+
+  for (j = 0; j < dev->geo.neraseblocks; j++)
+    {
+      if (dev->eblocks[j].state == FTL_BLOCK_CKPT &&
+          (dev->ckptseq == 0 || dev->eblocks[j].seq < dev->ckptseq ||
+           dev->eblocks[j].seq >= dev->ckptseq + dev->ckptblocks))
+        {
+          dev->eblocks[j].state = FTL_BLOCK_DIRTY;
+        }
+    }
+
+  /* The checkpoint may still map sectors that were discarded afterwards to
+   * blocks that have been erased and reused since.  Only blocks older than
+   * the checkpoint can hold the pages that it maps.
+   */
+
+  for (i = 0; i < dev->nsectors; i++)
+    {
+      page = dev->map[i];
+      if (page != FTL_UNMAPPED)
+        {
+          block = FTL_BLOCK(dev, page);
+          if (block >= dev->geo.neraseblocks ||
+              dev->eblocks[block].seq > dev->ckptseq)
+            {
+              dev->map[i] = FTL_UNMAPPED;
+            }
+        }
+    }
+
+  /* Replay the data blocks written after the checkpoint, oldest first */
+
+  lastseq = dev->ckptseq;
+  for (; ; )
+    {
+      block = FTL_NOBLOCK;
+      for (j = 0; j < dev->geo.neraseblocks; j++)
+        {
+          eblock = &dev->eblocks[j];
+          if (eblock->state == FTL_BLOCK_DATA && eblock->seq > lastseq &&
+              (block == FTL_NOBLOCK || eblock->seq < dev->eblocks[block].seq))
+            {
+              block = j;
+            }
+        }
+
+      if (block == FTL_NOBLOCK)
+        {
+          break;
+        }
+
+      ret = ftl_scanblock(dev, block);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      lastseq = dev->eblocks[block].seq;
+      newest  = block;
+    }
+
+  /* Drop mappings that do not point at a recovered data page and count
+   * the live pages of each block.
+   */
+
+  for (i = 0; i < dev->nsectors; i++)
+    {
+      page = dev->map[i];
+      if (page == FTL_UNMAPPED)
+        {
+          continue;
+        }
+
+      block  = FTL_BLOCK(dev, page);
+      eblock = block < dev->geo.neraseblocks ? &dev->eblocks[block] : NULL;
+
+      if (eblock == NULL || eblock->state != FTL_BLOCK_DATA ||
+          page % dev->blkper < 1 || page % dev->blkper >= eblock->lastsum)
+        {
+          dev->map[i] = FTL_UNMAPPED;
+        }
+      else
+        {
+          eblock->nlive++;
+        }
+    }
+
+  /* The block that was open when power was lost still has free pages */
+
+  if (newest != FTL_NOBLOCK)
+    {
+      ret = ftl_reopen(dev, newest);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  finfo("Mounted: %u free blocks, checkpoint %u, next sequence %u\n",
+        dev->nfree, dev->ckptseq, dev->seq);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_sync
+ *
+ * Description:
+ *   Make everything written so far recoverable.  A checkpoint is written
+ *   as well if 'checkpoint' is true and anything changed since the last
+ *   one.
+ *
+ ****************************************************************************/
+
+static int ftl_sync(FAR struct ftl_struct_s *dev, bool checkpoint)
+{
+  int ret;
+
+  ret = ftl_closesegment(dev);
+  if (ret >= 0 && checkpoint &&
+      (dev->nclosed > 0 || dev->discarded || dev->curblk != FTL_NOBLOCK))
+    {
+      ret = ftl_checkpoint(dev);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_ckptsize
+ *
+ * Description:
+ *   Compute the number of pages that the map and the erase block table
+ *   take in a checkpoint and the number of erase blocks that hold them and
+ *   the commit page.
+ *
+ ****************************************************************************/
+
+static void ftl_ckptsize(FAR struct ftl_struct_s *dev)
+{
+  uint64_t nbytes;
+
+  nbytes          = (uint64_t)dev->nsectors * sizeof(uint32_t) +
+                    dev->geo.neraseblocks * sizeof(struct ftl_ckptblock_s);
+  dev->ckptpages  = (nbytes + dev->geo.blocksize - 1) / dev->geo.blocksize;
+  dev->ckptblocks = (dev->ckptpages + dev->blkper - 1) / (dev->blkper - 1);
+}
+
+/****************************************************************************
+ * Name: ftl_free
+ *
+ * Description: Release all resources held by the driver
+ *
+ ****************************************************************************/
+
+static void ftl_free(FAR struct ftl_struct_s *dev)
+{
+#ifdef CONFIG_FTL_LOG_BGGC
+  work_cancel(FTL_WORK, &dev->work);
+#endif
+
+  nxsem_destroy(&dev->exclsem);
+
+  if (dev->eblocks)
+    {
+      kmm_free(dev->eblocks);
+    }
+
+  if (dev->map)
+    {
+      kmm_free(dev->map);
+    }
+
+  if (dev->segment)
+    {
+      kmm_free(dev->segment);
+    }
+
+  if (dev->gcsum)
+    {
+      kmm_free(dev->gcsum);
+    }
+
+  if (dev->pgbuf)
+    {
+      kmm_free(dev->pgbuf);
+    }
+
+  if (dev->gcbuf)
+    {
+      kmm_free(dev->gcbuf);
+    }
+
+  kmm_free(dev);
+}
+
+/****************************************************************************
+ * Name: ftl_open
+ *
+ * Description: Open the block device
+ *
+ ****************************************************************************/
+
+static int ftl_open(FAR struct inode *inode)
+{
+  FAR struct ftl_struct_s *dev;
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct ftl_struct_s *)inode->i_private;
+
+  nxsem_wait_uninterruptible(&dev->exclsem);
+  dev->refs++;
+  nxsem_post(&dev->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_close
+ *
+ * Description: close the block device
+ *
+ ****************************************************************************/
+
+static int ftl_close(FAR struct inode *inode)
+{
+  FAR struct ftl_struct_s *dev;
+  int ret;
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct ftl_struct_s *)inode->i_private;
+
+  /* Checkpoint when the last user goes away so that the next mount is
+   * fast.
+   */
+
+  nxsem_wait_uninterruptible(&dev->exclsem);
+  ret = ftl_sync(dev, dev->refs == 1);
+  if (ret < 0)
+    {
+      ferr("ERROR: Sync failed: %d\n", ret);
+    }
+
+  if (--dev->refs == 0 && dev->unlinked)
+    {
+      nxsem_post(&dev->exclsem);
+      ftl_free(dev);
+      return OK;
+    }
+
+  nxsem_post(&dev->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_read
+ *
+ * Description:
+ *   Read the specified number of sectors.  Sectors that map to consecutive
+ *   pages are read with a single MTD transfer.  Sectors that were never
+ *   written (or were discarded) read as erased flash.
+ *
+ ****************************************************************************/
+
+static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
+                        size_t start_sector, unsigned int nsectors)
+{
+  FAR struct ftl_struct_s *dev;
+  uint32_t page;
+  size_t nrun;
+  size_t i;
+  int ret = OK;
+
+  finfo("sector: %d nsectors: %d\n", start_sector, nsectors);
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct ftl_struct_s *)inode->i_private;
+
+  if (start_sector >= dev->nsectors ||
+      nsectors > dev->nsectors - start_sector)
+    {
+      return -EINVAL;
+    }
+
+  nxsem_wait_uninterruptible(&dev->exclsem);
+
+  for (i = 0; i < nsectors; i += nrun)
+    {
+      page = dev->map[start_sector + i];
+      nrun = 1;
+
+      if (page == FTL_UNMAPPED)
+        {
+          memset(buffer + i * dev->geo.blocksize,
+                 CONFIG_FTL_LOG_ERASEDSTATE, dev->geo.blocksize);
+          continue;
+        }
+
+      while (i + nrun < nsectors &&
+             dev->map[start_sector + i + nrun] == page + nrun)
+        {
+          nrun++;
+        }
+
+      ret = ftl_readpages(dev, page, nrun, buffer + i * dev->geo.blocksize);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  nxsem_post(&dev->exclsem);
+  return ret < 0 ? ret : nsectors;
+}
+
+/****************************************************************************
+ * Name: ftl_write
+ *
+ * Description:
+ *   Write the specified number of sectors.  The data is appended to the
+ *   log; the pages that held the old content become garbage.
+ *
+ ****************************************************************************/
+
+static ssize_t ftl_write(FAR struct inode *inode, const unsigned char *buffer,
+                         size_t start_sector, unsigned int nsectors)
+{
+  FAR struct ftl_struct_s *dev;
+  int ret;
+
+  finfo("sector: %d nsectors: %d\n", start_sector, nsectors);
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct ftl_struct_s *)inode->i_private;
+
+  if (start_sector >= dev->nsectors ||
+      nsectors > dev->nsectors - start_sector)
+    {
+      return -EINVAL;
+    }
+
+  nxsem_wait_uninterruptible(&dev->exclsem);
+
+  ret = ftl_append(dev, start_sector, buffer, nsectors, true);
+  if (ret >= 0)
+    {
+      dev->stats.nwritten += nsectors;
+    }
+
+  ftl_gcschedule(dev);
+  nxsem_post(&dev->exclsem);
+  return ret < 0 ? ret : nsectors;
+}
+
+/****************************************************************************
+ * Name: ftl_geometry
+ *
+ * Description: Return device geometry
+ *
+ ****************************************************************************/
+
+static int ftl_geometry(FAR struct inode *inode, struct geometry *geometry)
+{
+  struct ftl_struct_s *dev;
+
+  finfo("Entry\n");
+
+  DEBUGASSERT(inode);
+  if (geometry)
+    {
+      dev = (struct ftl_struct_s *)inode->i_private;
+      geometry->geo_available     = true;
+      geometry->geo_mediachanged  = false;
+      geometry->geo_writeenabled  = true;
+      geometry->geo_nsectors      = dev->nsectors;
+      geometry->geo_sectorsize    = dev->geo.blocksize;
+
+      finfo("nsectors: %d sectorsize: %d\n",
+            geometry->geo_nsectors, geometry->geo_sectorsize);
+
+      return OK;
+    }
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Name: ftl_ioctl
+ *
+ * Description: Handle block driver ioctl commands
+ *
+ ****************************************************************************/
+
+static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+  FAR struct ftl_struct_s *dev;
+  FAR struct ftl_log_stats_s *stats;
+  FAR struct discard_s *discard;
+  size_t i;
+  uint16_t j;
+  int ret;
+
+  finfo("Entry\n");
+  DEBUGASSERT(inode && inode->i_private);
+
+  dev = (struct ftl_struct_s *)inode->i_private;
+
+  switch (cmd)
+    {
+      case BIOC_FLUSH:
+        nxsem_wait_uninterruptible(&dev->exclsem);
+        ret = ftl_sync(dev, false);
+        nxsem_post(&dev->exclsem);
+        return ret;
+
+      case BIOC_DISCARD:
+        discard = (FAR struct discard_s *)((uintptr_t)arg);
+        if (discard == NULL || discard->startsector >= dev->nsectors ||
+            discard->nsectors > dev->nsectors - discard->startsector)
+          {
+            return -EINVAL;
+          }
+
+        /* The discarded sectors are recorded by the next checkpoint only.
+         * Until then, a power loss may bring their old content back.
+         */
+
+        nxsem_wait_uninterruptible(&dev->exclsem);
+        for (i = 0; i < discard->nsectors; i++)
+          {
+            if (dev->map[discard->startsector + i] != FTL_UNMAPPED)
+              {
+                ftl_remap(dev, discard->startsector + i, FTL_UNMAPPED);
+                dev->stats.ndiscarded++;
+                dev->discarded = true;
+              }
+          }
+
+        ftl_gcschedule(dev);
+        nxsem_post(&dev->exclsem);
+        return OK;
+
+      case BIOC_GETPROCFSD:
+        stats = (FAR struct ftl_log_stats_s *)((uintptr_t)arg);
+        if (stats == NULL)
+          {
+            return -EINVAL;
+          }
+
+        nxsem_wait_uninterruptible(&dev->exclsem);
+        dev->stats.nsectors = dev->nsectors;
+        dev->stats.nfree    = dev->nfree;
+        dev->stats.minerase = UINT32_MAX;
+        dev->stats.maxerase = 0;
+
+        for (j = 0; j < dev->geo.neraseblocks; j++)
+          {
+            if (dev->eblocks[j].erasecount < dev->stats.minerase)
+              {
+                dev->stats.minerase = dev->eblocks[j].erasecount;
+              }
+
+            if (dev->eblocks[j].erasecount > dev->stats.maxerase)
+              {
+                dev->stats.maxerase = dev->eblocks[j].erasecount;
+              }
+          }
+
+        memcpy(stats, &dev->stats, sizeof(struct ftl_log_stats_s));
+        nxsem_post(&dev->exclsem);
+        return OK;
+
+      case BIOC_XIPBASE:
+
+        /* The sectors are not at fixed locations on the media */
+
+        return -ENOTTY;
+
+      default:
+        break;
+    }
+
+  /* Other possible MTD driver ioctl commands are passed through to the MTD
+   * driver (unchanged).
+   */
+
+  ret = MTD_IOCTL(dev->mtd, cmd, arg);
+  if (ret < 0)
+    {
+      ferr("ERROR: MTD ioctl(%04x) failed: %d\n", cmd, ret);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_unlink
+ *
+ * Description: Unlink the device
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int ftl_unlink(FAR struct inode *inode)
+{
+  FAR struct ftl_struct_s *dev;
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct ftl_struct_s *)inode->i_private;
+
+  nxsem_wait_uninterruptible(&dev->exclsem);
+  dev->unlinked = true;
+  if (dev->refs == 0)
+    {
+      nxsem_post(&dev->exclsem);
+      ftl_free(dev);
+      return OK;
+    }
+
+  nxsem_post(&dev->exclsem);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ftl_initialize_by_path
+ *
+ * Description:
+ *   Initialize to provide a log-structured block driver wrapper around an
+ *   MTD interface
+ *
+ * Input Parameters:
+ *   path - The block device path.
+ *   mtd  - The MTD device that supports the FLASH interface.
+ *
+ ****************************************************************************/
+
+int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
+{
+  FAR struct ftl_struct_s *dev;
+  uint32_t perblock;
+  uint32_t nblocks;
+  uint32_t usable;
+  uint32_t nseg;
+  int ret;
+
+  /* Sanity check */
+
+  if (path == NULL || mtd == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* Allocate a FTL device structure */
+
+  dev = (FAR struct ftl_struct_s *)kmm_zalloc(sizeof(struct ftl_struct_s));
+  if (dev == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  dev->mtd = mtd;
+  nxsem_init(&dev->exclsem, 0, 1);
+
+  /* Get the device geometry. (casting to uintptr_t first eliminates
+   * complaints on some architectures where the sizeof long is different
+   * from the size of a pointer).
+   */
+
+  ret = MTD_IOCTL(mtd, MTDIOC_GEOMETRY,
+                  (unsigned long)((uintptr_t)&dev->geo));
+  if (ret < 0)
+    {
+      ferr("ERROR: MTD ioctl(MTDIOC_GEOMETRY) failed: %d\n", ret);
+      goto errout;
+    }
+
+  /* Get the number of R/W blocks per erase block.  A page must at least
+   * hold the summary of a short segment and an erase block must hold the
+   * header and two segments with their summaries.
+   */
+
+  if (dev->geo.blocksize < sizeof(struct ftl_summary_s) +
+                           4 * sizeof(uint32_t) ||
+      dev->geo.erasesize / dev->geo.blocksize < 5 ||
+      dev->geo.erasesize / dev->geo.blocksize > UINT16_MAX ||
+      dev->geo.neraseblocks <= CONFIG_FTL_LOG_NRESERVED ||
+      dev->geo.neraseblocks >= FTL_NOBLOCK)
+    {
+      ferr("ERROR: Unsupported geometry\n");
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  dev->blkper = dev->geo.erasesize / dev->geo.blocksize;
+  DEBUGASSERT(dev->blkper * dev->geo.blocksize == dev->geo.erasesize);
+
+  /* Each segment is closed by a summary page and garbage collection may
+   * have to close one more segment per block.  The exported capacity
+   * leaves CONFIG_FTL_LOG_NRESERVED erase blocks for the open block, the
+   * checkpoint and garbage collection.  A summary must be able to cover a
+   * whole segment, its interrupted summary and one more page when a block
+   * is reopened (see ftl_reopen()).  With 512-byte pages and 4 KiB erase
+   * blocks, for example, only 5 of every 8 pages hold sectors.
+   */
+
+  dev->maxseg = FTL_NENTRIES(dev) - 2;
+  usable      = dev->blkper - 1;
+  if (dev->maxseg > usable - 1)
+    {
+      dev->maxseg = usable - 1;
+    }
+
+  nseg     = (usable + dev->maxseg) / (dev->maxseg + 1);
+  perblock = usable - nseg - 1;
+
+  /* A checkpoint that does not fit into one erase block spans a chain of
+   * them.  The old and the new chain coexist until the new one has been
+   * committed, so each additional block of the chain takes two more erase
+   * blocks from the exported capacity.  The chain of the map that is
+   * finally exported is never longer than the one that was reserved.
+   */
+
+  nblocks       = dev->geo.neraseblocks - CONFIG_FTL_LOG_NRESERVED;
+  dev->nsectors = nblocks * perblock;
+  ftl_ckptsize(dev);
+
+  if (nblocks <= 2 * (dev->ckptblocks - 1))
+    {
+      ferr("ERROR: No room for checkpoints\n");
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  nblocks      -= 2 * (dev->ckptblocks - 1);
+  dev->nsectors = nblocks * perblock;
+  ftl_ckptsize(dev);
+
+  dev->eblocks = (FAR struct ftl_eblock_s *)
+    kmm_malloc(dev->geo.neraseblocks * sizeof(struct ftl_eblock_s));
+  dev->map     = (FAR uint32_t *)kmm_malloc(dev->nsectors * sizeof(uint32_t));
+  dev->segment = (FAR uint32_t *)kmm_malloc(dev->maxseg * sizeof(uint32_t));
+  dev->gcsum   = (FAR uint32_t *)kmm_malloc(FTL_NENTRIES(dev) *
+                                            sizeof(uint32_t));
+  dev->pgbuf   = (FAR uint8_t *)kmm_malloc(dev->geo.blocksize);
+  dev->gcbuf   = (FAR uint8_t *)kmm_malloc(dev->geo.blocksize);
+
+  if (dev->eblocks == NULL || dev->map == NULL || dev->segment == NULL ||
+      dev->gcsum == NULL || dev->pgbuf == NULL || dev->gcbuf == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  /* Recover the sector map from the media */
+
+  ret = ftl_mount(dev);
+  if (ret < 0)
+    {
+      ferr("ERROR: ftl_mount failed: %d\n", ret);
+      goto errout;
+    }
+
+  /* Inode private data is a reference to the FTL device structure */
+
+  ret = register_blockdriver(path, &g_bops, 0, dev);
+  if (ret < 0)
+    {
+      ferr("ERROR: register_blockdriver failed: %d\n", -ret);
+      goto errout;
+    }
+
+  return OK;
+
+errout:
+  ftl_free(dev);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_initialize
+ *
+ * Description:
+ *   Initialize to provide a block driver wrapper around an MTD interface
+ *
+ * Input Parameters:
+ *   minor - The minor device number.  The MTD block device will be
+ *           registered as as /dev/mtdblockN where N is the minor number.
+ *   mtd   - The MTD device that supports the FLASH interface.
+ *
+ ****************************************************************************/
+
+int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
+{
+  char path[DEV_NAME_MAX];
+
+#ifdef CONFIG_DEBUG_FEATURES
+  /* Sanity check */
+
+  if (minor < 0 || minor > 255)
+    {
+      return -EINVAL;
+    }
+#endif
+
+  /* Do the real work by ftl_initialize_by_path */
+
+  snprintf(path, DEV_NAME_MAX, "/dev/mtdblock%d", minor);
+  return ftl_initialize_by_path(path, mtd);
+}
@@ -122,6 +122,12 @@
                                              * other for our use, such as format
                                              * sector, etc. */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+#define SMART_CKPT_MAGIC            0x54504b43  /* "CKPT" */
+#define SMART_CKPT_VALID            CONFIG_SMARTFS_ERASEDSTATE
+#define SMART_CKPT_STALE            ((uint8_t)~CONFIG_SMARTFS_ERASEDSTATE)
+#endif
+
 #if defined(CONFIG_MTD_SMART_READAHEAD) || (defined(CONFIG_DRVR_WRITABLE) && \
     defined(CONFIG_MTD_SMART_WRITEBUFFER))
 #  define SMART_HAVE_RWBUFFER 1
@@ -258,6 +264,12 @@ struct smart_struct_s
 #ifdef CONFIG_MTD_SMART_ENABLE_CRC
   FAR struct smart_allocsector_s  *allocsector; /* Pointer to first alloc sector */
 #endif
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  uint16_t              ckptblock;        /* First erase block of the checkpoints */
+  uint16_t              ckptnblocks;      /* Erase blocks per checkpoint copy */
+  uint32_t              ckptseq;          /* Sequence number of newest checkpoint */
+  bool                  ckptvalid;        /* Newest checkpoint matches the media */
+#endif
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
   FAR uint16_t         *sMap;             /* Virtual to physical sector map */
 #else
@@ -357,6 +369,27 @@ typedef uint32_t crc_t;
 #endif
 
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+/* The header of a checkpoint.  The sector map, followed by the release and
+ * free counts of the erase blocks exactly as they are kept in RAM, is saved
+ * in the pages after it.
+ */
+
+struct smart_ckpt_s
+{
+  uint32_t              magic;            /* SMART_CKPT_MAGIC */
+  uint32_t              seq;              /* Incremented with every checkpoint */
+  uint16_t              sectorsize;       /* Sector size the map was saved for */
+  uint16_t              totalsectors;     /* Total number of sectors */
+  uint16_t              neraseblocks;     /* Number of erase blocks */
+  uint16_t              freesectors;      /* Total number of free sectors */
+  uint16_t              releasesectors;   /* Total number of released sectors */
+  uint16_t              reserved;
+  uint32_t              crc;              /* CRC-32 of the above and the map */
+  uint8_t               stale;            /* SMART_CKPT_STALE after a change */
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -391,6 +424,11 @@ static int smart_relocate_static_data(FAR struct smart_struct_s *dev, uint16_t b
 static int smart_relocate_sector(FAR struct smart_struct_s *dev,
                  uint16_t oldsector, uint16_t newsector);
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_write_checkpoint(FAR struct smart_struct_s *dev);
+static int smart_invalidate_checkpoint(FAR struct smart_struct_s *dev);
+#endif
+
 #ifdef CONFIG_SMART_DEV_LOOP
 static ssize_t smart_loop_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
@@ -456,8 +494,26 @@ static int smart_open(FAR struct inode *inode)
 
 static int smart_close(FAR struct inode *inode)
 {
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  FAR struct smart_struct_s *dev;
+#endif
+
   finfo("Entry\n");
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  DEBUGASSERT(inode && inode->i_private);
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+  dev = ((FAR struct smart_multiroot_device_s *)inode->i_private)->dev;
+#else
+  dev = (FAR struct smart_struct_s *)inode->i_private;
+#endif
+
+  /* Save the sector map so that the next scan can be skipped */
+
+  return smart_write_checkpoint(dev);
+#else
   return OK;
+#endif
 }
 
 /****************************************************************************
@@ -873,6 +929,16 @@ static ssize_t smart_write(FAR struct inode *inode,
   dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* The checkpoint no longer matches the media after this */
+
+  ret = smart_invalidate_checkpoint(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
   /* I think maybe we need to lock on a mutex here */
 
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
@@ -1821,6 +1887,374 @@ static int smart_set_wear_level(FAR struct smart_struct_s *dev, uint16_t block,
 }
 #endif
 
+/****************************************************************************
+ * Name: smart_checkformat
+ *
+ * Description: Validates the format signature in the physical sector that
+ *              holds logical sector zero and, if it is valid, marks the
+ *              volume as formatted.  Returns -EINVAL if the signature is
+ *              not valid.
+ *
+ ****************************************************************************/
+
+static int smart_checkformat(FAR struct smart_struct_s *dev, uint16_t sector)
+{
+  uint32_t  readaddress;
+  int       ret;
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+  int       x;
+  char      devname[22];
+  FAR struct smart_multiroot_device_s *rootdirdev;
+#endif
+
+  /* Read the sector data */
+
+  readaddress = sector * dev->mtdBlksPerSector * dev->geo.blocksize;
+  ret = MTD_READ(dev->mtd, readaddress, 32,
+                 (FAR uint8_t *)dev->rwbuffer);
+  if (ret != 32)
+    {
+      ferr("ERROR: Error reading physical sector %d.\n", sector);
+      return ret < 0 ? ret : -EIO;
+    }
+
+  /* Validate the format signature */
+
+  if (dev->rwbuffer[SMART_FMT_POS1] != SMART_FMT_SIG1 ||
+      dev->rwbuffer[SMART_FMT_POS2] != SMART_FMT_SIG2 ||
+      dev->rwbuffer[SMART_FMT_POS3] != SMART_FMT_SIG3 ||
+      dev->rwbuffer[SMART_FMT_POS4] != SMART_FMT_SIG4)
+    {
+      /* Invalid signature on a sector claiming to be sector 0!
+       * What should we do?  Release it?
+       */
+
+      return -EINVAL;
+    }
+
+  /* Mark the volume as formatted and set the sector size */
+
+  dev->formatstatus = SMART_FMT_STAT_FORMATTED;
+  dev->namesize = dev->rwbuffer[SMART_FMT_NAMESIZE_POS];
+  dev->formatversion = dev->rwbuffer[SMART_FMT_VERSION_POS];
+
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+  dev->rootdirentries = dev->rwbuffer[SMART_FMT_ROOTDIRS_POS];
+
+  /* If rootdirentries is greater than 1, then we need to register
+   * additional block devices.
+   */
+
+  for (x = 1; x < dev->rootdirentries; x++)
+    {
+      if (dev->partname[0] != '\0')
+        {
+          snprintf(dev->rwbuffer, sizeof(devname), "/dev/smart%d%sd%d",
+                  dev->minor, dev->partname, x+1);
+        }
+      else
+        {
+          snprintf(devname, sizeof(devname), "/dev/smart%dd%d", dev->minor,
+                   x + 1);
+        }
+
+      /* Inode private data is a reference to a struct containing
+       * the SMART device structure and the root directory number.
+       */
+
+      rootdirdev = (struct smart_multiroot_device_s *)
+        smart_malloc(dev, sizeof(*rootdirdev), "Root Dir");
+      if (rootdirdev == NULL)
+        {
+          ferr("ERROR: Memory alloc failed\n");
+          return -ENOMEM;
+        }
+
+      /* Populate the rootdirdev */
+
+      rootdirdev->dev = dev;
+      rootdirdev->rootdirnum = x;
+      ret = register_blockdriver(dev->rwbuffer, &g_bops, 0, rootdirdev);
+
+      /* Inode private data is a reference to the SMART device structure */
+
+      ret = register_blockdriver(devname, &g_bops, 0, rootdirdev);
+    }
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: smart_load_checkpoint
+ *
+ * Description: Loads the sector map and the free and release counts from
+ *              the newest checkpoint if it is intact, was saved for the
+ *              current geometry and has not been marked stale since.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_load_checkpoint(FAR struct smart_struct_s *dev)
+{
+  struct    smart_ckpt_s ckpt[2];
+  FAR uint8_t *map;
+  uint32_t  pgperblk;
+  uint32_t  page;
+  uint32_t  crc;
+  size_t    nbytes;
+  size_t    nfull;
+  int       newest = -1;
+  int       copy;
+  int       ret;
+
+  dev->ckptvalid = false;
+  if (dev->ckptnblocks == 0)
+    {
+      return -ENOENT;
+    }
+
+  /* Find the newest checkpoint.  The copies are written alternately, so
+   * the sequence number tells which copy a header belongs to.
+   */
+
+  for (copy = 0; copy < 2; copy++)
+    {
+      ret = MTD_READ(dev->mtd, (dev->ckptblock + copy * dev->ckptnblocks) *
+                     dev->geo.erasesize, sizeof(struct smart_ckpt_s),
+                     (FAR uint8_t *)&ckpt[copy]);
+      if (ret != sizeof(struct smart_ckpt_s))
+        {
+          return ret < 0 ? ret : -EIO;
+        }
+
+      if (ckpt[copy].magic == SMART_CKPT_MAGIC &&
+          (ckpt[copy].seq & 1) == copy &&
+          (newest < 0 || ckpt[copy].seq > ckpt[newest].seq))
+        {
+          newest = copy;
+        }
+    }
+
+  if (newest < 0)
+    {
+      return -ENOENT;
+    }
+
+  dev->ckptseq = ckpt[newest].seq;
+  if (ckpt[newest].stale != SMART_CKPT_VALID)
+    {
+      return -ENOENT;
+    }
+
+  /* The checkpoint claims to match the media.  If it cannot be used, it
+   * has to be marked stale before the media is changed.
+   */
+
+  dev->ckptvalid = true;
+
+  map      = (FAR uint8_t *)dev->sMap;
+  nbytes   = dev->totalsectors * sizeof(uint16_t) + (dev->neraseblocks << 1);
+  nfull    = nbytes / dev->geo.blocksize;
+  pgperblk = dev->geo.erasesize / dev->geo.blocksize;
+
+  if (ckpt[newest].sectorsize != dev->sectorsize ||
+      ckpt[newest].totalsectors != dev->totalsectors ||
+      ckpt[newest].neraseblocks != dev->neraseblocks ||
+      nfull + 2 > dev->ckptnblocks * pgperblk)
+    {
+      finfo("Checkpoint does not match the geometry\n");
+      return -EINVAL;
+    }
+
+  /* Read the map straight into place and verify it */
+
+  page = (dev->ckptblock + newest * dev->ckptnblocks) * pgperblk + 1;
+  if (nfull > 0)
+    {
+      ret = MTD_BREAD(dev->mtd, page, nfull, map);
+      if (ret != (int)nfull)
+        {
+          return ret < 0 ? ret : -EIO;
+        }
+    }
+
+  if (nbytes > nfull * dev->geo.blocksize)
+    {
+      ret = MTD_BREAD(dev->mtd, page + nfull, 1,
+                      (FAR uint8_t *)dev->rwbuffer);
+      if (ret != 1)
+        {
+          return ret < 0 ? ret : -EIO;
+        }
+
+      memcpy(&map[nfull * dev->geo.blocksize], dev->rwbuffer,
+             nbytes - nfull * dev->geo.blocksize);
+    }
+
+  crc = crc32((FAR const uint8_t *)&ckpt[newest],
+              offsetof(struct smart_ckpt_s, crc));
+  crc = crc32part(map, nbytes, crc);
+  if (crc != ckpt[newest].crc)
+    {
+      ferr("ERROR: Bad checkpoint CRC\n");
+      return -EIO;
+    }
+
+  dev->freesectors    = ckpt[newest].freesectors;
+  dev->releasesectors = ckpt[newest].releasesectors;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: smart_write_checkpoint
+ *
+ * Description: Saves the sector map and the free and release counts if they
+ *              changed since the last checkpoint.  The copy that does not
+ *              hold the newest checkpoint is overwritten and its header is
+ *              written last, so an interrupted write leaves no checkpoint
+ *              that would be trusted.
+ *
+ ****************************************************************************/
+
+static int smart_write_checkpoint(FAR struct smart_struct_s *dev)
+{
+  FAR struct smart_ckpt_s *ckpt;
+  FAR const uint8_t *map;
+  uint32_t  pgperblk;
+  uint32_t  block;
+  uint32_t  page;
+  size_t    nbytes;
+  size_t    nfull;
+  int       ret;
+
+  if (dev->ckptnblocks == 0 || dev->ckptvalid ||
+      dev->formatstatus != SMART_FMT_STAT_FORMATTED)
+    {
+      return OK;
+    }
+
+#ifdef CONFIG_MTD_SMART_ENABLE_CRC
+  /* Sectors that were allocated but not written yet are not on the media */
+
+  if (dev->allocsector != NULL)
+    {
+      return OK;
+    }
+#endif
+
+  map      = (FAR const uint8_t *)dev->sMap;
+  nbytes   = dev->totalsectors * sizeof(uint16_t) + (dev->neraseblocks << 1);
+  nfull    = nbytes / dev->geo.blocksize;
+  pgperblk = dev->geo.erasesize / dev->geo.blocksize;
+
+  if (nfull + 2 > dev->ckptnblocks * pgperblk)
+    {
+      /* The volume was formatted with a smaller sector size than the
+       * checkpoint space was reserved for.
+       */
+
+      return OK;
+    }
+
+  block = dev->ckptblock + ((dev->ckptseq + 1) & 1) * dev->ckptnblocks;
+  page  = block * pgperblk;
+
+  ret = MTD_ERASE(dev->mtd, block, dev->ckptnblocks);
+  if (ret < 0)
+    {
+      ferr("ERROR: Erase block=%d failed: %d\n", block, ret);
+      return ret;
+    }
+
+  if (nfull > 0)
+    {
+      ret = MTD_BWRITE(dev->mtd, page + 1, nfull, map);
+      if (ret != (int)nfull)
+        {
+          ferr("ERROR: Error writing checkpoint: %d\n", ret);
+          return ret < 0 ? ret : -EIO;
+        }
+    }
+
+  if (nbytes > nfull * dev->geo.blocksize)
+    {
+      memset(dev->rwbuffer, CONFIG_SMARTFS_ERASEDSTATE, dev->geo.blocksize);
+      memcpy(dev->rwbuffer, &map[nfull * dev->geo.blocksize],
+             nbytes - nfull * dev->geo.blocksize);
+
+      ret = MTD_BWRITE(dev->mtd, page + 1 + nfull, 1,
+                       (FAR uint8_t *)dev->rwbuffer);
+      if (ret != 1)
+        {
+          ferr("ERROR: Error writing checkpoint: %d\n", ret);
+          return ret < 0 ? ret : -EIO;
+        }
+    }
+
+  /* Writing the header commits the checkpoint */
+
+  memset(dev->rwbuffer, CONFIG_SMARTFS_ERASEDSTATE, dev->geo.blocksize);
+  ckpt                 = (FAR struct smart_ckpt_s *)dev->rwbuffer;
+  ckpt->magic          = SMART_CKPT_MAGIC;
+  ckpt->seq            = dev->ckptseq + 1;
+  ckpt->sectorsize     = dev->sectorsize;
+  ckpt->totalsectors   = dev->totalsectors;
+  ckpt->neraseblocks   = dev->neraseblocks;
+  ckpt->freesectors    = dev->freesectors;
+  ckpt->releasesectors = dev->releasesectors;
+  ckpt->reserved       = 0;
+  ckpt->crc            = crc32part(map, nbytes,
+                                   crc32((FAR const uint8_t *)ckpt,
+                                         offsetof(struct smart_ckpt_s, crc)));
+  ckpt->stale          = SMART_CKPT_VALID;
+
+  ret = MTD_BWRITE(dev->mtd, page, 1, (FAR uint8_t *)dev->rwbuffer);
+  if (ret != 1)
+    {
+      ferr("ERROR: Error writing checkpoint: %d\n", ret);
+      return ret < 0 ? ret : -EIO;
+    }
+
+  dev->ckptseq++;
+  dev->ckptvalid = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: smart_invalidate_checkpoint
+ *
+ * Description: Marks the newest checkpoint as stale.  This must be done
+ *              before the media is changed in any way.
+ *
+ ****************************************************************************/
+
+static int smart_invalidate_checkpoint(FAR struct smart_struct_s *dev)
+{
+  uint8_t   stale = SMART_CKPT_STALE;
+  size_t    offset;
+  ssize_t   ret;
+
+  if (!dev->ckptvalid)
+    {
+      return OK;
+    }
+
+  offset = (dev->ckptblock + (dev->ckptseq & 1) * dev->ckptnblocks) *
+           dev->geo.erasesize + offsetof(struct smart_ckpt_s, stale);
+
+  ret = smart_bytewrite(dev, offset, 1, &stale);
+  if (ret < 0)
+    {
+      ferr("ERROR: Error %d marking the checkpoint stale\n", -ret);
+      return (int)ret;
+    }
+
+  dev->ckptvalid = false;
+  return OK;
+}
+#endif /* CONFIG_MTD_SMART_CHECKPOINT */
+
 /****************************************************************************
  * Name: smart_scan
  *
@@ -1846,11 +2280,6 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 #ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
   int       dupsector;
   uint16_t  duplogsector;
-#endif
-#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
-  int       x;
-  char      devname[22];
-  FAR struct smart_multiroot_device_s *rootdirdev;
 #endif
   static const short sizetbl[8] =
   {
@@ -1919,6 +2348,36 @@ static int smart_scan(FAR struct smart_struct_s *dev)
       goto err_out;
     }
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* The headers need not be read if the checkpoint is still current */
+
+  ret = smart_load_checkpoint(dev);
+  if (ret == OK)
+    {
+      dev->formatstatus = SMART_FMT_STAT_NOFMT;
+      if (dev->sMap[0] != 0xffff)
+        {
+          ret = smart_checkformat(dev, dev->sMap[0]);
+          if (ret < 0 && ret != -EINVAL)
+            {
+              goto err_out;
+            }
+        }
+
+      goto scan_done;
+    }
+
+  /* A checkpoint that cannot be used must not outlive the changes that
+   * the scan may make to the media.
+   */
+
+  ret = smart_invalidate_checkpoint(dev);
+  if (ret < 0)
+    {
+      goto err_out;
+    }
+#endif
+
   /* Initialize the device variables */
 
   totalsectors        = dev->totalsectors;
@@ -2051,80 +2510,15 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 
       if (logicalsector == 0)
         {
-          /* Read the sector data */
-
-          ret = MTD_READ(dev->mtd, readaddress, 32,
-                         (FAR uint8_t *)dev->rwbuffer);
-          if (ret != 32)
-            {
-              ferr("ERROR: Error reading physical sector %d.\n", sector);
-              goto err_out;
-            }
-
-          /* Validate the format signature */
-
-          if (dev->rwbuffer[SMART_FMT_POS1] != SMART_FMT_SIG1 ||
-              dev->rwbuffer[SMART_FMT_POS2] != SMART_FMT_SIG2 ||
-              dev->rwbuffer[SMART_FMT_POS3] != SMART_FMT_SIG3 ||
-              dev->rwbuffer[SMART_FMT_POS4] != SMART_FMT_SIG4)
+          ret = smart_checkformat(dev, sector);
+          if (ret == -EINVAL)
             {
-              /* Invalid signature on a sector claiming to be sector 0!
-               * What should we do?  Release it?
-               */
-
               continue;
             }
-
-          /* Mark the volume as formatted and set the sector size */
-
-          dev->formatstatus = SMART_FMT_STAT_FORMATTED;
-          dev->namesize = dev->rwbuffer[SMART_FMT_NAMESIZE_POS];
-          dev->formatversion = dev->rwbuffer[SMART_FMT_VERSION_POS];
-
-#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
-          dev->rootdirentries = dev->rwbuffer[SMART_FMT_ROOTDIRS_POS];
-
-          /* If rootdirentries is greater than 1, then we need to register
-           * additional block devices.
-           */
-
-          for (x = 1; x < dev->rootdirentries; x++)
+          else if (ret < 0)
             {
-              if (dev->partname[0] != '\0')
-                {
-                  snprintf(dev->rwbuffer, sizeof(devname), "/dev/smart%d%sd%d",
-                          dev->minor, dev->partname, x+1);
-                }
-              else
-                {
-                  snprintf(devname, sizeof(devname), "/dev/smart%dd%d", dev->minor,
-                           x + 1);
-                }
-
-              /* Inode private data is a reference to a struct containing
-               * the SMART device structure and the root directory number.
-               */
-
-              rootdirdev = (struct smart_multiroot_device_s *)
-                smart_malloc(dev, sizeof(*rootdirdev), "Root Dir");
-              if (rootdirdev == NULL)
-                {
-                  ferr("ERROR: Memory alloc failed\n");
-                  ret = -ENOMEM;
-                  goto err_out;
-                }
-
-              /* Populate the rootdirdev */
-
-              rootdirdev->dev = dev;
-              rootdirdev->rootdirnum = x;
-              ret = register_blockdriver(dev->rwbuffer, &g_bops, 0, rootdirdev);
-
-              /* Inode private data is a reference to the SMART device structure */
-
-              ret = register_blockdriver(devname, &g_bops, 0, rootdirdev);
+              goto err_out;
             }
-#endif
         }
 
       /* Test for duplicate logical sectors on the device */
@@ -2373,6 +2767,10 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 #endif  /* CONFIG_MTD_SMART_CONVERT_WEAR_FORMAT */
 #endif  /* CONFIG_MTD_SMART_WEAR_LEVEL && SMART_STATUS_VERSION == 1 */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+scan_done:
+#endif
+
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
   /* Read the wear leveling status bits */
 
@@ -2902,6 +3300,16 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev, unsigned long a
 
   finfo("Entry\n");
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* The checkpoint no longer matches the media after this */
+
+  ret = smart_invalidate_checkpoint(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
   /* Get the sector size from the provided arg */
 
   sectorsize = arg >> 16;
@@ -4291,6 +4699,16 @@ static int smart_writesector(FAR struct smart_struct_s *dev,
   DEBUGASSERT(req->offset <= dev->sectorsize);
   DEBUGASSERT(req->offset+req->count <= dev->sectorsize);
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* The checkpoint no longer matches the media after this */
+
+  ret = smart_invalidate_checkpoint(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
   /* Ensure the logical sector has been allocated */
 
   if (req->logsector >= dev->totalsectors)
@@ -4825,11 +5243,21 @@ static inline int smart_allocsector(FAR struct smart_struct_s *dev,
 {
   uint16_t  logsector = 0xffff; /* Logical sector number selected */
   uint16_t  physicalsector;     /* The selected physical sector */
-#ifndef CONFIG_MTD_SMART_ENABLE_CRC
+#if !defined(CONFIG_MTD_SMART_ENABLE_CRC) || defined(CONFIG_MTD_SMART_CHECKPOINT)
   int       ret;
 #endif
   int       x;
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* The checkpoint no longer matches the media after this */
+
+  ret = smart_invalidate_checkpoint(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
   /* Validate that we have enough sectors available to perform an
    * allocation.  We have to ensure we keep enough reserved sectors
    * on hand to do released sector garbage collection.
@@ -5076,6 +5504,16 @@ static inline int smart_freesector(FAR struct smart_struct_s *dev,
   struct    smart_sect_header_s  header;
   size_t    offset;
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* The checkpoint no longer matches the media after this */
+
+  ret = smart_invalidate_checkpoint(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
   /* Check if the logical sector is within bounds */
 
   if ((logicalsector > 2) && (logicalsector < dev->totalsectors))
@@ -5282,6 +5720,15 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       goto ok_out;
 #endif /* CONFIG_FS_WRITABLE */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+    case BIOC_FLUSH:
+
+      /* Save the sector map if it changed since the last checkpoint */
+
+      ret = smart_write_checkpoint(dev);
+      goto ok_out;
+#endif
+
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
     case BIOC_GETPROCFSD:
 
@@ -5412,6 +5859,40 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
           goto errout;
         }
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+      /* Reserve the erase blocks at the end of the device for two copies
+       * of the checkpoint.  They are sized for the map of a volume with the
+       * default sector size.  Checkpoints are not used if they would take
+       * more than a quarter of the device.
+       */
+
+      if (dev->geo.blocksize > 0 &&
+          dev->geo.erasesize >= dev->geo.blocksize &&
+          dev->geo.erasesize >= CONFIG_MTD_SMART_SECTOR_SIZE)
+        {
+          totalsectors = dev->geo.neraseblocks *
+                         (dev->geo.erasesize / CONFIG_MTD_SMART_SECTOR_SIZE);
+          if (totalsectors > 65534)
+            {
+              totalsectors = 65534;
+            }
+
+          dev->ckptnblocks = (dev->geo.blocksize +
+                              totalsectors * sizeof(uint16_t) +
+                              dev->geo.neraseblocks * 2 +
+                              dev->geo.erasesize - 1) / dev->geo.erasesize;
+          if (8 * dev->ckptnblocks <= dev->geo.neraseblocks)
+            {
+              dev->geo.neraseblocks -= 2 * dev->ckptnblocks;
+              dev->ckptblock = dev->geo.neraseblocks;
+            }
+          else
+            {
+              dev->ckptnblocks = 0;
+            }
+        }
+#endif
+
       /* Set the sector size to the default for now */
 
       dev->sectorsize = 0;
@@ -57,10 +57,12 @@
 #ifdef CONFIG_DEBUG_FEATURES
 #  include <nuttx/arch.h>
 #endif
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/drivers/drivers.h>
 
 #include "pipe_common.h"
 
@@ -80,11 +82,30 @@
 #  define pipe_dumpbuffer(m,a,n)
 #endif
 
+/* The buffer is a single-producer, single-consumer ring:  Only the reader
+ * (holding d_rdexcl) moves d_rdndx and only the writer (holding d_wrexcl)
+ * moves d_wrndx, so readers and writers never take a common lock.  The
+ * index that publishes a transfer is stored with release semantics and
+ * the peer index is loaded with acquire semantics.
+ */
+
+#ifdef CONFIG_HAVE_BUILTIN_ATOMIC
+#  define pipe_load(p)    __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#  define pipe_store(p,v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#  define pipe_fence()    __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#  define pipe_load(p)    (*(p))
+#  define pipe_store(p,v) do { *(p) = (v); } while (0)
+#  define pipe_fence()
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
 static void pipecommon_semtake(sem_t *sem);
+static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
+                                  pollevent_t eventset);
 
 /****************************************************************************
  * Private Functions
@@ -120,6 +141,7 @@ static void pipecommon_semtake(FAR sem_t *sem)
 static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
                                   pollevent_t eventset)
 {
+  irqstate_t flags;
   int i;
 
   if (eventset & POLLERR)
@@ -127,6 +149,9 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
       eventset &= ~(POLLOUT | POLLIN);
     }
 
+  /* Readers and writers notify without holding d_bfsem */
+
+  flags = enter_critical_section();
   for (i = 0; i < CONFIG_DEV_PIPE_NPOLLWAITERS; i++)
     {
       FAR struct pollfd *fds = dev->d_fds[i];
@@ -145,10 +170,200 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
           if (fds->revents != 0)
             {
               finfo("Report events: %02x\n", fds->revents);
-              nxsem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: pipecommon_navail
+ *
+ * Description:
+ *   Return the number of bytes in the buffer.
+ *
+ ****************************************************************************/
+
+static inline size_t pipecommon_navail(FAR struct pipe_dev_s *dev)
+{
+  pipe_ndx_t wrndx = pipe_load(&dev->d_wrndx);
+  pipe_ndx_t rdndx = pipe_load(&dev->d_rdndx);
+
+  if (wrndx >= rdndx)
+    {
+      return wrndx - rdndx;
+    }
+
+  return dev->d_bufsize + wrndx - rdndx;
+}
+
+/****************************************************************************
+ * Name: pipecommon_nspace
+ *
+ * Description:
+ *   Return the number of bytes that can be written to the buffer.  One
+ *   byte is always left unused to distinguish a full buffer from an empty
+ *   one.
+ *
+ ****************************************************************************/
+
+static inline size_t pipecommon_nspace(FAR struct pipe_dev_s *dev)
+{
+  return dev->d_bufsize - 1 - pipecommon_navail(dev);
+}
+
+/****************************************************************************
+ * Name: pipecommon_wakeup
+ *
+ * Description:
+ *   Called after the buffer indices were updated.  Wake up the peers
+ *   waiting on 'sem', if there are any, and notify poll waiters.  Peers
+ *   wait only when the buffer is empty (readers) or full (writers), so
+ *   this usually costs no more than a memory barrier.
+ *
+ ****************************************************************************/
+
+static void pipecommon_wakeup(FAR struct pipe_dev_s *dev, FAR sem_t *sem,
+                              FAR volatile uint8_t *nwait,
+                              pollevent_t eventset)
+{
+  irqstate_t flags;
+  int sval;
+
+  pipe_fence();
+  if (*nwait > 0)
+    {
+      flags = enter_critical_section();
+      while (nxsem_getvalue(sem, &sval) == 0 && sval < 0)
+        {
+          nxsem_post(sem);
+        }
+
+      leave_critical_section(flags);
+    }
+
+  if (dev->d_npoll > 0)
+    {
+      pipecommon_pollnotify(dev, eventset);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_waitdata
+ *
+ * Description:
+ *   Wait until there is data in the buffer.  Returns the number of bytes
+ *   available, zero on end-of-file or a negated errno value.  The caller
+ *   holds d_rdexcl.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_waitdata(FAR struct file *filep,
+                                   FAR struct pipe_dev_s *dev)
+{
+  irqstate_t flags;
+  size_t navail;
+  int ret;
+
+  for (; ; )
+    {
+      navail = pipecommon_navail(dev);
+      if (navail > 0)
+        {
+          return navail;
+        }
+
+      /* If O_NONBLOCK was set, then return EGAIN */
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          return -EAGAIN;
+        }
+
+      /* If there are no writers on the pipe, then return end of file */
+
+      if (dev->d_nwriters <= 0)
+        {
+          return 0;
+        }
+
+      /* Otherwise, wait for something to be written to the pipe.  Count
+       * ourself as a waiter before checking again so that the writer
+       * cannot miss us.
+       */
+
+      ret   = OK;
+      flags = enter_critical_section();
+      dev->d_nrdwait++;
+      pipe_fence();
+
+      if (pipecommon_navail(dev) == 0 && dev->d_nwriters > 0)
+        {
+          ret = nxsem_wait(&dev->d_rdsem);
+        }
+
+      dev->d_nrdwait--;
+      leave_critical_section(flags);
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_waitspace
+ *
+ * Description:
+ *   Wait until there is space in the buffer.  Returns the number of bytes
+ *   that can be written or a negated errno value.  The caller holds
+ *   d_wrexcl.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_waitspace(FAR struct file *filep,
+                                    FAR struct pipe_dev_s *dev)
+{
+  irqstate_t flags;
+  size_t nspace;
+  int ret;
+
+  for (; ; )
+    {
+      nspace = pipecommon_nspace(dev);
+      if (nspace > 0)
+        {
+          return nspace;
+        }
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          return -EAGAIN;
+        }
+
+      /* Wait for data to be removed from the pipe */
+
+      ret   = OK;
+      flags = enter_critical_section();
+      dev->d_nwrwait++;
+      pipe_fence();
+
+      if (pipecommon_nspace(dev) == 0)
+        {
+          ret = nxsem_wait(&dev->d_wrsem);
+        }
+
+      dev->d_nwrwait--;
+      leave_critical_section(flags);
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
 }
 
 /****************************************************************************
@@ -174,6 +389,8 @@ FAR struct pipe_dev_s *pipecommon_allocdev(size_t bufsize)
 
       memset(dev, 0, sizeof(struct pipe_dev_s));
       nxsem_init(&dev->d_bfsem, 0, 1);
+      nxsem_init(&dev->d_rdexcl, 0, 1);
+      nxsem_init(&dev->d_wrexcl, 0, 1);
       nxsem_init(&dev->d_rdsem, 0, 0);
       nxsem_init(&dev->d_wrsem, 0, 0);
 
@@ -197,6 +414,8 @@ FAR struct pipe_dev_s *pipecommon_allocdev(size_t bufsize)
 void pipecommon_freedev(FAR struct pipe_dev_s *dev)
 {
   nxsem_destroy(&dev->d_bfsem);
+  nxsem_destroy(&dev->d_rdexcl);
+  nxsem_destroy(&dev->d_wrexcl);
   nxsem_destroy(&dev->d_rdsem);
   nxsem_destroy(&dev->d_wrsem);
   kmm_free(dev);
@@ -316,6 +535,7 @@ int pipecommon_close(FAR struct file *filep)
 {
   FAR struct inode      *inode = filep->f_inode;
   FAR struct pipe_dev_s *dev   = inode->i_private;
+  irqstate_t             flags;
   int                    sval;
 
   DEBUGASSERT(dev && filep->f_inode->i_crefs > 0);
@@ -345,6 +565,11 @@ int pipecommon_close(FAR struct file *filep)
            * waiting readers that they must return end-of-file.
            */
 
+          /* Readers check d_nwriters in a critical section before they
+           * wait, so update it in a critical section, too.
+           */
+
+          flags = enter_critical_section();
           if (--dev->d_nwriters <= 0)
             {
               while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
@@ -352,10 +577,16 @@ int pipecommon_close(FAR struct file *filep)
                   nxsem_post(&dev->d_rdsem);
                 }
 
+              leave_critical_section(flags);
+
               /* Inform poll readers that other end closed. */
 
               pipecommon_pollnotify(dev, POLLHUP);
             }
+          else
+            {
+              leave_critical_section(flags);
+            }
         }
 
       /* If opened for reading, decrement the count of readers on the pipe
@@ -421,11 +652,9 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 {
   FAR struct inode      *inode  = filep->f_inode;
   FAR struct pipe_dev_s *dev    = inode->i_private;
-#ifdef CONFIG_DEV_PIPEDUMP
-  FAR uint8_t           *start  = (FAR uint8_t *)buffer;
-#endif
-  ssize_t                nread  = 0;
-  int                    sval;
+  ssize_t                nread;
+  size_t                 nfirst;
+  pipe_ndx_t             rdndx;
   int                    ret;
 
   DEBUGASSERT(dev);
@@ -435,9 +664,11 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
       return 0;
     }
 
-  /* Make sure that we have exclusive access to the device structure */
+  /* Make sure that we have exclusive access to the read side of the
+   * buffer.  Writers are not blocked.
+   */
 
-  ret = nxsem_wait(&dev->d_bfsem);
+  ret = nxsem_wait(&dev->d_rdexcl);
   if (ret < 0)
     {
       return ret;
@@ -445,64 +676,43 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
   /* If the pipe is empty, then wait for something to be written to it */
 
-  while (dev->d_wrndx == dev->d_rdndx)
+  nread = pipecommon_waitdata(filep, dev);
+  if (nread <= 0)
     {
-      /* If O_NONBLOCK was set, then return EGAIN */
-
-      if (filep->f_oflags & O_NONBLOCK)
-        {
-          nxsem_post(&dev->d_bfsem);
-          return -EAGAIN;
-        }
-
-      /* If there are no writers on the pipe, then return end of file */
-
-      if (dev->d_nwriters <= 0)
-        {
-          nxsem_post(&dev->d_bfsem);
-          return 0;
-        }
-
-      /* Otherwise, wait for something to be written to the pipe */
-
-      sched_lock();
-      nxsem_post(&dev->d_bfsem);
-      ret = nxsem_wait(&dev->d_rdsem);
-      sched_unlock();
-
-      if (ret < 0 || (ret = nxsem_wait(&dev->d_bfsem)) < 0)
-        {
-          return ret;
-        }
+      nxsem_post(&dev->d_rdexcl);
+      return nread;
     }
 
-  /* Then return whatever is available in the pipe (which is at least one byte) */
+  /* Then return whatever is available in the pipe (which is at least one
+   * byte), copying at most two contiguous pieces of the ring.
+   */
 
-  nread = 0;
-  while ((size_t)nread < len && dev->d_wrndx != dev->d_rdndx)
+  if ((size_t)nread > len)
     {
-      *buffer++ = dev->d_buffer[dev->d_rdndx];
-      if (++dev->d_rdndx >= dev->d_bufsize)
-        {
-          dev->d_rdndx = 0;
-        }
-
-      nread++;
+      nread = len;
     }
 
-  /* Notify all waiting writers that bytes have been removed from the buffer */
-
-  while (nxsem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0)
+  rdndx  = dev->d_rdndx;
+  nfirst = dev->d_bufsize - rdndx;
+  if (nfirst > (size_t)nread)
     {
-      nxsem_post(&dev->d_wrsem);
+      nfirst = nread;
     }
 
-  /* Notify all poll/select waiters that they can write to the FIFO */
+  memcpy(buffer, &dev->d_buffer[rdndx], nfirst);
+  memcpy(buffer + nfirst, dev->d_buffer, nread - nfirst);
 
-  pipecommon_pollnotify(dev, POLLOUT);
+  pipe_store(&dev->d_rdndx,
+             (pipe_ndx_t)((rdndx + (size_t)nread) % dev->d_bufsize));
 
-  nxsem_post(&dev->d_bfsem);
-  pipe_dumpbuffer("From PIPE:", start, nread);
+  /* Notify waiting writers and poll/select waiters that they can write to
+   * the FIFO.
+   */
+
+  pipecommon_wakeup(dev, &dev->d_wrsem, &dev->d_nwrwait, POLLOUT);
+
+  nxsem_post(&dev->d_rdexcl);
+  pipe_dumpbuffer("From PIPE:", (FAR uint8_t *)buffer, nread);
   return nread;
 }
 
@@ -516,9 +726,10 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct inode      *inode    = filep->f_inode;
   FAR struct pipe_dev_s *dev      = inode->i_private;
   ssize_t                nwritten = 0;
-  ssize_t                last;
-  int                    nxtwrndx;
-  int                    sval;
+  ssize_t                nspace;
+  size_t                 nfirst;
+  size_t                 n;
+  pipe_ndx_t             wrndx;
   int                    ret;
 
   DEBUGASSERT(dev);
@@ -543,23 +754,20 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
     }
 
   /* At present, this method cannot be called from interrupt handlers.  That
-   * is because it calls nxsem_wait (via pipecommon_semtake below) and
-   * nxsem_wait cannot be called from interrupt level.  This actually
-   * happens fairly commonly IF [a-z]err() is called from interrupt handlers
-   * and stdout is being redirected via a pipe.  In that case, the debug
-   * output will try to go out the pipe (interrupt handlers should use the
-   * _err() APIs).
-   *
-   * On the other hand, it would be very valuable to be able to feed the pipe
-   * from an interrupt handler!  TODO:  Consider disabling interrupts instead
-   * of taking semaphores so that pipes can be written from interrupt handlers
+   * is because it calls nxsem_wait and nxsem_wait cannot be called from
+   * interrupt level.  This actually happens fairly commonly IF [a-z]err()
+   * is called from interrupt handlers and stdout is being redirected via a
+   * pipe.  In that case, the debug output will try to go out the pipe
+   * (interrupt handlers should use the _err() APIs).
    */
 
   DEBUGASSERT(up_interrupt_context() == false);
 
-  /* Make sure that we have exclusive access to the device structure */
+  /* Make sure that we have exclusive access to the write side of the
+   * buffer.  Readers are not blocked.
+   */
 
-  ret = nxsem_wait(&dev->d_bfsem);
+  ret = nxsem_wait(&dev->d_wrexcl);
   if (ret < 0)
     {
       return ret;
@@ -567,90 +775,55 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
   /* Loop until all of the bytes have been written */
 
-  last = 0;
-  for (; ; )
+  while ((size_t)nwritten < len)
     {
-      /* Calculate the write index AFTER the next byte is written */
-
-      nxtwrndx = dev->d_wrndx + 1;
-      if (nxtwrndx >= dev->d_bufsize)
-        {
-          nxtwrndx = 0;
-        }
-
-      /* Would the next write overflow the circular buffer? */
+      /* Wait for space in the buffer.  If O_NONBLOCK was set, then return
+       * partial bytes written or EGAIN.
+       */
 
-      if (nxtwrndx != dev->d_rdndx)
+      nspace = pipecommon_waitspace(filep, dev);
+      if (nspace < 0)
         {
-          /* No... copy the byte */
-
-          dev->d_buffer[dev->d_wrndx] = *buffer++;
-          dev->d_wrndx = nxtwrndx;
-
-          /* Is the write complete? */
-
-          nwritten++;
-          if ((size_t)nwritten >= len)
+          if (nwritten == 0)
             {
-              /* Yes.. Notify all of the waiting readers that more data is available */
-
-              while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  nxsem_post(&dev->d_rdsem);
-                }
-
-              /* Notify all poll/select waiters that they can read from the FIFO */
-
-              pipecommon_pollnotify(dev, POLLIN);
-
-              /* Return the number of bytes written */
-
-              nxsem_post(&dev->d_bfsem);
-              return len;
+              nwritten = nspace;
             }
+
+          break;
         }
-      else
-        {
-          /* There is not enough room for the next byte.  Was anything written in this pass? */
 
-          if (last < nwritten)
-            {
-              /* Yes.. Notify all of the waiting readers that more data is available */
+      /* Copy as much as fits, in at most two contiguous pieces */
 
-              while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  nxsem_post(&dev->d_rdsem);
-                }
-
-              /* Notify all poll/select waiters that they can read from the FIFO */
+      n = len - nwritten;
+      if (n > (size_t)nspace)
+        {
+          n = nspace;
+        }
 
-              pipecommon_pollnotify(dev, POLLIN);
-            }
+      wrndx  = dev->d_wrndx;
+      nfirst = dev->d_bufsize - wrndx;
+      if (nfirst > n)
+        {
+          nfirst = n;
+        }
 
-          last = nwritten;
+      memcpy(&dev->d_buffer[wrndx], buffer, nfirst);
+      memcpy(dev->d_buffer, buffer + nfirst, n - nfirst);
 
-          /* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
+      pipe_store(&dev->d_wrndx,
+                 (pipe_ndx_t)((wrndx + n) % dev->d_bufsize));
+      buffer   += n;
+      nwritten += n;
 
-          if (filep->f_oflags & O_NONBLOCK)
-            {
-              if (nwritten == 0)
-                {
-                  nwritten = -EAGAIN;
-                }
-
-              nxsem_post(&dev->d_bfsem);
-              return nwritten;
-            }
-
-          /* There is more to be written.. wait for data to be removed from the pipe */
+      /* Notify waiting readers and poll/select waiters that more data is
+       * available.
+       */
 
-          sched_lock();
-          nxsem_post(&dev->d_bfsem);
-          pipecommon_semtake(&dev->d_wrsem);
-          sched_unlock();
-          pipecommon_semtake(&dev->d_bfsem);
-        }
+      pipecommon_wakeup(dev, &dev->d_rdsem, &dev->d_nrdwait, POLLIN);
     }
+
+  nxsem_post(&dev->d_wrexcl);
+  return nwritten;
 }
 
 /****************************************************************************
@@ -664,14 +837,19 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
   FAR struct pipe_dev_s *dev      = inode->i_private;
   pollevent_t            eventset;
   pipe_ndx_t             nbytes;
+  irqstate_t             flags;
   int                    ret      = OK;
   int                    i;
 
   DEBUGASSERT(dev && fds);
 
-  /* Are we setting up the poll?  Or tearing it down? */
+  /* Are we setting up the poll?  Or tearing it down?  The poll structures
+   * are also used by readers and writers in pipecommon_pollnotify(), which
+   * do not hold d_bfsem.
+   */
 
   pipecommon_semtake(&dev->d_bfsem);
+  flags = enter_critical_section();
   if (setup)
     {
       /* This is a request to set up the poll.  Find an available
@@ -688,6 +866,7 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
               dev->d_fds[i] = fds;
               fds->priv     = &dev->d_fds[i];
+              dev->d_npoll++;
               break;
             }
         }
@@ -703,14 +882,7 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
        * First, determine how many bytes are in the buffer
        */
 
-      if (dev->d_wrndx >= dev->d_rdndx)
-        {
-          nbytes = dev->d_wrndx - dev->d_rdndx;
-        }
-      else
-        {
-          nbytes = dev->d_bufsize + dev->d_wrndx - dev->d_rdndx;
-        }
+      nbytes = pipecommon_navail(dev);
 
       /* Notify the POLLOUT event if the pipe is not full, but only if
        * there is readers.
@@ -768,9 +940,11 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
       *slot                = NULL;
       fds->priv            = NULL;
+      dev->d_npoll--;
     }
 
 errout:
+  leave_critical_section(flags);
   nxsem_post(&dev->d_bfsem);
   return ret;
 }
@@ -874,6 +1048,218 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
+/****************************************************************************
+ * Name: pipecommon_splicefrom
+ *
+ * Description:
+ *   Write up to 'count' bytes from the pipe buffer directly to 'outfd'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PIPE_SENDFILE
+static ssize_t pipecommon_splicefrom(FAR struct file *filep, int outfd,
+                                     size_t count)
+{
+  FAR struct pipe_dev_s *dev = filep->f_inode->i_private;
+  size_t ntransferred = 0;
+  pipe_ndx_t rdndx;
+  ssize_t navail;
+  ssize_t ret;
+
+  ret = nxsem_wait(&dev->d_rdexcl);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (ntransferred < count)
+    {
+      /* Wait for data, but do not block once something was transferred */
+
+      navail = pipecommon_navail(dev);
+      if (navail == 0 && ntransferred == 0)
+        {
+          navail = pipecommon_waitdata(filep, dev);
+        }
+
+      if (navail <= 0)
+        {
+          ret = navail;
+          break;
+        }
+
+      /* Send the contiguous piece starting at the read index */
+
+      rdndx = dev->d_rdndx;
+      if ((size_t)navail > dev->d_bufsize - rdndx)
+        {
+          navail = dev->d_bufsize - rdndx;
+        }
+
+      if ((size_t)navail > count - ntransferred)
+        {
+          navail = count - ntransferred;
+        }
+
+      ret = nx_write(outfd, &dev->d_buffer[rdndx], navail);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      pipe_store(&dev->d_rdndx,
+                 (pipe_ndx_t)((rdndx + (size_t)ret) % dev->d_bufsize));
+      ntransferred += ret;
+
+      pipecommon_wakeup(dev, &dev->d_wrsem, &dev->d_nwrwait, POLLOUT);
+    }
+
+  nxsem_post(&dev->d_rdexcl);
+  return ntransferred > 0 ? (ssize_t)ntransferred : ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: pipecommon_spliceto
+ *
+ * Description:
+ *   Read up to 'count' bytes from 'infd' directly into the pipe buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PIPE_SENDFILE
+static ssize_t pipecommon_spliceto(FAR struct file *filep, int infd,
+                                   size_t count)
+{
+  FAR struct pipe_dev_s *dev = filep->f_inode->i_private;
+  size_t ntransferred = 0;
+  pipe_ndx_t wrndx;
+  ssize_t nspace;
+  ssize_t ret;
+
+  if (dev->d_nreaders <= 0)
+    {
+      return -EPIPE;
+    }
+
+  ret = nxsem_wait(&dev->d_wrexcl);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (ntransferred < count)
+    {
+      nspace = pipecommon_waitspace(filep, dev);
+      if (nspace <= 0)
+        {
+          ret = nspace;
+          break;
+        }
+
+      /* Read into the contiguous free space at the write index */
+
+      wrndx = dev->d_wrndx;
+      if ((size_t)nspace > dev->d_bufsize - wrndx)
+        {
+          nspace = dev->d_bufsize - wrndx;
+        }
+
+      if ((size_t)nspace > count - ntransferred)
+        {
+          nspace = count - ntransferred;
+        }
+
+      ret = nx_read(infd, &dev->d_buffer[wrndx], nspace);
+      if (ret <= 0)
+        {
+          /* End of file or error */
+
+          break;
+        }
+
+      pipe_store(&dev->d_wrndx,
+                 (pipe_ndx_t)((wrndx + (size_t)ret) % dev->d_bufsize));
+      ntransferred += ret;
+
+      pipecommon_wakeup(dev, &dev->d_rdsem, &dev->d_nrdwait, POLLIN);
+    }
+
+  nxsem_post(&dev->d_wrexcl);
+  return ntransferred > 0 ? (ssize_t)ntransferred : ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: pipe_sendfile
+ *
+ * Description:
+ *   Called from sendfile() to move data between a pipe or FIFO and another
+ *   file or socket without an intermediate buffer:  Data is written to
+ *   'outfd' straight from the pipe buffer or read from 'infd' straight
+ *   into it.
+ *
+ * Input Parameters:
+ *   outfd - The descriptor to write to
+ *   infd  - The descriptor to read from
+ *   count - The maximum number of bytes to transfer
+ *
+ * Returned Value:
+ *   The number of bytes transferred or a negated errno value.  -ENOSYS is
+ *   returned if neither descriptor refers to a pipe or FIFO, -EBADF if the
+ *   pipe end is not open for the direction used and -EINVAL if both
+ *   descriptors refer to the same pipe.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PIPE_SENDFILE
+ssize_t pipe_sendfile(int outfd, int infd, size_t count)
+{
+  FAR struct file *filep;
+  FAR struct file *outfilep;
+
+  if ((unsigned int)infd < CONFIG_NFILE_DESCRIPTORS &&
+      fs_getfilep(infd, &filep) >= 0 && filep->f_inode != NULL &&
+      INODE_IS_DRIVER(filep->f_inode) &&
+      filep->f_inode->u.i_ops->read == pipecommon_read)
+    {
+      if ((filep->f_oflags & O_RDOK) == 0)
+        {
+          return -EBADF;
+        }
+
+      /* Writing to the same pipe would wait for space while holding the
+       * read exclusion that is needed to make space.
+       */
+
+      if ((unsigned int)outfd < CONFIG_NFILE_DESCRIPTORS &&
+          fs_getfilep(outfd, &outfilep) >= 0 &&
+          outfilep->f_inode != NULL &&
+          outfilep->f_inode->i_private == filep->f_inode->i_private)
+        {
+          return -EINVAL;
+        }
+
+      return pipecommon_splicefrom(filep, outfd, count);
+    }
+
+  if ((unsigned int)outfd < CONFIG_NFILE_DESCRIPTORS &&
+      fs_getfilep(outfd, &filep) >= 0 && filep->f_inode != NULL &&
+      INODE_IS_DRIVER(filep->f_inode) &&
+      filep->f_inode->u.i_ops->write == pipecommon_write)
+    {
+      if ((filep->f_oflags & O_WROK) == 0)
+        {
+          return -EBADF;
+        }
+
+      return pipecommon_spliceto(filep, infd, count);
+    }
+
+  return -ENOSYS;
+}
+#endif
+
 /****************************************************************************
  * Name: pipecommon_unlink
  ****************************************************************************/
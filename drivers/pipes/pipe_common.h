@@ -129,16 +129,21 @@ typedef uint8_t pipe_ndx_t;   /*  8-bit index */
 
 struct pipe_dev_s
 {
-  sem_t      d_bfsem;       /* Used to serialize access to d_buffer and indices */
+  sem_t      d_bfsem;       /* Serializes open, close, ioctl and poll setup */
+  sem_t      d_rdexcl;      /* Serializes readers */
+  sem_t      d_wrexcl;      /* Serializes writers */
   sem_t      d_rdsem;       /* Empty buffer - Reader waits for data write */
   sem_t      d_wrsem;       /* Full buffer - Writer waits for data read */
-  pipe_ndx_t d_wrndx;       /* Index in d_buffer to save next byte written */
-  pipe_ndx_t d_rdndx;       /* Index in d_buffer to return the next byte read */
+  volatile pipe_ndx_t d_wrndx; /* Index in d_buffer to save next byte written */
+  volatile pipe_ndx_t d_rdndx; /* Index in d_buffer to return the next byte read */
   pipe_ndx_t d_bufsize;     /* allocated size of d_buffer in bytes */
   uint8_t    d_nwriters;    /* Number of reference counts for write access */
   uint8_t    d_nreaders;    /* Number of reference counts for read access */
   uint8_t    d_pipeno;      /* Pipe minor number */
   uint8_t    d_flags;       /* See PIPE_FLAG_* definitions */
+  volatile uint8_t d_nrdwait;  /* Number of readers waiting on d_rdsem */
+  volatile uint8_t d_nwrwait;  /* Number of writers waiting on d_wrsem */
+  volatile uint8_t d_npoll;    /* Number of entries in use in d_fds[] */
   uint8_t   *d_buffer;      /* Buffer allocated when device opened */
 
   /* The following is a list if poll structures of threads waiting for
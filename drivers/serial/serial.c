@@ -210,7 +210,7 @@ static void uart_pollnotify(FAR uart_dev_t *dev, pollevent_t eventset)
               nxsem_getvalue(fds->sem, &semcount);
               if (semcount < 1)
                 {
-                  nxsem_post(fds->sem);
+                  poll_notify(fds);
                 }
 
               leave_critical_section(flags);
@@ -63,6 +63,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/fs/dirent.h>
 
 #include "inode/inode.h"
@@ -1306,6 +1307,17 @@ static int fat_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       return ret;
     }
 
+  if (cmd == FIOC_FILEID && arg != 0)
+    {
+      /* The location of the directory entry is unique within the volume */
+
+      *(FAR uintptr_t *)((uintptr_t)arg) =
+        (uintptr_t)ff->ff_dirsector * DIRSEC_NDIRS(fs) + ff->ff_dirindex;
+
+      fat_semgive(fs);
+      return OK;
+    }
+
   /* ioctl calls are just passed through to the contained block driver */
 
   fat_semgive(fs);
@@ -2172,6 +2184,12 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
         }
     }
 
+#ifdef CONFIG_FAT_SECTORCACHE
+  /* Write back any dirty sectors still held in the sector cache */
+
+  (void)fat_fscacheflush(fs);
+
+#endif
   /* Unmount ... close the block driver */
 
   if (fs->fs_blkdriver)
@@ -2199,11 +2217,7 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   /* Release the mountpoint private data */
 
-  if (fs->fs_buffer)
-    {
-      fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
-    }
-
+  fat_fscacherelease(fs);
   nxsem_destroy(&fs->fs_sem);
   kmm_free(fs);
   return OK;
@@ -863,10 +863,68 @@
 #  define fat_io_free(m,s) kmm_free(m)
 #endif
 
+/****************************************************************************
+ * Sector cache
+ *
+ *   If CONFIG_FAT_SECTORCACHE is selected, sectors that are switched out of
+ *   fs_buffer are retained in a small per-volume cache.  Dirty sectors are
+ *   written back only when they are replaced or when the volume is synced.
+ *   FAT table sectors may be given their own entries so that walking a
+ *   cluster chain does not evict directory sectors.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_SECTORCACHE
+#  ifndef CONFIG_FAT_SECTORCACHE_NSECTORS
+#    define CONFIG_FAT_SECTORCACHE_NSECTORS 8
+#  endif
+#  ifndef CONFIG_FAT_SECTORCACHE_NFATSECTORS
+#    define CONFIG_FAT_SECTORCACHE_NFATSECTORS 0
+#  endif
+#  ifndef CONFIG_FAT_SECTORCACHE_READAHEAD
+#    define CONFIG_FAT_SECTORCACHE_READAHEAD 1
+#  endif
+
+#  if CONFIG_FAT_SECTORCACHE_NSECTORS < 1
+#    error CONFIG_FAT_SECTORCACHE_NSECTORS must be at least one
+#  endif
+
+#  define FAT_NCACHED \
+     (CONFIG_FAT_SECTORCACHE_NSECTORS + CONFIG_FAT_SECTORCACHE_NFATSECTORS)
+
+#  if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_FAT)
+#    define FAT_CACHESTATS 1
+#  endif
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_FAT_SECTORCACHE
+/* This structure describes one entry in the sector cache */
+
+struct fat_cache_s
+{
+  off_t    fc_sector;              /* Sector held in fc_buffer (-1: none) */
+  uint32_t fc_stamp;               /* Time of last use, for LRU replacement */
+  bool     fc_dirty;               /* true: fc_buffer must be written back */
+  uint8_t *fc_buffer;              /* One sector of the cache memory */
+};
+#endif
+
+#ifdef FAT_CACHESTATS
+/* Sector cache statistics for all mounted volumes (see /proc/fs/fat) */
+
+struct fat_cachestats_s
+{
+  uint32_t cs_hits;                /* Sector found in fs_buffer or the cache */
+  uint32_t cs_misses;              /* Sector read from the device */
+  uint32_t cs_readahead;           /* Sectors read ahead of use */
+  uint32_t cs_writebacks;          /* Dirty sectors written to the device */
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a fat32 filesystem.
@@ -901,6 +959,11 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one sector
                                     * from the device */
+#ifdef CONFIG_FAT_SECTORCACHE
+  uint32_t fs_cachestamp;          /* Incremented on each cache access */
+  uint8_t *fs_cachemem;            /* Memory of all sector cache entries */
+  struct fat_cache_s fs_cache[FAT_NCACHED];
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -1004,10 +1067,6 @@ struct fat_dirinfo_s
  * Public Data
  ****************************************************************************/
 
-/****************************************************************************
- * Public Function Prototypes
- ****************************************************************************/
-
 #undef EXTERN
 #if defined(__cplusplus)
 #define EXTERN extern "C"
@@ -1016,6 +1075,14 @@ extern "C" {
 #define EXTERN extern
 #endif
 
+#ifdef FAT_CACHESTATS
+EXTERN struct fat_cachestats_s g_fatcachestats;
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
 /* Utitilies to handle unaligned or byte swapped accesses */
 
 EXTERN uint16_t fat_getuint16(uint8_t *ptr);
@@ -1080,6 +1147,8 @@ EXTERN int    fat_remove(struct fat_mountpt_s *fs, const char *relpath, bool dir
 
 /* Mountpoint and file buffer cache (for partial sector accesses) */
 
+EXTERN int    fat_fscacheinit(struct fat_mountpt_s *fs);
+EXTERN void   fat_fscacherelease(struct fat_mountpt_s *fs);
 EXTERN int    fat_fscacheflush(struct fat_mountpt_s *fs);
 EXTERN int    fat_fscacheread(struct fat_mountpt_s *fs, off_t sector);
 EXTERN int    fat_ffcacheflush(struct fat_mountpt_s *fs, struct fat_file_s *ff);
@@ -60,10 +60,31 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
+#include <nuttx/fs/ioctl.h>
 
 #include "inode/inode.h"
 #include "fs_fat32.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef FAT_CACHESTATS
+#  define fat_cachestat(n,f) (g_fatcachestats.f += (n))
+#else
+#  define fat_cachestat(n,f)
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef FAT_CACHESTATS
+/* Sector cache statistics for all mounted volumes */
+
+struct fat_cachestats_s g_fatcachestats;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -278,6 +299,423 @@ static int fat_checkbootrecord(struct fat_mountpt_s *fs)
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_writesector
+ *
+ * Description:
+ *   Write one cached sector to the device.  If the sector lies in the FAT
+ *   region, then the change is also made in each copy of the FAT.
+ *
+ ****************************************************************************/
+
+static int fat_writesector(struct fat_mountpt_s *fs, uint8_t *buffer,
+                           off_t sector)
+{
+  int ret;
+
+  /* Write the dirty sector */
+
+  ret = fat_hwwrite(fs, buffer, sector, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Does the sector lie in the FAT region? */
+
+  if (sector >= fs->fs_fatbase &&
+      sector < fs->fs_fatbase + fs->fs_nfatsects)
+    {
+      int i;
+
+      /* Yes, then make the change in the FAT copy as well */
+
+      for (i = fs->fs_fatnumfats; i >= 2; i--)
+        {
+          sector += fs->fs_nfatsects;
+          ret = fat_hwwrite(fs, buffer, sector, 1);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+#ifdef CONFIG_FAT_SECTORCACHE
+/****************************************************************************
+ * Name: fat_cachepool
+ *
+ * Description:
+ *   Return the range of cache entries that may hold the sector.  FAT table
+ *   sectors use their own entries if CONFIG_FAT_SECTORCACHE_NFATSECTORS is
+ *   non-zero.
+ *
+ ****************************************************************************/
+
+static void fat_cachepool(struct fat_mountpt_s *fs, off_t sector,
+                          FAR int *first, FAR int *last)
+{
+#if CONFIG_FAT_SECTORCACHE_NFATSECTORS > 0
+  if (sector >= fs->fs_fatbase &&
+      sector < fs->fs_fatbase + fs->fs_nfatsects)
+    {
+      *first = CONFIG_FAT_SECTORCACHE_NSECTORS;
+      *last  = FAT_NCACHED;
+      return;
+    }
+#endif
+
+  *first = 0;
+  *last  = CONFIG_FAT_SECTORCACHE_NSECTORS;
+}
+
+/****************************************************************************
+ * Name: fat_cachefind
+ *
+ * Description:
+ *   Return the cache entry that holds the sector or NULL if the sector is
+ *   not cached.
+ *
+ ****************************************************************************/
+
+static FAR struct fat_cache_s *fat_cachefind(struct fat_mountpt_s *fs,
+                                             off_t sector)
+{
+  int first;
+  int last;
+  int i;
+
+  fat_cachepool(fs, sector, &first, &last);
+  for (i = first; i < last; i++)
+    {
+      if (fs->fs_cache[i].fc_sector == sector)
+        {
+          return &fs->fs_cache[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: fat_cachevictim
+ *
+ * Description:
+ *   Select the cache entry to be replaced by the sector:  An unused entry
+ *   if there is one, otherwise the least recently used entry.
+ *
+ ****************************************************************************/
+
+static FAR struct fat_cache_s *fat_cachevictim(struct fat_mountpt_s *fs,
+                                               off_t sector)
+{
+  FAR struct fat_cache_s *victim = NULL;
+  uint32_t maxage = 0;
+  int first;
+  int last;
+  int i;
+
+  fat_cachepool(fs, sector, &first, &last);
+  for (i = first; i < last; i++)
+    {
+      FAR struct fat_cache_s *cache = &fs->fs_cache[i];
+      uint32_t age;
+
+      if (cache->fc_sector < 0)
+        {
+          return cache;
+        }
+
+      age = fs->fs_cachestamp - cache->fc_stamp;
+      if (victim == NULL || age > maxage)
+        {
+          victim = cache;
+          maxage = age;
+        }
+    }
+
+  return victim;
+}
+
+/****************************************************************************
+ * Name: fat_cachewriteback
+ *
+ * Description:
+ *   Write the cache entry back to the device if it is dirty.
+ *
+ ****************************************************************************/
+
+static int fat_cachewriteback(struct fat_mountpt_s *fs,
+                              FAR struct fat_cache_s *cache)
+{
+  int ret;
+
+  if (cache->fc_dirty)
+    {
+      ret = fat_writesector(fs, cache->fc_buffer, cache->fc_sector);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      cache->fc_dirty = false;
+      fat_cachestat(1, cs_writebacks);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cachesave
+ *
+ * Description:
+ *   Move the sector in fs_buffer into the cache before fs_buffer is reused
+ *   for another sector.  A dirty sector stays dirty in the cache.
+ *
+ ****************************************************************************/
+
+static int fat_cachesave(struct fat_mountpt_s *fs)
+{
+  FAR struct fat_cache_s *cache;
+  int ret;
+
+  if (fs->fs_currentsector < 0)
+    {
+      return OK;
+    }
+
+  /* The copy in fs_buffer is always the most recent, even if the cache
+   * already holds an (older) copy of the same sector.
+   */
+
+  cache = fat_cachefind(fs, fs->fs_currentsector);
+  if (cache == NULL)
+    {
+      cache = fat_cachevictim(fs, fs->fs_currentsector);
+      ret   = fat_cachewriteback(fs, cache);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  memcpy(cache->fc_buffer, fs->fs_buffer, fs->fs_hwsectorsize);
+  cache->fc_sector = fs->fs_currentsector;
+  cache->fc_dirty  = fs->fs_dirty;
+  cache->fc_stamp  = fs->fs_cachestamp;
+
+  fs->fs_dirty     = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cachemiss
+ *
+ * Description:
+ *   Read a sector that is not cached into fs_buffer.  If read-ahead is
+ *   enabled, the following sectors of the same cluster are read into the
+ *   cache with the same device request.
+ *
+ ****************************************************************************/
+
+static int fat_cachemiss(struct fat_mountpt_s *fs, off_t sector)
+{
+#if CONFIG_FAT_SECTORCACHE_READAHEAD > 1
+  FAR struct fat_cache_s *cache;
+  int nsectors;
+  int ndx;
+  int ret;
+  int i;
+
+  /* Read-ahead is only useful within the clusters of the data region */
+
+  if (sector >= fs->fs_database)
+    {
+      /* Don't read past the end of the cluster, past the size of the
+       * cache, or past a sector that is already cached.
+       */
+
+      nsectors = fs->fs_fatsecperclus -
+                 ((sector - fs->fs_database) & CLUS_NDXMASK(fs));
+      nsectors = MIN(nsectors, CONFIG_FAT_SECTORCACHE_READAHEAD);
+      nsectors = MIN(nsectors, CONFIG_FAT_SECTORCACHE_NSECTORS);
+
+      for (i = 1; i < nsectors; i++)
+        {
+          if (fat_cachefind(fs, sector + i) != NULL)
+            {
+              break;
+            }
+        }
+
+      nsectors = i;
+      if (nsectors > 1)
+        {
+          /* The sectors are read into a run of adjacent entries starting
+           * near the least recently used entry.
+           */
+
+          cache = fat_cachevictim(fs, sector);
+          ndx   = cache - fs->fs_cache;
+          if (ndx + nsectors > CONFIG_FAT_SECTORCACHE_NSECTORS)
+            {
+              ndx = CONFIG_FAT_SECTORCACHE_NSECTORS - nsectors;
+            }
+
+          for (i = 0; i < nsectors; i++)
+            {
+              ret = fat_cachewriteback(fs, &fs->fs_cache[ndx + i]);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              fs->fs_cache[ndx + i].fc_sector = -1;
+            }
+
+          ret = fat_hwread(fs, fs->fs_cache[ndx].fc_buffer, sector,
+                           nsectors);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          for (i = 0; i < nsectors; i++)
+            {
+              cache            = &fs->fs_cache[ndx + i];
+              cache->fc_sector = sector + i;
+              cache->fc_stamp  = fs->fs_cachestamp;
+            }
+
+          memcpy(fs->fs_buffer, fs->fs_cache[ndx].fc_buffer,
+                 fs->fs_hwsectorsize);
+
+          fat_cachestat(nsectors - 1, cs_readahead);
+          return OK;
+        }
+    }
+#endif
+
+  return fat_hwread(fs, fs->fs_buffer, sector, 1);
+}
+
+/****************************************************************************
+ * Name: fat_iscachemem
+ *
+ * Description:
+ *   Return true if the buffer is a cache entry.
+ *
+ ****************************************************************************/
+
+static inline bool fat_iscachemem(struct fat_mountpt_s *fs,
+                                  FAR uint8_t *buffer)
+{
+  return fs->fs_cachemem != NULL && buffer >= fs->fs_cachemem &&
+         buffer < fs->fs_cachemem + FAT_NCACHED * fs->fs_hwsectorsize;
+}
+
+/****************************************************************************
+ * Name: fat_cachecoherent
+ *
+ * Description:
+ *   Keep the cache coherent with a transfer that bypasses it.  Before a
+ *   read, dirty entries for the sectors are written back.  After a write,
+ *   the entries for the sectors are discarded.  The sector in fs_buffer is
+ *   not affected.
+ *
+ ****************************************************************************/
+
+static int fat_cachecoherent(struct fat_mountpt_s *fs, off_t sector,
+                             unsigned int nsectors, bool write)
+{
+  int ret;
+  int i;
+
+  for (i = 0; i < FAT_NCACHED; i++)
+    {
+      FAR struct fat_cache_s *cache = &fs->fs_cache[i];
+
+      if (cache->fc_sector >= sector &&
+          cache->fc_sector < sector + nsectors &&
+          cache->fc_sector != fs->fs_currentsector)
+        {
+          if (write)
+            {
+              cache->fc_sector = -1;
+              cache->fc_dirty  = false;
+            }
+          else
+            {
+              ret = fat_cachewriteback(fs, cache);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+        }
+    }
+
+  return OK;
+}
+#endif /* CONFIG_FAT_SECTORCACHE */
+
+/****************************************************************************
+ * Name: fat_discard
+ *
+ * Description:
+ *   Tell the block driver that a run of freed clusters no longer holds
+ *   useful data.  The FAT is written back first so that the clusters are
+ *   free on the media before their content is discarded.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_DISCARD
+static int fat_discard(struct fat_mountpt_s *fs, uint32_t cluster,
+                       uint32_t nclusters)
+{
+  FAR struct inode *inode = fs->fs_blkdriver;
+  struct discard_s discard;
+  off_t sector;
+  int ret;
+
+  sector = fat_cluster2sector(fs, cluster);
+  if (sector < 0)
+    {
+      return sector;
+    }
+
+  discard.startsector = sector;
+  discard.nsectors    = nclusters * fs->fs_fatsecperclus;
+
+#ifdef CONFIG_FAT_SECTORCACHE
+  /* Cached copies of the sectors must not be written back */
+
+  (void)fat_cachecoherent(fs, sector, discard.nsectors, true);
+#endif
+
+  ret = fat_fscacheflush(fs);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Discarding is only a hint.  Block drivers that do not support it just
+   * fail the ioctl.
+   */
+
+  if (inode && inode->u.i_bops && inode->u.i_bops->ioctl)
+    {
+      (void)inode->u.i_bops->ioctl(inode, BIOC_DISCARD,
+                                   (unsigned long)((uintptr_t)&discard));
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -549,12 +987,11 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   fs->fs_hwsectorsize = geo.geo_sectorsize;
   fs->fs_hwnsectors   = geo.geo_nsectors;
 
-  /* Allocate a buffer to hold one hardware sector */
+  /* Allocate a buffer to hold one hardware sector and the sector cache */
 
-  fs->fs_buffer = (FAR uint8_t *)fat_io_alloc(fs->fs_hwsectorsize);
-  if (!fs->fs_buffer)
+  ret = fat_fscacheinit(fs);
+  if (ret < 0)
     {
-      ret = -ENOMEM;
       goto errout;
     }
 
@@ -685,8 +1122,7 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   return OK;
 
 errout_with_buffer:
-  fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
-  fs->fs_buffer = 0;
+  fat_fscacherelease(fs);
 
 errout:
   fs->fs_mounted = false;
@@ -754,6 +1190,19 @@ int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
       struct inode *inode = fs->fs_blkdriver;
       if (inode && inode->u.i_bops && inode->u.i_bops->read)
         {
+#ifdef CONFIG_FAT_SECTORCACHE
+          /* Write back any newer data in the sector cache first */
+
+          if (!fat_iscachemem(fs, buffer))
+            {
+              ret = fat_cachecoherent(fs, sector, nsectors, false);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+#endif
+
           ssize_t nsectorsread = inode->u.i_bops->read(inode, buffer,
                                                        sector, nsectors);
           if (nsectorsread == nsectors)
@@ -798,6 +1247,15 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
             {
               ret = nsectorswritten;
             }
+
+#ifdef CONFIG_FAT_SECTORCACHE
+          /* Discard any older copies of the sectors in the sector cache */
+
+          if (!fat_iscachemem(fs, buffer))
+            {
+              (void)fat_cachecoherent(fs, sector, nsectors, true);
+            }
+#endif
         }
     }
 
@@ -1132,6 +1590,10 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
 int fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster)
 {
   int32_t nextcluster;
+#ifdef CONFIG_FAT_DISCARD
+  uint32_t runstart = 0;
+  uint32_t runlen   = 0;
+#endif
   int    ret;
 
   /* Loop while there are clusters in the chain */
@@ -1164,11 +1626,41 @@ int fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster)
           fs->fs_fsidirty = 1;
         }
 
+#ifdef CONFIG_FAT_DISCARD
+      /* Discard runs of consecutive clusters with a single request */
+
+      if (runlen > 0 && cluster == runstart + runlen)
+        {
+          runlen++;
+        }
+      else
+        {
+          if (runlen > 0)
+            {
+              ret = fat_discard(fs, runstart, runlen);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+
+          runstart = cluster;
+          runlen   = 1;
+        }
+#endif
+
       /* Then set up to remove the next cluster */
 
       cluster = nextcluster;
     }
 
+#ifdef CONFIG_FAT_DISCARD
+  if (runlen > 0)
+    {
+      return fat_discard(fs, runstart, runlen);
+    }
+#endif
+
   return OK;
 }
 
@@ -1768,16 +2260,98 @@ int fat_dirextend(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_fscacheinit
+ *
+ * Description:
+ *   Allocate fs_buffer and the sector cache of a volume.
+ *
+ ****************************************************************************/
+
+int fat_fscacheinit(struct fat_mountpt_s *fs)
+{
+#ifdef CONFIG_FAT_SECTORCACHE
+  int i;
+
+#endif
+  fs->fs_buffer = (FAR uint8_t *)fat_io_alloc(fs->fs_hwsectorsize);
+  if (!fs->fs_buffer)
+    {
+      return -ENOMEM;
+    }
+
+#ifdef CONFIG_FAT_SECTORCACHE
+  fs->fs_cachemem =
+    (FAR uint8_t *)fat_io_alloc(FAT_NCACHED * fs->fs_hwsectorsize);
+  if (!fs->fs_cachemem)
+    {
+      fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
+      fs->fs_buffer = NULL;
+      return -ENOMEM;
+    }
+
+  /* The entries of the cache are adjacent in memory so that read-ahead can
+   * fill several of them with one transfer.
+   */
+
+  for (i = 0; i < FAT_NCACHED; i++)
+    {
+      fs->fs_cache[i].fc_sector = -1;
+      fs->fs_cache[i].fc_stamp  = 0;
+      fs->fs_cache[i].fc_dirty  = false;
+      fs->fs_cache[i].fc_buffer = &fs->fs_cachemem[i * fs->fs_hwsectorsize];
+    }
+
+  fs->fs_cachestamp = 0;
+#endif
+
+  /* Nothing is held in fs_buffer yet */
+
+  fs->fs_currentsector = -1;
+  fs->fs_dirty         = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_fscacherelease
+ *
+ * Description:
+ *   Free the memory allocated by fat_fscacheinit().  Any dirty sectors are
+ *   discarded.
+ *
+ ****************************************************************************/
+
+void fat_fscacherelease(struct fat_mountpt_s *fs)
+{
+#ifdef CONFIG_FAT_SECTORCACHE
+  if (fs->fs_cachemem)
+    {
+      fat_io_free(fs->fs_cachemem, FAT_NCACHED * fs->fs_hwsectorsize);
+      fs->fs_cachemem = NULL;
+    }
+#endif
+
+  if (fs->fs_buffer)
+    {
+      fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
+      fs->fs_buffer = NULL;
+    }
+}
+
 /****************************************************************************
  * Name: fat_fscacheflush
  *
  * Description:
- *   Flush any dirty sector if fs_buffer as necessary
+ *   Flush any dirty sector if fs_buffer as necessary.  Dirty sectors in the
+ *   sector cache are written back as well.
  *
  ****************************************************************************/
 
 int fat_fscacheflush(struct fat_mountpt_s *fs)
 {
+#ifdef CONFIG_FAT_SECTORCACHE
+  int i;
+#endif
   int ret;
 
   /* Check if the fs_buffer is dirty.  In this case, we will write back the
@@ -1786,38 +2360,43 @@ int fat_fscacheflush(struct fat_mountpt_s *fs)
 
   if (fs->fs_dirty)
     {
-      /* Write the dirty sector */
+      /* Write the dirty sector (and its FAT copies) */
 
-      ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
+      ret = fat_writesector(fs, fs->fs_buffer, fs->fs_currentsector);
       if (ret < 0)
         {
           return ret;
         }
 
-      /* Does the sector lie in the FAT region? */
+      /* No longer dirty */
 
-      if (fs->fs_currentsector >= fs->fs_fatbase &&
-          fs->fs_currentsector < fs->fs_fatbase + fs->fs_nfatsects)
-        {
-          int i;
+      fs->fs_dirty = false;
+    }
 
-          /* Yes, then make the change in the FAT copy as well */
+#ifdef CONFIG_FAT_SECTORCACHE
+  for (i = 0; i < FAT_NCACHED; i++)
+    {
+      FAR struct fat_cache_s *cache = &fs->fs_cache[i];
 
-          for (i = fs->fs_fatnumfats; i >= 2; i--)
-            {
-              fs->fs_currentsector += fs->fs_nfatsects;
-              ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
-              if (ret < 0)
-                {
-                  return ret;
-                }
-            }
-        }
+      /* A cached copy of the sector in fs_buffer is stale.  Discard it:
+       * fs_currentsector may be changed without fat_cachesave(), and the
+       * old copy must not be found again after that.
+       */
 
-      /* No longer dirty */
+      if (cache->fc_sector == fs->fs_currentsector)
+        {
+          cache->fc_sector = -1;
+          cache->fc_dirty  = false;
+          continue;
+        }
 
-      fs->fs_dirty = false;
+      ret = fat_cachewriteback(fs, cache);
+      if (ret < 0)
+        {
+          return ret;
+        }
     }
+#endif
 
   return OK;
 }
@@ -1833,6 +2412,9 @@ int fat_fscacheflush(struct fat_mountpt_s *fs)
 
 int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
 {
+#ifdef CONFIG_FAT_SECTORCACHE
+  FAR struct fat_cache_s *cache;
+#endif
   int ret;
 
   /* fs->fs_currentsector holds the current sector that is buffered in
@@ -1842,6 +2424,42 @@ int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
 
   if (fs->fs_currentsector != sector)
     {
+#ifdef CONFIG_FAT_SECTORCACHE
+      /* Keep the current sector (dirty or not) in the sector cache */
+
+      ret = fat_cachesave(fs);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      fs->fs_cachestamp++;
+
+      /* Then get the requested sector from the cache or from the device */
+
+      cache = fat_cachefind(fs, sector);
+      if (cache != NULL)
+        {
+          /* fs_buffer becomes the owner of the most recent data */
+
+          memcpy(fs->fs_buffer, cache->fc_buffer, fs->fs_hwsectorsize);
+          fs->fs_dirty    = cache->fc_dirty;
+          cache->fc_dirty = false;
+          cache->fc_stamp = fs->fs_cachestamp;
+          fat_cachestat(1, cs_hits);
+        }
+      else
+        {
+          ret = fat_cachemiss(fs, sector);
+          if (ret < 0)
+            {
+              fs->fs_currentsector = -1;
+              return ret;
+            }
+
+          fat_cachestat(1, cs_misses);
+        }
+#else
       /* We will need to read the new sector.  First, flush the cached
        * sector if it is dirty.
        */
@@ -1859,11 +2477,18 @@ int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
         {
           return ret;
         }
+#endif
 
       /* Update the cached sector number */
 
       fs->fs_currentsector = sector;
     }
+#ifdef FAT_CACHESTATS
+  else
+    {
+      fat_cachestat(1, cs_hits);
+    }
+#endif
 
   return OK;
 }
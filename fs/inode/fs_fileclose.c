@@ -80,6 +80,10 @@ int file_close(FAR struct file *filep)
 
   if (inode)
     {
+      /* Remove any epoll registrations before the driver forgets them */
+
+      epoll_fdclose(filep);
+
       /* Close the file, driver, or mountpoint. */
 
       if (inode->u.i_ops && inode->u.i_ops->close)
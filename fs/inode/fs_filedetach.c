@@ -142,6 +142,10 @@ int file_detach(int fd, FAR struct file *filep)
       return -EBADF;
     }
 
+  /* The descriptor goes away, so do its epoll registrations */
+
+  epoll_fdclose(parent);
+
   /* Duplicate the 'struct file' content into the user-provided file
    * structure.
    */
@@ -0,0 +1,503 @@
+/****************************************************************************
+ * fs/inode/fs_inodecache.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_INODE_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Values for the ic_flags field */
+
+#define ICACHE_FLAG_PSEUDO   (1 << 0) /* Entry describes a pseudo-fs lookup */
+#define ICACHE_FLAG_MOUNTPT  (1 << 1) /* Entry describes a volume lookup */
+#define ICACHE_FLAG_NEGATIVE (1 << 2) /* The name does not exist */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes the cached outcome of looking up one path
+ * segment.  Pseudo-file system entries are keyed on the parent inode (NULL
+ * for the top level) and remain valid only as long as ic_gen matches the
+ * current generation.  Mountpoint entries are keyed on the private data of
+ * the mounted volume plus a file system specific directory location and
+ * remain valid until they are flushed explicitly.
+ */
+
+struct inode_cache_s
+{
+  FAR const void *ic_parent;          /* Parent inode or volume */
+  off_t ic_dir;                       /* Directory location in volume */
+  uint32_t ic_gen;                    /* Pseudo-fs generation */
+  uint8_t ic_flags;                   /* See ICACHE_FLAG_* definitions */
+  uint8_t ic_namelen;                 /* Length of ic_name */
+  char ic_name[CONFIG_FS_INODE_CACHE_NAMELEN];
+  union
+  {
+    struct
+    {
+      FAR struct inode *node;         /* The matching inode */
+      FAR struct inode *peer;         /* The inode to the "left" */
+    } ic_pseudo;
+    uint8_t ic_data[INODE_CACHE_DATALEN];
+  } u;
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef INODE_CACHESTATS
+struct inode_cachestats_s g_inodecachestats;
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct inode_cache_s g_inodecache[CONFIG_FS_INODE_CACHE_NENTRIES];
+
+/* The current pseudo-file system generation.  This is incremented each
+ * time that the shape of the inode tree changes.
+ */
+
+static uint32_t g_inodecache_gen = 1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_namelen
+ *
+ * Description:
+ *   Return the length of the path segment at 'name'.
+ *
+ ****************************************************************************/
+
+static size_t inode_cache_namelen(FAR const char *name)
+{
+  FAR const char *tmp = name;
+
+  while (*tmp != '\0' && *tmp != '/')
+    {
+      tmp++;
+    }
+
+  return tmp - name;
+}
+
+/****************************************************************************
+ * Name: inode_cache_hash
+ *
+ * Description:
+ *   Select the cache entry for a lookup (FNV-1a over the key).
+ *
+ ****************************************************************************/
+
+static FAR struct inode_cache_s *
+inode_cache_hash(FAR const void *parent, off_t dir, FAR const char *name,
+                 size_t namelen)
+{
+  uint32_t hash = 2166136261ul;
+
+  hash = (hash ^ (uint32_t)(uintptr_t)parent) * 16777619ul;
+  hash = (hash ^ (uint32_t)dir) * 16777619ul;
+
+  while (namelen-- > 0)
+    {
+      hash = (hash ^ (uint8_t)*name++) * 16777619ul;
+    }
+
+  return &g_inodecache[hash % CONFIG_FS_INODE_CACHE_NENTRIES];
+}
+
+/****************************************************************************
+ * Name: inode_cache_match
+ *
+ * Description:
+ *   Return true if the entry holds the lookup of 'name' in 'parent'.
+ *
+ ****************************************************************************/
+
+static bool inode_cache_match(FAR struct inode_cache_s *entry,
+                              uint8_t type, FAR const void *parent,
+                              off_t dir, FAR const char *name,
+                              size_t namelen)
+{
+  return (entry->ic_flags & type) != 0 &&
+         entry->ic_parent == parent && entry->ic_dir == dir &&
+         entry->ic_namelen == namelen &&
+         memcmp(entry->ic_name, name, namelen) == 0;
+}
+
+/****************************************************************************
+ * Name: inode_cache_fill
+ *
+ * Description:
+ *   Replace the contents of an entry with a new lookup.
+ *
+ ****************************************************************************/
+
+static void inode_cache_fill(FAR struct inode_cache_s *entry, uint8_t flags,
+                             FAR const void *parent, off_t dir,
+                             FAR const char *name, size_t namelen)
+{
+  entry->ic_parent  = parent;
+  entry->ic_dir     = dir;
+  entry->ic_gen     = g_inodecache_gen;
+  entry->ic_flags   = flags;
+  entry->ic_namelen = namelen;
+  memcpy(entry->ic_name, name, namelen);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up the outcome of a previous search for the path segment 'name'
+ *   among the children of 'parent' (NULL for the top level of the inode
+ *   tree).  On a hit, *node receives the matching inode (or NULL if the
+ *   name is known not to exist) and *peer the inode to its "left".
+ *
+ * Returned Value:
+ *   true on a cache hit; false if the peer list must be searched.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+bool inode_cache_lookup(FAR struct inode *parent, FAR const char *name,
+                        FAR struct inode **node, FAR struct inode **peer)
+{
+  FAR struct inode_cache_s *entry;
+  irqstate_t flags;
+  size_t namelen;
+  bool hit = false;
+
+  namelen = inode_cache_namelen(name);
+  if (namelen > CONFIG_FS_INODE_CACHE_NAMELEN)
+    {
+      return false;
+    }
+
+  entry = inode_cache_hash(parent, 0, name, namelen);
+
+  flags = enter_critical_section();
+  if (inode_cache_match(entry, ICACHE_FLAG_PSEUDO, parent, 0, name,
+                        namelen) &&
+      entry->ic_gen == g_inodecache_gen)
+    {
+      *node = entry->u.ic_pseudo.node;
+      *peer = entry->u.ic_pseudo.peer;
+      hit   = true;
+    }
+
+#ifdef INODE_CACHESTATS
+  if (!hit)
+    {
+      g_inodecachestats.cs_misses++;
+    }
+  else if (*node == NULL)
+    {
+      g_inodecachestats.cs_neghits++;
+    }
+  else
+    {
+      g_inodecachestats.cs_hits++;
+    }
+#endif
+
+  leave_critical_section(flags);
+  return hit;
+}
+
+/****************************************************************************
+ * Name: inode_cache_add
+ *
+ * Description:
+ *   Remember the outcome of searching for the path segment 'name' among the
+ *   children of 'parent'.  'node' is NULL if there is no such inode.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+void inode_cache_add(FAR struct inode *parent, FAR const char *name,
+                     FAR struct inode *node, FAR struct inode *peer)
+{
+  FAR struct inode_cache_s *entry;
+  irqstate_t flags;
+  size_t namelen;
+  uint8_t type;
+
+  namelen = inode_cache_namelen(name);
+  if (namelen > CONFIG_FS_INODE_CACHE_NAMELEN)
+    {
+      return;
+    }
+
+  type  = ICACHE_FLAG_PSEUDO;
+  if (node == NULL)
+    {
+      type |= ICACHE_FLAG_NEGATIVE;
+    }
+
+  entry = inode_cache_hash(parent, 0, name, namelen);
+
+  flags = enter_critical_section();
+  inode_cache_fill(entry, type, parent, 0, name, namelen);
+  entry->u.ic_pseudo.node = node;
+  entry->u.ic_pseudo.peer = peer;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: inode_cache_flush
+ *
+ * Description:
+ *   Invalidate all pseudo-file system entries.  This must be called
+ *   whenever an inode is linked into or unlinked from the inode tree.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+void inode_cache_flush(void)
+{
+  irqstate_t flags;
+  int i;
+
+  flags = enter_critical_section();
+
+  /* Entries are invalidated simply by changing the generation.  Only on the
+   * (very rare) wrap-around must the stale entries actually be discarded.
+   */
+
+  if (++g_inodecache_gen == 0)
+    {
+      for (i = 0; i < CONFIG_FS_INODE_CACHE_NENTRIES; i++)
+        {
+          if ((g_inodecache[i].ic_flags & ICACHE_FLAG_PSEUDO) != 0)
+            {
+              g_inodecache[i].ic_flags = 0;
+            }
+        }
+
+      g_inodecache_gen = 1;
+    }
+
+#ifdef INODE_CACHESTATS
+  g_inodecachestats.cs_flushes++;
+#endif
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: inode_cache_mntlookup
+ *
+ * Description:
+ *   Look up the outcome of a previous search for the path segment 'name'
+ *   of length 'namelen' in the directory at location 'dir' of a mounted
+ *   volume.  'volume' is the private data of the mountpoint.  On a
+ *   positive hit, the 'datalen' bytes of file system specific data that
+ *   were provided to inode_cache_mntadd() are copied to 'data'.
+ *
+ * Returned Value:
+ *   OK if the entry exists, -ENOENT if the entry is known not to exist, or
+ *   -ENODATA if the directory must be searched.
+ *
+ * Assumptions:
+ *   The caller holds the volume lock.
+ *
+ ****************************************************************************/
+
+int inode_cache_mntlookup(FAR const void *volume, off_t dir,
+                          FAR const char *name, size_t namelen,
+                          FAR void *data, size_t datalen)
+{
+  FAR struct inode_cache_s *entry;
+  irqstate_t flags;
+  int ret = -ENODATA;
+
+  DEBUGASSERT(volume != NULL && datalen <= INODE_CACHE_DATALEN);
+
+  if (namelen > CONFIG_FS_INODE_CACHE_NAMELEN)
+    {
+      return -ENODATA;
+    }
+
+  entry = inode_cache_hash(volume, dir, name, namelen);
+
+  flags = enter_critical_section();
+  if (inode_cache_match(entry, ICACHE_FLAG_MOUNTPT, volume, dir, name,
+                        namelen))
+    {
+      if ((entry->ic_flags & ICACHE_FLAG_NEGATIVE) != 0)
+        {
+          ret = -ENOENT;
+        }
+      else
+        {
+          memcpy(data, entry->u.ic_data, datalen);
+          ret = OK;
+        }
+    }
+
+#ifdef INODE_CACHESTATS
+  if (ret == OK)
+    {
+      g_inodecachestats.cs_hits++;
+    }
+  else if (ret == -ENOENT)
+    {
+      g_inodecachestats.cs_neghits++;
+    }
+  else
+    {
+      g_inodecachestats.cs_misses++;
+    }
+#endif
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: inode_cache_mntadd
+ *
+ * Description:
+ *   Remember the outcome of searching for the path segment 'name' in the
+ *   directory at location 'dir' of a mounted volume.  'data' is NULL if
+ *   the entry does not exist.
+ *
+ * Assumptions:
+ *   The caller holds the volume lock.
+ *
+ ****************************************************************************/
+
+void inode_cache_mntadd(FAR const void *volume, off_t dir,
+                        FAR const char *name, size_t namelen,
+                        FAR const void *data, size_t datalen)
+{
+  FAR struct inode_cache_s *entry;
+  irqstate_t flags;
+  uint8_t type;
+
+  DEBUGASSERT(volume != NULL && datalen <= INODE_CACHE_DATALEN);
+
+  if (namelen > CONFIG_FS_INODE_CACHE_NAMELEN)
+    {
+      return;
+    }
+
+  type  = ICACHE_FLAG_MOUNTPT;
+  if (data == NULL)
+    {
+      type |= ICACHE_FLAG_NEGATIVE;
+    }
+
+  entry = inode_cache_hash(volume, dir, name, namelen);
+
+  flags = enter_critical_section();
+  inode_cache_fill(entry, type, volume, dir, name, namelen);
+  if (data != NULL)
+    {
+      memcpy(entry->u.ic_data, data, datalen);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: inode_cache_mntflush
+ *
+ * Description:
+ *   Discard all entries that belong to a mounted volume.  This must be
+ *   called whenever the namespace of the volume changes (rename, unlink,
+ *   creation of files or directories) and when the volume is unmounted.
+ *
+ ****************************************************************************/
+
+void inode_cache_mntflush(FAR const void *volume)
+{
+  irqstate_t flags;
+  int i;
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_FS_INODE_CACHE_NENTRIES; i++)
+    {
+      if ((g_inodecache[i].ic_flags & ICACHE_FLAG_MOUNTPT) != 0 &&
+          g_inodecache[i].ic_parent == volume)
+        {
+          g_inodecache[i].ic_flags = 0;
+        }
+    }
+
+#ifdef INODE_CACHESTATS
+  g_inodecachestats.cs_flushes++;
+#endif
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_FS_INODE_CACHE */
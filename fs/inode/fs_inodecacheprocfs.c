@@ -0,0 +1,313 @@
+/****************************************************************************
+ * fs/inode/fs_inodecacheprocfs.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "inode/inode.h"
+
+#ifdef INODE_CACHESTATS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define ICSTATS_LINELEN 160
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct icstats_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  char line[ICSTATS_LINELEN];     /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     icstats_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     icstats_close(FAR struct file *filep);
+static ssize_t icstats_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     icstats_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     icstats_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_procfs.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations inodecache_procfsoperations =
+{
+  icstats_open,   /* open */
+  icstats_close,  /* close */
+  icstats_read,   /* read */
+  NULL,           /* write */
+  icstats_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  icstats_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: icstats_open
+ ****************************************************************************/
+
+static int icstats_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct icstats_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "fs/inodecache" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "fs/inodecache") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct icstats_file_s *)
+    kmm_zalloc(sizeof(struct icstats_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: icstats_close
+ ****************************************************************************/
+
+static int icstats_close(FAR struct file *filep)
+{
+  FAR struct icstats_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct icstats_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: icstats_read
+ ****************************************************************************/
+
+static ssize_t icstats_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct icstats_file_s *icfile;
+  struct inode_cachestats_s stats;
+  unsigned long total;
+  unsigned long rate;
+  size_t linesize;
+  off_t offset;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  icfile = (FAR struct icstats_file_s *)filep->f_priv;
+  DEBUGASSERT(icfile);
+
+  /* Take a snapshot of the statistics and calculate the hit rate in
+   * percent.  Negative hits count as hits.
+   */
+
+  stats = g_inodecachestats;
+  total = (unsigned long)stats.cs_hits + stats.cs_neghits + stats.cs_misses;
+  rate  = total > 0 ?
+          (100ul * (stats.cs_hits + stats.cs_neghits)) / total : 0;
+
+  linesize = snprintf(icfile->line, ICSTATS_LINELEN,
+                      "Hits:       %10lu\n"
+                      "Neg hits:   %10lu\n"
+                      "Misses:     %10lu\n"
+                      "Hit rate:   %9lu%%\n"
+                      "Flushes:    %10lu\n",
+                      (unsigned long)stats.cs_hits,
+                      (unsigned long)stats.cs_neghits,
+                      (unsigned long)stats.cs_misses, rate,
+                      (unsigned long)stats.cs_flushes);
+
+  if (linesize >= ICSTATS_LINELEN)
+    {
+      linesize = ICSTATS_LINELEN - 1;
+    }
+
+  buflen = procfs_memcpy(icfile->line, linesize, buffer, buflen, &offset);
+  if (buflen > 0)
+    {
+      filep->f_pos += buflen;
+    }
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: icstats_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int icstats_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct icstats_file_s *oldattr;
+  FAR struct icstats_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct icstats_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct icstats_file_s *)
+    kmm_malloc(sizeof(struct icstats_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct icstats_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: icstats_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int icstats_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "fs/inodecache" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "fs/inodecache") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "fs/inodecache" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* INODE_CACHESTATS */
@@ -117,6 +117,10 @@ FAR struct inode *inode_unlink(FAR const char *path)
         }
 
       node->i_peer = NULL;
+
+      /* Cached look-ups no longer describe the inode tree */
+
+      inode_cache_flush();
     }
 
   RELEASE_SEARCH(&desc);
@@ -135,6 +135,10 @@ static void inode_insert(FAR struct inode *node,
       node->i_peer = g_root_inode;
       g_root_inode = node;
     }
+
+  /* Cached look-ups no longer describe the inode tree */
+
+  inode_cache_flush();
 }
 
 /****************************************************************************
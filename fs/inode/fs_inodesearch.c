@@ -54,6 +54,10 @@
  ****************************************************************************/
 
 static int _inode_compare(FAR const char *fname, FAR struct inode *node);
+static FAR struct inode *_inode_findpeer(FAR struct inode *above,
+                                         FAR struct inode *node,
+                                         FAR const char *name,
+                                         FAR struct inode **left);
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
 static int _inode_linktarget(FAR struct inode *node,
                              FAR struct inode_search_s *desc);
@@ -146,6 +150,81 @@ static int _inode_compare(FAR const char *fname, FAR struct inode *node)
     }
 }
 
+/****************************************************************************
+ * Name: _inode_findpeer
+ *
+ * Description:
+ *   Search the ordered list of peers that begins with 'node' (the children
+ *   of 'above') for the inode that matches the path segment 'name'.  The
+ *   inode to the "left" of the match (or of the place where the match would
+ *   be inserted) is returned in 'left'.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+static FAR struct inode *_inode_findpeer(FAR struct inode *above,
+                                         FAR struct inode *node,
+                                         FAR const char *name,
+                                         FAR struct inode **left)
+{
+  FAR struct inode *peer = NULL;
+
+#ifdef CONFIG_FS_INODE_CACHE
+  /* Has this segment been looked up since the tree last changed? */
+
+  if (inode_cache_lookup(above, name, &node, left))
+    {
+      return node;
+    }
+#endif
+
+  while (node != NULL)
+    {
+      int result = _inode_compare(name, node);
+
+      /* Case 1:  The name is less than the name of the node.
+       * Since the names are ordered, these means that there
+       * is no peer node with this name and that there can be
+       * no match in the filesystem.
+       */
+
+      if (result < 0)
+        {
+          node = NULL;
+          break;
+        }
+
+      /* Case 2: the name is greater than the name of the node.
+       * In this case, the name may still be in the list to the
+       * "right"
+       */
+
+      else if (result > 0)
+        {
+          /* Continue looking to the "right" of this inode. */
+
+          peer = node;
+          node = node->i_peer;
+        }
+
+      /* The names match */
+
+      else
+        {
+          break;
+        }
+    }
+
+#ifdef CONFIG_FS_INODE_CACHE
+  inode_cache_add(above, name, node, peer);
+#endif
+
+  *left = peer;
+  return node;
+}
+
 /****************************************************************************
  * Name: _inode_linktarget
  *
@@ -280,129 +359,105 @@ static int _inode_search(FAR struct inode_search_s *desc)
 
   while (node != NULL)
     {
-      int result = _inode_compare(name, node);
-
-      /* Case 1:  The name is less than the name of the node.
-       * Since the names are ordered, these means that there
-       * is no peer node with this name and that there can be
-       * no match in the filesystem.
-       */
+      /* Find the inode that matches this segment among the peers */
 
-      if (result < 0)
+      node = _inode_findpeer(above, node, name, &left);
+      if (node == NULL)
         {
-          node = NULL;
           break;
         }
 
-      /* Case 2: the name is greater than the name of the node.
-       * In this case, the name may still be in the list to the
-       * "right"
+      /* Now there are three remaining possibilities:
+       *   (1) This is the node that we are looking for.
+       *   (2) The node we are looking for is "below" this one.
+       *   (3) This node is a mountpoint and will absorb all requests
+       *       below this one
        */
 
-      else if (result > 0)
+      name = inode_nextname(name);
+      if (*name == '\0' || INODE_IS_MOUNTPT(node))
         {
-          /* Continue looking to the "right" of this inode. */
+          /* Either (1) we are at the end of the path, so this must be
+           * the node we are looking for or else (2) this node is a
+           * mountpoint and will handle the remaining part of the
+           * pathname
+           */
 
-          left = node;
-          node = node->i_peer;
+          relpath = name;
+          ret = OK;
+          break;
         }
-
-      /* The names match */
-
       else
         {
-          /* Now there are three remaining possibilities:
-           *   (1) This is the node that we are looking for.
-           *   (2) The node we are looking for is "below" this one.
-           *   (3) This node is a mountpoint and will absorb all requests
-           *       below this one
-           */
+          /* More nodes to be examined in the path "below" this one. */
 
-          name = inode_nextname(name);
-          if (*name == '\0' || INODE_IS_MOUNTPT(node))
-            {
-              /* Either (1) we are at the end of the path, so this must be
-               * the node we are looking for or else (2) this node is a
-               * mountpoint and will handle the remaining part of the
-               * pathname
-               */
+#ifdef CONFIG_PSEUDOFS_SOFTLINKS
+          /* Was the node a soft link?  If so, then we need need to
+           * continue below the target of the link, not the link itself.
+           */
 
-              relpath = name;
-              ret = OK;
-              break;
-            }
-          else
+          if (INODE_IS_SOFTLINK(node))
             {
-              /* More nodes to be examined in the path "below" this one. */
+              int status;
 
-#ifdef CONFIG_PSEUDOFS_SOFTLINKS
-              /* Was the node a soft link?  If so, then we need need to
-               * continue below the target of the link, not the link itself.
+              /* If this intermediate inode in the is a soft link, then
+               * (1) get the name of the full path of the soft link, (2)
+               * recursively look-up the inode referenced by the soft
+               * link, and (3) continue searching with that inode instead.
                */
 
-              if (INODE_IS_SOFTLINK(node))
+              status = _inode_linktarget(node, desc);
+              if (status < 0)
                 {
-                  int status;
-
-                  /* If this intermediate inode in the is a soft link, then
-                   * (1) get the name of the full path of the soft link, (2)
-                   * recursively look-up the inode referenced by the soft
-                   * link, and (3) continue searching with that inode instead.
+                  /* Probably means that the target of the symbolic link
+                   * does not exist.
                    */
 
-                  status = _inode_linktarget(node, desc);
-                  if (status < 0)
+                  ret = status;
+                  break;
+                }
+              else
+                {
+                  FAR struct inode *newnode = desc->node;
+
+                  if (newnode != node)
                     {
-                      /* Probably means that the target of the symbolic link
-                       * does not exist.
+                      /* The node was a valid symbolic link and we have
+                       * jumped to a different, spot in the pseudo file
+                       * system tree.
                        */
 
-                      ret = status;
-                      break;
-                    }
-                  else
-                    {
-                      FAR struct inode *newnode = desc->node;
+                      /* Check if this took us to a mountpoint. */
 
-                      if (newnode != node)
+                      if (INODE_IS_MOUNTPT(newnode))
                         {
-                          /* The node was a valid symbolic link and we have
-                           * jumped to a different, spot in the pseudo file
-                           * system tree.
+                          /* Return the mountpoint information.
+                           * NOTE that the last path to the link target
+                           * was already set by _inode_linktarget().
                            */
 
-                          /* Check if this took us to a mountpoint. */
+                          node    = newnode;
+                          above   = NULL;
+                          left    = NULL;
+                          relpath = name;
 
-                          if (INODE_IS_MOUNTPT(newnode))
-                            {
-                              /* Return the mountpoint information.
-                               * NOTE that the last path to the link target
-                               * was already set by _inode_linktarget().
-                               */
-
-                              node    = newnode;
-                              above   = NULL;
-                              left    = NULL;
-                              relpath = name;
-
-                              ret     = OK;
-                              break;
-                            }
+                          ret     = OK;
+                          break;
+                        }
 
-                          /* Continue from this new inode. */
+                      /* Continue from this new inode. */
 
-                          node = newnode;
-                        }
+                      node = newnode;
                     }
                 }
+            }
 #endif
 
-              /* Keep looking at the next level "down" */
+          /* Keep looking at the next level "down" */
 
-              above = node;
-              left  = NULL;
-              node  = node->i_child;
-            }
+          above = node;
+          left  = NULL;
+          node  = node->i_child;
         }
     }
 
@@ -95,6 +95,22 @@
 
 #endif
 
+#ifdef CONFIG_FS_INODE_CACHE
+/* Maximum size of the file system specific data that may be attached to a
+ * cached lookup in a mounted volume.
+ */
+
+#  define INODE_CACHE_DATALEN 24
+
+#  if defined(CONFIG_FS_PROCFS) && \
+      !defined(CONFIG_FS_PROCFS_EXCLUDE_INODECACHE)
+#    define INODE_CACHESTATS 1
+#  endif
+#else
+#  define inode_cache_flush()
+#  define inode_cache_mntflush(v)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -150,6 +166,18 @@ typedef int (*foreach_inode_t)(FAR struct inode *node,
                                FAR char dirpath[PATH_MAX],
                                FAR void *arg);
 
+#ifdef INODE_CACHESTATS
+/* Path lookup cache statistics (see /proc/fs/inodecache) */
+
+struct inode_cachestats_s
+{
+  uint32_t cs_hits;                  /* Answered by a positive entry */
+  uint32_t cs_neghits;               /* Answered by a negative entry */
+  uint32_t cs_misses;                /* Had to search */
+  uint32_t cs_flushes;               /* Number of invalidations */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -165,6 +193,10 @@ extern "C"
 
 EXTERN FAR struct inode *g_root_inode;
 
+#ifdef INODE_CACHESTATS
+EXTERN struct inode_cachestats_s g_inodecachestats;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -424,6 +456,103 @@ int files_close(int fd);
 
 void files_release(int fd);
 
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up the outcome of a previous search for the path segment 'name'
+ *   among the children of 'parent' (NULL for the top level of the inode
+ *   tree).  On a hit, *node receives the matching inode (or NULL if the
+ *   name is known not to exist) and *peer the inode to its "left".
+ *
+ * Returned Value:
+ *   true on a cache hit; false if the peer list must be searched.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_CACHE
+bool inode_cache_lookup(FAR struct inode *parent, FAR const char *name,
+                        FAR struct inode **node, FAR struct inode **peer);
+
+/****************************************************************************
+ * Name: inode_cache_add
+ *
+ * Description:
+ *   Remember the outcome of searching for the path segment 'name' among the
+ *   children of 'parent'.  'node' is NULL if there is no such inode.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+void inode_cache_add(FAR struct inode *parent, FAR const char *name,
+                     FAR struct inode *node, FAR struct inode *peer);
+
+/****************************************************************************
+ * Name: inode_cache_flush
+ *
+ * Description:
+ *   Invalidate all pseudo-file system entries.  This must be called
+ *   whenever an inode is linked into or unlinked from the inode tree.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+void inode_cache_flush(void);
+
+/****************************************************************************
+ * Name: inode_cache_mntlookup
+ *
+ * Description:
+ *   Look up the outcome of a previous search for the path segment 'name'
+ *   of length 'namelen' in the directory at location 'dir' of a mounted
+ *   volume.  'volume' is the private data of the mountpoint.  On a
+ *   positive hit, the 'datalen' bytes of file system specific data that
+ *   were provided to inode_cache_mntadd() are copied to 'data'.
+ *
+ * Returned Value:
+ *   OK if the entry exists, -ENOENT if the entry is known not to exist, or
+ *   -ENODATA if the directory must be searched.
+ *
+ ****************************************************************************/
+
+int inode_cache_mntlookup(FAR const void *volume, off_t dir,
+                          FAR const char *name, size_t namelen,
+                          FAR void *data, size_t datalen);
+
+/****************************************************************************
+ * Name: inode_cache_mntadd
+ *
+ * Description:
+ *   Remember the outcome of searching for the path segment 'name' in the
+ *   directory at location 'dir' of a mounted volume.  'data' is NULL if
+ *   the entry does not exist.
+ *
+ ****************************************************************************/
+
+void inode_cache_mntadd(FAR const void *volume, off_t dir,
+                        FAR const char *name, size_t namelen,
+                        FAR const void *data, size_t datalen);
+
+/****************************************************************************
+ * Name: inode_cache_mntflush
+ *
+ * Description:
+ *   Discard all entries that belong to a mounted volume.  This must be
+ *   called whenever the namespace of the volume changes (rename, unlink,
+ *   creation of files or directories) and when the volume is unmounted.
+ *
+ ****************************************************************************/
+
+void inode_cache_mntflush(FAR const void *volume);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
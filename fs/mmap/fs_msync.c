@@ -0,0 +1,262 @@
+/****************************************************************************
+ * fs/mmap/fs_msync.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+
+#include <stdint.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+#include "fs_rammap.h"
+
+#ifdef CONFIG_FS_RAMMAP
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: msync_writeback
+ *
+ * Description:
+ *   Write part of a memory region back to the file that backs it.  Only the
+ *   part of the region that was loaded from the file is written:  The
+ *   zeroed tail beyond the end of the file never extends the file.
+ *
+ ****************************************************************************/
+
+static int msync_writeback(FAR struct fs_rammap_s *map, size_t offset,
+                           size_t length)
+{
+  FAR const uint8_t *wrbuffer;
+  ssize_t nwritten;
+  off_t fpos;
+
+  if (offset >= map->nvalid)
+    {
+      return OK;
+    }
+
+  if (offset + length > map->nvalid)
+    {
+      length = map->nvalid - offset;
+    }
+
+  fpos = file_seek(&map->file, map->offset + offset, SEEK_SET);
+  if (fpos < 0)
+    {
+      ferr("ERROR: Seek to position %d failed\n",
+           (int)(map->offset + offset));
+      return (int)fpos;
+    }
+
+  wrbuffer = (FAR const uint8_t *)map->addr + offset;
+  while (length > 0)
+    {
+      nwritten = file_write(&map->file, wrbuffer, length);
+      if (nwritten < 0)
+        {
+          if (nwritten != -EINTR)
+            {
+              ferr("ERROR: Write failed: offset=%d errno=%d\n",
+                   (int)(map->offset + offset), (int)nwritten);
+              return (int)nwritten;
+            }
+
+          continue;
+        }
+      else if (nwritten == 0)
+        {
+          /* Nothing could be written (e.g., the media is full).  Trying
+           * again would never finish.
+           */
+
+          ferr("ERROR: Write failed: offset=%d no space\n",
+               (int)(map->offset + offset));
+          return -ENOSPC;
+        }
+
+      wrbuffer += nwritten;
+      length   -= nwritten;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: msync
+ *
+ * Description:
+ *   Synchronize a memory mapped region with the file that backs it.
+ *
+ *   Only the RAM copies created when CONFIG_FS_RAMMAP is defined need to be
+ *   synchronized.  Mappings of files that are directly accessible in memory
+ *   (see mmap()) are never copied and are not known to msync().
+ *
+ * Input Parameters:
+ *   addr    The address within a mapped region of the first byte to
+ *           synchronize.
+ *   length  The number of bytes to synchronize.  The range is clipped to
+ *           the end of the region.
+ *   flags   One of MS_ASYNC or MS_SYNC, optionally OR'ed with
+ *           MS_INVALIDATE:
+ *           MS_ASYNC       - Write the modified range back to the file
+ *           MS_SYNC        - Write the modified range back to the file and
+ *                            flush the file to the media
+ *           MS_INVALIDATE  - Reload the range from the file after any
+ *                            write back
+ *
+ * Returned Value:
+ *   On success, msync() returns 0, on failure -1, and errno is set
+ *   appropriately.
+ *
+ *     EINVAL
+ *       'flags' is invalid.
+ *     ENOMEM
+ *       'addr' does not lie within a mapped region.
+ *
+ ****************************************************************************/
+
+int msync(FAR void *addr, size_t length, int flags)
+{
+  FAR struct fs_rammap_s *curr;
+  size_t offset;
+  int errcode;
+  int ret;
+
+  if ((flags & ~(MS_ASYNC | MS_SYNC | MS_INVALIDATE)) != 0 ||
+      (flags & (MS_ASYNC | MS_SYNC)) == (MS_ASYNC | MS_SYNC))
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  rammap_initialize();
+  ret = nxsem_wait(&g_rammaps.exclsem);
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout;
+    }
+
+  /* Find the region containing this address */
+
+  for (curr = g_rammaps.head; curr != NULL; curr = curr->flink)
+    {
+      if ((uintptr_t)addr >= (uintptr_t)curr->addr &&
+          (uintptr_t)addr < (uintptr_t)curr->addr + curr->length)
+        {
+          break;
+        }
+    }
+
+  if (curr == NULL)
+    {
+      ferr("ERROR: Region not found\n");
+      errcode = ENOMEM;
+      goto errout_with_semaphore;
+    }
+
+  offset = (uintptr_t)addr - (uintptr_t)curr->addr;
+  if (length > curr->length - offset)
+    {
+      length = curr->length - offset;
+    }
+
+  /* Write the range back if the file was opened for writing.  Otherwise
+   * the mapping is effectively read-only and there is nothing to do.
+   */
+
+  if ((flags & (MS_ASYNC | MS_SYNC)) != 0 &&
+      (curr->file.f_oflags & O_WROK) != 0)
+    {
+      ret = msync_writeback(curr, offset, length);
+      if (ret >= 0 && (flags & MS_SYNC) != 0)
+        {
+          ret = file_fsync(&curr->file);
+          if (ret == -EINVAL)
+            {
+              /* The file has no sync method; the data is already there */
+
+              ret = OK;
+            }
+        }
+
+      if (ret < 0)
+        {
+          errcode = -ret;
+          goto errout_with_semaphore;
+        }
+    }
+
+  /* Reload the range so that it reflects the current file content */
+
+  if ((flags & MS_INVALIDATE) != 0)
+    {
+      ret = rammap_read(curr, offset, length);
+      if (ret < 0)
+        {
+          errcode = -ret;
+          goto errout_with_semaphore;
+        }
+    }
+
+  nxsem_post(&g_rammaps.exclsem);
+  return OK;
+
+errout_with_semaphore:
+  nxsem_post(&g_rammaps.exclsem);
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+}
+
+#endif /* CONFIG_FS_RAMMAP */
@@ -48,6 +48,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
 
 #include "inode/inode.h"
 #include "fs_rammap.h"
@@ -93,14 +94,17 @@
  *   2. If CONFIG_FS_RAMMAP is defined in the configuration, then mmap() will
  *      support simulation of memory mapped files by copying files whole
  *      into RAM.  munmap() is required in this case to free the allocated
- *      memory holding the shared copy of the file.
+ *      memory holding the shared copy of the file.  The copy is shared by
+ *      all mappings of the file and is freed only when the last of them
+ *      is unmapped.
  *
  * Input Parameters:
- *   start   The start address of the mapping to delete.  For this
- *           simplified munmap() implementation, the *must* be the start
- *           address of the memory region (the same address returned by
- *           mmap()).
- *   length  The length region to be umapped.
+ *   start   The start address of the range to unmap.  This must be the
+ *           address returned by mmap() (to remove the whole mapping) or an
+ *           address within that mapping (to remove its tail).
+ *   length  The length of the range to be umapped.  The range must extend
+ *           to the end of the mapping:  Only the tail of a mapping can be
+ *           removed.
  *
  * Returned Value:
  *   On success, munmap() returns 0, on failure -1, and errno is set
@@ -110,10 +114,16 @@
 
 int munmap(FAR void *start, size_t length)
 {
+  FAR struct fs_mapping_s **pmapping;
+  FAR struct fs_mapping_s *mapping;
+  FAR struct fs_mapping_s *next;
   FAR struct fs_rammap_s *prev;
   FAR struct fs_rammap_s *curr;
   FAR void *newaddr;
-  unsigned int offset;
+  uintptr_t begin;
+  uintptr_t end;
+  size_t maxend;
+  int best;
   int ret;
   int errcode;
 
@@ -123,58 +133,96 @@ int munmap(FAR void *start, size_t length)
   ret = nxsem_wait(&g_rammaps.exclsem);
   if (ret < 0)
     {
-      errcode = ret;
+      errcode = -ret;
       goto errout;
     }
 
-  /* Seach the list of regions */
+  /* Seach the list of regions for the mapping to remove.  Nested mappings
+   * of a shared region overlap, so prefer the one that matches the range
+   * best:  Same start and length, then one that the range removes
+   * completely, then one whose tail the range removes.
+   */
+
+  begin   = (uintptr_t)start;
+  end     = begin + length;
+  mapping = NULL;
+  best    = 0;
 
   for (prev = NULL, curr = g_rammaps.head; curr; prev = curr, curr = curr->flink)
     {
-      /* Does this region include any part of the specified range? */
+      for (next = curr->mappings; next != NULL; next = next->flink)
+        {
+          uintptr_t mapend = (uintptr_t)next->addr + next->length;
+          int rank;
+
+          if (begin < (uintptr_t)next->addr || begin >= mapend)
+            {
+              continue;
+            }
+
+          rank = 1;
+          if (end >= mapend)
+            {
+              rank = next->addr != start ? 2 : end > mapend ? 3 : 4;
+            }
+
+          if (rank > best)
+            {
+              mapping = next;
+              best    = rank;
+            }
+        }
 
-      if ((uintptr_t)start < (uintptr_t)curr->addr + curr->length &&
-          (uintptr_t)start + length >= (uintptr_t)curr->addr)
+      if (mapping != NULL)
         {
           break;
         }
     }
 
-  /* Did we find the region */
+  /* Did we find the mapping */
 
-  if (!curr)
+  if (!mapping)
     {
       ferr("ERROR: Region not found\n");
       errcode = EINVAL;
       goto errout_with_semaphore;
     }
 
-  /* Get the offset from the beginning of the region and the actual number
-   * of bytes to "unmap".  All mappings must extend to the end of the region.
-   * There is no support for free a block of memory but leaving a block of
-   * memory at the end.  This is a consequence of using kumm_realloc() to
-   * simulate the unmapping.
+  /* All unmappings must extend to the end of the mapping.  There is no
+   * support for freeing a block of memory but leaving a block of memory at
+   * the end.  This is a consequence of using kumm_realloc() to simulate the
+   * unmapping.
    */
 
-  offset = start - curr->addr;
-  if (offset + length < curr->length)
+  if (end < (uintptr_t)mapping->addr + mapping->length)
     {
       ferr("ERROR: Cannot umap without unmapping to the end\n");
       errcode = ENOSYS;
       goto errout_with_semaphore;
     }
 
-  /* Okay.. the region is beging umapped to the end.  Make sure the length
-   * indicates that.
-   */
+  /* Remove the mapping or just its tail */
 
-  length = curr->length - offset;
+  if (start == mapping->addr)
+    {
+      for (pmapping = &curr->mappings; *pmapping != mapping;
+           pmapping = &(*pmapping)->flink)
+        {
+        }
 
-  /* Are we unmapping the entire region (offset == 0)? */
+      *pmapping = mapping->flink;
+      kmm_free(mapping);
+    }
+  else
+    {
+      mapping->length = begin - (uintptr_t)mapping->addr;
+    }
 
-  if (length >= curr->length)
+  /* Is the region still in use by other mappings? */
+
+  if (curr->mappings == NULL)
     {
-      /* Yes.. remove the mapping from the list */
+      /* No.. remove the region from the list */
 
       if (prev)
         {
@@ -185,20 +233,41 @@ int munmap(FAR void *start, size_t length)
           g_rammaps.head = curr->flink;
         }
 
-      /* Then free the region */
+      /* Then release the file and free the region */
 
+      file_close(&curr->file);
       kumm_free(curr);
     }
-
-  /* No.. We have been asked to "unmap' only a portion of the memory
-   * (offset > 0).
-   */
-
   else
     {
-      newaddr = kumm_realloc(curr->addr, sizeof(struct fs_rammap_s) + length);
-      DEBUGASSERT(newaddr == (FAR void *)(curr->addr));
-      curr->length = length;
+      /* Yes.. Keep only the part of the region up to the end of the last
+       * remaining mapping.
+       */
+
+      maxend = 0;
+      for (next = curr->mappings; next != NULL; next = next->flink)
+        {
+          size_t mapend = (uintptr_t)next->addr + next->length -
+                          (uintptr_t)curr->addr;
+
+          if (mapend > maxend)
+            {
+              maxend = mapend;
+            }
+        }
+
+      if (maxend < curr->length)
+        {
+          newaddr = kumm_realloc(curr, sizeof(struct fs_rammap_s) + maxend);
+          DEBUGASSERT(newaddr == (FAR void *)curr);
+          UNUSED(newaddr);
+
+          curr->length = maxend;
+          if (curr->nvalid > maxend)
+            {
+              curr->nvalid = maxend;
+            }
+        }
     }
 
   nxsem_post(&g_rammaps.exclsem);
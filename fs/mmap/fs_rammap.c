@@ -42,12 +42,15 @@
 #include <sys/types.h>
 #include <sys/mman.h>
 
+#include <stdint.h>
 #include <string.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <errno.h>
 #include <debug.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/kmalloc.h>
 
 #include "inode/inode.h"
@@ -90,11 +93,103 @@ void rammap_initialize(void)
     }
 }
 
+/****************************************************************************
+ * Name: rammap_read
+ *
+ * Description:
+ *   (Re-)load part of a memory region from the file that backs it.  Any
+ *   part of the range that lies beyond the end of the file is zeroed.  The
+ *   caller must hold g_rammaps.exclsem.
+ *
+ * Input Parameters:
+ *   map     The region to be loaded
+ *   offset  The offset into the region of the first byte to load
+ *   length  The number of bytes to load
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int rammap_read(FAR struct fs_rammap_s *map, size_t offset, size_t length)
+{
+  FAR uint8_t *rdbuffer;
+  ssize_t nread;
+  off_t fpos;
+
+  DEBUGASSERT(offset + length <= map->length);
+
+  /* Seek to the specified file offset */
+
+  fpos = file_seek(&map->file, map->offset + offset, SEEK_SET);
+  if (fpos < 0)
+    {
+      ferr("ERROR: Seek to position %d failed\n",
+           (int)(map->offset + offset));
+      return -EINVAL;
+    }
+
+  /* Read the file data into the memory region */
+
+  rdbuffer = (FAR uint8_t *)map->addr + offset;
+  while (length > 0)
+    {
+      nread = file_read(&map->file, rdbuffer, length);
+      if (nread < 0)
+        {
+          /* Handle the special case where the read was interrupted by a
+           * signal.
+           */
+
+          if (nread != -EINTR)
+            {
+              /* All other read errors are bad. */
+
+              ferr("ERROR: Read failed: offset=%d errno=%d\n",
+                   (int)(map->offset + offset), (int)nread);
+              return (int)nread;
+            }
+
+          continue;
+        }
+
+      /* Check for end of file. */
+
+      if (nread == 0)
+        {
+          break;
+        }
+
+      /* Increment number of bytes read */
+
+      rdbuffer += nread;
+      length   -= nread;
+    }
+
+  /* Remember how much of the region is backed by the file so that msync()
+   * does not extend the file with the zeroed tail of the region.
+   */
+
+  offset = rdbuffer - (FAR uint8_t *)map->addr;
+  if (length > 0 || offset > map->nvalid)
+    {
+      map->nvalid = offset;
+    }
+
+  /* Zero any memory beyond the amount read from the file */
+
+  memset(rdbuffer, 0, length);
+  return OK;
+}
+
 /****************************************************************************
  * Name: rammmap
  *
  * Description:
  *   Support simulation of memory mapped files by copying files into RAM.
+ *   The file is loaded once:  A mapping of a file that is already mapped
+ *   shares the existing copy if that copy covers the requested range.
  *
  * Input Parameters:
  *   fd      file descriptor of the backing file -- required.
@@ -117,119 +212,156 @@ void rammap_initialize(void)
 
 FAR void *rammap(int fd, size_t length, off_t offset)
 {
+  FAR struct fs_mapping_s *mapping;
   FAR struct fs_rammap_s *map;
+  FAR struct file *filep;
   FAR uint8_t *alloc;
-  FAR uint8_t *rdbuffer;
-  ssize_t nread;
-  off_t fpos;
+  struct file newfile;
+  uintptr_t fileid = 0;
+  bool shared = false;
   int errcode;
   int ret;
 
-  /* There is a major design flaw that I have not yet thought of fix for:
-   * The goal is to have a single region of memory that represents a single
-   * file and can be shared by many threads.  That is, given a filename a
-   * thread should be able to open the file, get a file descriptor, and
-   * call mmap() to get a memory region.  Different file descriptors opened
-   * with the same file path should get the same memory region when mapped.
-   *
-   * The design flaw is that I don't have sufficient knowledge to know that
-   * these different file descriptors map to the same file.  So, for the time
-   * being, a new memory region is created each time that rammap() is called.
-   * Not very useful!
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout;
+    }
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+  /* Different file descriptors opened with the same file path should get
+   * the same memory region when mapped.  The inode only identifies the
+   * volume, so ask the file system which file on the volume this is.  Files
+   * that cannot be identified get a private copy.
    */
 
-  /* Allocate a region of memory of the specified size */
+  if (INODE_IS_MOUNTPT(filep->f_inode))
+    {
+      ret = file_ioctl(filep, FIOC_FILEID,
+                       (unsigned long)((uintptr_t)&fileid));
+      shared = (ret >= 0);
+    }
+#endif
 
-  alloc = (FAR uint8_t *)kumm_malloc(sizeof(struct fs_rammap_s) + length);
-  if (!alloc)
+  /* The list is locked while the file is loaded so that concurrent mappings
+   * of the same file load it only once.
+   */
+
+  mapping = (FAR struct fs_mapping_s *)
+    kmm_malloc(sizeof(struct fs_mapping_s));
+  if (mapping == NULL)
     {
-      ferr("ERROR: Region allocation failed, length: %d\n", (int)length);
       errcode = ENOMEM;
       goto errout;
     }
 
-  /* Initialize the region */
-
-  map         = (FAR struct fs_rammap_s *)alloc;
-  memset(map, 0, sizeof(struct fs_rammap_s));
-  map->addr   = alloc + sizeof(struct fs_rammap_s);
-  map->length = length;
-  map->offset = offset;
-
-  /* Seek to the specified file offset */
+  mapping->length = length;
 
-  fpos = lseek(fd, offset,  SEEK_SET);
-  if (fpos == (off_t)-1)
+  rammap_initialize();
+  ret = nxsem_wait(&g_rammaps.exclsem);
+  if (ret < 0)
     {
-      /* Seek failed... errno has already been set, but EINVAL is probably
-       * the correct response.
-       */
-
-      ferr("ERROR: Seek to position %d failed\n", (int)offset);
-      errcode = EINVAL;
-      goto errout_with_region;
+      errcode = -ret;
+      goto errout_with_mapping;
     }
 
-  /* Read the file data into the memory region */
+  /* Is the requested range already held by a region that we can share? */
 
-  rdbuffer = map->addr;
-  while (length > 0)
+  for (map = shared ? g_rammaps.head : NULL; map != NULL; map = map->flink)
     {
-      nread = nx_read(fd, rdbuffer, length);
-      if (nread < 0)
+      if (map->shared && map->file.f_inode == filep->f_inode &&
+          map->fileid == fileid && offset >= map->offset &&
+          offset + length <= map->offset + map->length)
         {
-          /* Handle the special case where the read was interrupted by a
-           * signal.
+          /* msync() writes back through the file held by the region.  Make
+           * sure that it is writable if this mapping's file is.
            */
 
-          if (nread != -EINTR)
+          if ((map->file.f_oflags & O_WROK) == 0 &&
+              (filep->f_oflags & O_WROK) != 0)
             {
-              /* All other read errors are bad. */
-
-              ferr("ERROR: Read failed: offset=%d errno=%d\n",
-                   (int)offset, (int)nread);
-
-              errcode = (int)-nread;
-              goto errout_with_region;
+              memset(&newfile, 0, sizeof(struct file));
+              if (file_dup2(filep, &newfile) >= 0)
+                {
+                  file_close(&map->file);
+                  memcpy(&map->file, &newfile, sizeof(struct file));
+                }
             }
-        }
 
-      /* Check for end of file. */
+          mapping->addr  = (FAR uint8_t *)map->addr + (offset - map->offset);
+          mapping->flink = map->mappings;
+          map->mappings  = mapping;
 
-      if (nread == 0)
-        {
-          break;
+          nxsem_post(&g_rammaps.exclsem);
+          return mapping->addr;
         }
+    }
 
-      /* Increment number of bytes read */
+  /* Allocate a region of memory of the specified size */
 
-      rdbuffer += nread;
-      length   -= nread;
+  alloc = (FAR uint8_t *)kumm_malloc(sizeof(struct fs_rammap_s) + length);
+  if (!alloc)
+    {
+      ferr("ERROR: Region allocation failed, length: %d\n", (int)length);
+      errcode = ENOMEM;
+      goto errout_with_semaphore;
     }
 
-  /* Zero any memory beyond the amount read from the file */
+  /* Initialize the region */
 
-  memset(rdbuffer, 0, length);
+  map         = (FAR struct fs_rammap_s *)alloc;
+  memset(map, 0, sizeof(struct fs_rammap_s));
+  map->addr   = alloc + sizeof(struct fs_rammap_s);
+  map->length = length;
+  map->offset = offset;
+  map->fileid = fileid;
+  map->shared = shared;
 
-  /* Add the buffer to the list of regions */
+  /* The region holds its own reference to the file.  That keeps the file
+   * identifier valid and is used to write the region back in msync().
+   */
 
-  rammap_initialize();
-  ret = nxsem_wait(&g_rammaps.exclsem);
+  ret = file_dup2(filep, &map->file);
   if (ret < 0)
     {
       errcode = -ret;
       goto errout_with_region;
     }
 
-  map->flink  = g_rammaps.head;
+  /* Read the file data into the memory region */
+
+  ret = rammap_read(map, 0, length);
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout_with_file;
+    }
+
+  /* Record the mapping and add the buffer to the list of regions */
+
+  mapping->addr  = map->addr;
+  mapping->flink = NULL;
+  map->mappings  = mapping;
+
+  map->flink     = g_rammaps.head;
   g_rammaps.head = map;
 
   nxsem_post(&g_rammaps.exclsem);
   return map->addr;
 
+errout_with_file:
+  file_close(&map->file);
+
 errout_with_region:
   kumm_free(alloc);
 
+errout_with_semaphore:
+  nxsem_post(&g_rammaps.exclsem);
+
+errout_with_mapping:
+  kmm_free(mapping);
+
 errout:
   set_errno(errcode);
   return MAP_FAILED;
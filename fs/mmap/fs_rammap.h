@@ -45,8 +45,12 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include <semaphore.h>
 
+#include <nuttx/fs/fs.h>
+
 #ifdef CONFIG_FS_RAMMAP
 
 /****************************************************************************
@@ -59,23 +63,44 @@
  * that do not have MMUs and, hence, cannot support on demand paging of
  * blocks of a file.
  *
+ * The copy is loaded once and then shared:  Subsequent mappings of the same
+ * file that fall within the region reuse the copy.  Each mapping is
+ * recorded with its own address and length so that munmap() can remove
+ * exactly that mapping; the region is freed when its last mapping is
+ * unmapped.
+ * Files are identified by their mountpoint inode and the FIOC_FILEID ioctl;
+ * files that cannot be identified always receive a private copy.
+ *
  * This copied file has many of the properties of a standard memory mapped
  * file except:
  *
  * - All of the file must be present in memory.  This limits the size of
  *   files that may be memory mapped (especially on MCUs with no significant
  *   RAM resources).
- * - All mapped files are read-only.  You can write to the in-memory image,
- *   but the file contents will not change.
+ * - Modifications to the in-memory image are written back to the file only
+ *   when msync() is called.  Changes made to the file through write() are
+ *   not visible in the image until msync() is called with MS_INVALIDATE.
  * - There are not access privileges.
  */
 
+struct fs_mapping_s
+{
+  FAR struct fs_mapping_s *flink;  /* Next mapping of the same region */
+  FAR void           *addr;        /* Address returned by mmap() */
+  size_t              length;      /* Length still mapped */
+};
+
 struct fs_rammap_s
 {
   struct fs_rammap_s *flink;       /* Implements a singly linked list */
   FAR void           *addr;        /* Start of allocated memory */
   size_t              length;      /* Length of region */
+  size_t              nvalid;      /* Number of bytes backed by the file */
   off_t               offset;      /* File offset */
+  uintptr_t           fileid;      /* Identifies the file in the volume */
+  FAR struct fs_mapping_s *mappings; /* Mappings of the region */
+  bool                shared;      /* True: May be shared by other mappings */
+  struct file         file;        /* Open file used for write-back */
 };
 
 /* This structure defines all "mapped" files */
@@ -115,11 +140,34 @@ extern struct fs_allmaps_s g_rammaps;
 
 void rammap_initialize(void);
 
+/****************************************************************************
+ * Name: rammap_read
+ *
+ * Description:
+ *   (Re-)load part of a memory region from the file that backs it.  Any
+ *   part of the range that lies beyond the end of the file is zeroed.  The
+ *   caller must hold g_rammaps.exclsem.
+ *
+ * Input Parameters:
+ *   map     The region to be loaded
+ *   offset  The offset into the region of the first byte to load
+ *   length  The number of bytes to load
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int rammap_read(FAR struct fs_rammap_s *map, size_t offset, size_t length);
+
 /****************************************************************************
  * Name: rammmap
  *
  * Description:
  *   Support simulation of memory mapped files by copying files into RAM.
+ *   The file is loaded once:  A mapping of a file that is already mapped
+ *   shares the existing copy if that copy covers the requested range.
  *
  * Input Parameters:
  *   fd      file descriptor of the backing file -- required.
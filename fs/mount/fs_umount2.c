@@ -143,10 +143,12 @@ int umount2(FAR const char *target, unsigned int flags)
       goto errout_with_semaphore;
     }
 
-  /* Successfully unbound.  Convert the mountpoint inode to regular
-   * pseudo-file inode.
+  /* Successfully unbound.  Forget any names cached for the volume and
+   * convert the mountpoint inode to regular pseudo-file inode.
    */
 
+  inode_cache_mntflush(mountpt_inode->i_private);
+
   mountpt_inode->i_flags  &= ~FSNODEFLAG_TYPE_MASK;
   mountpt_inode->i_private = NULL;
   mountpt_inode->u.i_mops  = NULL;
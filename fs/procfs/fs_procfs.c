@@ -97,6 +97,8 @@ extern const struct procfs_operations net_procfs_routeoperations;
 extern const struct procfs_operations part_procfsoperations;
 extern const struct procfs_operations mount_procfsoperations;
 extern const struct procfs_operations smartfs_procfsoperations;
+extern const struct procfs_operations fat_procfsoperations;
+extern const struct procfs_operations inodecache_procfsoperations;
 
 /* And even worse, this one is specific to the STM32.  The solution to
  * this nasty couple would be to replace this hard-coded, ROM-able
@@ -160,6 +162,14 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "fs/usage",      &mount_procfsoperations,     PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_FAT_SECTORCACHE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_FAT)
+  { "fs/fat",        &fat_procfsoperations,       PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_FS_INODE_CACHE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_INODECACHE)
+  { "fs/inodecache", &inodecache_procfsoperations, PROCFS_FILE_TYPE },
+#endif
+
 #if defined(CONFIG_FS_SMARTFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
   { "fs/smartfs**",  &smartfs_procfsoperations,   PROCFS_UNKOWN_TYPE },
 #endif
@@ -273,7 +273,10 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
                             size_t buflen)
 {
   FAR struct iobinfo_file_s *iobfile;
-  FAR struct iob_userstats_s *userstats;
+  struct iob_userstats_s userstats;
+#ifdef CONFIG_IOB_CPUCACHE
+  struct iob_cpustats_s cpustats;
+#endif
   size_t linesize;
   size_t copysize;
   size_t totalsize;
@@ -321,12 +324,12 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
           buffer    += copysize;
           buflen    -= copysize;
 
-          userstats  = iob_getuserstats(i);
+          iob_getuserstats(i, &userstats);
           linesize   = snprintf(iobfile->line, IOBINFO_LINELEN,
                                 "%-16s%16lu%16lu\n",
                                 g_iob_user_names[i],
-                                (unsigned long)userstats->totalconsumed,
-                                (unsigned long)userstats->totalproduced);
+                                (unsigned long)userstats.totalconsumed,
+                                (unsigned long)userstats.totalproduced);
 
           copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
                                      &offset);
@@ -339,18 +342,55 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
       buffer    += copysize;
       buflen    -= copysize;
 
-      userstats  = iob_getuserstats(IOBUSER_GLOBAL);
+      iob_getuserstats(IOBUSER_GLOBAL, &userstats);
       linesize   = snprintf(iobfile->line, IOBINFO_LINELEN,
                             "\n%-16s%16lu%16lu\n",
                             g_iob_user_names[IOBUSER_GLOBAL],
-                            (unsigned long)userstats->totalconsumed,
-                            (unsigned long)userstats->totalproduced);
+                            (unsigned long)userstats.totalconsumed,
+                            (unsigned long)userstats.totalproduced);
 
       copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
                                  &offset);
       totalsize += copysize;
     }
 
+#ifdef CONFIG_IOB_CPUCACHE
+  /* Then the statistics of the I/O buffer cache of each CPU */
+
+  if (totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = snprintf(iobfile->line, IOBINFO_LINELEN,
+                            "\n CPU  CACHED            HITS"
+                            "         REFILLS          DRAINS\n");
+
+      copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (totalsize < buflen)
+        {
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          iob_getcpustats(i, &cpustats);
+          linesize   = snprintf(iobfile->line, IOBINFO_LINELEN,
+                                "%4d%8d%16lu%16lu%16lu\n",
+                                i, cpustats.ncached, cpustats.nhits,
+                                cpustats.nrefills, cpustats.ndrains);
+
+          copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                                     &offset);
+          totalsize += copysize;
+        }
+    }
+#endif
+
   /* Update the file offset */
 
   filep->f_pos += totalsize;
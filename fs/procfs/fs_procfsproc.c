@@ -62,6 +62,7 @@
 #include <nuttx/sched.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/environ.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/procfs.h>
 #include <nuttx/fs/dirent.h>
@@ -115,6 +116,9 @@ enum proc_node_e
   PROC_CRITMON,                       /* Critical section monitor */
 #endif
   PROC_STACK,                         /* Task stack info */
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  PROC_PI,                            /* Priority inheritance chains */
+#endif
   PROC_GROUP,                         /* Group directory */
   PROC_GROUP_STATUS,                  /* Task group status */
   PROC_GROUP_FD                       /* Group file descriptors */
@@ -202,6 +206,11 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
 static ssize_t proc_stack(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+static ssize_t proc_pi(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+#endif
 static ssize_t proc_groupstatus(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
@@ -299,6 +308,13 @@ static const struct proc_node_s g_stack =
   "stack",        "stack",   (uint8_t)PROC_STACK,        DTYPE_FILE        /* Task stack info */
 };
 
+#ifdef CONFIG_PRIORITY_INHERITANCE
+static const struct proc_node_s g_pi =
+{
+  "pi",           "pi",      (uint8_t)PROC_PI,           DTYPE_FILE        /* Priority inheritance chains */
+};
+#endif
+
 static const struct proc_node_s g_group =
 {
   "group",        "group",   (uint8_t)PROC_GROUP,        DTYPE_DIRECTORY   /* Group directory */
@@ -335,6 +351,9 @@ static FAR const struct proc_node_s * const g_nodeinfo[] =
   &g_critmon,      /* Critical section Monitor */
 #endif
   &g_stack,        /* Task stack info */
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  &g_pi,           /* Priority inheritance chains */
+#endif
   &g_group,        /* Group directory */
   &g_groupstatus,  /* Task group status */
   &g_groupfd       /* Group file descriptors */
@@ -358,6 +377,9 @@ static const struct proc_node_s * const g_level0info[] =
   &g_critmon,      /* Critical section monitor */
 #endif
   &g_stack,        /* Task stack info */
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  &g_pi,           /* Priority inheritance chains */
+#endif
   &g_group,        /* Group directory */
 };
 #define PROC_NLEVEL0NODES (sizeof(g_level0info)/sizeof(FAR const struct proc_node_s * const))
@@ -912,6 +934,117 @@ static ssize_t proc_stack(FAR struct proc_file_s *procfile,
   return totalsize;
 }
 
+/****************************************************************************
+ * Name: proc_pi
+ *
+ * Description:
+ *   Show the base and current priority of the thread, the semaphore counts
+ *   that it holds and the chain of threads that it is waiting for:  The
+ *   first holder of the semaphore that the thread waits for, the first
+ *   holder of the semaphore that that holder waits for, and so on.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+static ssize_t proc_pi(FAR struct proc_file_s *procfile,
+                       FAR struct tcb_s *tcb, FAR char *buffer,
+                       size_t buflen, off_t offset)
+{
+  FAR struct semholder_s *pholder;
+  FAR struct tcb_s *htcb;
+  irqstate_t flags;
+  size_t remaining;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  int depth;
+
+  remaining = buflen;
+  totalsize = 0;
+
+  /* Show the base priority */
+
+  linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%d\n",
+                        "BasePrio:", tcb->base_priority);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Show the current, possibly inherited priority */
+
+  linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%d\n",
+                        "CurPrio:", tcb->sched_priority);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  /* The holder records and the chain may change while we walk them */
+
+  flags = enter_critical_section();
+
+  /* Show each semaphore held by the thread and its number of counts */
+
+  for (pholder = tcb->holdsem;
+       pholder != NULL && totalsize < buflen;
+       pholder = pholder->tlink)
+    {
+      linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%p,%d\n",
+                            "Holds:", pholder->sem, pholder->counts);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                                 &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+    }
+
+  /* Follow the chain of waits.  The depth is limited in case the chain is
+   * a deadlock cycle.
+   */
+
+  for (htcb = tcb, depth = 0;
+       htcb != NULL && htcb->waitsem != NULL && depth < SEM_MAXCHAIN &&
+       totalsize < buflen;
+       depth++)
+    {
+      linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%p\n",
+                            "Waits:", htcb->waitsem);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                                 &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+
+      htcb = nxsem_getholder(htcb->waitsem, 0);
+      if (htcb != NULL && totalsize < buflen)
+        {
+          linesize   = snprintf(procfile->line, STATUS_LINELEN,
+                                "%-12s%d,%d\n", "Holder:", htcb->pid,
+                                htcb->sched_priority);
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     remaining, &offset);
+
+          totalsize += copysize;
+          buffer    += copysize;
+          remaining -= copysize;
+        }
+    }
+
+  leave_critical_section(flags);
+  return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_groupstatus
  ****************************************************************************/
@@ -1447,6 +1580,12 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
       ret = proc_stack(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
 
+#ifdef CONFIG_PRIORITY_INHERITANCE
+    case PROC_PI: /* Priority inheritance chains */
+      ret = proc_pi(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+#endif
+
     case PROC_GROUP_STATUS: /* Task group status */
       ret = proc_groupstatus(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
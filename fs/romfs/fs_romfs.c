@@ -598,8 +598,6 @@ static int romfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   DEBUGASSERT(rm != NULL);
 
-  /* Only one ioctl command is supported */
-
   if (cmd == FIOC_MMAP && rm->rm_xipbase && ppv)
     {
       /* Return the address on the media corresponding to the start of
@@ -610,6 +608,14 @@ static int romfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       return OK;
     }
 
+  if (cmd == FIOC_FILEID && arg != 0)
+    {
+      /* The start offset of the file data is unique within the volume */
+
+      *(FAR uintptr_t *)((uintptr_t)arg) = (uintptr_t)rf->rf_startoffset;
+      return OK;
+    }
+
   ferr("ERROR: Invalid cmd: %d \n", cmd);
   return -ENOTTY;
 }
@@ -56,6 +56,7 @@
 #include <nuttx/fs/dirent.h>
 #include <nuttx/mtd/mtd.h>
 
+#include "inode/inode.h"
 #include "fs_romfs.h"
 
 /****************************************************************************
@@ -725,6 +726,9 @@ int romfs_finddirentry(struct romfs_mountpt_s *rm,
 {
   const char *entryname;
   const char *terminator;
+#ifdef CONFIG_FS_INODE_CACHE
+  off_t dir;
+#endif
   int entrylen;
   int ret;
 
@@ -776,7 +780,31 @@ int romfs_finddirentry(struct romfs_mountpt_s *rm,
        * matching name.
        */
 
+#ifdef CONFIG_FS_INODE_CACHE
+      /* The volume is read-only, so the outcome of an earlier search of
+       * this directory for this name remains valid until it is unmounted.
+       */
+
+      dir = dirinfo->rd_dir.fr_firstoffset;
+      ret = inode_cache_mntlookup(rm, dir, entryname, entrylen, dirinfo,
+                                  sizeof(struct romfs_dirinfo_s));
+      if (ret == -ENODATA)
+        {
+          ret = romfs_searchdir(rm, entryname, entrylen, dirinfo);
+          if (ret == OK)
+            {
+              inode_cache_mntadd(rm, dir, entryname, entrylen, dirinfo,
+                                 sizeof(struct romfs_dirinfo_s));
+            }
+          else if (ret == -ENOENT)
+            {
+              inode_cache_mntadd(rm, dir, entryname, entrylen, NULL, 0);
+            }
+        }
+#else
       ret = romfs_searchdir(rm, entryname, entrylen, dirinfo);
+#endif
+
       if (ret < 0)
         {
           return ret;
@@ -417,14 +417,17 @@ static int smartfs_close(FAR struct file *filep)
   fs    = inode->i_private;
   sf    = filep->f_priv;
 
-  /* Sync the file */
-
-  smartfs_sync(filep);
-
   /* Take the semaphore */
 
   smartfs_semtake(fs);
 
+  /* Sync the file.  The checkpoint of the sector map is left to fsync()
+   * and to the unmount:  Writing it on every close would cost far more
+   * than the sync itself.
+   */
+
+  (void)smartfs_sync_internal(fs, sf);
+
   /* Check if we are the last one with a reference to the file and
    * only close if we are.
    */
@@ -988,7 +991,9 @@ static int smartfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
  * Name: smartfs_sync
  *
  * Description: Synchronize the file state on disk to match internal, in-
- *   memory state.
+ *   memory state.  With CONFIG_MTD_SMART_CHECKPOINT, the block driver is
+ *   also asked to checkpoint its sector map so that the next mount after a
+ *   power loss does not need a full scan.
  *
  ****************************************************************************/
 
@@ -1017,6 +1022,13 @@ static int smartfs_sync(FAR struct file *filep)
 
   ret = smartfs_sync_internal(fs, sf);
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  if (ret >= 0)
+    {
+      ret = FS_IOCTL(fs, BIOC_FLUSH, 0);
+    }
+#endif
+
   smartfs_semgive(fs);
   return ret;
 }
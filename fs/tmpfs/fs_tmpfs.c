@@ -67,10 +67,6 @@
 #  warning CONFIG_FS_TMPFS_DIRECTORY_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
-#if CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
-#  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
-#endif
-
 #define tmpfs_lock_file(tfo) \
            (tmpfs_lock_object((FAR struct tmpfs_object_s *)tfo))
 #define tmpfs_lock_directory(tdo) \
@@ -94,8 +90,10 @@ static void tmpfs_lock_object(FAR struct tmpfs_object_s *to);
 static void tmpfs_unlock_object(FAR struct tmpfs_object_s *to);
 static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
               unsigned int nentries);
-static int  tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
-              size_t newsize);
+static int  tmpfs_grow_pages(FAR struct tmpfs_file_s *tfo, size_t npages);
+static void tmpfs_resize_file(FAR struct tmpfs_file_s *tfo, size_t newsize);
+static int  tmpfs_map_file(FAR struct tmpfs_file_s *tfo);
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
@@ -373,74 +371,228 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
 }
 
 /****************************************************************************
- * Name: tmpfs_realloc_file
+ * Name: tmpfs_grow_pages
+ *
+ * Description:
+ *   Make sure that the page index of the file can hold at least 'npages'
+ *   entries.  The index grows geometrically so that appending to a file
+ *   costs amortized O(1) index updates and no file data is ever copied.
+ *
  ****************************************************************************/
 
-static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
-                              size_t newsize)
+static int tmpfs_grow_pages(FAR struct tmpfs_file_s *tfo, size_t npages)
 {
-  FAR struct tmpfs_file_s *oldtfo = *tfo;
-  FAR struct tmpfs_file_s *newtfo;
-  size_t objsize;
-  size_t allocsize;
-  size_t delta;
+  FAR uint8_t **newpages;
+  size_t newcount;
+
+  if (npages <= tfo->tfo_npages)
+    {
+      return OK;
+    }
 
-  /* Check if the current allocation is sufficient */
+  newcount = tfo->tfo_npages < 4 ? 4 : 2 * tfo->tfo_npages;
+  if (newcount < npages)
+    {
+      newcount = npages;
+    }
+
+  newpages = (FAR uint8_t **)
+    kmm_realloc(tfo->tfo_pages, newcount * sizeof(FAR uint8_t *));
+  if (newpages == NULL)
+    {
+      return -ENOMEM;
+    }
 
-  objsize = SIZEOF_TMPFS_FILE(newsize);
+  /* The new entries are holes */
 
-  /* Are we growing or shrinking the object? */
+  memset(&newpages[tfo->tfo_npages], 0,
+         (newcount - tfo->tfo_npages) * sizeof(FAR uint8_t *));
 
-  if (objsize <= oldtfo->tfo_alloc)
+  tfo->tfo_alloc += (newcount - tfo->tfo_npages) * sizeof(FAR uint8_t *);
+  tfo->tfo_pages  = newpages;
+  tfo->tfo_npages = newcount;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tmpfs_resize_file
+ *
+ * Description:
+ *   Set the size of the file.  Growing the file just creates a hole.
+ *   Shrinking the file releases the pages beyond the new end of the file.
+ *
+ ****************************************************************************/
+
+static void tmpfs_resize_file(FAR struct tmpfs_file_s *tfo, size_t newsize)
+{
+  size_t npages;
+  size_t oldpages;
+  size_t offset;
+  size_t i;
+
+  if (newsize < tfo->tfo_size)
     {
-      /* Shrinking ... Shrink unconditionally if the size is shrinking to
-       * zero.
+      npages   = TMPFS_NPAGES(newsize);
+      oldpages = TMPFS_NPAGES(tfo->tfo_size);
+      if (oldpages > tfo->tfo_npages)
+        {
+          oldpages = tfo->tfo_npages;
+        }
+
+      /* Release the whole pages beyond the new end of the file.  Pages in
+       * the mmap() region cannot be released individually and are cleared
+       * instead.
        */
 
-      if (newsize > 0)
+      for (i = npages; i < oldpages; i++)
         {
-          /* Otherwise, don't realloc unless the object has shrunk by a
-           * lot.
-           */
-
-          delta = oldtfo->tfo_alloc - objsize;
-          if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD)
+          if (i < tfo->tfo_nmapped)
             {
-              /* Hasn't shrunk enough.. Return doing nothing for now */
-
-              oldtfo->tfo_size = newsize;
-              return OK;
+              memset(tfo->tfo_pages[i], 0, TMPFS_PAGESIZE);
             }
+          else if (tfo->tfo_pages[i] != NULL)
+            {
+              kmm_free(tfo->tfo_pages[i]);
+              tfo->tfo_pages[i] = NULL;
+              tfo->tfo_alloc   -= TMPFS_PAGESIZE;
+            }
+        }
+
+      /* Clear the remainder of the new final page so that the data does
+       * not reappear if the file grows again.
+       */
+
+      offset = newsize % TMPFS_PAGESIZE;
+      if (offset > 0 && npages <= tfo->tfo_npages &&
+          tfo->tfo_pages[npages - 1] != NULL)
+        {
+          memset(&tfo->tfo_pages[npages - 1][offset], 0,
+                 TMPFS_PAGESIZE - offset);
+        }
+
+      /* Release the page index too if nothing is left */
+
+      if (newsize == 0 && tfo->tfo_nmapped == 0 && tfo->tfo_pages != NULL)
+        {
+          kmm_free(tfo->tfo_pages);
+          tfo->tfo_alloc -= tfo->tfo_npages * sizeof(FAR uint8_t *);
+          tfo->tfo_pages  = NULL;
+          tfo->tfo_npages = 0;
         }
     }
 
-  /* Added some additional amount to the new size to account frequent
-   * reallocations.
-   */
+  tfo->tfo_size = newsize;
+}
 
-  allocsize = objsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+/****************************************************************************
+ * Name: tmpfs_map_file
+ *
+ * Description:
+ *   Make the file data addressable as one contiguous region in tfo_map.
+ *   A file of a single page is mapped in place.  Otherwise, the pages are
+ *   moved into one new allocation.
+ *
+ *   The region is never moved once established because existing mappings
+ *   refer to it.  If the file has since grown beyond it, it cannot be
+ *   mapped again.
+ *
+ ****************************************************************************/
 
-  /* Realloc the file object */
+static int tmpfs_map_file(FAR struct tmpfs_file_s *tfo)
+{
+  FAR uint8_t *map;
+  size_t npages;
+  size_t i;
+  int ret;
 
-  newtfo = (FAR struct tmpfs_file_s *)kmm_realloc(oldtfo, allocsize);
-  if (newtfo == NULL)
+  npages = TMPFS_NPAGES(tfo->tfo_size);
+
+  if (tfo->tfo_nmapped > 0)
     {
-      return -ENOMEM;
+      return npages <= tfo->tfo_nmapped ? OK : -EBUSY;
     }
 
-  /* Adjust the reference in the parent directory entry */
+  if (npages == 0)
+    {
+      return -ENXIO;
+    }
 
-  DEBUGASSERT(newtfo->tfo_dirent);
-  newtfo->tfo_dirent->tde_object = (FAR struct tmpfs_object_s *)newtfo;
+  ret = tmpfs_grow_pages(tfo, npages);
+  if (ret < 0)
+    {
+      return ret;
+    }
 
-  /* Return the new address of the reallocated file object */
+  if (npages == 1 && tfo->tfo_pages[0] != NULL)
+    {
+      map = tfo->tfo_pages[0];
+    }
+  else
+    {
+      map = (FAR uint8_t *)kmm_malloc(npages * TMPFS_PAGESIZE);
+      if (map == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      for (i = 0; i < npages; i++)
+        {
+          FAR uint8_t *page = &map[i * TMPFS_PAGESIZE];
+
+          if (tfo->tfo_pages[i] != NULL)
+            {
+              memcpy(page, tfo->tfo_pages[i], TMPFS_PAGESIZE);
+              kmm_free(tfo->tfo_pages[i]);
+            }
+          else
+            {
+              memset(page, 0, TMPFS_PAGESIZE);
+              tfo->tfo_alloc += TMPFS_PAGESIZE;
+            }
 
-  newtfo->tfo_alloc = allocsize;
-  newtfo->tfo_size  = newsize;
-  *tfo              = newtfo;
+          tfo->tfo_pages[i] = page;
+        }
+    }
+
+  tfo->tfo_map     = map;
+  tfo->tfo_nmapped = npages;
   return OK;
 }
 
+/****************************************************************************
+ * Name: tmpfs_free_file
+ *
+ * Description:
+ *   Free a file object and all of its pages.
+ *
+ ****************************************************************************/
+
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo)
+{
+  size_t i;
+
+  for (i = tfo->tfo_nmapped; i < tfo->tfo_npages; i++)
+    {
+      if (tfo->tfo_pages[i] != NULL)
+        {
+          kmm_free(tfo->tfo_pages[i]);
+        }
+    }
+
+  if (tfo->tfo_map != NULL)
+    {
+      kmm_free(tfo->tfo_map);
+    }
+
+  if (tfo->tfo_pages != NULL)
+    {
+      kmm_free(tfo->tfo_pages);
+    }
+
+  nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
+  kmm_free(tfo);
+}
+
 /****************************************************************************
  * Name: tmpfs_release_lockedobject
  ****************************************************************************/
@@ -476,8 +628,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
 
   if (tfo->tfo_refs == 1 && (tfo->tfo_flags & TFO_FLAG_UNLINKED) != 0)
     {
-      nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
     }
 
   /* Otherwise, just decrement the reference count on the file object */
@@ -623,12 +774,12 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s **tdo,
 static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
 {
   FAR struct tmpfs_file_s *tfo;
-  size_t allocsize;
 
-  /* Create a new zero length file object */
+  /* Create a new zero length file object.  No pages are allocated until
+   * data is written.
+   */
 
-  allocsize = SIZEOF_TMPFS_FILE(CONFIG_FS_TMPFS_FILE_ALLOCGUARD);
-  tfo = (FAR struct tmpfs_file_s *)kmm_malloc(allocsize);
+  tfo = (FAR struct tmpfs_file_s *)kmm_zalloc(sizeof(struct tmpfs_file_s));
   if (tfo == NULL)
     {
       return NULL;
@@ -638,11 +789,9 @@ static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
    * locked with one reference count.
    */
 
-  tfo->tfo_alloc = allocsize;
+  tfo->tfo_alloc = sizeof(struct tmpfs_file_s);
   tfo->tfo_type  = TMPFS_REGULAR;
   tfo->tfo_refs  = 1;
-  tfo->tfo_flags = 0;
-  tfo->tfo_size  = 0;
 
   tfo->tfo_exclsem.ts_holder = getpid();
   tfo->tfo_exclsem.ts_count  = 1;
@@ -758,8 +907,7 @@ static int tmpfs_create_file(FAR struct tmpfs_s *fs,
   /* Error exits */
 
 errout_with_file:
-  nxsem_destroy(&newtfo->tfo_exclsem.ts_sem);
-  kmm_free(newtfo);
+  tmpfs_free_file(newtfo);
 
 errout_with_parent:
   parent->tdo_refs--;
@@ -1280,8 +1428,16 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
 
   /* Free the object now */
 
-  nxsem_destroy(&to->to_exclsem.ts_sem);
-  kmm_free(to);
+  if (to->to_type == TMPFS_REGULAR)
+    {
+      tmpfs_free_file((FAR struct tmpfs_file_s *)to);
+    }
+  else
+    {
+      nxsem_destroy(&to->to_exclsem.ts_sem);
+      kmm_free(to);
+    }
+
   return TMPFS_DELETED;
 }
 
@@ -1433,11 +1589,7 @@ static int tmpfs_open(FAR struct file *filep, FAR const char *relpath,
 
           if (tfo->tfo_size > 0)
             {
-              ret = tmpfs_realloc_file(&tfo, 0);
-              if (ret < 0)
-                {
-                  goto errout_with_filelock;
-                }
+              tmpfs_resize_file(tfo, 0);
             }
         }
     }
@@ -1548,7 +1700,7 @@ static int tmpfs_close(FAR struct file *filep)
        * have any other references.
        */
 
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
       return OK;
     }
 
@@ -1566,7 +1718,10 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
                           size_t buflen)
 {
   FAR struct tmpfs_file_s *tfo;
-  ssize_t nread;
+  FAR uint8_t *page;
+  size_t nread;
+  size_t ncopy;
+  size_t offset;
   off_t startpos;
   off_t endpos;
 
@@ -1585,18 +1740,42 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
   /* Handle attempts to read beyond the end of the file. */
 
   startpos = filep->f_pos;
-  nread    = buflen;
   endpos   = startpos + buflen;
 
   if (endpos > tfo->tfo_size)
     {
       endpos = tfo->tfo_size;
-      nread  = endpos - startpos;
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Copy data from the file pages to the user buffer a page at a time.
+   * Holes read as zeroes.
+   */
+
+  for (nread = 0; startpos < endpos; startpos += ncopy, nread += ncopy)
+    {
+      offset = startpos % TMPFS_PAGESIZE;
+      ncopy  = TMPFS_PAGESIZE - offset;
+      if (ncopy > (size_t)(endpos - startpos))
+        {
+          ncopy = endpos - startpos;
+        }
+
+      page = NULL;
+      if ((size_t)startpos / TMPFS_PAGESIZE < tfo->tfo_npages)
+        {
+          page = tfo->tfo_pages[startpos / TMPFS_PAGESIZE];
+        }
+
+      if (page != NULL)
+        {
+          memcpy(&buffer[nread], &page[offset], ncopy);
+        }
+      else
+        {
+          memset(&buffer[nread], 0, ncopy);
+        }
+    }
 
-  memcpy(buffer, &tfo->tfo_data[startpos], nread);
   filep->f_pos += nread;
 
   /* Release the lock on the file */
@@ -1613,7 +1792,10 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
                            size_t buflen)
 {
   FAR struct tmpfs_file_s *tfo;
-  ssize_t nwritten;
+  FAR uint8_t *page;
+  size_t nwritten;
+  size_t ncopy;
+  size_t offset;
   off_t startpos;
   off_t endpos;
   int ret;
@@ -1630,28 +1812,72 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 
   tmpfs_lock_file(tfo);
 
-  /* Handle attempts to write beyond the end of the file */
+  /* Make sure that the page index covers the write.  Writing beyond the
+   * end of the file leaves a hole between the old end and the write.
+   */
 
   startpos = filep->f_pos;
-  nwritten = buflen;
   endpos   = startpos + buflen;
 
-  if (endpos > tfo->tfo_size)
+  ret = tmpfs_grow_pages(tfo, TMPFS_NPAGES((size_t)endpos));
+  if (ret < 0)
     {
-      /* Reallocate the file to handle the write past the end of the file. */
+      goto errout_with_lock;
+    }
 
-      ret = tmpfs_realloc_file(&tfo, (size_t)endpos);
-      if (ret < 0)
+  /* Copy data from the user buffer to the file pages a page at a time,
+   * allocating pages as needed.
+   */
+
+  for (nwritten = 0; startpos < endpos;
+       startpos += ncopy, nwritten += ncopy)
+    {
+      offset = startpos % TMPFS_PAGESIZE;
+      ncopy  = TMPFS_PAGESIZE - offset;
+      if (ncopy > (size_t)(endpos - startpos))
         {
-          goto errout_with_lock;
+          ncopy = endpos - startpos;
+        }
+
+      page = tfo->tfo_pages[startpos / TMPFS_PAGESIZE];
+      if (page == NULL)
+        {
+          /* A new page must be cleared unless it is written entirely */
+
+          if (ncopy == TMPFS_PAGESIZE)
+            {
+              page = (FAR uint8_t *)kmm_malloc(TMPFS_PAGESIZE);
+            }
+          else
+            {
+              page = (FAR uint8_t *)kmm_zalloc(TMPFS_PAGESIZE);
+            }
+
+          if (page == NULL)
+            {
+              break;
+            }
+
+          tfo->tfo_pages[startpos / TMPFS_PAGESIZE] = page;
+          tfo->tfo_alloc += TMPFS_PAGESIZE;
         }
 
-      filep->f_priv = tfo;
+      memcpy(&page[offset], &buffer[nwritten], ncopy);
+    }
+
+  /* Report a partial write if memory ran out part way */
+
+  if (nwritten == 0 && buflen > 0)
+    {
+      ret = -ENOMEM;
+      goto errout_with_lock;
     }
 
-  /* Copy data from the memory object to the user buffer */
+  if ((size_t)startpos > tfo->tfo_size)
+    {
+      tfo->tfo_size = startpos;
+    }
 
-  memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
   filep->f_pos += nwritten;
 
   /* Release the lock on the file */
@@ -1732,6 +1958,7 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
   FAR struct tmpfs_file_s *tfo;
   FAR void **ppv = (FAR void**)arg;
+  int ret;
 
   finfo("filep: %p cmd: %d arg: %08lx\n", filep, cmd, arg);
   DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
@@ -1742,15 +1969,28 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   DEBUGASSERT(tfo != NULL);
 
-  /* Only one ioctl command is supported */
-
   if (cmd == FIOC_MMAP && ppv != NULL)
     {
-      /* Return the address on the media corresponding to the start of
-       * the file.
+      /* Return the address of the contiguous region that holds the file
+       * data, creating it if necessary.
        */
 
-      *ppv = (FAR void *)tfo->tfo_data;
+      tmpfs_lock_file(tfo);
+      ret = tmpfs_map_file(tfo);
+      if (ret >= 0)
+        {
+          *ppv = (FAR void *)tfo->tfo_map;
+        }
+
+      tmpfs_unlock_file(tfo);
+      return ret;
+    }
+
+  if (cmd == FIOC_FILEID && arg != 0)
+    {
+      /* The file object persists for as long as the file is open */
+
+      *(FAR uintptr_t *)((uintptr_t)arg) = (uintptr_t)tfo;
       return OK;
     }
 
@@ -1832,8 +2072,6 @@ static int tmpfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
 static int tmpfs_truncate(FAR struct file *filep, off_t length)
 {
   FAR struct tmpfs_file_s *tfo;
-  size_t oldsize;
-  int ret = OK;
 
   finfo("filep: %p length: %ld\n", filep, (long)length);
   DEBUGASSERT(filep != NULL && length >= 0);
@@ -1846,40 +2084,16 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
 
   tmpfs_lock_file(tfo);
 
-  /* Get the old size of the file.  Do nothing if the file size is not
-   * changing.
+  /* Set the new size.  If the file grows, the new space is a hole and
+   * no memory is allocated for it.
    */
 
-  oldsize = tfo->tfo_size;
-  if (oldsize != length)
-    {
-      /* The size is changing.. up or down.  Reallocate the file memory. */
-
-      ret = tmpfs_realloc_file(&tfo, (size_t)length);
-      if (ret < 0)
-        {
-          goto errout_with_lock;
-        }
-
-      filep->f_priv = tfo;
-
-      /* If the size has increased, then we need to zero the newly added
-       * memory.
-       */
-
-      if (length > oldsize)
-        {
-          memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
-        }
-
-      ret = OK;
-    }
+  tmpfs_resize_file(tfo, (size_t)length);
 
   /* Release the lock on the file */
 
-errout_with_lock:
   tmpfs_unlock_file(tfo);
-  return ret;
+  return OK;
 }
 
 /****************************************************************************
@@ -2280,8 +2494,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
 
   else
     {
-      nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
     }
 
   /* Release the reference and lock on the parent directory */
@@ -58,6 +58,11 @@
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
 
+/* File data is held in fixed size pages */
+
+#define TMPFS_PAGESIZE    CONFIG_FS_TMPFS_PAGESIZE
+#define TMPFS_NPAGES(n)   (((n) + TMPFS_PAGESIZE - 1) / TMPFS_PAGESIZE)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -137,6 +142,17 @@ struct tmpfs_directory_s
  * state.  The file memory object also serves as the open file object,
  * saving an allocation.  This has the negative side effect that no per-
  * open state can be retained (such as open flags).
+ *
+ * The file data is held in pages of TMPFS_PAGESIZE bytes that are found
+ * through the page index tfo_pages[].  A NULL entry is a hole that reads
+ * as zeroes.  Bytes of allocated pages that lie beyond tfo_size are always
+ * zero.
+ *
+ * mmap() needs the file data to be contiguous.  The first mmap() of the
+ * file moves its pages into the single allocation tfo_map.  The first
+ * tfo_nmapped entries of tfo_pages[] then point into tfo_map so that
+ * read() and write() stay coherent with the mapping.  tfo_map is never
+ * moved or freed while the file exists.
  */
 
 struct tmpfs_file_s
@@ -146,7 +162,7 @@ struct tmpfs_file_s
   FAR struct tmpfs_dirent_s *tfo_dirent;
   struct tmpfs_sem_s tfo_exclsem;
 
-  size_t   tfo_alloc;    /* Allocated size of the file object */
+  size_t   tfo_alloc;    /* Memory used by the file and its pages */
   uint8_t  tfo_type;     /* See enum tmpfs_objtype_e */
   uint8_t  tfo_refs;     /* Reference count */
 
@@ -154,11 +170,12 @@ struct tmpfs_file_s
 
   uint8_t  tfo_flags;    /* See TFO_FLAG_* definitions */
   size_t   tfo_size;     /* Valid file size */
-  uint8_t  tfo_data[1];  /* File data starts here */
+  size_t   tfo_npages;   /* Number of entries in the page index */
+  size_t   tfo_nmapped;  /* Number of pages held in tfo_map */
+  FAR uint8_t *tfo_map;  /* Contiguous pages for mmap() (may be NULL) */
+  FAR uint8_t **tfo_pages; /* Page index */
 };
 
-#define SIZEOF_TMPFS_FILE(n) (sizeof(struct tmpfs_file_s) + (n) - 1)
-
 /* This structure represents one instance of a TMPFS file system */
 
 struct tmpfs_s
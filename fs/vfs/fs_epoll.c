@@ -42,194 +42,1101 @@
 #include <sys/epoll.h>
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
 #include <poll.h>
+#include <fcntl.h>
+#include <semaphore.h>
+#include <assert.h>
 #include <errno.h>
-#include <string.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* These are the events that are always monitored, whether requested or
+ * not.
+ */
+
+#define EPOLL_ALWAYS  (POLLERR | POLLHUP)
+
+/* These are the flags that select behavior but are not events */
+
+#define EPOLL_FLAGS   (EPOLLONESHOT | EPOLLET)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one file descriptor registered with an epoll
+ * instance.  The embedded pollfd stays set up with the driver for as long
+ * as the registration is armed so that readiness changes are delivered
+ * directly to the instance's ready list instead of being re-discovered by
+ * scanning every descriptor on each call to epoll_wait().
+ */
+
+struct epoll_head_s;
+struct epoll_node_s
+{
+  FAR struct epoll_node_s *flink;    /* Next registration of this instance */
+  FAR struct epoll_node_s *rflink;   /* Next entry in the ready list */
+  FAR struct epoll_node_s *rblink;   /* Previous entry in the ready list */
+  FAR struct epoll_node_s *relink;   /* Link in the re-arm list */
+  FAR struct epoll_head_s *eph;      /* The containing epoll instance */
+  struct pollfd pfd;                 /* Persistent driver registration */
+  epoll_data_t data;                 /* User data returned with events */
+  uint32_t events;                   /* Requested events and flags */
+  pollevent_t revents;               /* Events accumulated while queued */
+  bool ready;                        /* True: In the ready list */
+  bool armed;                        /* True: pfd is set up with the driver */
+  bool recheck;                      /* True: Queued to re-check readiness */
+#ifdef CONFIG_NET
+  bool issock;                       /* True: pfd.ptr is a socket */
+#endif
+};
+
+/* This structure describes the state of one epoll instance.  It is the
+ * private data of the anonymous inode behind the epoll file descriptor.
+ */
+
+struct epoll_head_s
+{
+  FAR struct epoll_head_s *flink;    /* Next epoll instance */
+  sem_t sem;                         /* Signals readiness to epoll_wait() */
+  sem_t exclsem;                     /* Protects the registration list */
+  FAR struct epoll_node_s *nodes;    /* All registrations */
+  FAR struct epoll_node_s *rhead;    /* Head of the ready list */
+  FAR struct epoll_node_s *rtail;    /* Tail of the ready list */
+  unsigned int cbposts;              /* Semaphore posts made by callback */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int epoll_do_close(FAR struct file *filep);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* All epoll instances, so that the registrations of a descriptor can be
+ * removed when it is closed.  Protected by g_epoll_sem.
+ */
+
+static FAR struct epoll_head_s *g_epoll_heads;
+static sem_t g_epoll_sem = SEM_INITIALIZER(1);
+
+static const struct file_operations g_epoll_ops =
+{
+  NULL,            /* open */
+  epoll_do_close,  /* close */
+  NULL,            /* read */
+  NULL,            /* write */
+  NULL,            /* seek */
+  NULL,            /* ioctl */
+  NULL             /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL           /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_semtake
+ ****************************************************************************/
+
+static void epoll_semtake(FAR sem_t *sem)
+{
+  int ret;
+
+  do
+    {
+      /* Take the semaphore (perhaps waiting) */
+
+      ret = nxsem_wait(sem);
+
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+}
+
+#define epoll_semgive(sem) nxsem_post(sem)
+
+/****************************************************************************
+ * Name: epoll_head
+ *
+ * Description:
+ *   Map an epoll file descriptor to the epoll instance.
+ *
+ ****************************************************************************/
+
+static int epoll_head(int epfd, FAR struct epoll_head_s **eph)
+{
+  FAR struct file *filep;
+  int ret;
+
+  ret = fs_getfilep(epfd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (filep->f_inode == NULL || filep->f_inode->u.i_ops != &g_epoll_ops)
+    {
+      return -EINVAL;
+    }
+
+  *eph = (FAR struct epoll_head_s *)filep->f_inode->i_private;
+  DEBUGASSERT(*eph != NULL);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_find
+ *
+ * Description:
+ *   Find the registration of fd.  The caller must hold exclsem.
+ *
+ ****************************************************************************/
+
+static FAR struct epoll_node_s *epoll_find(FAR struct epoll_head_s *eph,
+                                           int fd)
+{
+  FAR struct epoll_node_s *node;
+
+  for (node = eph->nodes; node != NULL; node = node->flink)
+    {
+      if (node->pfd.fd == fd)
+        {
+          break;
+        }
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: epoll_rqadd and epoll_rqrem
+ *
+ * Description:
+ *   Add or remove a registration to/from the ready list.  Must be called
+ *   from within a critical section.
+ *
+ ****************************************************************************/
+
+static void epoll_rqadd(FAR struct epoll_head_s *eph,
+                        FAR struct epoll_node_s *node)
+{
+  node->rflink = NULL;
+  node->rblink = eph->rtail;
+
+  if (eph->rtail != NULL)
+    {
+      eph->rtail->rflink = node;
+    }
+  else
+    {
+      eph->rhead = node;
+    }
+
+  eph->rtail  = node;
+  node->ready = true;
+}
+
+static void epoll_rqrem(FAR struct epoll_head_s *eph,
+                        FAR struct epoll_node_s *node)
+{
+  if (node->rblink != NULL)
+    {
+      node->rblink->rflink = node->rflink;
+    }
+  else
+    {
+      eph->rhead = node->rflink;
+    }
+
+  if (node->rflink != NULL)
+    {
+      node->rflink->rblink = node->rblink;
+    }
+  else
+    {
+      eph->rtail = node->rblink;
+    }
+
+  node->rflink = NULL;
+  node->rblink = NULL;
+  node->ready  = false;
+}
+
+/****************************************************************************
+ * Name: epoll_callback
+ *
+ * Description:
+ *   Called by poll_notify() when the driver reports an event on a
+ *   registered descriptor.  This may run from interrupt context.
+ *
+ ****************************************************************************/
+
+static void epoll_callback(FAR struct pollfd *fds)
+{
+  FAR struct epoll_node_s *node = (FAR struct epoll_node_s *)fds->arg;
+  FAR struct epoll_head_s *eph;
+  irqstate_t flags;
+
+  DEBUGASSERT(node != NULL && node->eph != NULL);
+  eph = node->eph;
+
+  flags = enter_critical_section();
+  node->revents |= fds->revents;
+
+  if (node->armed && !node->ready)
+    {
+      epoll_rqadd(eph, node);
+      eph->cbposts++;
+      nxsem_post(&eph->sem);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_poll
+ *
+ * Description:
+ *   Set up or tear down a poll of the file or socket of one node.  The
+ *   file or socket saved by EPOLL_CTL_ADD is used rather than the
+ *   descriptor number, so that the same object is addressed no matter
+ *   which task calls.
+ *
+ ****************************************************************************/
+
+static int epoll_poll(FAR struct epoll_node_s *node, FAR struct pollfd *fds,
+                      bool setup)
+{
+#ifdef CONFIG_NET
+  if (node->issock)
+    {
+      return psock_poll((FAR struct socket *)node->pfd.ptr, fds, setup);
+    }
+#endif
+
+  return file_poll((FAR struct file *)node->pfd.ptr, fds, setup);
+}
+
+/****************************************************************************
+ * Name: epoll_fdsetup
+ *
+ * Description:
+ *   Set up or tear down the persistent poll registration of one node.
+ *
+ ****************************************************************************/
+
+static int epoll_fdsetup(FAR struct epoll_node_s *node, bool setup)
+{
+  FAR struct pollfd *fds = &node->pfd;
+  int ret;
+
+  if (setup)
+    {
+      fds->events  = (pollevent_t)(node->events & ~EPOLL_FLAGS) |
+                     EPOLL_ALWAYS;
+      fds->revents = 0;
+      fds->sem     = &node->eph->sem;
+      fds->priv    = NULL;
+      fds->cb      = epoll_callback;
+      fds->arg     = node;
+      node->armed  = true;
+    }
+  else if (!node->armed)
+    {
+      return OK;
+    }
+
+  ret = epoll_poll(node, fds, setup);
+  if (!setup || ret < 0)
+    {
+      node->armed = false;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: epoll_probe
+ *
+ * Description:
+ *   Return the events that are pending now on the descriptor of a level-
+ *   triggered node that was reported before and has not been notified
+ *   since.  A separate poll structure is used so that the persistent
+ *   registration stays in place.  If the driver has no room for another
+ *   poll, the persistent registration is refreshed instead and the events
+ *   are left in the node.
+ *
+ ****************************************************************************/
+
+static pollevent_t epoll_probe(FAR struct epoll_node_s *node)
+{
+  struct pollfd fds;
+
+  fds.fd      = node->pfd.fd;
+  fds.events  = node->pfd.events;
+  fds.revents = 0;
+  fds.ptr     = node->pfd.ptr;
+  fds.sem     = NULL;
+  fds.priv    = NULL;
+  fds.cb      = NULL;
+  fds.arg     = NULL;
+
+  if (epoll_poll(node, &fds, true) >= 0)
+    {
+      (void)epoll_poll(node, &fds, false);
+      return fds.revents & fds.events;
+    }
+
+  /* Setup notifies any pending events to the node itself; the caller
+   * takes them from there.
+   */
+
+  (void)epoll_fdsetup(node, false);
+  (void)epoll_fdsetup(node, true);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: epoll_unregister
+ *
+ * Description:
+ *   Tear down and free one registration.  The caller must hold exclsem.
+ *
+ ****************************************************************************/
+
+static void epoll_unregister(FAR struct epoll_head_s *eph,
+                             FAR struct epoll_node_s *node)
+{
+  FAR struct epoll_node_s **pprev;
+  irqstate_t flags;
+
+  (void)epoll_fdsetup(node, false);
+
+  flags = enter_critical_section();
+  if (node->ready)
+    {
+      epoll_rqrem(eph, node);
+    }
+
+  leave_critical_section(flags);
+
+  for (pprev = &eph->nodes; *pprev != node; pprev = &(*pprev)->flink)
+    {
+    }
+
+  *pprev = node->flink;
+  kmm_free(node);
+}
+
+/****************************************************************************
+ * Name: epoll_scan
+ *
+ * Description:
+ *   Not all drivers report events through poll_notify(); some still post
+ *   the semaphore directly.  When the semaphore was posted but not by
+ *   epoll_callback(), find the registrations that have pending events the
+ *   old fashioned way.  The caller must hold exclsem and be within a
+ *   critical section.
+ *
+ ****************************************************************************/
+
+static void epoll_scan(FAR struct epoll_head_s *eph)
+{
+  FAR struct epoll_node_s *node;
+
+  for (node = eph->nodes; node != NULL; node = node->flink)
+    {
+      if (node->armed && !node->ready && node->pfd.revents != 0)
+        {
+          epoll_rqadd(eph, node);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_collect
+ *
+ * Description:
+ *   Move up to maxevents entries from the ready list into evs.  The caller
+ *   must hold exclsem.
+ *
+ *   Level-triggered registrations stay set up with the driver.  After being
+ *   reported they are put back in the ready list to be re-checked by the
+ *   next call:  If the driver has not notified them again in the meantime,
+ *   epoll_probe() finds out whether the descriptor is still ready.
+ *
+ ****************************************************************************/
+
+static int epoll_collect(FAR struct epoll_head_s *eph,
+                         FAR struct epoll_event *evs, int maxevents,
+                         bool posted)
+{
+  FAR struct epoll_node_s *rearm = NULL;
+  FAR struct epoll_node_s *node;
+  irqstate_t flags;
+  pollevent_t revents;
+  bool recheck;
+  int nevents = 0;
+
+  flags = enter_critical_section();
+
+  /* Account for the semaphore count just taken, if any */
+
+  if (posted)
+    {
+      if (eph->cbposts > 0)
+        {
+          eph->cbposts--;
+        }
+      else
+        {
+          epoll_scan(eph);
+        }
+    }
+
+  while (nevents < maxevents && (node = eph->rhead) != NULL)
+    {
+      epoll_rqrem(eph, node);
+
+      revents            = (node->revents | node->pfd.revents) &
+                           node->pfd.events;
+      recheck            = node->recheck;
+      node->revents      = 0;
+      node->pfd.revents  = 0;
+      node->recheck      = false;
+
+      if (revents == 0 && recheck && node->armed)
+        {
+          /* Not notified since it was last reported.  Ask the driver
+           * outside of the critical section.
+           */
+
+          leave_critical_section(flags);
+          revents = epoll_probe(node);
+          flags   = enter_critical_section();
+
+          /* It may have been notified and queued again meanwhile */
+
+          if (node->ready)
+            {
+              epoll_rqrem(eph, node);
+            }
+
+          revents          |= (node->revents | node->pfd.revents) &
+                              node->pfd.events;
+          node->revents     = 0;
+          node->pfd.revents = 0;
+        }
+
+      /* A one-shot registration may be re-queued between being reported
+       * and being torn down.
+       */
+
+      if (revents == 0 || !node->armed)
+        {
+          continue;
+        }
+
+      evs[nevents].events = revents;
+      evs[nevents].data   = node->data;
+      nevents++;
+
+      /* One-shot registrations are disarmed until re-enabled with
+       * EPOLL_CTL_MOD; level-triggered registrations are re-checked;
+       * edge-triggered registrations are left as they are.
+       */
+
+      if ((node->events & (EPOLLONESHOT | EPOLLET)) != EPOLLET)
+        {
+          node->relink = rearm;
+          rearm = node;
+        }
+    }
+
+  /* Queue the level-triggered registrations for the next call */
+
+  for (node = rearm; node != NULL; node = node->relink)
+    {
+      if ((node->events & EPOLLONESHOT) == 0 && !node->ready)
+        {
+          node->recheck = true;
+          epoll_rqadd(eph, node);
+        }
+    }
+
+  leave_critical_section(flags);
+
+  /* Tear down one-shot registrations */
+
+  for (node = rearm; node != NULL; node = node->relink)
+    {
+      if ((node->events & EPOLLONESHOT) != 0)
+        {
+          (void)epoll_fdsetup(node, false);
+        }
+    }
+
+  return nevents;
+}
+
+/****************************************************************************
+ * Name: epoll_unlink
+ *
+ * Description:
+ *   Remove an epoll instance from the list of instances.
+ *
+ ****************************************************************************/
+
+static void epoll_unlink(FAR struct epoll_head_s *eph)
+{
+  FAR struct epoll_head_s **pprev;
+
+  epoll_semtake(&g_epoll_sem);
+  for (pprev = &g_epoll_heads; *pprev != eph; pprev = &(*pprev)->flink)
+    {
+    }
+
+  *pprev = eph->flink;
+  epoll_semgive(&g_epoll_sem);
+}
+
+/****************************************************************************
+ * Name: epoll_do_close
+ *
+ * Description:
+ *   The close method of the epoll inode.  Frees the instance when the last
+ *   reference is closed.
+ *
+ ****************************************************************************/
+
+static int epoll_do_close(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct epoll_head_s *eph;
+  FAR struct epoll_node_s *node;
+  FAR struct epoll_node_s *next;
+
+  DEBUGASSERT(inode != NULL && inode->i_private != NULL);
+
+  /* Other descriptors may still refer to the instance after dup() */
+
+  if (inode->i_crefs > 1)
+    {
+      return OK;
+    }
+
+  eph = (FAR struct epoll_head_s *)inode->i_private;
+  inode->i_private = NULL;
+
+  /* After this, epoll_fdclose() no longer visits the instance */
+
+  epoll_unlink(eph);
+
+  for (node = eph->nodes; node != NULL; node = next)
+    {
+      next = node->flink;
+      (void)epoll_fdsetup(node, false);
+      kmm_free(node);
+    }
+
+  nxsem_destroy(&eph->sem);
+  nxsem_destroy(&eph->exclsem);
+  kmm_free(eph);
+
+  /* The inode itself is freed by inode_release() */
+
+  return OK;
+}
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: epoll_create
+ * Name: epoll_create1
  *
  * Description:
+ *   Create an epoll instance and return a file descriptor that refers to
+ *   it.  The descriptor must be released with close().
  *
  * Input Parameters:
+ *   flags - Zero or EPOLL_CLOEXEC
  *
  * Returned Value:
+ *   A non-negative file descriptor on success.  -1 is returned on failure
+ *   with the errno variable set appropriately:
+ *
+ *   EINVAL - Invalid flags
+ *   EMFILE - No free file descriptor
+ *   ENOMEM - Insufficient memory
  *
  ****************************************************************************/
 
-int epoll_create(int size)
+int epoll_create1(int flags)
 {
-  FAR struct epoll_head *eph =
-    (FAR struct epoll_head *)kmm_malloc(sizeof(struct epoll_head));
+  FAR struct epoll_head_s *eph;
+  FAR struct inode *inode;
+  int errcode;
+  int fd;
 
-  eph->size = size;
-  eph->occupied = 0;
-  eph->evs = kmm_malloc(sizeof(struct epoll_event) * eph->size);
+  if ((flags & ~EPOLL_CLOEXEC) != 0)
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
 
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
+  eph = (FAR struct epoll_head_s *)kmm_zalloc(sizeof(struct epoll_head_s));
+  if (eph == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout;
+    }
+
+  /* The semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_init(&eph->sem, 0, 0);
+  nxsem_setprotocol(&eph->sem, SEM_PRIO_NONE);
+  nxsem_init(&eph->exclsem, 0, 1);
+
+  /* Create an anonymous inode to hold the instance.  It is never linked
+   * into the inode tree and is freed when the last reference is closed.
    */
 
-  return (int)((intptr_t)eph);
+  inode = (FAR struct inode *)kmm_zalloc(FSNODE_SIZE(0));
+  if (inode == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout_with_eph;
+    }
+
+  inode->i_crefs   = 1;
+  inode->i_flags   = FSNODEFLAG_DELETED;
+  inode->u.i_ops   = &g_epoll_ops;
+  inode->i_private = eph;
+
+  /* Add the instance to the list of instances before it can be used */
+
+  epoll_semtake(&g_epoll_sem);
+  eph->flink    = g_epoll_heads;
+  g_epoll_heads = eph;
+  epoll_semgive(&g_epoll_sem);
+
+  fd = files_allocate(inode, O_RDOK, 0, 0);
+  if (fd < 0)
+    {
+      errcode = EMFILE;
+      goto errout_with_list;
+    }
+
+  return fd;
+
+errout_with_list:
+  epoll_unlink(eph);
+  kmm_free(inode);
+
+errout_with_eph:
+  nxsem_destroy(&eph->sem);
+  nxsem_destroy(&eph->exclsem);
+  kmm_free(eph);
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: epoll_create
+ *
+ * Description:
+ *   Same as epoll_create1(0).  The size argument is only a hint and is
+ *   ignored other than being validated.
+ *
+ ****************************************************************************/
+
+int epoll_create(int size)
+{
+  if (size <= 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  return epoll_create1(0);
 }
 
 /****************************************************************************
  * Name: epoll_close
  *
  * Description:
+ *   Same as close(epfd).
+ *
+ ****************************************************************************/
+
+void epoll_close(int epfd)
+{
+  (void)close(epfd);
+}
+
+/****************************************************************************
+ * Name: epoll_fdclose
+ *
+ * Description:
+ *   Remove the registrations of a file or socket from all epoll instances.
+ *   Called just before the file or socket is closed, so that no driver
+ *   keeps a reference to the poll structure of a registration that would
+ *   otherwise outlive the descriptor.
  *
  * Input Parameters:
+ *   ptr - The struct file or struct socket being closed
  *
  * Returned Value:
+ *   None
  *
  ****************************************************************************/
 
-void epoll_close(int epfd)
+void epoll_fdclose(FAR void *ptr)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  FAR struct epoll_head_s *eph;
+  FAR struct epoll_node_s *node;
+  FAR struct epoll_node_s *next;
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  /* Most systems have no epoll instances at all */
 
-  kmm_free(eph->evs);
-  kmm_free(eph);
+  if (g_epoll_heads == NULL)
+    {
+      return;
+    }
+
+  epoll_semtake(&g_epoll_sem);
+  for (eph = g_epoll_heads; eph != NULL; eph = eph->flink)
+    {
+      epoll_semtake(&eph->exclsem);
+      for (node = eph->nodes; node != NULL; node = next)
+        {
+          next = node->flink;
+          if (node->pfd.ptr == ptr)
+            {
+              epoll_unregister(eph, node);
+            }
+        }
+
+      epoll_semgive(&eph->exclsem);
+    }
+
+  epoll_semgive(&g_epoll_sem);
 }
 
 /****************************************************************************
  * Name: epoll_ctl
  *
  * Description:
+ *   Add, modify, or remove the registration of fd with the epoll instance
+ *   epfd.  Closing a registered descriptor removes its registration.
  *
  * Input Parameters:
+ *   epfd - The epoll file descriptor
+ *   op   - EPOLL_CTL_ADD, EPOLL_CTL_MOD, or EPOLL_CTL_DEL
+ *   fd   - The target file or socket descriptor
+ *   ev   - The requested events and user data.  Ignored for EPOLL_CTL_DEL.
  *
  * Returned Value:
+ *   Zero on success.  -1 is returned on failure with the errno variable
+ *   set appropriately:
+ *
+ *   EBADF  - epfd or fd is not a valid descriptor
+ *   EEXIST - op is EPOLL_CTL_ADD and fd is already registered
+ *   EINVAL - epfd is not an epoll descriptor, fd is epfd, or op is invalid
+ *   ENOENT - op is EPOLL_CTL_MOD or EPOLL_CTL_DEL and fd is not registered
+ *   ENOMEM - Insufficient memory
  *
  ****************************************************************************/
 
-int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev)
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  FAR struct epoll_head_s *eph;
+  FAR struct epoll_node_s *node;
+  irqstate_t flags;
+  int ret;
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  ret = epoll_head(epfd, &eph);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (fd == epfd || (op != EPOLL_CTL_DEL && ev == NULL))
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  epoll_semtake(&eph->exclsem);
+  node = epoll_find(eph, fd);
 
   switch (op)
     {
       case EPOLL_CTL_ADD:
-        finfo("%08x CTL ADD(%d): fd=%d ev=%08x\n",
-              epfd, eph->occupied, fd, ev->events);
+        finfo("epfd=%d CTL ADD: fd=%d ev=%08lx\n",
+              epfd, fd, (unsigned long)ev->events);
 
-        eph->evs[eph->occupied].events = ev->events | POLLERR | POLLHUP;
-        eph->evs[eph->occupied++].data.fd = fd;
-        return 0;
+        if (node != NULL)
+          {
+            ret = -EEXIST;
+            break;
+          }
 
-      case EPOLL_CTL_DEL:
-        {
-          int i;
+        node = (FAR struct epoll_node_s *)
+          kmm_zalloc(sizeof(struct epoll_node_s));
+        if (node == NULL)
+          {
+            ret = -ENOMEM;
+            break;
+          }
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->evs[i].data.fd == fd)
-                {
-                  if (i != eph->occupied - 1)
-                    {
-                      memmove(&eph->evs[i], &eph->evs[i + 1],
-                              eph->occupied - i);
-                    }
-
-                  eph->occupied--;
-                  return 0;
-                }
-            }
+        node->eph    = eph;
+        node->pfd.fd = fd;
+        node->events = ev->events;
+        node->data   = ev->data;
 
-          return -ENOENT;
-        }
+        /* Remember the file or socket.  Its registration is removed by
+         * epoll_fdclose() when it is closed.
+         */
+
+        if ((unsigned int)fd < CONFIG_NFILE_DESCRIPTORS)
+          {
+            FAR struct file *filep;
+
+            ret = fs_getfilep(fd, &filep);
+            node->pfd.ptr = filep;
+          }
+#ifdef CONFIG_NET
+        else if ((unsigned int)fd < (CONFIG_NFILE_DESCRIPTORS +
+                                     CONFIG_NSOCKET_DESCRIPTORS))
+          {
+            FAR struct socket *psock = sockfd_socket(fd);
+
+            ret = psock != NULL && psock->s_crefs > 0 ? OK : -EBADF;
+            node->pfd.ptr = psock;
+            node->issock  = true;
+          }
+#endif
+        else
+          {
+            ret = -EBADF;
+          }
+
+        if (ret >= 0)
+          {
+            ret = epoll_fdsetup(node, true);
+          }
+
+        if (ret < 0)
+          {
+            kmm_free(node);
+            break;
+          }
+
+        node->flink = eph->nodes;
+        eph->nodes  = node;
+        break;
 
       case EPOLL_CTL_MOD:
-        {
-          int i;
+        finfo("epfd=%d CTL MOD: fd=%d ev=%08lx\n",
+              epfd, fd, (unsigned long)ev->events);
 
-          finfo("%08x CTL MOD(%d): fd=%d ev=%08x\n",
-                epfd, eph->occupied, fd, ev->events);
+        if (node == NULL)
+          {
+            ret = -ENOENT;
+            break;
+          }
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->evs[i].data.fd == fd)
-                {
-                  eph->evs[i].events = ev->events | POLLERR | POLLHUP;
-                  return 0;
-                }
-            }
+        (void)epoll_fdsetup(node, false);
 
-          return -ENOENT;
-        }
+        flags = enter_critical_section();
+        if (node->ready)
+          {
+            epoll_rqrem(eph, node);
+          }
+
+        node->revents = 0;
+        node->recheck = false;
+        leave_critical_section(flags);
+
+        node->events = ev->events;
+        node->data   = ev->data;
+        ret = epoll_fdsetup(node, true);
+        break;
+
+      case EPOLL_CTL_DEL:
+        finfo("epfd=%d CTL DEL: fd=%d\n", epfd, fd);
+
+        if (node == NULL)
+          {
+            ret = -ENOENT;
+            break;
+          }
+
+        epoll_unregister(eph, node);
+        break;
+
+      default:
+        ret = -EINVAL;
+        break;
+    }
+
+  epoll_semgive(&eph->exclsem);
+
+  if (ret < 0)
+    {
+      goto errout;
     }
 
-  return -EINVAL;
+  return OK;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
 }
 
 /****************************************************************************
  * Name: epoll_wait
  *
  * Description:
+ *   Wait for events on the descriptors registered with epfd.  Only the
+ *   descriptors that became ready are visited; the cost does not depend on
+ *   the number of registered descriptors.
  *
  * Input Parameters:
+ *   epfd      - The epoll file descriptor
+ *   evs       - The location to return the events
+ *   maxevents - The maximum number of events to return
+ *   timeout   - Wait time in milliseconds: Zero means to return immediately
+ *               and -1 means to wait indefinitely.
  *
  * Returned Value:
+ *   The number of events returned, zero on timeout.  -1 is returned on
+ *   failure with the errno variable set appropriately:
+ *
+ *   EBADF  - epfd is not a valid descriptor
+ *   EINTR  - A signal was received while waiting
+ *   EINVAL - epfd is not an epoll descriptor or maxevents is not positive
  *
  ****************************************************************************/
 
 int epoll_wait(int epfd, FAR struct epoll_event *evs, int maxevents,
                int timeout)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  FAR struct epoll_head_s *eph;
+  clock_t start = 0;
+  clock_t ticks = 0;
+  bool posted = false;
+  int ret;
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
-  int counter;
-  int rc;
-  int i;
+  /* epoll_wait() is a cancellation point */
 
-  rc = poll((FAR struct pollfd *)eph->evs, eph->occupied, timeout);
+  (void)enter_cancellation_point();
 
-  if (rc <= 0)
+  ret = epoll_head(epfd, &eph);
+  if (ret < 0)
     {
-      if (rc < 0)
+      goto errout;
+    }
+
+  if (evs == NULL || maxevents <= 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  if (timeout > 0)
+    {
+      /* Round timeout up to next full tick, as does poll() */
+
+#if (MSEC_PER_TICK * USEC_PER_MSEC) != USEC_PER_TICK && \
+    defined(CONFIG_HAVE_LONG_LONG)
+      ticks = (((unsigned long long)timeout * USEC_PER_MSEC) +
+               (USEC_PER_TICK - 1)) /
+              USEC_PER_TICK;
+#else
+      ticks = ((unsigned int)timeout + (MSEC_PER_TICK - 1)) /
+              MSEC_PER_TICK;
+#endif
+      start = clock_systimer();
+    }
+
+  for (; ; )
+    {
+      epoll_semtake(&eph->exclsem);
+      ret = epoll_collect(eph, evs, maxevents, posted);
+      epoll_semgive(&eph->exclsem);
+      posted = false;
+
+      if (ret > 0 || timeout == 0)
         {
-          ferr("ERROR: %08x poll fail: %d for %d, %d msecs\n",
-               epfd, rc, eph->occupied, timeout);
+          break;
+        }
+
+      /* Nothing is ready.  Wait for the next notification.  Stale counts
+       * left behind by notifications already consumed only cause an extra
+       * pass through the (empty) ready list.
+       */
 
-          for (i = 0; i < eph->occupied; i++)
+      if (timeout > 0)
+        {
+          ret = nxsem_tickwait(&eph->sem, start, ticks);
+          if (ret == -ETIMEDOUT)
             {
-              ferr("  %02d: fd=%d\n", i, eph->evs[i].data.fd);
+              ret = 0;
+              break;
             }
         }
+      else
+        {
+          ret = nxsem_wait(&eph->sem);
+        }
 
-      return rc;
-    }
-
-  /* Iterate over non NULL event fds */
-
-  for (i = 0, counter = 0; i < rc && counter < eph->size; counter++)
-    {
-      if (eph->evs[counter].revents != 0)
+      if (ret < 0)
         {
-          evs[i].data.fd = eph->evs[counter].data.fd;
-          evs[i].events  = eph->evs[counter].revents;
-          i += 1;
+          goto errout;
         }
+
+      posted = true;
     }
 
-  return i;
-}
+  leave_cancellation_point();
+  return ret;
 
+errout:
+  leave_cancellation_point();
+  set_errno(-ret);
+  return ERROR;
+}
@@ -126,6 +126,8 @@ int mkdir(const char *pathname, mode_t mode)
               errcode = -ret;
               goto errout_with_inode;
             }
+
+          inode_cache_mntflush(inode->i_private);
         }
       else
         {
@@ -233,6 +233,13 @@ int nx_vopen(FAR const char *path, int oflags, va_list ap)
       if (INODE_IS_MOUNTPT(inode))
         {
           ret = inode->u.i_mops->open(filep, desc.relpath, oflags, mode);
+
+          /* A file may have been created in the volume */
+
+          if (ret >= 0 && (oflags & O_CREAT) != 0)
+            {
+              inode_cache_mntflush(inode->i_private);
+            }
         }
       else
 #endif
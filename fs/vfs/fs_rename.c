@@ -471,6 +471,10 @@ next_subdir:
       ret = oldinode->u.i_mops->rename(oldinode, oldrelpath, newrelpath);
     }
 
+  /* Names cached for the volume may no longer be valid */
+
+  inode_cache_mntflush(oldinode->i_private);
+
 errout_with_newinode:
   inode_release(newinode);
 
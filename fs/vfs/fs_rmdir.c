@@ -126,6 +126,8 @@ int rmdir(FAR const char *pathname)
               errcode = -ret;
               goto errout_with_inode;
             }
+
+          inode_cache_mntflush(inode->i_private);
         }
       else
         {
@@ -49,8 +49,9 @@
 
 #include <nuttx/sched.h>
 #include <nuttx/net/net.h>
+#include <nuttx/drivers/drivers.h>
 
-#ifdef CONFIG_NET_SENDFILE
+#if defined(CONFIG_NET_SENDFILE) || defined(CONFIG_DEV_PIPE_SENDFILE)
 
 /****************************************************************************
  * Public Functions
@@ -103,6 +104,25 @@
 
 ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
 {
+#ifdef CONFIG_DEV_PIPE_SENDFILE
+  /* Is either descriptor a pipe or FIFO?  Pipes have no file offset. */
+
+  if (offset == NULL)
+    {
+      ssize_t ret = pipe_sendfile(outfd, infd, count);
+      if (ret != -ENOSYS)
+        {
+          if (ret < 0)
+            {
+              set_errno(-ret);
+              return ERROR;
+            }
+
+          return ret;
+        }
+    }
+#endif
+
 #ifdef CONFIG_NET_SENDFILE
   /* Check the destination file descriptor:  Is it a (probable) file
    * descriptor?  Check the source file:  Is it a normal file?
@@ -148,5 +168,5 @@ ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
   return lib_sendfile(outfd, infd, offset, count);
 }
 
-#endif /* CONFIG_NET_SENDFILE */
+#endif /* CONFIG_NET_SENDFILE || CONFIG_DEV_PIPE_SENDFILE */
 
@@ -125,6 +125,8 @@ int unlink(FAR const char *pathname)
               errcode = -ret;
               goto errout_with_inode;
             }
+
+          inode_cache_mntflush(inode->i_private);
         }
       else
         {
@@ -79,6 +79,14 @@
 #  define CONFIG_HAVE_BUILTIN_CLZ 1
 #endif
 
+/* GCC 4.7 and later have the __atomic_*() built-in functions.  Whether they
+ * are lock-free for a given object size depends on the architecture.
+ */
+
+#if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7)
+#  define CONFIG_HAVE_BUILTIN_ATOMIC 1
+#endif
+
 /* C++ support */
 
 #if defined(__cplusplus) && __cplusplus >= 201402L
@@ -42,6 +42,8 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <sys/types.h>
 #include <stdint.h>
 
 /****************************************************************************
@@ -49,6 +51,11 @@
  ****************************************************************************/
 
 #define AES128_KEY_SIZE    16
+#define AES192_KEY_SIZE    24
+#define AES256_KEY_SIZE    32
+
+#define AES_BLOCK_SIZE     16
+#define AES_MAXROUNDS      14
 
 /****************************************************************************
  * Public Types
@@ -56,8 +63,19 @@
 
 struct aes_state_s
 {
-  uint8_t expanded_key[176];
+  uint32_t ek[4 * (AES_MAXROUNDS + 1)];  /* Encryption round keys */
+  uint32_t dk[4 * (AES_MAXROUNDS + 1)];  /* Decryption round keys */
+  int nrounds;                           /* 10, 12 or 14 */
+};
+
+#ifdef CONFIG_CRYPTO_AES_GCM
+struct aes_gcm_s
+{
+  struct aes_state_s aes;                /* Only ek[] is used */
+  uint64_t hh[16];                       /* GHASH tables for the hash subkey */
+  uint64_t hl[16];
 };
+#endif
 
 /****************************************************************************
  * Public Data
@@ -118,14 +136,12 @@ void aes_decrypt(FAR uint8_t *state, FAR const uint8_t *key);
  *
  * Input Parameters:
  *  state  an AES context that can be used for AES operations
- *  key    a pointer to a 16-byte buffer holding the AES-128 key
- *  len    length of the key, must be 16
- *
- * TODO: Support other key lengths of 24 (AES-192) and 32 (AES-256)
+ *  key    a pointer to a buffer holding the AES key
+ *  len    length of the key:  16 (AES-128), 24 (AES-192) or 32 (AES-256)
  *
  * Returned Value:
  *   0 if OK
- *   -EINVAL if len is not 16
+ *   -EINVAL if len is not 16, 24 or 32
  *
  ****************************************************************************/
 
@@ -164,6 +180,70 @@ void aes_encipher(FAR struct aes_state_s *state, FAR uint8_t *blocks,
 void aes_decipher(FAR struct aes_state_s *state, FAR uint8_t *blocks,
                   int nblk);
 
+#ifdef CONFIG_CRYPTO_AES_GCM
+/****************************************************************************
+ * Name: aes_gcm_setkey
+ *
+ * Description:
+ *   Prepare a GCM context for the given key.  The context can then be used
+ *   for any number of aes_gcm_encrypt() and aes_gcm_decrypt() calls.
+ *
+ * Input Parameters:
+ *  gcm    the GCM context
+ *  key    a pointer to a buffer holding the AES key
+ *  len    length of the key:  16, 24 or 32
+ *
+ * Returned Value:
+ *   0 if OK
+ *   -EINVAL if len is not 16, 24 or 32
+ *
+ ****************************************************************************/
+
+int aes_gcm_setkey(FAR struct aes_gcm_s *gcm, FAR const uint8_t *key,
+                   int len);
+
+/****************************************************************************
+ * Name: aes_gcm_encrypt
+ *
+ * Description:
+ *   Encrypt and authenticate len bytes with AES-GCM.  aad is authenticated
+ *   but not encrypted.  A 12-byte IV is recommended; other lengths are
+ *   hashed.  taglen may be 4 to 16 bytes.  out may be the same buffer as
+ *   in.
+ *
+ * Returned Value:
+ *   0 if OK
+ *   -EINVAL if ivlen or taglen is invalid
+ *
+ ****************************************************************************/
+
+int aes_gcm_encrypt(FAR const struct aes_gcm_s *gcm,
+                    FAR const uint8_t *iv, size_t ivlen,
+                    FAR const uint8_t *aad, size_t aadlen,
+                    FAR const uint8_t *in, FAR uint8_t *out, size_t len,
+                    FAR uint8_t *tag, size_t taglen);
+
+/****************************************************************************
+ * Name: aes_gcm_decrypt
+ *
+ * Description:
+ *   Decrypt len bytes with AES-GCM and verify the authentication tag.  On
+ *   a tag mismatch, the output buffer is cleared.
+ *
+ * Returned Value:
+ *   0 if OK
+ *   -EINVAL if ivlen or taglen is invalid
+ *   -EBADMSG if the tag does not match
+ *
+ ****************************************************************************/
+
+int aes_gcm_decrypt(FAR const struct aes_gcm_s *gcm,
+                    FAR const uint8_t *iv, size_t ivlen,
+                    FAR const uint8_t *aad, size_t aadlen,
+                    FAR const uint8_t *in, FAR uint8_t *out, size_t len,
+                    FAR const uint8_t *tag, size_t taglen);
+#endif
+
 #ifdef  __cplusplus
 }
 #endif /* __cplusplus */
@@ -53,6 +53,7 @@
 #define CRYPTO_AES_ECB          1
 #define CRYPTO_AES_CBC          2
 #define CRYPTO_AES_CTR          3
+#define CRYPTO_AES_GCM          4
 #define CRYPTO_ALGORITHM_MAX    1
 
 #define CRYPTO_FLAG_HARDWARE    0x01000000 /* hardware accelerated */
@@ -65,6 +66,7 @@
 #define CIOCGSESSION            101
 #define CIOCFSESSION            102
 #define CIOCCRYPT               103
+#define CIOCAUTHCRYPT           104
 
 typedef char* caddr_t;
 
@@ -92,4 +94,21 @@ struct crypt_op
   caddr_t iv;
 };
 
+/* Authenticated encryption (CRYPTO_AES_GCM) for CIOCAUTHCRYPT */
+
+struct crypt_auth_op
+{
+  uint32_t ses;
+  uint16_t op;        /* i.e. COP_ENCRYPT */
+  uint16_t flags;
+  unsigned len;       /* length of the payload */
+  unsigned auth_len;  /* length of the additional authenticated data */
+  caddr_t auth_src;   /* additional authenticated data */
+  caddr_t src, dst;
+  caddr_t tag;        /* returns the tag on encrypt, checked on decrypt */
+  unsigned tag_len;
+  caddr_t iv;
+  unsigned iv_len;
+};
+
 #endif /* __INCLUDE_NUTTX_CRYPTO_CRYPTODEV_H */
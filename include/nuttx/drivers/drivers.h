@@ -280,6 +280,32 @@ int pipe2(int fd[2], size_t bufsize);
 int mkfifo2(FAR const char *pathname, mode_t mode, size_t bufsize);
 #endif
 
+/****************************************************************************
+ * Name: pipe_sendfile
+ *
+ * Description:
+ *   Called from sendfile() to move data between a pipe or FIFO and another
+ *   file or socket without an intermediate buffer.  The data is written to
+ *   'outfd' directly from the pipe buffer or read from 'infd' directly into
+ *   the pipe buffer.
+ *
+ * Input Parameters:
+ *   outfd - The descriptor to write to
+ *   infd  - The descriptor to read from
+ *   count - The maximum number of bytes to transfer
+ *
+ * Returned Value:
+ *   The number of bytes transferred or a negated errno value.  -ENOSYS is
+ *   returned if neither descriptor refers to a pipe or FIFO, -EBADF if the
+ *   pipe end is not open for the direction used and -EINVAL if both
+ *   descriptors refer to the same pipe.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_PIPES) && defined(CONFIG_DEV_PIPE_SENDFILE)
+ssize_t pipe_sendfile(int outfd, int infd, size_t count);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,250 @@
+/****************************************************************************
+ * include/nuttx/drivers/msgring.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_DRIVERS_MSGRING_H
+#define __INCLUDE_NUTTX_DRIVERS_MSGRING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/fs/ioctl.h>
+
+#ifdef CONFIG_DEV_MSGRING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* IOCTL commands for zero-copy access to the ring.  The messages are
+ * accessed in place, so these are only usable when the ring memory is
+ * addressable by the caller (always true in the FLAT build).
+ *
+ * MSGRINGIOC_RESERVE
+ *   Reserve the next free message slot.  Blocks while the ring is full
+ *   unless the file was opened with O_NONBLOCK.  Reservations that have
+ *   not been committed when the file is closed (e.g., because the
+ *   producer exited) are abandoned; the reader never sees them.
+ *   IN:  Location to return the address of the message buffer (void **)
+ *   OUT: None
+ *
+ * MSGRINGIOC_COMMIT
+ *   Publish a message previously reserved with MSGRINGIOC_RESERVE.  Fails
+ *   with EINVAL if the message is not reserved or is already committed and
+ *   with EPERM if it was reserved through another file.
+ *   IN:  Message address and length (struct msgring_msg_s *)
+ *   OUT: None
+ *
+ * MSGRINGIOC_PEEK
+ *   Return the oldest message without removing it from the ring.  Blocks
+ *   while the ring is empty unless the file was opened with O_NONBLOCK.
+ *   Only the single reader may use this command.
+ *   IN:  Location to return the message (struct msgring_msg_s *)
+ *   OUT: None
+ *
+ * MSGRINGIOC_CONSUME
+ *   Release the message returned by MSGRINGIOC_PEEK.  Only the single
+ *   reader may use this command.
+ *   IN:  None
+ *   OUT: None
+ *
+ * MSGRINGIOC_GETINFO
+ *   Return the geometry of the ring.
+ *   IN:  Location to return the information (struct msgring_info_s *)
+ *   OUT: None
+ */
+
+#define MSGRINGIOC_RESERVE  _MSGRINGIOC(0x0001)
+#define MSGRINGIOC_COMMIT   _MSGRINGIOC(0x0002)
+#define MSGRINGIOC_PEEK     _MSGRINGIOC(0x0003)
+#define MSGRINGIOC_CONSUME  _MSGRINGIOC(0x0004)
+#define MSGRINGIOC_GETINFO  _MSGRINGIOC(0x0005)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Describes one message for MSGRINGIOC_COMMIT and MSGRINGIOC_PEEK */
+
+struct msgring_msg_s
+{
+  FAR void *buf;          /* Address of the message in the ring */
+  size_t len;             /* Length of the message in bytes */
+};
+
+/* Returned by MSGRINGIOC_GETINFO */
+
+struct msgring_info_s
+{
+  uint32_t nslots;        /* Number of message slots in the ring */
+  size_t msgsize;         /* Maximum size of one message in bytes */
+};
+
+/* The opaque state of one message ring */
+
+struct msgring_s;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: msgring_register
+ *
+ * Description:
+ *   Create a message ring of nslots fixed-size slots and register it as a
+ *   character driver at 'path'.  Any number of producers may write to the
+ *   ring; at most one reader may have the driver open at a time.
+ *
+ * Input Parameters:
+ *   path    - The full path to the driver to be registered
+ *   nslots  - The number of message slots.  Must be a power of two.
+ *   msgsize - The maximum size of one message in bytes
+ *   ring    - Location to return the ring for use with the kernel
+ *             interfaces below.  May be NULL.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  -EINVAL is
+ *   returned if the ring would not fit into the address space.
+ *
+ ****************************************************************************/
+
+int msgring_register(FAR const char *path, uint32_t nslots, size_t msgsize,
+                     FAR struct msgring_s **ring);
+
+/****************************************************************************
+ * Name: msgring_reserve
+ *
+ * Description:
+ *   Reserve the next free slot of the ring for a new message.  The message
+ *   is written in place and becomes visible to the reader only when it is
+ *   passed to msgring_commit().  Producers never block each other; with
+ *   nonblock set this may be called from an interrupt handler.  Every
+ *   reservation must be committed:  The reader does not get past a
+ *   message that is never committed and the ring fills up behind it.
+ *
+ * Input Parameters:
+ *   ring     - The message ring
+ *   msg      - Location to return the address of the message buffer
+ *   nonblock - Return -EAGAIN rather than wait if the ring is full
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int msgring_reserve(FAR struct msgring_s *ring, FAR void **msg,
+                    bool nonblock);
+
+/****************************************************************************
+ * Name: msgring_commit
+ *
+ * Description:
+ *   Publish a message reserved with msgring_reserve().  Messages become
+ *   visible to the reader in the order in which they were reserved.
+ *
+ * Input Parameters:
+ *   ring - The message ring
+ *   msg  - The message buffer returned by msgring_reserve()
+ *   len  - The length of the message.  Must not exceed the message size.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if msg is not a reserved message of this
+ *   ring that is still waiting to be committed or if len is too large.
+ *
+ ****************************************************************************/
+
+int msgring_commit(FAR struct msgring_s *ring, FAR void *msg, size_t len);
+
+/****************************************************************************
+ * Name: msgring_peek
+ *
+ * Description:
+ *   Return the oldest message in the ring without copying it.  The message
+ *   remains valid until it is released with msgring_consume().  Only one
+ *   thread may consume messages from a ring.
+ *
+ * Input Parameters:
+ *   ring     - The message ring
+ *   msg      - Location to return the address of the message
+ *   len      - Location to return the length of the message
+ *   nonblock - Return -EAGAIN rather than wait if the ring is empty
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int msgring_peek(FAR struct msgring_s *ring, FAR void **msg,
+                 FAR size_t *len, bool nonblock);
+
+/****************************************************************************
+ * Name: msgring_consume
+ *
+ * Description:
+ *   Release the message returned by msgring_peek() and make its slot
+ *   available to the producers again.
+ *
+ * Input Parameters:
+ *   ring - The message ring
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void msgring_consume(FAR struct msgring_s *ring);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_DEV_MSGRING */
+#endif /* __INCLUDE_NUTTX_DRIVERS_MSGRING_H */
@@ -258,6 +258,16 @@ struct geometry
   size_t geo_sectorsize;   /* Size of one sector */
 };
 
+/* This structure describes a range of sectors whose content is no longer
+ * needed (see BIOC_DISCARD).
+ */
+
+struct discard_s
+{
+  size_t startsector;      /* First sector of the range */
+  size_t nsectors;         /* Number of sectors in the range */
+};
+
 /* This structure is provided by block devices when they register with the
  * system.  It is used by file systems to perform filesystem transfers.  It
  * differs from the normal driver vtable in several ways -- most notably in
@@ -974,7 +984,7 @@ int lib_flushall(FAR struct streamlist *list);
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_SENDFILE
+#if defined(CONFIG_NET_SENDFILE) || defined(CONFIG_DEV_PIPE_SENDFILE)
 ssize_t lib_sendfile(int outfd, int infd, off_t *offset, size_t count);
 #endif
 
@@ -1256,6 +1266,45 @@ int file_fcntl(FAR struct file *filep, int cmd, ...);
 
 int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
 
+/****************************************************************************
+ * Name: poll_notify
+ *
+ * Description:
+ *   Notify the waiter that events are reported in fds->revents.  Drivers
+ *   should call this rather than posting fds->sem directly:  If the poll
+ *   structure has a notification callback (as used by epoll), the callback
+ *   is called instead of posting the semaphore.
+ *
+ * Input Parameters:
+ *   fds - The poll structure with the events in fds->revents
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   May be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+void poll_notify(FAR struct pollfd *fds);
+
+/****************************************************************************
+ * Name: epoll_fdclose
+ *
+ * Description:
+ *   Remove the registrations of a file or socket from all epoll instances.
+ *   This is called when the file or socket is closed.
+ *
+ * Input Parameters:
+ *   ptr - The struct file or struct socket being closed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void epoll_fdclose(FAR void *ptr);
+
 /****************************************************************************
  * Name: file_fstat
  *
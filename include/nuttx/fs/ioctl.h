@@ -97,6 +97,7 @@
 #define _NXTERMBASE     (0x2900) /* NxTerm character driver ioctl commands */
 #define _RFIOCBASE      (0x2a00) /* RF devices ioctl commands */
 #define _RPTUNBASE      (0x2b00) /* Remote processor tunnel ioctl commands */
+#define _MSGRINGBASE    (0x2c00) /* Message ring ioctl commands */
 
 /* boardctl() commands share the same number space */
 
@@ -171,6 +172,14 @@
                                            * OUT: Instance number is returned on
                                            *      success.
                                            */
+#define FIOC_FILEID     _FIOC(0x000b)     /* IN:  Location to return value
+                                           *      (uintptr_t *)
+                                           * OUT: Value that identifies the
+                                           *      open file within its
+                                           *      volume.  (Guaranteed to
+                                           *      persist while the file is
+                                           *      open).
+                                           */
 
 /* NuttX file system ioctl definitions **************************************/
 
@@ -265,6 +274,13 @@
                                            * IN:  None
                                            * OUT: None (ioctl return value provides
                                            *      success/failure indication). */
+#define BIOC_DISCARD    _BIOC(0x000e)     /* Inform the block device that a range
+                                           * of sectors no longer holds useful
+                                           * data (TRIM).
+                                           * IN:  Pointer to struct discard_s
+                                           *      describing the range.
+                                           * OUT: None (ioctl return value provides
+                                           *      success/failure indication). */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -512,6 +528,11 @@
 #define _RPTUNIOCVALID(c)   (_IOC_TYPE(c)==_RPTUNBASE)
 #define _RPTUNIOC(nr)       _IOC(_RPTUNBASE,nr)
 
+/* Message ring driver ioctl definitions (see nuttx/drivers/msgring.h) ******/
+
+#define _MSGRINGIOCVALID(c) (_IOC_TYPE(c)==_MSGRINGBASE)
+#define _MSGRINGIOC(nr)     _IOC(_MSGRINGBASE,nr)
+
 /* boardctl() command definitions *******************************************/
 
 #define _BOARDIOCVALID(c) (_IOC_TYPE(c)==_BOARDBASE)
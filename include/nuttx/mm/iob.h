@@ -233,6 +233,18 @@ struct iob_userstats_s
   int totalproduced;
 };
 
+#ifdef CONFIG_IOB_CPUCACHE
+/* Statistics of the I/O buffer cache of one CPU */
+
+struct iob_cpustats_s
+{
+  int ncached;                  /* Number of IOBs in the cache */
+  unsigned long nhits;          /* Allocations served from the cache */
+  unsigned long nrefills;       /* Batches taken from the global pool */
+  unsigned long ndrains;        /* Batches returned to the global pool */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -589,10 +601,11 @@ void iob_dump(FAR const char *msg, FAR struct iob_s *iob, unsigned int len,
  * Name: iob_getuserstats
  *
  * Description:
- *   Return a reference to the IOB usage statitics for the IOB consumer/producer
+ *   Return the IOB usage statitics for the IOB consumer/producer
  *
  * Input Parameters:
  *   userid - id representing the IOB producer/consumer
+ *   stats  - location to return the statistics
  *
  * Returned Value:
  *   None.
@@ -601,7 +614,28 @@ void iob_dump(FAR const char *msg, FAR struct iob_s *iob, unsigned int len,
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
     !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
-FAR struct iob_userstats_s * iob_getuserstats(enum iob_user_e userid);
+void iob_getuserstats(enum iob_user_e userid,
+                      FAR struct iob_userstats_s *stats);
+#endif
+
+/****************************************************************************
+ * Name: iob_getcpustats
+ *
+ * Description:
+ *   Return the statistics of the I/O buffer cache of one CPU
+ *
+ * Input Parameters:
+ *   cpu   - the CPU index
+ *   stats - location to return the statistics
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO) && defined(CONFIG_IOB_CPUCACHE)
+void iob_getcpustats(int cpu, FAR struct iob_cpustats_s *stats);
 #endif
 
 #endif /* CONFIG_MM_IOB */
@@ -47,6 +47,10 @@
 #include <string.h>
 #include <semaphore.h>
 
+#if defined(CONFIG_MM_CPUCACHE) && defined(CONFIG_SMP)
+#  include <nuttx/spinlock.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -166,6 +170,26 @@
 #define MM_ALIGN_UP(a)   (((a) + MM_GRAN_MASK) & ~MM_GRAN_MASK)
 #define MM_ALIGN_DOWN(a) ((a) & ~MM_GRAN_MASK)
 
+/* TLSF heap manager.  Free chunks are kept in segregated lists indexed by
+ * a first level (the power of two of the chunk size) and a second level
+ * that divides each power of two range into MM_TLSF_SLCOUNT sub-ranges.
+ * Chunks smaller than (1 << MM_TLSF_FLSHIFT) are all kept at the first
+ * level zero, in sub-ranges of MM_MIN_CHUNK bytes.
+ */
+
+#ifdef CONFIG_MM_TLSF_MANAGER
+#  ifdef CONFIG_MM_SMALL
+#    define MM_TLSF_SIZEBITS 16
+#  else
+#    define MM_TLSF_SIZEBITS 32
+#  endif
+
+#  define MM_TLSF_SLSHIFT  CONFIG_MM_TLSF_SLSHIFT
+#  define MM_TLSF_SLCOUNT  (1 << MM_TLSF_SLSHIFT)
+#  define MM_TLSF_FLSHIFT  (MM_TLSF_SLSHIFT + MM_MIN_SHIFT)
+#  define MM_TLSF_FLCOUNT  (MM_TLSF_SIZEBITS - MM_TLSF_FLSHIFT + 1)
+#endif
+
 /* An allocated chunk is distinguished from a free chunk by bit 31 (or 15)
  * of the 'preceding' chunk size.  If set, then this is an allocated chunk.
  */
@@ -178,6 +202,22 @@
 #define MM_IS_ALLOCATED(n) \
   ((int)((struct mm_allocnode_s*)(n)->preceding) < 0))
 
+/* Per-CPU small chunk cache.  Each CPU has CONFIG_MM_CPUCACHE_NCLASSES
+ * bins; bin 'n' holds free chunks of at least (n + 1) * MM_MIN_CHUNK
+ * bytes (including the allocated node header).
+ */
+
+#ifdef CONFIG_MM_CPUCACHE
+#  ifdef CONFIG_SMP
+#    define MM_CPUCACHE_NCPUS  CONFIG_SMP_NCPUS
+#  else
+#    define MM_CPUCACHE_NCPUS  1
+#  endif
+
+#  define MM_CPUCACHE_MAXCHUNK (CONFIG_MM_CPUCACHE_NCLASSES * MM_MIN_CHUNK)
+#  define MM_CPUCACHE_NDX(s)   (((s) >> MM_MIN_SHIFT) - 1)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -232,6 +272,30 @@ struct mm_freenode_s
 #define CHECK_FREENODE_SIZE \
   DEBUGASSERT(sizeof(struct mm_freenode_s) == SIZEOF_MM_FREENODE)
 
+#ifdef CONFIG_MM_CPUCACHE
+/* This describes one size class of a per-CPU cache.  The cached chunks
+ * remain marked as allocated in the heap and are linked together through
+ * the flink field of the chunk.
+ */
+
+struct mm_cachebin_s
+{
+  FAR struct mm_freenode_s *head;  /* List of cached chunks */
+  uint16_t nchunks;                /* Number of chunks in the list */
+};
+
+/* This describes the small chunk cache of one CPU */
+
+struct mm_cpucache_s
+{
+#ifdef CONFIG_SMP
+  spinlock_t lock;                 /* Only contended by mm_cpucache_flush() */
+#endif
+  size_t nbytes;                   /* Total size of all cached chunks */
+  struct mm_cachebin_s bin[CONFIG_MM_CPUCACHE_NCLASSES];
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -257,12 +321,30 @@ struct mm_heap_s
   int mm_nregions;
 #endif
 
+#ifdef CONFIG_MM_TLSF_MANAGER
+  /* Free nodes are maintained in segregated, doubly linked lists.  A bit
+   * is set in the bitmaps for each non-empty list.
+   */
+
+  uint32_t mm_flbitmap;
+  uint32_t mm_slbitmap[MM_TLSF_FLCOUNT];
+  FAR struct mm_freenode_s *mm_freelist[MM_TLSF_FLCOUNT][MM_TLSF_SLCOUNT];
+#else
   /* All free nodes are maintained in a doubly linked list.  This
    * array provides some hooks into the list at various points to
    * speed searches for free nodes.
    */
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
+#endif
+
+#ifdef CONFIG_MM_CPUCACHE
+  /* Caches of small, free chunks that can be accessed without holding
+   * mm_semaphore.  One per CPU.
+   */
+
+  struct mm_cpucache_s mm_cpucache[MM_CPUCACHE_NCPUS];
+#endif
 };
 
 /****************************************************************************
@@ -367,6 +449,8 @@ void kmm_givesemaphore(void);
 
 /* Functions contained in mm_malloc.c ***************************************/
 
+FAR struct mm_allocnode_s *mm_allocchunk(FAR struct mm_heap_s *heap,
+                                         size_t alignsize);
 FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size);
 
 /* Functions contained in kmm_malloc.c **************************************/
@@ -377,6 +461,8 @@ FAR void *kmm_malloc(size_t size);
 
 /* Functions contained in mm_free.c *****************************************/
 
+void mm_freechunk(FAR struct mm_heap_s *heap,
+                  FAR struct mm_allocnode_s *chunk);
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem);
 
 /* Functions contained in kmm_free.c ****************************************/
@@ -509,14 +595,43 @@ int kmm_mallinfo(struct mallinfo *info);
 void mm_shrinkchunk(FAR struct mm_heap_s *heap,
                     FAR struct mm_allocnode_s *node, size_t size);
 
-/* Functions contained in mm_addfreechunk.c *********************************/
+/* Functions contained in mm_addfreechunk.c (or mm_tlsf.c) ******************/
 
 void mm_addfreechunk(FAR struct mm_heap_s *heap,
                      FAR struct mm_freenode_s *node);
 
+/* Functions contained in mm_delfreechunk.c (or mm_tlsf.c) ******************/
+
+void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node);
+
+/* Functions contained in mm_findfreechunk.c (or mm_tlsf.c) *****************/
+
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap,
+                                           size_t size);
+
 /* Functions contained in mm_size2ndx.c.c ***********************************/
 
+#ifndef CONFIG_MM_TLSF_MANAGER
 int mm_size2ndx(size_t size);
+#endif
+
+/* Functions contained in mm_tlsf.c *****************************************/
+
+#ifdef CONFIG_MM_TLSF_MANAGER
+void mm_tlsf_initialize(FAR struct mm_heap_s *heap);
+#endif
+
+/* Functions contained in mm_cpucache.c *************************************/
+
+#ifdef CONFIG_MM_CPUCACHE
+void mm_cpucache_initialize(FAR struct mm_heap_s *heap);
+FAR void *mm_cpucache_alloc(FAR struct mm_heap_s *heap, size_t alignsize);
+bool mm_cpucache_free(FAR struct mm_heap_s *heap, FAR void *mem);
+int mm_cpucache_flush(FAR struct mm_heap_s *heap);
+void mm_cpucache_info(FAR struct mm_heap_s *heap, FAR int *nchunks,
+                      FAR size_t *nbytes);
+#endif
 
 #undef EXTERN
 #ifdef __cplusplus
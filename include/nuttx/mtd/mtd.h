@@ -131,6 +131,25 @@ struct mtd_protect_s
   size_t nblocks;         /* Number of blocks to [un-]protect */
 };
 
+/* Statistics returned by the log-structured FTL in response to the
+ * BIOC_GETPROCFSD ioctl.  The write amplification is the ratio of
+ * nprogrammed to nwritten.
+ */
+
+struct ftl_log_stats_s
+{
+  uint32_t nsectors;      /* Number of logical sectors exported */
+  uint32_t nwritten;      /* Sectors written by the user */
+  uint32_t nprogrammed;   /* Pages programmed, including meta-data and GC */
+  uint32_t nrelocated;    /* Pages moved by garbage collection */
+  uint32_t nerased;       /* Erase blocks erased */
+  uint32_t ndiscarded;    /* Sectors discarded with BIOC_DISCARD */
+  uint32_t ncheckpoints;  /* Map checkpoints written */
+  uint32_t minerase;      /* Lowest erase count of any erase block */
+  uint32_t maxerase;      /* Highest erase count of any erase block */
+  uint16_t nfree;         /* Number of free erase blocks */
+};
+
 /* The following defines the information for writing bytes to a sector
  * that are not a full page write (bytewrite).
  */
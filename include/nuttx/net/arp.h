@@ -87,6 +87,19 @@ struct arp_entry_s
   clock_t           at_time;     /* Time of last usage */
 };
 
+/* The ARP table statistics that are gathered if CONFIG_NET_STATISTICS is
+ * defined.
+ */
+
+#ifdef CONFIG_NET_STATISTICS
+struct arp_stats_s
+{
+  net_stats_t hit;        /* Number of lookups that found a valid entry */
+  net_stats_t miss;       /* Number of lookups that found no valid entry */
+  net_stats_t evict;      /* Number of valid entries replaced when full */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -101,6 +101,19 @@ struct neighbor_entry_s
   clock_t                ne_time;    /* For aging, units of tick */
 };
 
+/* The Neighbor table statistics that are gathered if CONFIG_NET_STATISTICS
+ * is defined.
+ */
+
+#ifdef CONFIG_NET_STATISTICS
+struct neighbor_stats_s
+{
+  net_stats_t hit;        /* Number of lookups that found an entry */
+  net_stats_t miss;       /* Number of lookups that found no entry */
+  net_stats_t evict;      /* Number of entries replaced when full */
+};
+#endif
+
 #ifdef __cplusplus
 #define EXTERN extern "C"
 extern "C"
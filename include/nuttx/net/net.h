@@ -303,6 +303,17 @@ struct socketlist
 };
 #endif
 
+/* A reader-writer lock for read-mostly networking data such as the list of
+ * network devices and the routing table.  See net_rdlock() and
+ * net_wrlock().
+ */
+
+struct net_rwlock_s
+{
+  sem_t    rw_sem;      /* Held by a writer or on behalf of all readers */
+  uint16_t rw_readers;  /* Number of readers holding the lock */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -483,6 +494,31 @@ int net_lockedwait(sem_t *sem);
 FAR struct iob_s *net_ioballoc(bool throttled, enum iob_user_e consumerid);
 #endif
 
+/****************************************************************************
+ * Reader-writer locks.
+ *
+ * Data that is read on every packet but rarely modified may be protected
+ * with a reader-writer lock rather than with the network lock so that
+ * readers on different CPUs do not serialize:
+ *
+ *   net_rwlock_init() - Initialize the lock
+ *   net_rdlock()      - Take the lock for reading.  Recursive.
+ *   net_rdunlock()    - Release the read lock
+ *   net_wrlock()      - Take the lock for writing.  Not recursive.
+ *   net_wrunlock()    - Release the write lock
+ *
+ * A thread that holds a read lock must not wait for the network lock if
+ * any writer of the same data holds the network lock while it takes the
+ * write lock.
+ *
+ ****************************************************************************/
+
+void net_rwlock_init(FAR struct net_rwlock_s *rwlock);
+int net_rdlock(FAR struct net_rwlock_s *rwlock);
+void net_rdunlock(FAR struct net_rwlock_s *rwlock);
+int net_wrlock(FAR struct net_rwlock_s *rwlock);
+void net_wrunlock(FAR struct net_rwlock_s *rwlock);
+
 /****************************************************************************
  * Name: net_setipid
  *
@@ -343,6 +343,17 @@ struct net_driver_s
 
   uint16_t d_sndlen;
 
+#ifndef CONFIG_NET_ARCH_CHKSUM
+  /* If d_sndchksumvalid is true, then d_sndchksum holds the partial
+   * checksum of the d_sndlen bytes at d_appdata.  It is calculated while
+   * devif_send() or devif_iob_send() copy the data so that the TCP/UDP
+   * checksum does not need to read the data again.
+   */
+
+  bool d_sndchksumvalid;
+  uint16_t d_sndchksum;
+#endif
+
   /* Multicast group support */
 
 #ifdef CONFIG_NET_IGMP
@@ -406,6 +417,20 @@ struct net_driver_s
 
 typedef CODE int (*devif_poll_callback_t)(FAR struct net_driver_s *dev);
 
+#ifdef CONFIG_NETDEV_BURST
+/* Describes one frame buffer handed between a driver and the network in a
+ * burst (see netdev_rxburst() and netdev_txburst()).  The buffer belongs to
+ * the driver and must be at least MAX_NETDEV_PKTSIZE + CONFIG_NET_GUARDSIZE
+ * bytes, aligned to a 16-bit boundary, just like d_buf.
+ */
+
+struct netdev_pkt_s
+{
+  FAR uint8_t *p_buf;           /* Frame buffer (owned by the driver) */
+  uint16_t p_len;               /* Length of the frame in p_buf */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -608,6 +633,61 @@ int devif_loopback(FAR struct net_driver_s *dev);
 int netdev_carrier_on(FAR struct net_driver_s *dev);
 int netdev_carrier_off(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: netdev_rxburst
+ *
+ * Description:
+ *   Process a burst of received Ethernet frames.  Each frame is processed in
+ *   place:  d_buf is pointed at the driver's buffer rather than copying the
+ *   frame, and the network is locked only once for the whole burst.
+ *
+ *   On return, the p_len field of each entry holds the length of a reply
+ *   frame that the network left in that same buffer (with the Ethernet
+ *   header already completed) or zero if there is nothing to send.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure
+ *   rx  - The array of received frames
+ *   nrx - The number of entries in rx
+ *
+ * Returned Value:
+ *   The number of entries in rx that now hold a reply frame to be sent.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_BURST
+int netdev_rxburst(FAR struct net_driver_s *dev,
+                   FAR struct netdev_pkt_s *rx, int nrx);
+
+/****************************************************************************
+ * Name: netdev_txburst
+ *
+ * Description:
+ *   Poll the network for a burst of frames to send.  This is equivalent to
+ *   devif_poll() (or devif_timer() if timer is true), but each frame is
+ *   built directly in the next buffer of tx rather than in d_buf and
+ *   the network is locked only once for the whole burst.  Polling stops
+ *   when all of the buffers in tx are used.  Frames sent to ourself are
+ *   looped back and not returned.
+ *
+ * Input Parameters:
+ *   dev   - The device driver structure
+ *   tx    - The array of frame buffers.  The driver provides p_buf and
+ *           the length of each frame is returned in p_len.
+ *   ntx   - The number of entries in tx
+ *   timer - True to perform the periodic timer processing as well
+ *
+ * Returned Value:
+ *   The number of frames in tx that are ready to be sent.  If this equals
+ *   ntx, there may be more frames and the driver should poll again once
+ *   it has sent this burst.
+ *
+ ****************************************************************************/
+
+int netdev_txburst(FAR struct net_driver_s *dev,
+                   FAR struct netdev_pkt_s *tx, int ntx, bool timer);
+#endif
+
 /****************************************************************************
  * Name: net_ioctl_arglen
  *
@@ -51,6 +51,12 @@
 #include <nuttx/net/netconfig.h>
 
 #include <nuttx/net/ip.h>
+#ifdef CONFIG_NET_ARP
+#  include <nuttx/net/arp.h>
+#endif
+#ifdef CONFIG_NET_IPv6
+#  include <nuttx/net/neighbor.h>
+#endif
 #ifdef CONFIG_NET_TCP
 #  include <nuttx/net/tcp.h>
 #endif
@@ -94,6 +100,14 @@ struct net_stats_s
   struct ipv6_stats_s ipv6;     /* IPv6 statistics */
 #endif
 
+#ifdef CONFIG_NET_ARP
+  struct arp_stats_s  arp;      /* ARP table statistics */
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  struct neighbor_stats_s neighbor; /* Neighbor table statistics */
+#endif
+
 #ifdef CONFIG_NET_ICMP
   struct icmp_stats_s icmp;     /* ICMP statistics */
 #endif
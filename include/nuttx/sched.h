@@ -627,7 +627,7 @@ struct tcb_s
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 #if CONFIG_SEM_NNESTPRIO > 0
-  uint8_t  npend_reprio;                 /* Number of nested reprioritizations  */
+  uint8_t  npend_reprio;                 /* Number of work queue boosts         */
   uint8_t  pend_reprios[CONFIG_SEM_NNESTPRIO];
 #endif
   uint8_t  base_priority;                /* "Normal" priority of the thread     */
@@ -676,6 +676,11 @@ struct tcb_s
   /* POSIX Semaphore Control Fields *********************************************/
 
   sem_t *waitsem;                        /* Semaphore ID waiting on             */
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  FAR struct semholder_s *holdsem;       /* List of semaphore counts held       */
+  FAR struct tcb_s *waitflink;           /* Next waiter for waitsem             */
+  FAR struct tcb_s *waitblink;           /* Previous waiter for waitsem         */
+#endif
 
   /* POSIX Signal Control Fields ************************************************/
 
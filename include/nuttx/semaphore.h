@@ -41,7 +41,9 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/compiler.h>
 
+#include <stdbool.h>
 #include <errno.h>
 #include <semaphore.h>
 
@@ -57,6 +59,36 @@
 #define SEM_PRIO_INHERIT          1
 #define SEM_PRIO_PROTECT          2
 
+/* A priority change is propagated along a chain of threads, each waiting
+ * for a semaphore held by the next, at most this many links deep.  This
+ * bounds the work done in the critical section even if the chain is a
+ * deadlock cycle.
+ */
+
+#define SEM_MAXCHAIN              8
+
+#if defined(CONFIG_SEM_FASTPATH) && !defined(CONFIG_HAVE_BUILTIN_ATOMIC)
+#  undef CONFIG_SEM_FASTPATH
+#endif
+
+/* With CONFIG_SEM_FASTPATH, the semaphore count may be changed outside of
+ * the critical section so every update of the count must be atomic.  This
+ * includes OS logic that keeps a semaphore count in step with a free list
+ * and adjusts the count directly (e.g., the IOB allocators).  Such logic
+ * must use nxsem_addcount() rather than modifying semcount itself.
+ * nxsem_addcount() returns the new count.
+ */
+
+#ifdef CONFIG_SEM_FASTPATH
+#  define nxsem_addcount(sem,n) \
+     __atomic_add_fetch(&(sem)->semcount, (n), __ATOMIC_ACQ_REL)
+#  define nxsem_cmpxchg(sem,old,new) \
+     __atomic_compare_exchange_n(&(sem)->semcount, &(old), (new), false, \
+                                 __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)
+#else
+#  define nxsem_addcount(sem,n) ((sem)->semcount += (n))
+#endif
+
 /* Most internal nxsem_* interfaces are not available in the user space in
  * PROTECTED and KERNEL builds.  In that context, the application semaphore
  * interfaces must be used.  The differences between the two sets of
@@ -523,6 +555,28 @@ int nxsem_setprotocol(FAR sem_t *sem, int protocol);
 
 int sem_setprotocol(FAR sem_t *sem, int protocol);
 
+/****************************************************************************
+ * Name: nxsem_getholder
+ *
+ * Description:
+ *   Return the TCB of one of the threads holding counts on a semaphore
+ *   with priority inheritance.  This is used by procfs to show chains of
+ *   inherited priorities.  The caller must prevent changes to the holders
+ *   (e.g., by entering a critical section) while the TCB is in use.
+ *
+ * Input Parameters:
+ *   sem   - A pointer to the semaphore
+ *   index - Which holder to return, starting from zero
+ *
+ * Returned Value:
+ *   The TCB of the holder or NULL if there are not that many holders.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+FAR struct tcb_s *nxsem_getholder(FAR sem_t *sem, int index);
+#endif
+
 /****************************************************************************
  * Name: nxsem_wait_uninterruptible
  *
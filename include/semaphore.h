@@ -66,19 +66,23 @@
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 struct tcb_s; /* Forward reference */
+struct sem_s; /* Forward reference */
 struct semholder_s
 {
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  struct semholder_s *flink;     /* Implements singly linked list */
+  struct semholder_s *flink;      /* Implements singly linked list */
 #endif
-  FAR struct tcb_s *htcb;        /* Holder TCB */
-  int16_t counts;                /* Number of counts owned by this holder */
+  FAR struct semholder_s *tlink;  /* Next count held by the same thread */
+  FAR struct semholder_s *tblink; /* Previous count held by the thread */
+  FAR struct sem_s *sem;          /* Semaphore that the count belongs to */
+  FAR struct tcb_s *htcb;         /* Holder TCB */
+  int16_t counts;                 /* Number of counts owned by this holder */
 };
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-#  define SEMHOLDER_INITIALIZER {NULL, NULL, 0}
+#  define SEMHOLDER_INITIALIZER {NULL, NULL, NULL, NULL, NULL, 0}
 #else
-#  define SEMHOLDER_INITIALIZER {NULL, 0}
+#  define SEMHOLDER_INITIALIZER {NULL, NULL, NULL, NULL, 0}
 #endif
 #endif /* CONFIG_PRIORITY_INHERITANCE */
 
@@ -94,6 +98,7 @@ struct sem_s
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t flags;                 /* See PRIOINHERIT_FLAGS_* definitions */
+  FAR struct tcb_s *whead;       /* Waiting threads in priority order */
 # if CONFIG_SEM_PREALLOCHOLDERS > 0
   FAR struct semholder_s *hhead; /* List of holders of semaphore counts */
 # else
@@ -109,10 +114,10 @@ typedef struct sem_s sem_t;
 #ifdef CONFIG_PRIORITY_INHERITANCE
 # if CONFIG_SEM_PREALLOCHOLDERS > 0
 #  define SEM_INITIALIZER(c) \
-    {(c), 0, NULL}               /* semcount, flags, hhead */
+    {(c), 0, NULL, NULL}         /* semcount, flags, whead, hhead */
 # else
 #  define SEM_INITIALIZER(c) \
-    {(c), 0, {SEMHOLDER_INITIALIZER, SEMHOLDER_INITIALIZER}} /* semcount, flags, holder[2] */
+    {(c), 0, NULL, {SEMHOLDER_INITIALIZER, SEMHOLDER_INITIALIZER}} /* semcount, flags, whead, holder[2] */
 # endif
 #else
 #  define SEM_INITIALIZER(c) \
@@ -40,6 +40,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdint.h>
 #include <poll.h>
 
 /****************************************************************************
@@ -50,6 +51,12 @@
 #define EPOLL_CTL_DEL 2 /* Remove a file descriptor from the interface.  */
 #define EPOLL_CTL_MOD 3 /* Change file descriptor epoll_event structure.  */
 
+/* Flags for epoll_create1().  NuttX has no close-on-exec descriptor flag so
+ * this is accepted for compatibility only.
+ */
+
+#define EPOLL_CLOEXEC 0
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -76,35 +83,55 @@ enum EPOLL_EVENTS
 #define EPOLLHUP EPOLLHUP
   };
 
-typedef union poll_data
+/* Input flags that select the notification behavior.  They are not
+ * representable in an enum on machines where int is 16 bits.
+ */
+
+#define EPOLLONESHOT  (1ul << 30) /* Disable the descriptor after one event */
+#define EPOLLET       (1ul << 31) /* Edge-triggered notification */
+
+typedef union epoll_data
 {
-  int          fd;       /* The descriptor being polled */
+  FAR void    *ptr;
+  int          fd;
+  uint32_t     u32;
+#ifdef __INT64_DEFINED
+  uint64_t     u64;
+#endif
 } epoll_data_t;
 
 struct epoll_event
 {
-  epoll_data_t data;
-  FAR sem_t   *sem;      /* Pointer to semaphore used to post output event */
-  pollevent_t  events;   /* The input event flags */
-  pollevent_t  revents;  /* The output event flags */
-  FAR void    *priv;     /* For use by drivers */
-};
-
-struct epoll_head
-{
-  int size;
-  int occupied;
-  FAR struct epoll_event *evs;
+  uint32_t     events;   /* Epoll events */
+  epoll_data_t data;     /* User data variable */
 };
 
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
 int epoll_create(int size);
-int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev);
-int epoll_wait(int epfd, struct epoll_event *evs, int maxevents, int timeout);
+int epoll_create1(int flags);
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev);
+int epoll_wait(int epfd, FAR struct epoll_event *evs, int maxevents,
+               int timeout);
+
+/* Same as close(epfd).  Retained for compatibility. */
 
 void epoll_close(int epfd);
 
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
 #endif /* __INCLUDE_SYS_EPOLL_H */
@@ -359,8 +359,9 @@
 #define SYS_telldir                    (__SYS_filedesc + 15)
 
 #ifdef CONFIG_FS_RAMMAP
-#  define SYS_munmap                   (__SYS_filedesc + 16)
-#  define __SYS_link                   (__SYS_filedesc + 17)
+#  define SYS_msync                    (__SYS_filedesc + 16)
+#  define SYS_munmap                   (__SYS_filedesc + 17)
+#  define __SYS_link                   (__SYS_filedesc + 18)
 #else
 #  define __SYS_link                   (__SYS_filedesc + 16)
 #endif
@@ -395,7 +396,7 @@
 #  define __SYS_sendfile               (__SYS_fs_fdopen + 0)
 #endif
 
-#if defined(CONFIG_NET_SENDFILE)
+#if defined(CONFIG_NET_SENDFILE) || defined(CONFIG_DEV_PIPE_SENDFILE)
 #  define SYS_sendfile,                __SYS_sendfile
 #  define __SYS_mountpoint             (__SYS_sendfile + 1)
 #else
@@ -97,7 +97,7 @@
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_SENDFILE
+#if defined(CONFIG_NET_SENDFILE) || defined(CONFIG_DEV_PIPE_SENDFILE)
 ssize_t lib_sendfile(int outfd, int infd, off_t *offset, size_t count)
 #else
 ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
@@ -91,6 +91,7 @@ int nxsem_init(FAR sem_t *sem, int pshared, unsigned int value)
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
       sem->flags            = 0;
+      sem->whead            = NULL;
 #  if CONFIG_SEM_PREALLOCHOLDERS > 0
       sem->hhead            = NULL;
 #  else
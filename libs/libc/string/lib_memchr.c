@@ -39,8 +39,11 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 
+#include "string/lib_string.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -65,6 +68,35 @@ FAR void *memchr(FAR const void *s, int c, size_t n)
 
   if (s)
     {
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+      uintptr_t mask = LIBC_REPEAT(c);
+      FAR const uintptr_t *w;
+
+      /* Check bytes up to the first word boundary */
+
+      while (n > 0 && LIBC_UNALIGNED(p))
+        {
+          if (*p == (unsigned char)c)
+            {
+              return (FAR void *)p;
+            }
+
+          p++;
+          n--;
+        }
+
+      /* Then skip whole words that do not contain the byte */
+
+      w = (FAR const uintptr_t *)p;
+      while (n >= LIBC_WORDSIZE && !LIBC_HASZERO(*w ^ mask))
+        {
+          w++;
+          n -= LIBC_WORDSIZE;
+        }
+
+      p = (FAR const unsigned char *)w;
+#endif
+
       while (n--)
         {
           if (*p == (unsigned char)c)
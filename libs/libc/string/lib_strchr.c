@@ -39,8 +39,11 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 
+#include "string/lib_string.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -64,9 +67,39 @@ FAR char *strchr(FAR const char *s, int c)
 {
   if (s)
     {
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+      uintptr_t mask = LIBC_REPEAT(c);
+      FAR const uintptr_t *w;
+
+      /* Check bytes up to the first word boundary */
+
+      for (; LIBC_UNALIGNED(s); s++)
+        {
+          if (*s == (char)c)
+            {
+              return (FAR char *)s;
+            }
+
+          if (!*s)
+            {
+              return NULL;
+            }
+        }
+
+      /* Then skip whole words that contain neither the character nor the
+       * terminator.
+       */
+
+      for (w = (FAR const uintptr_t *)s;
+           !LIBC_HASZERO(*w) && !LIBC_HASZERO(*w ^ mask);
+           w++);
+
+      s = (FAR const char *)w;
+#endif
+
       for (; ; s++)
         {
-          if (*s == c)
+          if (*s == (char)c)
             {
               return (FAR char *)s;
             }
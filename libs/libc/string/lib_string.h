@@ -0,0 +1,78 @@
+/****************************************************************************
+ * libs/libc/string/lib_string.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __LIBS_LIBC_STRING_LIB_STRING_H
+#define __LIBS_LIBC_STRING_LIB_STRING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Helpers for the word-at-a-time versions of the string functions
+ * (CONFIG_LIBC_STRING_OPTSPEED).  A word is the size of uintptr_t.
+ */
+
+#define LIBC_WORDSIZE       sizeof(uintptr_t)
+#define LIBC_WORDMASK       (LIBC_WORDSIZE - 1)
+
+/* True if the pointer is not aligned to a word boundary */
+
+#define LIBC_UNALIGNED(p)   (((uintptr_t)(p) & LIBC_WORDMASK) != 0)
+
+/* 0x01010101... and 0x80808080... */
+
+#define LIBC_ONES           ((uintptr_t)-1 / 0xff)
+#define LIBC_HIGHS          (LIBC_ONES * 0x80)
+
+/* Non-zero if any byte of the word is zero.  Aligned words never cross a
+ * page boundary, so the aligned loops may safely read the bytes beyond the
+ * terminating NUL within the last word.
+ */
+
+#define LIBC_HASZERO(w)     (((w) - LIBC_ONES) & ~(w) & LIBC_HIGHS)
+
+/* A word with all bytes equal to the byte 'c' */
+
+#define LIBC_REPEAT(c)      (LIBC_ONES * (uint8_t)(c))
+
+#endif /* __LIBS_LIBC_STRING_LIB_STRING_H */
@@ -115,6 +115,14 @@ extern sem_t g_throttle_sem;  /* Counts available I/O buffers when throttled */
 extern sem_t g_qentry_sem;    /* Counts free I/O buffer queue containers */
 #endif
 
+#ifdef CONFIG_IOB_CPUCACHE
+/* Number of threads waiting for an IOB.  Freed IOBs bypass the CPU caches
+ * while it is non-zero.
+ */
+
+extern volatile int16_t g_iob_nwaiters;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -154,6 +162,66 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_release
+ *
+ * Description:
+ *   Return an I/O buffer to the global pool (or to the committed list if a
+ *   thread is waiting for an IOB) and post the counting semaphores.  Must
+ *   be called within a critical section.
+ *
+ ****************************************************************************/
+
+void iob_release(FAR struct iob_s *iob);
+
+#ifdef CONFIG_IOB_CPUCACHE
+/****************************************************************************
+ * Name: iob_cpucache_alloc
+ *
+ * Description:
+ *   Try to allocate an IOB from the cache of the current CPU, refilling the
+ *   cache from the global pool in a batch if it is empty.  Returns NULL if
+ *   the global pool must be used instead.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cpucache_alloc(bool throttled,
+                                     enum iob_user_e consumerid);
+
+/****************************************************************************
+ * Name: iob_cpucache_free
+ *
+ * Description:
+ *   Try to free an IOB into the cache of the current CPU.  Returns false if
+ *   the IOB must be freed to the global pool instead.
+ *
+ ****************************************************************************/
+
+bool iob_cpucache_free(FAR struct iob_s *iob, enum iob_user_e producerid);
+
+/****************************************************************************
+ * Name: iob_cpucache_flush and iob_cpucache_flushall
+ *
+ * Description:
+ *   Return the IOBs cached for one CPU, or for all CPUs, to the global
+ *   pool.  Return the number of IOBs released.
+ *
+ ****************************************************************************/
+
+int iob_cpucache_flush(int cpu);
+int iob_cpucache_flushall(void);
+
+/****************************************************************************
+ * Name: iob_cpucache_navail
+ *
+ * Description:
+ *   Return the number of IOBs held in all CPU caches.
+ *
+ ****************************************************************************/
+
+int iob_cpucache_navail(void);
+#endif
+
 /****************************************************************************
  * Name: iob_notifier_signal
  *
@@ -46,6 +46,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
 
 #include "iob.h"
@@ -100,6 +101,94 @@ static FAR struct iob_s *iob_alloc_committed(enum iob_user_e consumerid)
   return iob;
 }
 
+/****************************************************************************
+ * Name: iob_tryalloc_global
+ *
+ * Description:
+ *   Try to allocate an I/O buffer by taking the buffer at the head of the
+ *   global free list without waiting for a buffer to become free.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_tryalloc_global(bool throttled,
+                                             enum iob_user_e consumerid)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+#if CONFIG_IOB_THROTTLE > 0
+  FAR sem_t *sem;
+#endif
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* Select the semaphore count to check. */
+
+  sem = (throttled ? &g_throttle_sem : &g_iob_sem);
+#endif
+
+  /* We don't know what context we are called from so we use extreme measures
+   * to protect the free list:  We disable interrupts very briefly.
+   */
+
+  flags = enter_critical_section();
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* If there are free I/O buffers for this allocation */
+
+  if (sem->semcount > 0)
+#endif
+    {
+      /* Take the I/O buffer from the head of the free list */
+
+      iob = g_iob_freelist;
+      if (iob != NULL)
+        {
+          /* Remove the I/O buffer from the free list and decrement the
+           * counting semaphore(s) that tracks the number of available
+           * IOBs.
+           */
+
+          g_iob_freelist = iob->io_flink;
+
+          /* Take a semaphore count.  Note that we cannot do this in
+           * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
+           * because this function may be called from an interrupt
+           * handler. Fortunately we know at at least one free buffer
+           * so a simple decrement is all that is needed.
+           */
+
+          (void)nxsem_addcount(&g_iob_sem, -1);
+          DEBUGASSERT(g_iob_sem.semcount >= 0);
+
+#if CONFIG_IOB_THROTTLE > 0
+          /* The throttle semaphore is a little more complicated because
+           * it can be negative!  Decrementing is still safe, however.
+           */
+
+          (void)nxsem_addcount(&g_throttle_sem, -1);
+          DEBUGASSERT(g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE);
+#endif
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+          iob_stats_onalloc(consumerid);
+#endif
+
+          leave_critical_section(flags);
+
+          /* Put the I/O buffer in a known state */
+
+          iob->io_flink  = NULL; /* Not in a chain */
+          iob->io_len    = 0;    /* Length of the data in the entry */
+          iob->io_offset = 0;    /* Offset to the beginning of data */
+          iob->io_pktlen = 0;    /* Total length of the packet */
+          return iob;
+        }
+    }
+
+  leave_critical_section(flags);
+  return NULL;
+}
+
 /****************************************************************************
  * Name: iob_allocwait
  *
@@ -115,6 +204,9 @@ static FAR struct iob_s *iob_allocwait(bool throttled,
   FAR struct iob_s *iob;
   irqstate_t flags;
   FAR sem_t *sem;
+#ifdef CONFIG_IOB_CPUCACHE
+  bool waiting = false;
+#endif
   int ret = OK;
 
 #if CONFIG_IOB_THROTTLE > 0
@@ -138,6 +230,23 @@ static FAR struct iob_s *iob_allocwait(bool throttled,
    */
 
   iob = iob_tryalloc(throttled, consumerid);
+
+#ifdef CONFIG_IOB_CPUCACHE
+  if (iob == NULL)
+    {
+      /* We are about to wait.  From now on, freed IOBs bypass the CPU
+       * caches.  IOBs that were cached after iob_tryalloc() flushed the
+       * caches are returned to the global pool before we decide to wait.
+       */
+
+      g_iob_nwaiters++;
+      waiting = true;
+
+      iob_cpucache_flushall();
+      iob = iob_tryalloc(throttled, consumerid);
+    }
+#endif
+
   while (ret == OK && iob == NULL)
     {
       /* If not successful, then the semaphore count was less than or equal
@@ -194,17 +303,24 @@ static FAR struct iob_s *iob_allocwait(bool throttled,
             {
               if (throttled)
                 {
-                  g_iob_sem.semcount--;
+                  (void)nxsem_addcount(&g_iob_sem, -1);
                 }
               else
                 {
-                  g_throttle_sem.semcount--;
+                  (void)nxsem_addcount(&g_throttle_sem, -1);
                 }
             }
 #endif
         }
     }
 
+#ifdef CONFIG_IOB_CPUCACHE
+  if (waiting)
+    {
+      g_iob_nwaiters--;
+    }
+#endif
+
   leave_critical_section(flags);
   return iob;
 }
@@ -250,78 +366,27 @@ FAR struct iob_s *iob_alloc(bool throttled, enum iob_user_e consumerid)
 
 FAR struct iob_s *iob_tryalloc(bool throttled, enum iob_user_e consumerid)
 {
+#ifdef CONFIG_IOB_CPUCACHE
   FAR struct iob_s *iob;
-  irqstate_t flags;
-#if CONFIG_IOB_THROTTLE > 0
-  FAR sem_t *sem;
-#endif
 
-#if CONFIG_IOB_THROTTLE > 0
-  /* Select the semaphore count to check. */
+  /* Try the cache of this CPU first */
 
-  sem = (throttled ? &g_throttle_sem : &g_iob_sem);
-#endif
-
-  /* We don't know what context we are called from so we use extreme measures
-   * to protect the free list:  We disable interrupts very briefly.
-   */
-
-  flags = enter_critical_section();
-
-#if CONFIG_IOB_THROTTLE > 0
-  /* If there are free I/O buffers for this allocation */
-
-  if (sem->semcount > 0)
-#endif
+  iob = iob_cpucache_alloc(throttled, consumerid);
+  if (iob == NULL)
     {
-      /* Take the I/O buffer from the head of the free list */
+      /* Then the global pool.  If that fails too, return the IOBs held in
+       * the caches of all CPUs to the global pool and try once more.
+       */
 
-      iob = g_iob_freelist;
-      if (iob != NULL)
+      iob = iob_tryalloc_global(throttled, consumerid);
+      if (iob == NULL && iob_cpucache_flushall() > 0)
         {
-          /* Remove the I/O buffer from the free list and decrement the
-           * counting semaphore(s) that tracks the number of available
-           * IOBs.
-           */
-
-          g_iob_freelist = iob->io_flink;
-
-          /* Take a semaphore count.  Note that we cannot do this in
-           * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
-           * because this function may be called from an interrupt
-           * handler. Fortunately we know at at least one free buffer
-           * so a simple decrement is all that is needed.
-           */
-
-          g_iob_sem.semcount--;
-          DEBUGASSERT(g_iob_sem.semcount >= 0);
-
-#if CONFIG_IOB_THROTTLE > 0
-          /* The throttle semaphore is a little more complicated because
-           * it can be negative!  Decrementing is still safe, however.
-           */
-
-          g_throttle_sem.semcount--;
-          DEBUGASSERT(g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE);
-#endif
-
-#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
-    defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
-          iob_stats_onalloc(consumerid);
-#endif
-
-          leave_critical_section(flags);
-
-          /* Put the I/O buffer in a known state */
-
-          iob->io_flink  = NULL; /* Not in a chain */
-          iob->io_len    = 0;    /* Length of the data in the entry */
-          iob->io_offset = 0;    /* Offset to the beginning of data */
-          iob->io_pktlen = 0;    /* Total length of the packet */
-          return iob;
+          iob = iob_tryalloc_global(throttled, consumerid);
         }
     }
 
-  leave_critical_section(flags);
-  return NULL;
+  return iob;
+#else
+  return iob_tryalloc_global(throttled, consumerid);
+#endif
 }
@@ -45,6 +45,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
 
 #include "iob.h"
@@ -251,7 +252,7 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void)
        * so a simple decrement is all that is needed.
        */
 
-      g_qentry_sem.semcount--;
+      (void)nxsem_addcount(&g_qentry_sem, -1);
       DEBUGASSERT(g_qentry_sem.semcount >= 0);
 
       /* Put the I/O buffer in a known state */
@@ -0,0 +1,540 @@
+/****************************************************************************
+ * mm/iob/iob_cpucache.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_CPUCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_IOB_CPUCACHE_BATCH < 1 || \
+    CONFIG_IOB_CPUCACHE_BATCH > CONFIG_IOB_CPUCACHE_SIZE
+#  error CONFIG_IOB_CPUCACHE_BATCH must be in the range 1..CONFIG_IOB_CPUCACHE_SIZE
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The IOB cache of one CPU */
+
+struct iob_cpucache_s
+{
+  FAR struct iob_s *head;       /* Free IOBs reserved for this CPU */
+  int16_t ncached;              /* Number of IOBs in the list */
+  spinlock_t lock;              /* Taken by other CPUs only to flush */
+  unsigned long nhits;          /* Allocations served from the cache */
+  unsigned long nrefills;       /* Batches taken from the global pool */
+  unsigned long ndrains;        /* Batches returned to the global pool */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The number of threads that are about to wait, or are waiting, for an
+ * IOB.  While it is non-zero, freed IOBs bypass the caches.  Modified only
+ * within a critical section.
+ */
+
+volatile int16_t g_iob_nwaiters;
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct iob_cpucache_s g_iob_cpucache[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cpucache_lock
+ *
+ * Description:
+ *   Get exclusive access to the cache of one CPU.  Interrupts are disabled
+ *   on the local CPU so that we cannot be suspended or migrated while the
+ *   cache is in use.  The spinlock is normally taken only by the owning CPU
+ *   and is contended only when the caches are flushed.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_cpucache_s *iob_cpucache_lock(int cpu,
+                                                    FAR irqstate_t *flags)
+{
+  FAR struct iob_cpucache_s *cache;
+
+  *flags = up_irq_save();
+
+  if (cpu < 0)
+    {
+      cpu = up_cpu_index();
+    }
+
+  cache = &g_iob_cpucache[cpu];
+  spin_lock(&cache->lock);
+  return cache;
+}
+
+/****************************************************************************
+ * Name: iob_cpucache_unlock
+ *
+ * Description:
+ *   Relinquish the access obtained by iob_cpucache_lock().
+ *
+ ****************************************************************************/
+
+static inline void iob_cpucache_unlock(FAR struct iob_cpucache_s *cache,
+                                       irqstate_t flags)
+{
+  spin_unlock(&cache->lock);
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: iob_cpucache_release
+ *
+ * Description:
+ *   Return a list of IOBs taken from a cache to the global pool.
+ *
+ ****************************************************************************/
+
+static void iob_cpucache_release(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *next;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  for (; iob != NULL; iob = next)
+    {
+      next = iob->io_flink;
+      iob_release(iob);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: iob_cpucache_takecount
+ *
+ * Description:
+ *   Take one count from an IOB semaphore if the count is positive, as
+ *   nxsem_trywait() would, but without the holder logic so that this may
+ *   be used from an interrupt handler.  Must be called within a critical
+ *   section.  The count is taken atomically because, with
+ *   CONFIG_SEM_FASTPATH, it may also change outside of the critical
+ *   section.
+ *
+ ****************************************************************************/
+
+static bool iob_cpucache_takecount(FAR sem_t *sem)
+{
+  int16_t count = sem->semcount;
+
+#ifdef CONFIG_SEM_FASTPATH
+  /* nxsem_cmpxchg() reloads count if it fails */
+
+  while (count > 0)
+    {
+      if (nxsem_cmpxchg(sem, count, count - 1))
+        {
+          return true;
+        }
+    }
+
+  return false;
+#else
+  if (count > 0)
+    {
+      (void)nxsem_addcount(sem, -1);
+      return true;
+    }
+
+  return false;
+#endif
+}
+
+/****************************************************************************
+ * Name: iob_cpucache_refill
+ *
+ * Description:
+ *   Take a batch of IOBs from the global pool.  The first one is returned
+ *   and the rest are added to the cache of the current CPU.
+ *
+ *   Only IOBs in excess of the throttle reserve are taken, so the reserve
+ *   always stays in the global pool.  Nothing is taken while a thread is
+ *   waiting for an IOB.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_cpucache_refill(void)
+{
+  FAR struct iob_cpucache_s *cache;
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *tail = NULL;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int n = 0;
+
+  flags = enter_critical_section();
+
+  while (g_iob_nwaiters == 0 && n < CONFIG_IOB_CPUCACHE_BATCH &&
+         g_iob_freelist != NULL)
+    {
+      /* Take the semaphore counts first.  A positive count guarantees that
+       * the free list holds an IOB that is not committed to some other
+       * allocation.
+       */
+
+#if CONFIG_IOB_THROTTLE > 0
+      if (!iob_cpucache_takecount(&g_throttle_sem))
+        {
+          break;
+        }
+#endif
+
+      if (!iob_cpucache_takecount(&g_iob_sem))
+        {
+#if CONFIG_IOB_THROTTLE > 0
+          /* Give back the throttle count.  It was positive and cannot
+           * have become negative since:  Only nxsem_wait() makes a count
+           * negative and that needs the critical section that we hold.
+           */
+
+          (void)nxsem_addcount(&g_throttle_sem, 1);
+#endif
+          break;
+        }
+
+      iob            = g_iob_freelist;
+      g_iob_freelist = iob->io_flink;
+      iob->io_flink  = head;
+      head           = iob;
+
+      if (tail == NULL)
+        {
+          tail = iob;
+        }
+
+      n++;
+    }
+
+  leave_critical_section(flags);
+
+  if (head == NULL)
+    {
+      return NULL;
+    }
+
+  /* Keep the first IOB for the caller and cache the others */
+
+  iob = head;
+  if (n > 1)
+    {
+      cache          = iob_cpucache_lock(-1, &flags);
+      tail->io_flink = cache->head;
+      cache->head    = head->io_flink;
+      cache->ncached += n - 1;
+      cache->nrefills++;
+      iob_cpucache_unlock(cache, flags);
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cpucache_alloc
+ *
+ * Description:
+ *   Try to allocate an IOB from the cache of the current CPU, refilling the
+ *   cache from the global pool if it is empty.  NULL is returned if that
+ *   is not possible; the caller must then fall back to the global pool.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cpucache_alloc(bool throttled,
+                                     enum iob_user_e consumerid)
+{
+  FAR struct iob_cpucache_s *cache;
+  FAR struct iob_s *iob = NULL;
+  irqstate_t flags;
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* A throttled allocation may use a cached IOB only if the whole
+   * throttle reserve is still in the global pool.  Otherwise the exact
+   * check in the global path is needed.
+   */
+
+  if (throttled && g_throttle_sem.semcount < 0)
+    {
+      return NULL;
+    }
+#endif
+
+  cache = iob_cpucache_lock(-1, &flags);
+
+  iob = cache->head;
+  if (iob != NULL)
+    {
+      cache->head = iob->io_flink;
+      cache->ncached--;
+      cache->nhits++;
+    }
+
+  iob_cpucache_unlock(cache, flags);
+
+  if (iob == NULL)
+    {
+      iob = iob_cpucache_refill();
+      if (iob == NULL)
+        {
+          return NULL;
+        }
+    }
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+  flags = up_irq_save();
+  iob_stats_onalloc(consumerid);
+  up_irq_restore(flags);
+#endif
+
+  /* Put the I/O buffer in a known state */
+
+  iob->io_flink  = NULL; /* Not in a chain */
+  iob->io_len    = 0;    /* Length of the data in the entry */
+  iob->io_offset = 0;    /* Offset to the beginning of data */
+  iob->io_pktlen = 0;    /* Total length of the packet */
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_cpucache_free
+ *
+ * Description:
+ *   Try to free an IOB into the cache of the current CPU.  If the cache
+ *   overflows, a batch of IOBs is returned to the global pool.  false is
+ *   returned if a thread is waiting for an IOB; the caller must then free
+ *   the IOB to the global pool.
+ *
+ ****************************************************************************/
+
+bool iob_cpucache_free(FAR struct iob_s *iob, enum iob_user_e producerid)
+{
+  FAR struct iob_cpucache_s *cache;
+  FAR struct iob_s *drain = NULL;
+  FAR struct iob_s *tail;
+  irqstate_t flags;
+  int i;
+
+  if (g_iob_nwaiters > 0)
+    {
+      return false;
+    }
+
+  cache = iob_cpucache_lock(-1, &flags);
+
+  iob->io_flink = cache->head;
+  cache->head   = iob;
+  cache->ncached++;
+
+  if (cache->ncached > CONFIG_IOB_CPUCACHE_SIZE)
+    {
+      /* Detach a batch from the head of the list */
+
+      drain = cache->head;
+      for (tail = drain, i = 1; i < CONFIG_IOB_CPUCACHE_BATCH; i++)
+        {
+          tail = tail->io_flink;
+        }
+
+      cache->head     = tail->io_flink;
+      cache->ncached -= CONFIG_IOB_CPUCACHE_BATCH;
+      cache->ndrains++;
+      tail->io_flink  = NULL;
+    }
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+  iob_stats_onfree(producerid);
+#endif
+
+  iob_cpucache_unlock(cache, flags);
+
+  if (drain != NULL)
+    {
+      iob_cpucache_release(drain);
+    }
+
+  /* A thread may have started to wait after the check above but before the
+   * IOB was cached.  It flushed the caches before waiting, so the IOB was
+   * either released by that flush or we see the waiter now.
+   */
+
+  if (g_iob_nwaiters > 0)
+    {
+      iob_cpucache_flush(up_cpu_index());
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: iob_cpucache_flush
+ *
+ * Description:
+ *   Return all IOBs in the cache of one CPU to the global pool.  Returns
+ *   the number of IOBs released.
+ *
+ ****************************************************************************/
+
+int iob_cpucache_flush(int cpu)
+{
+  FAR struct iob_cpucache_s *cache;
+  FAR struct iob_s *head;
+  irqstate_t flags;
+  int ncached;
+
+  cache          = iob_cpucache_lock(cpu, &flags);
+  head           = cache->head;
+  ncached        = cache->ncached;
+  cache->head    = NULL;
+  cache->ncached = 0;
+
+  if (ncached > 0)
+    {
+      cache->ndrains++;
+    }
+
+  iob_cpucache_unlock(cache, flags);
+
+  iob_cpucache_release(head);
+  return ncached;
+}
+
+/****************************************************************************
+ * Name: iob_cpucache_flushall
+ *
+ * Description:
+ *   Return all cached IOBs to the global pool.  This is done before an
+ *   allocation fails or waits so that cached IOBs are never withheld.
+ *   Returns the number of IOBs released.
+ *
+ ****************************************************************************/
+
+int iob_cpucache_flushall(void)
+{
+  int nflushed = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      nflushed += iob_cpucache_flush(cpu);
+    }
+
+  return nflushed;
+}
+
+/****************************************************************************
+ * Name: iob_cpucache_navail
+ *
+ * Description:
+ *   Return the number of IOBs held in all caches.  The value is a
+ *   snapshot; it is not taken under the cache locks.
+ *
+ ****************************************************************************/
+
+int iob_cpucache_navail(void)
+{
+  int navail = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      navail += g_iob_cpucache[cpu].ncached;
+    }
+
+  return navail;
+}
+
+/****************************************************************************
+ * Name: iob_getcpustats
+ *
+ * Description:
+ *   Return the cache statistics of one CPU.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
+void iob_getcpustats(int cpu, FAR struct iob_cpustats_s *stats)
+{
+  FAR struct iob_cpucache_s *cache;
+
+  DEBUGASSERT(cpu >= 0 && cpu < CONFIG_SMP_NCPUS && stats != NULL);
+
+  cache           = &g_iob_cpucache[cpu];
+  stats->ncached  = cache->ncached;
+  stats->nhits    = cache->nhits;
+  stats->nrefills = cache->nrefills;
+  stats->ndrains  = cache->ndrains;
+}
+#endif
+
+#endif /* CONFIG_IOB_CPUCACHE */
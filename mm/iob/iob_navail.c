@@ -71,6 +71,12 @@ int iob_navail(bool throttled)
     {
       ret = navail;
 
+#ifdef CONFIG_IOB_CPUCACHE
+      /* IOBs held in the CPU caches are available, too */
+
+      ret += iob_cpucache_navail();
+#endif
+
 #if CONFIG_IOB_THROTTLE > 0
       /* Subtract the throttle value is so requested */
 
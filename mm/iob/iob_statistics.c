@@ -44,16 +44,34 @@
 #include <string.h>
 #include <debug.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/mm/iob.h>
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
     !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* With the per-CPU caches, IOBs are allocated and freed outside of the
+ * critical section.  The statistics are then kept per CPU and summed up
+ * when read.
+ */
+
+#ifdef CONFIG_IOB_CPUCACHE
+#  define IOB_NSTATS   CONFIG_SMP_NCPUS
+#  define IOB_THISCPU  up_cpu_index()
+#else
+#  define IOB_NSTATS   1
+#  define IOB_THISCPU  0
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-struct iob_userstats_s g_iobuserstats[IOBUSER_NENTRIES];
+static struct iob_userstats_s g_iobuserstats[IOB_NSTATS][IOBUSER_NENTRIES];
 
 /****************************************************************************
  * Public Functions
@@ -76,12 +94,14 @@ struct iob_userstats_s g_iobuserstats[IOBUSER_NENTRIES];
 
 void iob_stats_onalloc(enum iob_user_e consumerid)
 {
+  FAR struct iob_userstats_s *stats = g_iobuserstats[IOB_THISCPU];
+
   DEBUGASSERT(consumerid < IOBUSER_NENTRIES);
-  g_iobuserstats[consumerid].totalconsumed++;
+  stats[consumerid].totalconsumed++;
 
   /* Increment the global statistic as well */
 
-  g_iobuserstats[IOBUSER_GLOBAL].totalconsumed++;
+  stats[IOBUSER_GLOBAL].totalconsumed++;
 }
 
 /****************************************************************************
@@ -101,33 +121,46 @@ void iob_stats_onalloc(enum iob_user_e consumerid)
 
 void iob_stats_onfree(enum iob_user_e producerid)
 {
+  FAR struct iob_userstats_s *stats = g_iobuserstats[IOB_THISCPU];
+
   DEBUGASSERT(producerid < IOBUSER_NENTRIES);
-  g_iobuserstats[producerid].totalproduced++;
+  stats[producerid].totalproduced++;
 
   /* Increment the global statistic as well */
 
-  g_iobuserstats[IOBUSER_GLOBAL].totalproduced++;
-
+  stats[IOBUSER_GLOBAL].totalproduced++;
 }
 
 /****************************************************************************
  * Name: iob_getuserstats
  *
  * Description:
- *   Return a reference to the IOB usage statitics for the IOB consumer/producer
+ *   Return the IOB usage statitics for the IOB consumer/producer
  *
  * Input Parameters:
  *   userid - id representing the IOB producer/consumer
+ *   stats  - location to return the statistics
  *
  * Returned Value:
  *   None.
  *
  ****************************************************************************/
 
-FAR struct iob_userstats_s * iob_getuserstats(enum iob_user_e userid)
+void iob_getuserstats(enum iob_user_e userid,
+                      FAR struct iob_userstats_s *stats)
 {
-  DEBUGASSERT(userid < IOBUSER_NENTRIES);
-  return &g_iobuserstats[userid];
+  int i;
+
+  DEBUGASSERT(userid < IOBUSER_NENTRIES && stats != NULL);
+
+  stats->totalconsumed = 0;
+  stats->totalproduced = 0;
+
+  for (i = 0; i < IOB_NSTATS; i++)
+    {
+      stats->totalconsumed += g_iobuserstats[i][userid].totalconsumed;
+      stats->totalproduced += g_iobuserstats[i][userid].totalproduced;
+    }
 }
 
 #endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
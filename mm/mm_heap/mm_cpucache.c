@@ -0,0 +1,476 @@
+/****************************************************************************
+ * mm/mm_heap/mm_cpucache.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_CPUCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Special CPU index that selects the cache of the current CPU */
+
+#define MM_THISCPU -1
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cpucache_lock
+ *
+ * Description:
+ *   Get exclusive access to the cache of one CPU.  Interrupts are disabled
+ *   on the local CPU so that we cannot be suspended or migrated while the
+ *   cache is in use.  In the SMP case, the cache is also protected by a
+ *   spinlock; that spinlock is normally taken only by the owning CPU and
+ *   is contended only when the caches are flushed.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_cpucache_s *
+  mm_cpucache_lock(FAR struct mm_heap_s *heap, int cpu,
+                   FAR irqstate_t *flags)
+{
+  FAR struct mm_cpucache_s *cache;
+
+  *flags = up_irq_save();
+
+  if (cpu == MM_THISCPU)
+    {
+      cpu = up_cpu_index();
+    }
+
+  cache = &heap->mm_cpucache[cpu];
+
+#ifdef CONFIG_SMP
+  spin_lock(&cache->lock);
+#endif
+  return cache;
+}
+
+/****************************************************************************
+ * Name: mm_cpucache_unlock
+ *
+ * Description:
+ *   Relinquish the access obtained by mm_cpucache_lock().
+ *
+ ****************************************************************************/
+
+static inline void mm_cpucache_unlock(FAR struct mm_cpucache_s *cache,
+                                      irqstate_t flags)
+{
+#ifdef CONFIG_SMP
+  spin_unlock(&cache->lock);
+#endif
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: mm_cpucache_refill
+ *
+ * Description:
+ *   Allocate CONFIG_MM_CPUCACHE_BATCH chunks of size 'alignsize' from the
+ *   heap with a single search of the free list.  The first chunk is
+ *   returned to the caller; the remaining chunks are added to the cache of
+ *   the current CPU.
+ *
+ ****************************************************************************/
+
+static FAR void *mm_cpucache_refill(FAR struct mm_heap_s *heap,
+                                    size_t alignsize)
+{
+  FAR struct mm_cpucache_s *cache;
+  FAR struct mm_allocnode_s *chunk;
+  FAR struct mm_allocnode_s *next;
+  FAR struct mm_freenode_s *head = NULL;
+  FAR struct mm_freenode_s *tail = NULL;
+  FAR struct mm_freenode_s *piece;
+  FAR struct mm_cachebin_s *bin;
+  irqstate_t flags;
+  size_t chunksize;
+  size_t nbytes = 0;
+  int i;
+
+  /* Allocate one chunk that is large enough to hold the whole batch */
+
+  mm_takesemaphore(heap);
+
+  chunk = mm_allocchunk(heap, CONFIG_MM_CPUCACHE_BATCH * alignsize);
+  if (chunk == NULL)
+    {
+      mm_givesemaphore(heap);
+      return NULL;
+    }
+
+  /* And carve it into individual allocated chunks.  The final chunk
+   * absorbs any bytes left over by mm_allocchunk().
+   */
+
+  chunksize = chunk->size;
+  next      = (FAR struct mm_allocnode_s *)((FAR char *)chunk + chunksize);
+
+  for (i = 0; i < CONFIG_MM_CPUCACHE_BATCH; i++)
+    {
+      piece = (FAR struct mm_freenode_s *)
+        ((FAR char *)chunk + i * alignsize);
+
+      if (i < CONFIG_MM_CPUCACHE_BATCH - 1)
+        {
+          piece->size = alignsize;
+        }
+      else
+        {
+          piece->size = chunksize - i * alignsize;
+        }
+
+      if (i > 0)
+        {
+          piece->preceding = alignsize | MM_ALLOC_BIT;
+          piece->flink     = head;
+          head             = piece;
+          nbytes          += piece->size;
+
+          if (tail == NULL)
+            {
+              tail = piece;
+            }
+        }
+    }
+
+  next->preceding = piece->size | (next->preceding & MM_ALLOC_BIT);
+  mm_givesemaphore(heap);
+
+  /* Add the extra chunks to the cache of this CPU (which may not be the
+   * same CPU that missed in the cache).
+   */
+
+  if (head != NULL)
+    {
+      cache        = mm_cpucache_lock(heap, MM_THISCPU, &flags);
+      bin          = &cache->bin[MM_CPUCACHE_NDX(alignsize)];
+      tail->flink  = bin->head;
+      bin->head    = head;
+      bin->nchunks += CONFIG_MM_CPUCACHE_BATCH - 1;
+      cache->nbytes += nbytes;
+      mm_cpucache_unlock(cache, flags);
+    }
+
+  return (FAR void *)((FAR char *)chunk + SIZEOF_MM_ALLOCNODE);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cpucache_initialize
+ *
+ * Description:
+ *   Initialize the (empty) per-CPU caches of the selected heap.
+ *
+ ****************************************************************************/
+
+void mm_cpucache_initialize(FAR struct mm_heap_s *heap)
+{
+#ifdef CONFIG_SMP
+  int cpu;
+#endif
+
+  memset(heap->mm_cpucache, 0, sizeof(heap->mm_cpucache));
+
+#ifdef CONFIG_SMP
+  for (cpu = 0; cpu < MM_CPUCACHE_NCPUS; cpu++)
+    {
+      heap->mm_cpucache[cpu].lock = SP_UNLOCKED;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_cpucache_alloc
+ *
+ * Description:
+ *   Try to satisfy a small allocation from the cache of the current CPU.
+ *   If the cache is empty, then the cache is refilled from the heap with a
+ *   batch of chunks.
+ *
+ * Input Parameters:
+ *   heap      - The selected heap
+ *   alignsize - The size of the chunk, including the allocated node header.
+ *
+ * Returned Value:
+ *   The allocated memory or NULL if the request could not be satisfied
+ *   from the cache.  In that case, the caller should fall back to the
+ *   normal heap allocation.
+ *
+ ****************************************************************************/
+
+FAR void *mm_cpucache_alloc(FAR struct mm_heap_s *heap, size_t alignsize)
+{
+  FAR struct mm_cpucache_s *cache;
+  FAR struct mm_cachebin_s *bin;
+  FAR struct mm_freenode_s *node;
+  irqstate_t flags;
+
+  if (alignsize > MM_CPUCACHE_MAXCHUNK)
+    {
+      return NULL;
+    }
+
+  cache = mm_cpucache_lock(heap, MM_THISCPU, &flags);
+  bin   = &cache->bin[MM_CPUCACHE_NDX(alignsize)];
+  node  = bin->head;
+
+  if (node != NULL)
+    {
+      bin->head = node->flink;
+      bin->nchunks--;
+      cache->nbytes -= node->size;
+    }
+
+  mm_cpucache_unlock(cache, flags);
+
+  if (node != NULL)
+    {
+      DEBUGASSERT((node->preceding & MM_ALLOC_BIT) != 0 &&
+                  node->size >= alignsize);
+      return (FAR void *)((FAR char *)node + SIZEOF_MM_ALLOCNODE);
+    }
+
+  return mm_cpucache_refill(heap, alignsize);
+}
+
+/****************************************************************************
+ * Name: mm_cpucache_free
+ *
+ * Description:
+ *   Try to retain a small chunk in the cache of the current CPU.  If the
+ *   cache bin is full, then a batch of chunks is returned to the heap
+ *   first.
+ *
+ * Input Parameters:
+ *   heap - The selected heap
+ *   mem  - The memory being freed
+ *
+ * Returned Value:
+ *   True if the chunk was retained in the cache; false if the chunk is too
+ *   large to be cached and must be returned to the heap by the caller.
+ *
+ ****************************************************************************/
+
+bool mm_cpucache_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_cpucache_s *cache;
+  FAR struct mm_cachebin_s *bin;
+  FAR struct mm_freenode_s *node;
+  FAR struct mm_freenode_s *drain = NULL;
+  irqstate_t flags;
+  int i;
+
+  node = (FAR struct mm_freenode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+  if (node->size > MM_CPUCACHE_MAXCHUNK)
+    {
+      return false;
+    }
+
+  /* Sanity check against double-frees */
+
+  DEBUGASSERT((node->preceding & MM_ALLOC_BIT) != 0);
+
+  cache = mm_cpucache_lock(heap, MM_THISCPU, &flags);
+  bin   = &cache->bin[MM_CPUCACHE_NDX(node->size)];
+
+  /* If the bin is full, detach a batch of chunks to be returned to the
+   * heap.
+   */
+
+  if (bin->nchunks >= CONFIG_MM_CPUCACHE_DEPTH)
+    {
+      FAR struct mm_freenode_s *tail;
+
+      drain = bin->head;
+      tail  = drain;
+      cache->nbytes -= tail->size;
+
+      for (i = 1; i < CONFIG_MM_CPUCACHE_BATCH; i++)
+        {
+          tail = tail->flink;
+          cache->nbytes -= tail->size;
+        }
+
+      bin->head    = tail->flink;
+      bin->nchunks -= CONFIG_MM_CPUCACHE_BATCH;
+      tail->flink  = NULL;
+    }
+
+  node->flink = bin->head;
+  bin->head   = node;
+  bin->nchunks++;
+  cache->nbytes += node->size;
+
+  mm_cpucache_unlock(cache, flags);
+
+  /* Return the detached chunks to the heap */
+
+  if (drain != NULL)
+    {
+      mm_takesemaphore(heap);
+
+      while (drain != NULL)
+        {
+          node  = drain;
+          drain = drain->flink;
+          mm_freechunk(heap, (FAR struct mm_allocnode_s *)node);
+        }
+
+      mm_givesemaphore(heap);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: mm_cpucache_flush
+ *
+ * Description:
+ *   Return all chunks held in the caches of all CPUs to the heap.  This is
+ *   done when the heap is exhausted.
+ *
+ * Input Parameters:
+ *   heap - The selected heap
+ *
+ * Returned Value:
+ *   The number of chunks that were returned to the heap.
+ *
+ * Assumptions:
+ *   The caller holds the MM semaphore.
+ *
+ ****************************************************************************/
+
+int mm_cpucache_flush(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_cpucache_s *cache;
+  FAR struct mm_cachebin_s *bin;
+  FAR struct mm_freenode_s *node;
+  FAR struct mm_freenode_s *next;
+  irqstate_t flags;
+  int nflushed = 0;
+  int cpu;
+  int ndx;
+
+  for (cpu = 0; cpu < MM_CPUCACHE_NCPUS; cpu++)
+    {
+      for (ndx = 0; ndx < CONFIG_MM_CPUCACHE_NCLASSES; ndx++)
+        {
+          /* Detach the whole bin, then free the chunks without holding the
+           * cache lock.
+           */
+
+          cache = mm_cpucache_lock(heap, cpu, &flags);
+          bin   = &cache->bin[ndx];
+          node  = bin->head;
+
+          for (next = node; next != NULL; next = next->flink)
+            {
+              cache->nbytes -= next->size;
+            }
+
+          nflushed    += bin->nchunks;
+          bin->head    = NULL;
+          bin->nchunks = 0;
+          mm_cpucache_unlock(cache, flags);
+
+          for (; node != NULL; node = next)
+            {
+              next = node->flink;
+              mm_freechunk(heap, (FAR struct mm_allocnode_s *)node);
+            }
+        }
+    }
+
+  return nflushed;
+}
+
+/****************************************************************************
+ * Name: mm_cpucache_info
+ *
+ * Description:
+ *   Return the number and total size of the chunks held in the caches of
+ *   all CPUs.  These chunks are marked as allocated in the heap but are
+ *   really free.
+ *
+ ****************************************************************************/
+
+void mm_cpucache_info(FAR struct mm_heap_s *heap, FAR int *nchunks,
+                      FAR size_t *nbytes)
+{
+  FAR struct mm_cpucache_s *cache;
+  irqstate_t flags;
+  int cpu;
+  int ndx;
+
+  *nchunks = 0;
+  *nbytes  = 0;
+
+  for (cpu = 0; cpu < MM_CPUCACHE_NCPUS; cpu++)
+    {
+      cache = mm_cpucache_lock(heap, cpu, &flags);
+
+      for (ndx = 0; ndx < CONFIG_MM_CPUCACHE_NCLASSES; ndx++)
+        {
+          *nchunks += cache->bin[ndx].nchunks;
+        }
+
+      *nbytes += cache->nbytes;
+      mm_cpucache_unlock(cache, flags);
+    }
+}
+
+#endif /* CONFIG_MM_CPUCACHE */
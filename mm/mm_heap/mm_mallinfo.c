@@ -64,6 +64,10 @@ int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info)
   int    ordblks  = 0;  /* Number of non-inuse chunks */
   size_t uordblks = 0;  /* Total allocated space */
   size_t fordblks = 0;  /* Total non-inuse space */
+#ifdef CONFIG_MM_CPUCACHE
+  size_t cachebytes;
+  int    cacheblks;
+#endif
 #if CONFIG_MM_REGIONS > 1
   int region;
 #else
@@ -119,6 +123,17 @@ int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info)
     }
 #undef region
 
+#ifdef CONFIG_MM_CPUCACHE
+  /* Chunks held in the per-CPU caches are marked as allocated in the heap,
+   * but are really free.
+   */
+
+  mm_cpucache_info(heap, &cacheblks, &cachebytes);
+  ordblks  += cacheblks;
+  uordblks -= cachebytes;
+  fordblks += cachebytes;
+#endif
+
   DEBUGASSERT(uordblks + fordblks == heap->mm_heapsize);
 
   info->arena    = heap->mm_heapsize;
@@ -59,69 +59,36 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_malloc
+ * Name: mm_allocchunk
  *
  * Description:
- *  Find the smallest chunk that satisfies the request. Take the memory from
- *  that chunk, save the remaining, smaller chunk (if any).
+ *   Find the smallest free chunk that holds at least 'alignsize' bytes,
+ *   remove it from the free list, return any unused remainder to the free
+ *   list and mark the chunk as allocated.
  *
- *  8-byte alignment of the allocated data is assured.
+ * Input Parameters:
+ *   heap      - The selected heap
+ *   alignsize - The size of the chunk, including the allocated node header.
+ *               This must already be aligned to MM_MIN_CHUNK.
+ *
+ * Returned Value:
+ *   The allocated chunk on success; NULL if no free chunk is large enough.
+ *
+ * Assumptions:
+ *   The caller holds the MM semaphore.
  *
  ****************************************************************************/
 
-FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+FAR struct mm_allocnode_s *mm_allocchunk(FAR struct mm_heap_s *heap,
+                                         size_t alignsize)
 {
   FAR struct mm_freenode_s *node;
-  size_t alignsize;
-  void *ret = NULL;
-  int ndx;
-
-  /* Ignore zero-length allocations */
-
-  if (size < 1)
-    {
-      return NULL;
-    }
-
-  /* Adjust the size to account for (1) the size of the allocated node and
-   * (2) to make sure that it is an even multiple of our granule size.
-   */
-
-  alignsize = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
-  DEBUGASSERT(alignsize >= size);  /* Check for integer overflow */
-
-  /* We need to hold the MM semaphore while we muck with the nodelist. */
-
-  mm_takesemaphore(heap);
-
-  /* Get the location in the node list to start the search. Special case
-   * really big allocations
-   */
-
-  if (alignsize >= MM_MAX_CHUNK)
-    {
-      ndx = MM_NNODES-1;
-    }
-  else
-    {
-      /* Convert the request size into a nodelist index */
-
-      ndx = mm_size2ndx(alignsize);
-    }
 
-  /* Search for a large enough chunk in the list of nodes. This list is
-   * ordered by size, but will have occasional zero sized nodes as we visit
-   * other mm_nodelist[] entries.
-   */
+  /* Search for a large enough chunk in the free list. */
 
-  for (node = heap->mm_nodelist[ndx].flink;
-       node && node->size < alignsize;
-       node = node->flink);
+  node = mm_findfreechunk(heap, alignsize);
 
-  /* If we found a node with non-zero size, then this is one to use. Since
-   * the list is ordered, we know that is must be best fitting chunk
-   * available.
-   */
+  /* If we found a node with non-zero size, then this is one to use. */
 
   if (node)
     {
@@ -129,16 +96,9 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       FAR struct mm_freenode_s *next;
       size_t remaining;
 
-      /* Remove the node.  There must be a predecessor, but there may not be
-       * a successor node.
-       */
+      /* Remove the node from the free list */
 
-      DEBUGASSERT(node->blink);
-      node->blink->flink = node->flink;
-      if (node->flink)
-        {
-          node->flink->blink = node->blink;
-        }
+      mm_delfreechunk(heap, node);
 
       /* Check if we have to split the free node into one of the allocated
        * size and another smaller freenode.  In some cases, the remaining
@@ -180,10 +140,75 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       /* Handle the case of an exact size match */
 
       node->preceding |= MM_ALLOC_BIT;
-      ret = (void *)((FAR char *)node + SIZEOF_MM_ALLOCNODE);
     }
 
-  mm_givesemaphore(heap);
+  return (FAR struct mm_allocnode_s *)node;
+}
+
+/****************************************************************************
+ * Name: mm_malloc
+ *
+ * Description:
+ *  Find the smallest chunk that satisfies the request. Take the memory from
+ *  that chunk, save the remaining, smaller chunk (if any).
+ *
+ *  8-byte alignment of the allocated data is assured.
+ *
+ ****************************************************************************/
+
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR struct mm_allocnode_s *node;
+  size_t alignsize;
+  void *ret = NULL;
+
+  /* Ignore zero-length allocations */
+
+  if (size < 1)
+    {
+      return NULL;
+    }
+
+  /* Adjust the size to account for (1) the size of the allocated node and
+   * (2) to make sure that it is an even multiple of our granule size.
+   */
+
+  alignsize = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
+  DEBUGASSERT(alignsize >= size);  /* Check for integer overflow */
+
+#ifdef CONFIG_MM_CPUCACHE
+  /* Small allocations are first attempted from the per-CPU cache.  This
+   * does not require the MM semaphore.
+   */
+
+  ret = mm_cpucache_alloc(heap, alignsize);
+  if (ret == NULL)
+#endif
+    {
+      /* We need to hold the MM semaphore while we muck with the nodelist. */
+
+      mm_takesemaphore(heap);
+
+      node = mm_allocchunk(heap, alignsize);
+
+#ifdef CONFIG_MM_CPUCACHE
+      /* If the heap is exhausted, then return the chunks held in the
+       * per-CPU caches to the heap and try again.
+       */
+
+      if (node == NULL && mm_cpucache_flush(heap) > 0)
+        {
+          node = mm_allocchunk(heap, alignsize);
+        }
+#endif
+
+      if (node != NULL)
+        {
+          ret = (FAR void *)((FAR char *)node + SIZEOF_MM_ALLOCNODE);
+        }
+
+      mm_givesemaphore(heap);
+    }
 
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
   if (ret)
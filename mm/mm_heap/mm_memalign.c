@@ -93,25 +93,34 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
   size      = MM_ALIGN_UP(size);   /* Make multiples of our granule size */
   allocsize = size + 2*alignment;  /* Add double full alignment size */
 
-  /* Then malloc that size */
-
-  rawchunk = (size_t)mm_malloc(heap, allocsize);
-  if (rawchunk == 0)
-    {
-      return NULL;
-    }
-
   /* We need to hold the MM semaphore while we muck with the chunks and
    * nodelist.
    */
 
   mm_takesemaphore(heap);
 
-  /* Get the node associated with the allocation and the next node after
-   * the allocation.
+  /* Then allocate a chunk of that size.  The chunk is taken directly from
+   * the free list (and not from a per-CPU cache) so that we know that the
+   * preceding chunk is allocated.
    */
 
-  node = (FAR struct mm_allocnode_s *)(rawchunk - SIZEOF_MM_ALLOCNODE);
+  node = mm_allocchunk(heap, MM_ALIGN_UP(allocsize + SIZEOF_MM_ALLOCNODE));
+
+#ifdef CONFIG_MM_CPUCACHE
+  if (node == NULL && mm_cpucache_flush(heap) > 0)
+    {
+      node = mm_allocchunk(heap,
+                           MM_ALIGN_UP(allocsize + SIZEOF_MM_ALLOCNODE));
+    }
+#endif
+
+  if (node == NULL)
+    {
+      mm_givesemaphore(heap);
+      return NULL;
+    }
+
+  rawchunk = (size_t)node + SIZEOF_MM_ALLOCNODE;
 
   /* Find the aligned subregion */
 
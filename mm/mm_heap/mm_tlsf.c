@@ -0,0 +1,254 @@
+/****************************************************************************
+ * mm/mm_heap/mm_tlsf.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <strings.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_TLSF_MANAGER
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tlsf_mapping
+ *
+ * Description:
+ *   Map a chunk size to the first and second level indices of the free
+ *   list that holds chunks of that size.
+ *
+ ****************************************************************************/
+
+static inline void mm_tlsf_mapping(size_t size, FAR int *fl, FAR int *sl)
+{
+  int msb;
+
+  if (size < ((size_t)1 << MM_TLSF_FLSHIFT))
+    {
+      /* Small chunks are kept in MM_MIN_CHUNK sized ranges at level 0 */
+
+      *fl = 0;
+      *sl = (int)(size >> MM_MIN_SHIFT);
+    }
+  else
+    {
+      /* fls() returns the one-based index of the most significant bit */
+
+      msb = fls((int)size) - 1;
+      *fl = msb - MM_TLSF_FLSHIFT + 1;
+      *sl = (int)(size >> (msb - MM_TLSF_SLSHIFT)) - MM_TLSF_SLCOUNT;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tlsf_initialize
+ *
+ * Description:
+ *   Initialize the (empty) segregated free lists of the selected heap.
+ *
+ ****************************************************************************/
+
+void mm_tlsf_initialize(FAR struct mm_heap_s *heap)
+{
+  heap->mm_flbitmap = 0;
+  memset(heap->mm_slbitmap, 0, sizeof(heap->mm_slbitmap));
+  memset(heap->mm_freelist, 0, sizeof(heap->mm_freelist));
+}
+
+/****************************************************************************
+ * Name: mm_addfreechunk
+ *
+ * Description:
+ *   Add a free chunk to the head of the free list for its size.  It is
+ *   assumed that the caller holds the mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_addfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node)
+{
+  FAR struct mm_freenode_s *head;
+  int fl;
+  int sl;
+
+  mm_tlsf_mapping(node->size, &fl, &sl);
+  DEBUGASSERT(fl < MM_TLSF_FLCOUNT && sl < MM_TLSF_SLCOUNT);
+
+  head        = heap->mm_freelist[fl][sl];
+  node->blink = NULL;
+  node->flink = head;
+
+  if (head != NULL)
+    {
+      head->blink = node;
+    }
+
+  heap->mm_freelist[fl][sl] = node;
+  heap->mm_flbitmap        |= (uint32_t)1 << fl;
+  heap->mm_slbitmap[fl]    |= (uint32_t)1 << sl;
+}
+
+/****************************************************************************
+ * Name: mm_delfreechunk
+ *
+ * Description:
+ *   Remove a free chunk from the free list for its size.  The size of the
+ *   chunk must not have been modified since it was added to the free list.
+ *   It is assumed that the caller holds the mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node)
+{
+  int fl;
+  int sl;
+
+  if (node->flink != NULL)
+    {
+      node->flink->blink = node->blink;
+    }
+
+  if (node->blink != NULL)
+    {
+      node->blink->flink = node->flink;
+    }
+  else
+    {
+      /* This is the head of the list.  Clear the bitmaps if the list
+       * becomes empty.
+       */
+
+      mm_tlsf_mapping(node->size, &fl, &sl);
+      DEBUGASSERT(heap->mm_freelist[fl][sl] == node);
+
+      heap->mm_freelist[fl][sl] = node->flink;
+      if (node->flink == NULL)
+        {
+          heap->mm_slbitmap[fl] &= ~((uint32_t)1 << sl);
+          if (heap->mm_slbitmap[fl] == 0)
+            {
+              heap->mm_flbitmap &= ~((uint32_t)1 << fl);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mm_findfreechunk
+ *
+ * Description:
+ *   Find a free chunk that holds at least 'size' bytes in constant time.
+ *   The size is first rounded up to the next free list boundary so that
+ *   every chunk in the selected list is large enough; the first non-empty
+ *   list at or above that boundary is then located using the bitmaps, so
+ *   the chunk at its head always fits.  The lists are never searched:  If
+ *   there is no such list, the allocation fails even though the list for
+ *   the unrounded size might hold a chunk that is large enough.
+ *
+ *   The chunk is not removed from the free list.  It is assumed that the
+ *   caller holds the mm semaphore.
+ *
+ ****************************************************************************/
+
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap,
+                                           size_t size)
+{
+  FAR struct mm_freenode_s *node = NULL;
+  size_t rounded;
+  uint32_t flmap;
+  uint32_t slmap;
+  int fl;
+  int sl;
+
+  if (size > MMSIZE_MAX)
+    {
+      return NULL;
+    }
+
+  if (size < ((size_t)1 << MM_TLSF_FLSHIFT))
+    {
+      rounded = MM_ALIGN_UP(size);
+    }
+  else
+    {
+      rounded = size +
+        ((size_t)1 << (fls((int)size) - 1 - MM_TLSF_SLSHIFT)) - 1;
+    }
+
+  if (rounded <= MMSIZE_MAX)
+    {
+      mm_tlsf_mapping(rounded, &fl, &sl);
+
+      /* Search the second level bitmap for a list at or above sl */
+
+      slmap = heap->mm_slbitmap[fl] & (~(uint32_t)0 << sl);
+      if (slmap == 0 && fl + 1 < MM_TLSF_FLCOUNT)
+        {
+          /* None.. search for any non-empty list at a higher first level */
+
+          flmap = heap->mm_flbitmap & (~(uint32_t)0 << (fl + 1));
+          if (flmap != 0)
+            {
+              fl    = ffs((int)flmap) - 1;
+              slmap = heap->mm_slbitmap[fl];
+            }
+        }
+
+      if (slmap != 0)
+        {
+          sl   = ffs((int)slmap) - 1;
+          node = heap->mm_freelist[fl][sl];
+          DEBUGASSERT(node != NULL && node->size >= size);
+        }
+    }
+
+  return node;
+}
+
+#endif /* CONFIG_MM_TLSF_MANAGER */
@@ -317,6 +317,17 @@ void arp_notify(in_addr_t ipaddr);
 #  define arp_notify(i)
 #endif
 
+/****************************************************************************
+ * Name: arp_initialize
+ *
+ * Description:
+ *   Initialize the ARP table.  Called once from the network initialization
+ *   logic.
+ *
+ ****************************************************************************/
+
+void arp_initialize(void);
+
 /****************************************************************************
  * Name: arp_lookup
  *
@@ -467,6 +478,7 @@ void arp_dump(FAR struct arp_hdr_s *arp);
 
 /* If ARP is disabled, stub out all ARP interfaces */
 
+#  define arp_initialize()
 #  define arp_format(d,i);
 #  define arp_send(i) (0)
 #  define arp_poll(d,c) (0)
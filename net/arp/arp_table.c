@@ -49,6 +49,8 @@
 #include <sys/ioctl.h>
 #include <stdint.h>
 #include <string.h>
+#include <assert.h>
+#include <queue.h>
 #include <debug.h>
 
 #include <netinet/in.h>
@@ -60,6 +62,7 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/net/netstats.h>
 
 #include <arp/arp.h>
 #include <netdev/netdev.h>
@@ -72,6 +75,16 @@
 
 #define ARP_MAXAGE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE)
 
+#ifndef CONFIG_NET_ARPTAB_HASHSIZE
+#  define CONFIG_NET_ARPTAB_HASHSIZE 8
+#endif
+
+#if (CONFIG_NET_ARPTAB_HASHSIZE & (CONFIG_NET_ARPTAB_HASHSIZE - 1)) != 0
+#  error CONFIG_NET_ARPTAB_HASHSIZE must be a power of two
+#endif
+
+#define ARP_HASHMASK (CONFIG_NET_ARPTAB_HASHSIZE - 1)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -82,13 +95,34 @@ struct arp_table_info_s
   FAR struct ether_addr *ai_ethaddr;  /* Location to return the MAC address */
 };
 
+/* The container of one ARP table entry.  All entries are kept in a list
+ * ordered from most to least recently used with the unused entries at the
+ * tail.  Entries in use are also linked into the hash chain selected by
+ * their IP address.
+ */
+
+struct arp_hentry_s
+{
+  dq_entry_t               ah_node;   /* Supports a doubly linked list */
+  FAR struct arp_hentry_s *ah_flink;  /* Next entry in the hash chain */
+  struct arp_entry_s       ah_entry;  /* The ARP table entry */
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
 /* The table of known address mappings */
 
-static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
+static struct arp_hentry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
+
+/* Hash chains of the entries that are in use */
+
+static FAR struct arp_hentry_s *g_arphash[CONFIG_NET_ARPTAB_HASHSIZE];
+
+/* All entries from the most to the least recently used */
+
+static dq_queue_t g_arplru;
 
 /****************************************************************************
  * Private Functions
@@ -141,31 +175,89 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
 }
 
 /****************************************************************************
- * Name: arp_return_old_entry
+ * Name: arp_hash
  *
  * Description:
- *   Compare and return the old ARP table entry.
+ *   Return the hash chain index of an IP address (network order).
  *
  ****************************************************************************/
 
-static FAR struct arp_entry_s *
-arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
+static inline unsigned int arp_hash(in_addr_t ipaddr)
 {
-  if (e1->at_ipaddr == 0)
-    {
-      return e1;
-    }
-  else if (e2->at_ipaddr == 0)
+  uint32_t key = (uint32_t)ipaddr;
+
+  key ^= key >> 16;
+  key ^= key >> 8;
+  return key & ARP_HASHMASK;
+}
+
+/****************************************************************************
+ * Name: arp_findentry
+ *
+ * Description:
+ *   Return the entry in use for the IP address, whether expired or not.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_hentry_s *arp_findentry(in_addr_t ipaddr)
+{
+  FAR struct arp_hentry_s *hentry;
+
+  for (hentry = g_arphash[arp_hash(ipaddr)];
+       hentry != NULL;
+       hentry = hentry->ah_flink)
     {
-      return e2;
+      if (net_ipv4addr_cmp(ipaddr, hentry->ah_entry.at_ipaddr))
+        {
+          break;
+        }
     }
-  else if ((int)(e1->at_time - e2->at_time) <= 0)
+
+  return hentry;
+}
+
+/****************************************************************************
+ * Name: arp_unhash
+ *
+ * Description:
+ *   Remove an entry from its hash chain and move it to the tail of the list
+ *   so that it is the first to be reused.
+ *
+ ****************************************************************************/
+
+static void arp_unhash(FAR struct arp_hentry_s *hentry)
+{
+  FAR struct arp_hentry_s **pprev;
+
+  pprev = &g_arphash[arp_hash(hentry->ah_entry.at_ipaddr)];
+  while (*pprev != hentry)
     {
-      return e1;
+      DEBUGASSERT(*pprev != NULL);
+      pprev = &(*pprev)->ah_flink;
     }
-  else
+
+  *pprev = hentry->ah_flink;
+  hentry->ah_flink = NULL;
+  hentry->ah_entry.at_ipaddr = 0;
+
+  dq_rem(&hentry->ah_node, &g_arplru);
+  dq_addlast(&hentry->ah_node, &g_arplru);
+}
+
+/****************************************************************************
+ * Name: arp_touch
+ *
+ * Description:
+ *   Make the entry the most recently used.
+ *
+ ****************************************************************************/
+
+static inline void arp_touch(FAR struct arp_hentry_s *hentry)
+{
+  if (g_arplru.head != &hentry->ah_node)
     {
-      return e2;
+      dq_rem(&hentry->ah_node, &g_arplru);
+      dq_addfirst(&hentry->ah_node, &g_arplru);
     }
 }
 
@@ -173,6 +265,26 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: arp_initialize
+ *
+ * Description:
+ *   Initialize the ARP table.  Called once from the network initialization
+ *   logic.
+ *
+ ****************************************************************************/
+
+void arp_initialize(void)
+{
+  int i;
+
+  dq_init(&g_arplru);
+  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; i++)
+    {
+      dq_addlast(&g_arptable[i].ah_node, &g_arplru);
+    }
+}
+
 /****************************************************************************
  * Name: arp_update
  *
@@ -195,43 +307,40 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
 
 int arp_update(in_addr_t ipaddr, FAR uint8_t *ethaddr)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
-  int i;
+  FAR struct arp_hentry_s *hentry;
+  FAR struct arp_entry_s *tabptr;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
+  /* Try to find an entry to update.  If none is found, reuse the least
+   * recently used entry.  Unused entries are always at the tail.
    */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  hentry = arp_findentry(ipaddr);
+  if (hentry == NULL)
     {
-      /* Check if the source IP address of the incoming packet matches
-       * the IP address in this ARP table entry.
-       */
+      hentry = (FAR struct arp_hentry_s *)g_arplru.tail;
+      DEBUGASSERT(hentry != NULL);
 
-      if (g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
+      if (hentry->ah_entry.at_ipaddr != 0)
         {
-          /* An old entry found, break. */
-
-          tabptr = &g_arptable[i];
-          break;
+          arp_unhash(hentry);
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.arp.evict++;
+#endif
         }
-      else
-        {
-          /* Record the oldest entry. */
 
-          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
-        }
+      hentry->ah_entry.at_ipaddr = ipaddr;
+      hentry->ah_flink = g_arphash[arp_hash(ipaddr)];
+      g_arphash[arp_hash(ipaddr)] = hentry;
     }
 
   /* Now, tabptr is the ARP table entry which we will fill with the new
    * information.
    */
 
-  tabptr->at_ipaddr = ipaddr;
+  tabptr = &hentry->ah_entry;
   memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
   tabptr->at_time = clock_systimer();
+  arp_touch(hentry);
   return OK;
 }
 
@@ -281,23 +390,34 @@ void arp_hdr_update(FAR uint16_t *pipaddr, FAR uint8_t *ethaddr)
 
 FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr)
 {
-  FAR struct arp_entry_s *tabptr;
-  int i;
+  FAR struct arp_hentry_s *hentry;
 
   /* Check if the IPv4 address is already in the ARP table. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  hentry = arp_findentry(ipaddr);
+  if (hentry != NULL)
     {
-      tabptr = &g_arptable[i];
-      if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr) &&
-          clock_systimer() - tabptr->at_time <= ARP_MAXAGE_TICK)
+      if (clock_systimer() - hentry->ah_entry.at_time <= ARP_MAXAGE_TICK)
         {
-          return tabptr;
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.arp.hit++;
+#endif
+#ifdef CONFIG_NET_ARP_LRU
+          arp_touch(hentry);
+#endif
+          return &hentry->ah_entry;
         }
+
+      /* The entry has expired.  Make it available for reuse. */
+
+      arp_unhash(hentry);
     }
 
   /* Not found */
 
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.arp.miss++;
+#endif
   return NULL;
 }
 
@@ -380,16 +500,16 @@ int arp_find(in_addr_t ipaddr, FAR struct ether_addr *ethaddr)
 
 void arp_delete(in_addr_t ipaddr)
 {
-  FAR struct arp_entry_s *tabptr;
+  FAR struct arp_hentry_s *hentry;
 
   /* Check if the IPv4 address is in the ARP table. */
 
-  tabptr = arp_lookup(ipaddr);
-  if (tabptr != NULL)
+  hentry = arp_findentry(ipaddr);
+  if (hentry != NULL)
     {
       /* Yes.. Set the IP address to zero to "delete" it */
 
-      tabptr->at_ipaddr = 0;
+      arp_unhash(hentry);
     }
 }
 
@@ -428,7 +548,7 @@ unsigned int arp_snapshot(FAR struct arp_entry_s *snapshot,
        nentries > ncopied && i < CONFIG_NET_ARPTAB_SIZE;
        i++)
     {
-      tabptr = &g_arptable[i];
+      tabptr = &g_arptable[i].ah_entry;
       if (tabptr->at_ipaddr != 0 &&
           now - tabptr->at_time <= ARP_MAXAGE_TICK)
         {
@@ -46,8 +46,72 @@
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/netdev.h>
 
+#include "utils/utils.h"
+
 #ifdef CONFIG_MM_IOB
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devif_iob_copyout
+ *
+ * Description:
+ *   This is iob_copyout() that also returns the checksum of the data
+ *   copied.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_ARCH_CHKSUM
+static uint16_t devif_iob_copyout(FAR uint8_t *dest, FAR struct iob_s *iob,
+                                  unsigned int len, unsigned int offset)
+{
+  unsigned int copied = 0;
+  unsigned int ncopy;
+  uint16_t sum = 0;
+  uint16_t part;
+
+  /* Skip to the I/O buffer containing the offset */
+
+  while (iob != NULL && offset >= iob->io_len)
+    {
+      offset -= iob->io_len;
+      iob     = iob->io_flink;
+    }
+
+  /* Then copy and sum the data in each I/O buffer */
+
+  while (iob != NULL && copied < len)
+    {
+      ncopy = iob->io_len - offset;
+      if (ncopy > len - copied)
+        {
+          ncopy = len - copied;
+        }
+
+      part = chksum_copy(0, &dest[copied],
+                         &iob->io_data[iob->io_offset + offset], ncopy);
+
+      /* Data that starts at an odd offset in the packet contributes to
+       * the checksum with its bytes swapped.
+       */
+
+      if ((copied & 1) != 0)
+        {
+          part = (uint16_t)((part << 8) | (part >> 8));
+        }
+
+      sum     = chksum_add(sum, part);
+      copied += ncopy;
+      iob     = iob->io_flink;
+      offset  = 0;
+    }
+
+  return sum;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -74,7 +138,12 @@ void devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
 
   /* Copy the data from the I/O buffer chain to the device buffer */
 
+#ifndef CONFIG_NET_ARCH_CHKSUM
+  dev->d_sndchksum      = devif_iob_copyout(dev->d_appdata, iob, len, offset);
+  dev->d_sndchksumvalid = true;
+#else
   iob_copyout(dev->d_appdata, iob, len, offset);
+#endif
   dev->d_sndlen = len;
 
 #ifdef CONFIG_NET_TCP_WRBUFFER_DUMP
@@ -48,6 +48,7 @@
 #include <nuttx/net/netdev.h>
 
 #include "devif/devif.h"
+#include "utils/utils.h"
 
 /****************************************************************************
  * Public Functions
@@ -69,6 +70,13 @@ void devif_send(struct net_driver_s *dev, const void *buf, int len)
 {
   DEBUGASSERT(dev != NULL && len > 0 && len < NETDEV_PKTSIZE(dev));
 
+#ifndef CONFIG_NET_ARCH_CHKSUM
+  /* Calculate the checksum of the data while copying it */
+
+  dev->d_sndchksum      = chksum_copy(0, dev->d_appdata, buf, len);
+  dev->d_sndchksumvalid = true;
+#else
   memcpy(dev->d_appdata, buf, len);
+#endif
   dev->d_sndlen = len;
 }
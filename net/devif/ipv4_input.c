@@ -341,6 +341,12 @@ int ipv4_input(FAR struct net_driver_s *dev)
   g_netstats.ipv4.recv++;
 #endif
 
+#ifndef CONFIG_NET_ARCH_CHKSUM
+  /* d_buf now holds received data, not the data of devif_send() */
+
+  dev->d_sndchksumvalid = false;
+#endif
+
   /* Start of IP input header processing code.
    *
    * Check validity of the IP header.
@@ -289,6 +289,12 @@ int ipv6_input(FAR struct net_driver_s *dev)
   g_netstats.ipv6.recv++;
 #endif
 
+#ifndef CONFIG_NET_ARCH_CHKSUM
+  /* d_buf now holds received data, not the data of devif_send() */
+
+  dev->d_sndchksumvalid = false;
+#endif
+
   /* Start of IP input header processing code.
    *
    * Check validity of the IP header.
@@ -152,7 +152,7 @@ void local_accept_pollnotify(FAR struct local_conn_s *conn,
           if (fds->revents != 0)
             {
               ninfo("Report events: %02x\n", fds->revents);
-              nxsem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
@@ -225,10 +225,14 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
 
           shadowfds[0].fd     = 0; /* Does not matter */
           shadowfds[0].sem    = fds->sem;
+          shadowfds[0].cb     = fds->cb;
+          shadowfds[0].arg    = fds->arg;
           shadowfds[0].events = fds->events & ~POLLOUT;
 
           shadowfds[1].fd     = 1; /* Does not matter */
           shadowfds[1].sem    = fds->sem;
+          shadowfds[1].cb     = fds->cb;
+          shadowfds[1].arg    = fds->arg;
           shadowfds[1].events = fds->events & ~POLLIN;
 
           /* Setup poll for both shadow pollfds. */
@@ -295,7 +299,7 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
 
 pollerr:
   fds->revents |= POLLERR;
-  nxsem_post(fds->sem);
+  poll_notify(fds);
   return OK;
 }
 
@@ -46,6 +46,7 @@
  ****************************************************************************/
 
 #include <stdint.h>
+#include <queue.h>
 
 #include <net/ethernet.h>
 
@@ -57,6 +58,35 @@
 
 #ifdef CONFIG_NET_IPv6
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_IPv6_NCONF_HASHSIZE
+#  define CONFIG_NET_IPv6_NCONF_HASHSIZE 4
+#endif
+
+#if (CONFIG_NET_IPv6_NCONF_HASHSIZE & (CONFIG_NET_IPv6_NCONF_HASHSIZE - 1)) != 0
+#  error CONFIG_NET_IPv6_NCONF_HASHSIZE must be a power of two
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The container of one Neighbor Table entry.  All entries are kept in a
+ * list ordered from most to least recently used with the unused entries at
+ * the tail.  Entries in use are also linked into the hash chain selected by
+ * their IPv6 address.
+ */
+
+struct neighbor_hentry_s
+{
+  dq_entry_t                    nh_node;   /* Supports a doubly linked list */
+  FAR struct neighbor_hentry_s *nh_flink;  /* Next entry in the hash chain */
+  struct neighbor_entry_s       nh_entry;  /* The Neighbor Table entry */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -65,7 +95,16 @@
  * this table.
  */
 
-extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+extern struct neighbor_hentry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+
+/* Hash chains of the entries that are in use */
+
+extern FAR struct neighbor_hentry_s *
+  g_neighbor_hash[CONFIG_NET_IPv6_NCONF_HASHSIZE];
+
+/* All entries from the most to the least recently used */
+
+extern dq_queue_t g_neighbor_lru;
 
 /****************************************************************************
  * Public Function Prototypes
@@ -73,6 +112,27 @@ extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
 struct net_driver_s; /* Forward reference */
 
+/****************************************************************************
+ * Name: neighbor_initialize
+ *
+ * Description:
+ *   Initialize the Neighbor Table.  Called once from the network
+ *   initialization logic.
+ *
+ ****************************************************************************/
+
+void neighbor_initialize(void);
+
+/****************************************************************************
+ * Name: neighbor_hash
+ *
+ * Description:
+ *   Return the hash chain index of an IPv6 address.
+ *
+ ****************************************************************************/
+
+unsigned int neighbor_hash(const net_ipv6addr_t ipaddr);
+
 /****************************************************************************
  * Name: neighbor_findentry
  *
@@ -89,7 +149,19 @@ struct net_driver_s; /* Forward reference */
  *
  ****************************************************************************/
 
-FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr);
+FAR struct neighbor_hentry_s *
+  neighbor_findentry(const net_ipv6addr_t ipaddr);
+
+/****************************************************************************
+ * Name: neighbor_touch
+ *
+ * Description:
+ *   Make the entry the most recently used so that it is the last candidate
+ *   for replacement.
+ *
+ ****************************************************************************/
+
+void neighbor_touch(FAR struct neighbor_hentry_s *hentry);
 
 /****************************************************************************
  * Name: neighbor_add
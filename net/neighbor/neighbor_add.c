@@ -53,8 +53,10 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/neighbor.h>
+#include <nuttx/net/netstats.h>
 
 #include "netdev/netdev.h"
+#include "inet/inet.h"
 #include "neighbor/neighbor.h"
 
 /****************************************************************************
@@ -81,53 +83,68 @@
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                   FAR uint8_t *addr)
 {
-  uint8_t lltype;
-  clock_t oldest_time;
-  int     oldest_ndx;
-  int     i;
+  FAR struct neighbor_hentry_s *hentry;
+  FAR struct neighbor_hentry_s **pprev;
+  FAR struct neighbor_entry_s *neighbor;
+  unsigned int hash;
 
   DEBUGASSERT(dev != NULL && addr != NULL);
 
-  /* Find the matching entry, first unused entry, or the oldest used entry.
-   * The unused entry will have ne_time == 0 and should generate the oldest
-   * time.  REVISIT:  Could this fail on clock wraparound?  A more explicit
-   * check might be to compare ne_ipaddr with the IPv6 unspecified address.
+  /* Check if there is already an entry for this address.  Its link layer
+   * address will be replaced.
    */
 
-  oldest_time = g_neighbors[0].ne_time;
-  oldest_ndx  = 0;
-  lltype      = dev->d_lltype;
-
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  hentry = neighbor_findentry(ipaddr);
+  if (hentry == NULL)
     {
-      if (g_neighbors[i].ne_addr.na_lltype == lltype &&
-          net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
-        {
-          oldest_ndx = i;
-          break;
-        }
+      /* No.. Use the entry at the tail of the list.  That is either an
+       * unused entry or, if the table is full, the least recently used
+       * entry.
+       */
 
-      if ((int)(g_neighbors[i].ne_time - oldest_time) < 0)
+      hentry = (FAR struct neighbor_hentry_s *)g_neighbor_lru.tail;
+      DEBUGASSERT(hentry != NULL);
+
+      neighbor = &hentry->nh_entry;
+      if (!net_ipv6addr_cmp(neighbor->ne_ipaddr, g_ipv6_unspecaddr))
         {
-          oldest_ndx = i;
-          oldest_time = g_neighbors[i].ne_time;
+          /* The entry is in use.  Remove it from its hash chain. */
+
+          pprev = &g_neighbor_hash[neighbor_hash(neighbor->ne_ipaddr)];
+          while (*pprev != hentry)
+            {
+              DEBUGASSERT(*pprev != NULL);
+              pprev = &(*pprev)->nh_flink;
+            }
+
+          *pprev = hentry->nh_flink;
+          neighbor_dumpentry("Evicted entry", neighbor);
+
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.neighbor.evict++;
+#endif
         }
+
+      /* Add the entry to the hash chain of the new address */
+
+      hash             = neighbor_hash(ipaddr);
+      hentry->nh_flink = g_neighbor_hash[hash];
+      g_neighbor_hash[hash] = hentry;
     }
 
-  /* Use the oldest or first free entry (either pointed to by the
-   * "oldest_ndx" variable).
-   */
+  /* Initialize the entry and make it the most recently used */
 
-  g_neighbors[oldest_ndx].ne_time = clock_systimer();
-  net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
+  neighbor          = &hentry->nh_entry;
+  neighbor->ne_time = clock_systimer();
+  net_ipv6addr_copy(neighbor->ne_ipaddr, ipaddr);
 
-  g_neighbors[oldest_ndx].ne_addr.na_lltype = lltype;
-  g_neighbors[oldest_ndx].ne_addr.na_llsize = netdev_lladdrsize(dev);
+  neighbor->ne_addr.na_lltype = dev->d_lltype;
+  neighbor->ne_addr.na_llsize = netdev_lladdrsize(dev);
 
-  memcpy(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-         g_neighbors[oldest_ndx].ne_addr.na_llsize);
+  memcpy(&neighbor->ne_addr.u, addr, neighbor->ne_addr.na_llsize);
+  neighbor_touch(hentry);
 
   /* Dump the contents of the new entry */
 
-  neighbor_dumpentry("Added entry", &g_neighbors[oldest_ndx]);
+  neighbor_dumpentry("Added entry", neighbor);
 }
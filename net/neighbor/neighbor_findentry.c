@@ -52,6 +52,23 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: neighbor_hash
+ *
+ * Description:
+ *   Return the hash chain index of an IPv6 address.  Neighbors normally
+ *   share the network prefix so only the interface identifier is hashed.
+ *
+ ****************************************************************************/
+
+unsigned int neighbor_hash(const net_ipv6addr_t ipaddr)
+{
+  uint16_t key = ipaddr[4] ^ ipaddr[5] ^ ipaddr[6] ^ ipaddr[7];
+
+  key ^= key >> 8;
+  return key & (CONFIG_NET_IPv6_NCONF_HASHSIZE - 1);
+}
+
 /****************************************************************************
  * Name: neighbor_findentry
  *
@@ -68,21 +85,40 @@
  *
  ****************************************************************************/
 
-FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
+FAR struct neighbor_hentry_s *
+  neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
-  int i;
+  FAR struct neighbor_hentry_s *hentry;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (hentry = g_neighbor_hash[neighbor_hash(ipaddr)];
+       hentry != NULL;
+       hentry = hentry->nh_flink)
     {
-      FAR struct neighbor_entry_s *neighbor = &g_neighbors[i];
-
-      if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
+      if (net_ipv6addr_cmp(hentry->nh_entry.ne_ipaddr, ipaddr))
         {
-          neighbor_dumpentry("Entry found", neighbor);
-          return neighbor;
+          neighbor_dumpentry("Entry found", &hentry->nh_entry);
+          return hentry;
         }
     }
 
   neighbor_dumpipaddr("Not found", ipaddr);
   return NULL;
 }
+
+/****************************************************************************
+ * Name: neighbor_touch
+ *
+ * Description:
+ *   Make the entry the most recently used so that it is the last candidate
+ *   for replacement.
+ *
+ ****************************************************************************/
+
+void neighbor_touch(FAR struct neighbor_hentry_s *hentry)
+{
+  if (g_neighbor_lru.head != &hentry->nh_node)
+    {
+      dq_rem(&hentry->nh_node, &g_neighbor_lru);
+      dq_addfirst(&hentry->nh_node, &g_neighbor_lru);
+    }
+}
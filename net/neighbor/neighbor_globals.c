@@ -42,6 +42,10 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <string.h>
+#include <queue.h>
+
 #include <nuttx/clock.h>
 
 #include "neighbor/neighbor.h"
@@ -54,5 +58,42 @@
  * this table.
  */
 
-struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+struct neighbor_hentry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+
+/* Hash chains of the entries that are in use */
+
+FAR struct neighbor_hentry_s *g_neighbor_hash[CONFIG_NET_IPv6_NCONF_HASHSIZE];
+
+/* All entries from the most to the least recently used */
+
+dq_queue_t g_neighbor_lru;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_initialize
+ *
+ * Description:
+ *   Initialize the Neighbor Table.  Called once from the network
+ *   initialization logic.
+ *
+ ****************************************************************************/
+
+void neighbor_initialize(void)
+{
+  int i;
+
+  memset(g_neighbors, 0, sizeof(g_neighbors));
+  memset(g_neighbor_hash, 0, sizeof(g_neighbor_hash));
+  dq_init(&g_neighbor_lru);
+
+  /* All entries start out unused and available for allocation */
+
+  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; i++)
+    {
+      dq_addlast(&g_neighbors[i].nh_node, &g_neighbor_lru);
+    }
+}
 
@@ -49,6 +49,7 @@
 
 #include <nuttx/net/ip.h>
 #include <nuttx/net/neighbor.h>
+#include <nuttx/net/netstats.h>
 
 #include "netdev/netdev.h"
 #include "neighbor/neighbor.h"
@@ -131,21 +132,28 @@ static int neighbor_match(FAR struct net_driver_s *dev, FAR void *arg)
 int neighbor_lookup(FAR const net_ipv6addr_t ipaddr,
                     FAR struct neighbor_addr_s *laddr)
 {
-  FAR struct neighbor_entry_s *neighbor;
+  FAR struct neighbor_hentry_s *hentry;
   struct neighbor_table_info_s info;
 
   /* Check if the IPv6 address is already in the neighbor table. */
 
-  neighbor = neighbor_findentry(ipaddr);
-  if (neighbor != NULL)
+  hentry = neighbor_findentry(ipaddr);
+  if (hentry != NULL)
     {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.neighbor.hit++;
+#endif
+#ifdef CONFIG_NET_IPv6_NCONF_LRU
+      neighbor_touch(hentry);
+#endif
+
       /* Yes.. return the link layer address if the caller has provided a
        * non-NULL address in 'laddr'.
        */
 
       if (laddr != NULL)
         {
-          memcpy(laddr, &neighbor->ne_addr, sizeof(*laddr));
+          memcpy(laddr, &hentry->nh_entry.ne_addr, sizeof(*laddr));
         }
 
       /* Return success in any case meaning that a valid link layer
@@ -155,6 +163,10 @@ int neighbor_lookup(FAR const net_ipv6addr_t ipaddr,
       return OK;
     }
 
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.neighbor.miss++;
+#endif
+
   /* No.. check if the IPv6 address is the address assigned to a local
    * network device.  If so, return a mapping of that IPv6 address
    * to the linker layer address assigned to the network device.
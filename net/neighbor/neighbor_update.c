@@ -67,11 +67,12 @@
 
 void neighbor_update(const net_ipv6addr_t ipaddr)
 {
-  struct neighbor_entry_s *neighbor;
+  FAR struct neighbor_hentry_s *hentry;
 
-  neighbor = neighbor_findentry(ipaddr);
-  if (neighbor != NULL)
+  hentry = neighbor_findentry(ipaddr);
+  if (hentry != NULL)
     {
-      neighbor->ne_time = clock_systimer();
+      hentry->nh_entry.ne_time = clock_systimer();
+      neighbor_touch(hentry);
     }
 }
@@ -48,6 +48,8 @@
 #include "socket/socket.h"
 #include "devif/devif.h"
 #include "netdev/netdev.h"
+#include "arp/arp.h"
+#include "neighbor/neighbor.h"
 #include "ipforward/ipforward.h"
 #include "sixlowpan/sixlowpan.h"
 #include "icmp/icmp.h"
@@ -99,7 +101,21 @@ void net_initialize(void)
 
   net_lockinitialize();
 
+  /* Initialize the lock on the list of network devices */
+
+  net_rwlock_init(&g_netdev_lock);
+
+#ifdef CONFIG_NET_ARP
+  /* Initialize the ARP table */
+
+  arp_initialize();
+#endif
+
 #ifdef CONFIG_NET_IPv6
+  /* Initialize the Neighbor table */
+
+  neighbor_initialize();
+
 #ifdef CONFIG_NET_MLD
   /* Initialize ICMPv6 Multicast Listener Discovery (MLD) logic */
 
@@ -45,6 +45,7 @@
 #include <sys/types.h>
 #include <stdbool.h>
 
+#include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
 #ifdef CONFIG_NETDOWN_NOTIFIER
@@ -74,14 +75,22 @@ extern "C"
 #define EXTERN extern
 #endif
 
-/* List of registered Ethernet device drivers.  You must have the network
- * locked in order to access this list.
+/* List of registered Ethernet device drivers.  You must have either the
+ * network locked or g_netdev_lock held for reading in order to access this
+ * list.  Modifications require both the network lock and g_netdev_lock
+ * held for writing.
  *
  * NOTE that this duplicates a declaration in net/tcp/tcp.h
  */
 
 EXTERN struct net_driver_s *g_netdevices;
 
+/* Reader-writer lock that protects g_netdevices and the interface index
+ * sets below.  It lets device lookups proceed without the network lock.
+ */
+
+EXTERN struct net_rwlock_s g_netdev_lock;
+
 #ifdef CONFIG_NETDEV_IFINDEX
 /* The set of network devices that have been registered.  This is used to
  * assign a unique device index to the newly registered device.
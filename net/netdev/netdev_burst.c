@@ -0,0 +1,356 @@
+/****************************************************************************
+ * net/netdev/netdev_burst.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <arpa/inet.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/arp.h>
+#include <nuttx/net/ethernet.h>
+#include <nuttx/net/netdev.h>
+
+#ifdef CONFIG_NET_PKT
+#  include <nuttx/net/pkt.h>
+#endif
+
+#include "netdev/netdev.h"
+
+#ifdef CONFIG_NETDEV_BURST
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of one netdev_txburst() call */
+
+struct netdev_txburst_s
+{
+  FAR struct netdev_pkt_s *tx;  /* The driver's array of frame buffers */
+  int ntx;                      /* The number of entries in tx */
+  int n;                        /* The number of entries filled so far */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The poll callback has no argument other than the device, so the state of
+ * the burst in progress is reached through this pointer.  It is protected
+ * by net_lock().
+ */
+
+static FAR struct netdev_txburst_s *g_txburst;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_burst_out
+ *
+ * Description:
+ *   Add the Ethernet header to the outgoing IP packet in d_buf.
+ *
+ ****************************************************************************/
+
+static void netdev_burst_out(FAR struct net_driver_s *dev)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (IFF_IS_IPv4(dev->d_flags))
+#endif
+    {
+      arp_out(dev);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      neighbor_out(dev);
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+
+/****************************************************************************
+ * Name: netdev_burst_input
+ *
+ * Description:
+ *   Give the Ethernet frame in d_buf to the network.  On return, d_len is
+ *   the length of any reply frame left in d_buf.
+ *
+ ****************************************************************************/
+
+static void netdev_burst_input(FAR struct net_driver_s *dev)
+{
+  FAR struct eth_hdr_s *eth = (FAR struct eth_hdr_s *)dev->d_buf;
+
+  NETDEV_RXPACKETS(dev);
+
+  if (dev->d_len <= ETH_HDRLEN)
+    {
+      NETDEV_RXERRORS(dev);
+      dev->d_len = 0;
+      return;
+    }
+
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the frame into the packet tap */
+
+  pkt_input(dev);
+#endif
+
+  /* We only accept IP packets of the configured type and ARP packets */
+
+#ifdef CONFIG_NET_IPv4
+  if (eth->type == HTONS(ETHTYPE_IP))
+    {
+      ninfo("IPv4 frame\n");
+      NETDEV_RXIPV4(dev);
+
+      /* Handle ARP on input then give the IPv4 packet to the network
+       * layer
+       */
+
+      arp_ipin(dev);
+      ipv4_input(dev);
+
+      if (dev->d_len > 0)
+        {
+          netdev_burst_out(dev);
+        }
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (eth->type == HTONS(ETHTYPE_IP6))
+    {
+      ninfo("IPv6 frame\n");
+      NETDEV_RXIPV6(dev);
+
+      ipv6_input(dev);
+
+      if (dev->d_len > 0)
+        {
+          netdev_burst_out(dev);
+        }
+    }
+  else
+#endif
+#ifdef CONFIG_NET_ARP
+  if (eth->type == HTONS(ETHTYPE_ARP))
+    {
+      ninfo("ARP frame\n");
+      NETDEV_RXARP(dev);
+
+      arp_arpin(dev);
+    }
+  else
+#endif
+    {
+      NETDEV_RXDROPPED(dev);
+      nwarn("WARNING: Unsupported Ethernet type %u\n", eth->type);
+      dev->d_len = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: netdev_txburst_callback
+ *
+ * Description:
+ *   The devif_poll() callback used by netdev_txburst().  Each frame is left
+ *   in the current buffer and d_buf moves on to the next one.
+ *
+ ****************************************************************************/
+
+static int netdev_txburst_callback(FAR struct net_driver_s *dev)
+{
+  FAR struct netdev_txburst_s *burst = g_txburst;
+
+  if (dev->d_len > 0)
+    {
+      netdev_burst_out(dev);
+
+      if (!devif_loopback(dev))
+        {
+          burst->tx[burst->n].p_len = dev->d_len;
+          if (++burst->n >= burst->ntx)
+            {
+              /* No more buffers, stop the poll */
+
+              return 1;
+            }
+
+          dev->d_buf = burst->tx[burst->n].p_buf;
+        }
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_rxburst
+ *
+ * Description:
+ *   Process a burst of received Ethernet frames.  Each frame is processed in
+ *   place:  d_buf is pointed at the driver's buffer rather than copying the
+ *   frame, and the network is locked only once for the whole burst.
+ *
+ *   On return, the p_len field of each entry holds the length of a reply
+ *   frame that the network left in that same buffer (with the Ethernet
+ *   header already completed) or zero if there is nothing to send.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure
+ *   rx  - The array of received frames
+ *   nrx - The number of entries in rx
+ *
+ * Returned Value:
+ *   The number of entries in rx that now hold a reply frame to be sent.
+ *
+ ****************************************************************************/
+
+int netdev_rxburst(FAR struct net_driver_s *dev,
+                   FAR struct netdev_pkt_s *rx, int nrx)
+{
+  FAR uint8_t *buf;
+  int nreply = 0;
+  int i;
+
+  DEBUGASSERT(dev != NULL && rx != NULL &&
+              dev->d_lltype == NET_LL_ETHERNET);
+
+  net_lock();
+  buf = dev->d_buf;
+
+  for (i = 0; i < nrx; i++)
+    {
+      dev->d_buf = rx[i].p_buf;
+      dev->d_len = rx[i].p_len;
+
+      netdev_burst_input(dev);
+
+      rx[i].p_len = dev->d_len;
+      if (dev->d_len > 0)
+        {
+          nreply++;
+        }
+    }
+
+  dev->d_buf = buf;
+  dev->d_len = 0;
+  net_unlock();
+
+  return nreply;
+}
+
+/****************************************************************************
+ * Name: netdev_txburst
+ *
+ * Description:
+ *   Poll the network for a burst of frames to send.  This is equivalent to
+ *   devif_poll() (or devif_timer() if timer is true), but each frame is
+ *   built directly in the next buffer of tx rather than in d_buf and
+ *   the network is locked only once for the whole burst.  Polling stops
+ *   when all of the buffers in tx are used.  Frames sent to ourself are
+ *   looped back and not returned.
+ *
+ * Input Parameters:
+ *   dev   - The device driver structure
+ *   tx    - The array of frame buffers.  The driver provides p_buf and
+ *           the length of each frame is returned in p_len.
+ *   ntx   - The number of entries in tx
+ *   timer - True to perform the periodic timer processing as well
+ *
+ * Returned Value:
+ *   The number of frames in tx that are ready to be sent.  If this equals
+ *   ntx, there may be more frames and the driver should poll again once
+ *   it has sent this burst.
+ *
+ ****************************************************************************/
+
+int netdev_txburst(FAR struct net_driver_s *dev,
+                   FAR struct netdev_pkt_s *tx, int ntx, bool timer)
+{
+  FAR struct netdev_txburst_s *save;
+  struct netdev_txburst_s burst;
+  FAR uint8_t *buf;
+
+  DEBUGASSERT(dev != NULL && tx != NULL && ntx > 0 &&
+              dev->d_lltype == NET_LL_ETHERNET);
+
+  burst.tx  = tx;
+  burst.ntx = ntx;
+  burst.n   = 0;
+
+  net_lock();
+  save       = g_txburst;
+  g_txburst  = &burst;
+  buf        = dev->d_buf;
+  dev->d_buf = tx[0].p_buf;
+
+  if (timer)
+    {
+      devif_timer(dev, netdev_txburst_callback);
+    }
+  else
+    {
+      devif_poll(dev, netdev_txburst_callback);
+    }
+
+  dev->d_buf = buf;
+  g_txburst  = save;
+  net_unlock();
+
+  return burst.n;
+}
+
+#endif /* CONFIG_NETDEV_BURST */
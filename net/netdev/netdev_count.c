@@ -70,9 +70,13 @@ int netdev_count(void)
   struct net_driver_s *dev;
   int ndev;
 
-  net_lock();
+  if (net_rdlock(&g_netdev_lock) < 0)
+    {
+      return 0;
+    }
+
   for (dev = g_netdevices, ndev = 0; dev; dev = dev->flink, ndev++);
-  net_unlock();
+  net_rdunlock(&g_netdev_lock);
   return ndev;
 }
 
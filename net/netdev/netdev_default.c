@@ -76,7 +76,11 @@ FAR struct net_driver_s *netdev_default(void)
 
   /* Examine each registered network device */
 
-  net_lock();
+  if (net_rdlock(&g_netdev_lock) < 0)
+    {
+      return NULL;
+    }
+
   for (dev = g_netdevices; dev; dev = dev->flink)
     {
       /* Is the interface in the "up" state? */
@@ -96,7 +100,7 @@ FAR struct net_driver_s *netdev_default(void)
         }
     }
 
-  net_unlock();
+  net_rdunlock(&g_netdev_lock);
   return ret;
 }
 
@@ -84,7 +84,11 @@ FAR struct net_driver_s *netdev_findby_lipv4addr(in_addr_t lipaddr)
 
   /* Examine each registered network device */
 
-  net_lock();
+  if (net_rdlock(&g_netdev_lock) < 0)
+    {
+      return NULL;
+    }
+
   for (dev = g_netdevices; dev; dev = dev->flink)
     {
       /* Is the interface in the "up" state? */
@@ -98,7 +102,7 @@ FAR struct net_driver_s *netdev_findby_lipv4addr(in_addr_t lipaddr)
             {
               /* Its a match */
 
-              net_unlock();
+              net_rdunlock(&g_netdev_lock);
               return dev;
             }
         }
@@ -106,7 +110,7 @@ FAR struct net_driver_s *netdev_findby_lipv4addr(in_addr_t lipaddr)
 
   /* No device with the matching address found */
 
-  net_unlock();
+  net_rdunlock(&g_netdev_lock);
   return NULL;
 }
 #endif /* CONFIG_NET_IPv4 */
@@ -135,7 +139,11 @@ FAR struct net_driver_s *netdev_findby_lipv6addr(const net_ipv6addr_t lipaddr)
 
   /* Examine each registered network device */
 
-  net_lock();
+  if (net_rdlock(&g_netdev_lock) < 0)
+    {
+      return NULL;
+    }
+
   for (dev = g_netdevices; dev; dev = dev->flink)
     {
       /* Is the interface in the "up" state? */
@@ -149,7 +157,7 @@ FAR struct net_driver_s *netdev_findby_lipv6addr(const net_ipv6addr_t lipaddr)
             {
               /* Its a match */
 
-              net_unlock();
+              net_rdunlock(&g_netdev_lock);
               return dev;
             }
         }
@@ -157,7 +165,7 @@ FAR struct net_driver_s *netdev_findby_lipv6addr(const net_ipv6addr_t lipaddr)
 
   /* No device with the matching address found */
 
-  net_unlock();
+  net_rdunlock(&g_netdev_lock);
   return NULL;
 }
 #endif /* CONFIG_NET_IPv6 */
@@ -64,7 +64,8 @@
  *
  * Returned Value:
  *  Pointer to driver on success; NULL on failure.  This function will return
- *  NULL only if there is no device corresponding to the provided index.
+ *  NULL only if there is no device corresponding to the provided index or
+ *  if the wait for the lock was canceled.
  *
  ****************************************************************************/
 
@@ -85,7 +86,10 @@ FAR struct net_driver_s *netdev_findbyindex(int ifindex)
     }
 #endif
 
-  net_lock();
+  if (net_rdlock(&g_netdev_lock) < 0)
+    {
+      return NULL;
+    }
 
 #ifdef CONFIG_NETDEV_IFINDEX
   /* Check if this index has been assigned */
@@ -94,7 +98,7 @@ FAR struct net_driver_s *netdev_findbyindex(int ifindex)
     {
       /* This index has not been assigned */
 
-      net_unlock();
+      net_rdunlock(&g_netdev_lock);
       return NULL;
     }
 #endif
@@ -117,12 +121,12 @@ FAR struct net_driver_s *netdev_findbyindex(int ifindex)
       if (i == (ifindex - 1))
 #endif
         {
-          net_unlock();
+          net_rdunlock(&g_netdev_lock);
           return dev;
         }
     }
 
-  net_unlock();
+  net_rdunlock(&g_netdev_lock);
   return NULL;
 }
 
@@ -152,9 +156,9 @@ int netdev_nextindex(int ifindex)
   DEBUGASSERT(ifindex > 0 && ifindex <= MAX_IFINDEX);
   ifindex--;
 
-  if (ifindex >= 0 && ifindex < MAX_IFINDEX)
+  if (ifindex >= 0 && ifindex < MAX_IFINDEX &&
+      net_rdlock(&g_netdev_lock) >= 0)
     {
-      net_lock();
       for (; ifindex < MAX_IFINDEX; ifindex++)
         {
           if ((g_devset & (1L << ifindex)) != 0)
@@ -163,12 +167,12 @@ int netdev_nextindex(int ifindex)
                * mean no-index in the POSIX standards.
                */
 
-              net_unlock();
+              net_rdunlock(&g_netdev_lock);
               return ifindex + 1;
             }
         }
 
-      net_unlock();
+      net_rdunlock(&g_netdev_lock);
     }
 
   return -ENODEV;
@@ -70,19 +70,18 @@ FAR struct net_driver_s *netdev_findbyname(FAR const char *ifname)
 {
   FAR struct net_driver_s *dev;
 
-  if (ifname)
+  if (ifname && net_rdlock(&g_netdev_lock) >= 0)
     {
-      net_lock();
       for (dev = g_netdevices; dev; dev = dev->flink)
         {
           if (strcmp(ifname, dev->d_ifname) == 0)
             {
-              net_unlock();
+              net_rdunlock(&g_netdev_lock);
               return dev;
             }
         }
 
-      net_unlock();
+      net_rdunlock(&g_netdev_lock);
     }
 
   return NULL;
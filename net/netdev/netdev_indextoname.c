@@ -84,7 +84,13 @@ int netdev_indextoname(unsigned int ifindex, FAR char *ifname)
 
   /* Find the driver with this name */
 
-  net_lock();
+  ret = net_rdlock(&g_netdev_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = -ENODEV;
   dev = netdev_findbyindex(ifindex);
   if (dev != NULL)
     {
@@ -92,7 +98,7 @@ int netdev_indextoname(unsigned int ifindex, FAR char *ifname)
       ret = OK;
     }
 
-  net_unlock();
+  net_rdunlock(&g_netdev_lock);
   return ret;
 }
 
@@ -1255,6 +1255,12 @@ static int netdev_arp_ioctl(FAR struct socket *psock, int cmd,
 {
   int ret;
 
+  /* Look-ups reorder the ARP table, so all commands need the network
+   * locked.
+   */
+
+  net_lock();
+
   /* Execute the command */
 
   switch (cmd)
@@ -1291,14 +1297,11 @@ static int netdev_arp_ioctl(FAR struct socket *psock, int cmd,
 
               /* Find the existing ARP table entry for this protocol address. */
 
-              FAR struct arp_entry_s *entry = arp_lookup(addr->sin_addr.s_addr);
-              if (entry != NULL)
+              if (arp_lookup(addr->sin_addr.s_addr) != NULL)
                 {
-                  /* The ARP table is fixed size; an entry is deleted
-                   * by nullifying its protocol address.
-                   */
+                  /* Remove it from the hash and LRU lists as well */
 
-                  entry->at_ipaddr = 0;
+                  arp_delete(addr->sin_addr.s_addr);
                   ret = OK;
                 }
               else
@@ -1346,6 +1349,7 @@ static int netdev_arp_ioctl(FAR struct socket *psock, int cmd,
         break;
     }
 
+  net_unlock();
   return ret;
 }
 #endif
@@ -75,17 +75,23 @@ unsigned int netdev_nametoindex(FAR const char *ifname)
 {
   FAR struct net_driver_s *dev;
   unsigned int ifindex = -ENODEV;
+  int ret;
 
   /* Find the driver with this name */
 
-  net_lock();
+  ret = net_rdlock(&g_netdev_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   dev = netdev_findbyname(ifname);
   if (dev != NULL)
     {
       ifindex = dev->d_ifindex;
     }
 
-  net_unlock();
+  net_rdunlock(&g_netdev_lock);
   return ifindex;
 }
 
@@ -99,6 +99,10 @@
 
 struct net_driver_s *g_netdevices = NULL;
 
+/* Reader-writer lock that protects the list of devices */
+
+struct net_rwlock_s g_netdev_lock;
+
 #ifdef CONFIG_NETDEV_IFINDEX
 /* The set of network devices that have been registered.  This is used to
  * assign a unique device index to the newly registered device.
@@ -360,7 +364,10 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
       net_lock();
 
 #ifdef CONFIG_NETDEV_IFINDEX
+      (void)net_wrlock(&g_netdev_lock);
       ifindex = get_ifindex();
+      net_wrunlock(&g_netdev_lock);
+
       if (ifindex < 0)
         {
           return ifindex;
@@ -418,8 +425,10 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
 
       /* Add the device to the list of known network devices */
 
+      (void)net_wrlock(&g_netdev_lock);
       dev->flink  = g_netdevices;
       g_netdevices = dev;
+      net_wrunlock(&g_netdev_lock);
 
 #ifdef CONFIG_NET_IGMP
       /* Configure the device for IGMP support */
@@ -132,6 +132,7 @@ int netdev_unregister(FAR struct net_driver_s *dev)
   if (dev)
     {
       net_lock();
+      (void)net_wrlock(&g_netdev_lock);
 
       /* Find the device in the list of known network devices */
 
@@ -164,6 +165,7 @@ int netdev_unregister(FAR struct net_driver_s *dev)
 #ifdef CONFIG_NETDEV_IFINDEX
       free_ifindex(dev->d_ifindex);
 #endif
+      net_wrunlock(&g_netdev_lock);
       net_unlock();
 
 #ifdef CONFIG_NET_ETHERNET
@@ -68,7 +68,11 @@ bool netdev_verify(FAR struct net_driver_s *dev)
 
   /* Search the list of registered devices */
 
-  net_lock();
+  if (net_rdlock(&g_netdev_lock) < 0)
+    {
+      return false;
+    }
+
   for (chkdev = g_netdevices; chkdev != NULL; chkdev = chkdev->flink)
     {
       /* Is the network device that we are looking for? */
@@ -82,6 +86,6 @@ bool netdev_verify(FAR struct net_driver_s *dev)
         }
     }
 
-  net_unlock();
+  net_rdunlock(&g_netdev_lock);
   return valid;
 }
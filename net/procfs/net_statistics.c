@@ -80,6 +80,12 @@ static int     netprocfs_sent(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_TCP
 static int     netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NET_TCP */
+#ifdef CONFIG_NET_ARP
+static int     netprocfs_arp(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_ARP */
+#ifdef CONFIG_NET_IPv6
+static int     netprocfs_neighbor(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_IPv6 */
 
 /****************************************************************************
  * Private Data
@@ -114,6 +120,14 @@ static const linegen_t g_stat_linegen[] =
 #ifdef CONFIG_NET_TCP
   , netprocfs_retransmissions
 #endif /* CONFIG_NET_TCP */
+
+#ifdef CONFIG_NET_ARP
+  , netprocfs_arp
+#endif /* CONFIG_NET_ARP */
+
+#ifdef CONFIG_NET_IPv6
+  , netprocfs_neighbor
+#endif /* CONFIG_NET_IPv6 */
 };
 
 #define NSTAT_LINES (sizeof(g_stat_linegen) / sizeof(linegen_t))
@@ -436,6 +450,34 @@ static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP */
 
+/****************************************************************************
+ * Name: netprocfs_arp
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_ARP)
+static int netprocfs_arp(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "ARP          Hit: %04x  Miss: %04x  Evict: %04x\n",
+                  g_netstats.arp.hit, g_netstats.arp.miss,
+                  g_netstats.arp.evict);
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_ARP */
+
+/****************************************************************************
+ * Name: netprocfs_neighbor
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_IPv6)
+static int netprocfs_neighbor(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "Neighbor     Hit: %04x  Miss: %04x  Evict: %04x\n",
+                  g_netstats.neighbor.hit, g_netstats.neighbor.miss,
+                  g_netstats.neighbor.evict);
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_IPv6 */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -92,15 +92,15 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
   net_ipv4addr_copy(route->router, router);
   net_ipv4_dumproute("New route", route);
 
-  /* Get exclusive address to the networking data structures */
+  /* Get exclusive access to the routing table */
 
-  net_lock();
+  (void)net_wrlock(&g_ramroute_lock);
 
   /* Then add the new entry to the table */
 
   ramroute_ipv4_addlast((FAR struct net_route_ipv4_entry_s *)route,
                         &g_ipv4_routes);
-  net_unlock();
+  net_wrunlock(&g_ramroute_lock);
   return OK;
 }
 #endif
@@ -127,15 +127,15 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
   net_ipv6addr_copy(route->router, router);
   net_ipv6_dumproute("New route", route);
 
-  /* Get exclusive address to the networking data structures */
+  /* Get exclusive access to the routing table */
 
-  net_lock();
+  (void)net_wrlock(&g_ramroute_lock);
 
   /* Then add the new entry to the table */
 
   ramroute_ipv6_addlast((FAR struct net_route_ipv6_entry_s *)route,
                         &g_ipv6_routes);
-  net_unlock();
+  net_wrunlock(&g_ramroute_lock);
   return OK;
 }
 #endif
@@ -67,6 +67,10 @@ FAR struct net_route_ipv4_queue_s g_ipv4_routes;
 FAR struct net_route_ipv6_queue_s g_ipv6_routes;
 #endif
 
+/* Protects the routing tables and the free lists */
+
+struct net_rwlock_s g_ramroute_lock;
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -118,6 +122,8 @@ void net_init_ramroute(void)
 {
   int i;
 
+  net_rwlock_init(&g_ramroute_lock);
+
   /* Initialize the routing table and the free list */
 
 #ifdef CONFIG_ROUTE_IPv4_RAMROUTE
@@ -165,15 +171,15 @@ FAR struct net_route_ipv4_s *net_allocroute_ipv4(void)
 {
   FAR struct net_route_ipv4_entry_s *route;
 
-  /* Get exclusive address to the networking data structures */
+  /* Get exclusive access to the routing table */
 
-  net_lock();
+  (void)net_wrlock(&g_ramroute_lock);
 
   /* Then add the remove the first entry from the table */
 
   route = ramroute_ipv4_remfirst(&g_free_ipv4routes);
 
-  net_unlock();
+  net_wrunlock(&g_ramroute_lock);
   return &route->entry;
 }
 #endif
@@ -183,15 +189,15 @@ FAR struct net_route_ipv6_s *net_allocroute_ipv6(void)
 {
   FAR struct net_route_ipv6_entry_s *route;
 
-  /* Get exclusive address to the networking data structures */
+  /* Get exclusive access to the routing table */
 
-  net_lock();
+  (void)net_wrlock(&g_ramroute_lock);
 
   /* Then add the remove the first entry from the table */
 
   route = ramroute_ipv6_remfirst(&g_free_ipv6routes);
 
-  net_unlock();
+  net_wrunlock(&g_ramroute_lock);
   return &route->entry;
 }
 #endif
@@ -215,15 +221,15 @@ void net_freeroute_ipv4(FAR struct net_route_ipv4_s *route)
 {
   DEBUGASSERT(route);
 
-  /* Get exclusive address to the networking data structures */
+  /* Get exclusive access to the routing table */
 
-  net_lock();
+  (void)net_wrlock(&g_ramroute_lock);
 
   /* Then add the new entry to the table */
 
   ramroute_ipv4_addlast((FAR struct net_route_ipv4_entry_s *)route,
                         &g_free_ipv4routes);
-  net_unlock();
+  net_wrunlock(&g_ramroute_lock);
 }
 #endif
 
@@ -232,15 +238,15 @@ void net_freeroute_ipv6(FAR struct net_route_ipv6_s *route)
 {
   DEBUGASSERT(route);
 
-  /* Get exclusive address to the networking data structures */
+  /* Get exclusive access to the routing table */
 
-  net_lock();
+  (void)net_wrlock(&g_ramroute_lock);
 
   /* Then add the new entry to the table */
 
   ramroute_ipv6_addlast((FAR struct net_route_ipv6_entry_s *)route,
                         &g_free_ipv6routes);
-  net_unlock();
+  net_wrunlock(&g_ramroute_lock);
 }
 #endif
 
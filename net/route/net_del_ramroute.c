@@ -89,7 +89,8 @@ struct route_match_ipv6_s
  *   arg   - The match values (cast to void*)
  *
  * Returned Value:
- *   0 if the entry is not a match; 1 if the entry matched and was cleared.
+ *   0 if the entry is not a match; 1 if the entry matched and was removed
+ *   from the list.
  *
  ****************************************************************************/
 
@@ -122,11 +123,9 @@ static int net_match_ipv4(FAR struct net_route_ipv4_s *route, FAR void *arg)
           (void)ramroute_ipv4_remfirst(&g_ipv4_routes);
         }
 
-      /* And free the routing table entry by adding it to the free list */
-
-      net_freeroute_ipv4(route);
-
-      /* Return a non-zero value to terminate the traversal */
+      /* Return a non-zero value to terminate the traversal.  The caller
+       * frees the entry after releasing the routing table lock.
+       */
 
       return 1;
     }
@@ -175,11 +174,9 @@ static int net_match_ipv6(FAR struct net_route_ipv6_s *route, FAR void *arg)
           (void)ramroute_ipv6_remfirst(&g_ipv6_routes);
         }
 
-      /* And free the routing table entry by adding it to the free list */
-
-      net_freeroute_ipv6(route);
-
-      /* Return a non-zero value to terminate the traversal */
+      /* Return a non-zero value to terminate the traversal.  The caller
+       * frees the entry after releasing the routing table lock.
+       */
 
       return 1;
     }
@@ -211,6 +208,7 @@ static int net_match_ipv6(FAR struct net_route_ipv6_s *route, FAR void *arg)
 #ifdef CONFIG_ROUTE_IPv4_RAMROUTE
 int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
 {
+  FAR struct net_route_ipv4_entry_s *route;
   struct route_match_ipv4_s match;
 
   /* Set up the comparison structure */
@@ -221,13 +219,33 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
 
   /* Then remove the entry from the routing table */
 
-  return net_foreachroute_ipv4(net_match_ipv4, &match) ? OK : -ENOENT;
+  (void)net_wrlock(&g_ramroute_lock);
+  for (route = g_ipv4_routes.head; route != NULL; route = route->flink)
+    {
+      if (net_match_ipv4(&route->entry, &match) != 0)
+        {
+          break;
+        }
+    }
+
+  net_wrunlock(&g_ramroute_lock);
+
+  if (route == NULL)
+    {
+      return -ENOENT;
+    }
+
+  /* And free the routing table entry by adding it to the free list */
+
+  net_freeroute_ipv4(&route->entry);
+  return OK;
 }
 #endif
 
 #ifdef CONFIG_ROUTE_IPv6_RAMROUTE
 int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
 {
+  FAR struct net_route_ipv6_entry_s *route;
   struct route_match_ipv6_s match;
 
   /* Set up the comparison structure */
@@ -238,7 +256,26 @@ int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
 
   /* Then remove the entry from the routing table */
 
-  return net_foreachroute_ipv6(net_match_ipv6, &match) ? OK : -ENOENT;
+  (void)net_wrlock(&g_ramroute_lock);
+  for (route = g_ipv6_routes.head; route != NULL; route = route->flink)
+    {
+      if (net_match_ipv6(&route->entry, &match) != 0)
+        {
+          break;
+        }
+    }
+
+  net_wrunlock(&g_ramroute_lock);
+
+  if (route == NULL)
+    {
+      return -ENOENT;
+    }
+
+  /* And free the routing table entry by adding it to the free list */
+
+  net_freeroute_ipv6(&route->entry);
+  return OK;
 }
 #endif
 
@@ -77,11 +77,15 @@ int net_foreachroute_ipv4(route_handler_ipv4_t handler, FAR void *arg)
 {
   FAR struct net_route_ipv4_entry_s *route;
   FAR struct net_route_ipv4_entry_s *next;
-  int ret = 0;
+  int ret;
 
-  /* Prevent concurrent access to the routing table */
+  /* Prevent modification of the routing table */
 
-  net_lock();
+  ret = net_rdlock(&g_ramroute_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
 
   /* Visit each entry in the routing table */
 
@@ -95,9 +99,9 @@ int net_foreachroute_ipv4(route_handler_ipv4_t handler, FAR void *arg)
       ret  = handler(&route->entry, arg);
     }
 
-  /* Unlock the network */
+  /* Unlock the routing table */
 
-  net_unlock();
+  net_rdunlock(&g_ramroute_lock);
   return ret;
 }
 #endif
@@ -107,11 +111,15 @@ int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg)
 {
   FAR struct net_route_ipv6_entry_s *route;
   FAR struct net_route_ipv6_entry_s *next;
-  int ret = 0;
+  int ret;
 
-  /* Prevent concurrent access to the routing table */
+  /* Prevent modification of the routing table */
 
-  net_lock();
+  ret = net_rdlock(&g_ramroute_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
 
   /* Visit each entry in the routing table */
 
@@ -125,9 +133,9 @@ int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg)
       ret  = handler(&route->entry, arg);
     }
 
-  /* Unlock the network */
+  /* Unlock the routing table */
 
-  net_unlock();
+  net_rdunlock(&g_ramroute_lock);
   return ret;
 }
 #endif
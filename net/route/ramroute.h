@@ -42,6 +42,8 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/net/net.h>
+
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
@@ -128,6 +130,14 @@ extern struct net_route_ipv4_queue_s g_ipv4_routes;
 extern struct net_route_ipv6_queue_s g_ipv6_routes;
 #endif
 
+/* Reader-writer lock that protects the in-memory routing tables and their
+ * free lists.  Route lookups take the lock for reading so that they do not
+ * serialize behind the network lock.  The network lock must not be taken
+ * while this lock is held for writing.
+ */
+
+extern struct net_rwlock_s g_ramroute_lock;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -47,6 +47,7 @@
 #include <debug.h>
 #include <assert.h>
 
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 
 #include "socket/socket.h"
@@ -95,6 +96,10 @@ int psock_close(FAR struct socket *psock)
 
   if (psock->s_crefs <= 1 && psock->s_conn != NULL)
     {
+      /* Remove any epoll registrations before the connection goes away */
+
+      epoll_fdclose(psock);
+
       /* Let the address family's close() method handle the operation */
 
       DEBUGASSERT(psock->s_sockif != NULL && psock->s_sockif->si_close != NULL);
@@ -158,6 +158,15 @@ struct tcp_conn_s
 
   /* TCP-specific content follows */
 
+#ifdef CONFIG_NET_TCP_HASH
+  /* Hash chains used to look up the connection by its remote address and
+   * ports (active connections only) and by its local port.
+   */
+
+  FAR struct tcp_conn_s *hflink;
+  FAR struct tcp_conn_s *pflink;
+#endif
+
   union ip_binding_u u;   /* IP address binding */
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
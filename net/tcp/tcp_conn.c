@@ -72,6 +72,13 @@
 #define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+#ifdef CONFIG_NET_TCP_HASH
+#  if (CONFIG_NET_TCP_HASHSIZE & (CONFIG_NET_TCP_HASHSIZE - 1)) != 0
+#    error CONFIG_NET_TCP_HASHSIZE must be a power of two
+#  endif
+#  define TCP_HASHMASK (CONFIG_NET_TCP_HASHSIZE - 1)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -92,10 +99,172 @@ static dq_queue_t g_active_tcp_connections;
 
 static uint16_t g_last_tcp_port;
 
+#ifdef CONFIG_NET_TCP_HASH
+/* Active connections hashed by remote address and ports */
+
+static FAR struct tcp_conn_s *g_tcp_hash[CONFIG_NET_TCP_HASHSIZE];
+
+/* Connections with an assigned local port hashed by local port */
+
+static FAR struct tcp_conn_s *g_tcp_porthash[CONFIG_NET_TCP_HASHSIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_porthash and tcp_ipv4_hash and tcp_ipv6_hash
+ *
+ * Description:
+ *   Return the hash bucket index of a local port or of the remote address
+ *   and ports of a connection.  The local address is not part of the key
+ *   since a connection bound to INADDR_ANY must match any destination.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_HASH
+static inline unsigned int tcp_porthash(uint16_t lport)
+{
+  return (lport ^ (lport >> 8)) & TCP_HASHMASK;
+}
+
+static inline unsigned int tcp_fold(uint32_t key)
+{
+  key ^= key >> 16;
+  key ^= key >> 8;
+  return key & TCP_HASHMASK;
+}
+
+#ifdef CONFIG_NET_IPv4
+static inline unsigned int tcp_ipv4_hash(in_addr_t raddr, uint16_t lport,
+                                         uint16_t rport)
+{
+  return tcp_fold((uint32_t)raddr ^ ((uint32_t)lport << 16) ^ rport);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static inline unsigned int tcp_ipv6_hash(const net_ipv6addr_t raddr,
+                                         uint16_t lport, uint16_t rport)
+{
+  uint32_t key = ((uint32_t)lport << 16) ^ rport;
+  int i;
+
+  for (i = 0; i < 8; i += 2)
+    {
+      key ^= ((uint32_t)raddr[i] << 16) | raddr[i + 1];
+    }
+
+  return tcp_fold(key);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_hash_add and tcp_hash_remove
+ *
+ * Description:
+ *   Add or remove an active connection to/from the remote address hash.
+ *   Called whenever the connection is added to or removed from
+ *   g_active_tcp_connections.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static unsigned int tcp_conn_hash(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return tcp_ipv4_hash(conn->u.ipv4.raddr, conn->lport, conn->rport);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return tcp_ipv6_hash(conn->u.ipv6.raddr, conn->lport, conn->rport);
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+
+static void tcp_hash_add(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **head = &g_tcp_hash[tcp_conn_hash(conn)];
+
+  conn->hflink = *head;
+  *head        = conn;
+}
+
+static void tcp_hash_remove(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **pprev = &g_tcp_hash[tcp_conn_hash(conn)];
+
+  for (; *pprev != NULL; pprev = &(*pprev)->hflink)
+    {
+      if (*pprev == conn)
+        {
+          *pprev       = conn->hflink;
+          conn->hflink = NULL;
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_porthash_add and tcp_porthash_remove
+ *
+ * Description:
+ *   Add or remove a connection to/from the local port hash.  A connection
+ *   is in the local port hash whenever conn->lport is non-zero.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_porthash_add(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **head = &g_tcp_porthash[tcp_porthash(conn->lport)];
+
+  DEBUGASSERT(conn->lport != 0);
+  conn->pflink = *head;
+  *head        = conn;
+}
+
+static void tcp_porthash_remove(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **pprev;
+
+  if (conn->lport == 0)
+    {
+      return;
+    }
+
+  pprev = &g_tcp_porthash[tcp_porthash(conn->lport)];
+  for (; *pprev != NULL; pprev = &(*pprev)->pflink)
+    {
+      if (*pprev == conn)
+        {
+          *pprev       = conn->pflink;
+          conn->pflink = NULL;
+          break;
+        }
+    }
+}
+#else
+#  define tcp_hash_add(c)
+#  define tcp_hash_remove(c)
+#  define tcp_porthash_add(c)
+#  define tcp_porthash_remove(c)
+#endif /* CONFIG_NET_TCP_HASH */
+
 /****************************************************************************
  * Name: tcp_ipv4_listener
  *
@@ -113,13 +282,23 @@ static inline FAR struct tcp_conn_s *tcp_ipv4_listener(in_addr_t ipaddr,
                                                        uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
+#ifndef CONFIG_NET_TCP_HASH
   int i;
+#endif
 
   /* Check if this port number is in use by any active UIP TCP connection */
 
+#ifdef CONFIG_NET_TCP_HASH
+  for (conn = g_tcp_porthash[tcp_porthash(portno)];
+       conn != NULL;
+       conn = conn->pflink)
+#else
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
+#endif
     {
+#ifndef CONFIG_NET_TCP_HASH
       conn = &g_tcp_connections[i];
+#endif
 
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
@@ -164,13 +343,23 @@ static inline FAR struct tcp_conn_s *
 tcp_ipv6_listener(const net_ipv6addr_t ipaddr, uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
+#ifndef CONFIG_NET_TCP_HASH
   int i;
+#endif
 
   /* Check if this port number is in use by any active UIP TCP connection */
 
+#ifdef CONFIG_NET_TCP_HASH
+  for (conn = g_tcp_porthash[tcp_porthash(portno)];
+       conn != NULL;
+       conn = conn->pflink)
+#else
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
+#endif
     {
+#ifndef CONFIG_NET_TCP_HASH
       conn = &g_tcp_connections[i];
+#endif
 
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
@@ -327,9 +516,14 @@ static inline FAR struct tcp_conn_s *
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
+#ifdef CONFIG_NET_TCP_HASH
+  conn       = g_tcp_hash[tcp_ipv4_hash(srcipaddr, tcp->destport,
+                                        tcp->srcport)];
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
 
   while (conn)
     {
@@ -366,7 +560,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_HASH
+      conn = conn->hflink;
+#else
       conn = (FAR struct tcp_conn_s *)conn->node.flink;
+#endif
     }
 
   return conn;
@@ -394,9 +592,14 @@ static inline FAR struct tcp_conn_s *
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
+#ifdef CONFIG_NET_TCP_HASH
+  conn       = g_tcp_hash[tcp_ipv6_hash(*srcipaddr, tcp->destport,
+                                        tcp->srcport)];
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
 
   while (conn)
     {
@@ -433,7 +636,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_HASH
+      conn = conn->hflink;
+#else
       conn = (FAR struct tcp_conn_s *)conn->node.flink;
+#endif
     }
 
   return conn;
@@ -479,6 +686,7 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
   /* Save the local address in the connection structure (network byte order). */
 
+  tcp_porthash_remove(conn);
   conn->lport = htons(port);
   net_ipv4addr_copy(conn->u.ipv4.laddr, addr->sin_addr.s_addr);
 
@@ -500,6 +708,7 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
       return ret;
     }
 
+  tcp_porthash_add(conn);
   net_unlock();
   return OK;
 }
@@ -546,6 +755,7 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
   /* Save the local address in the connection structure (network byte order). */
 
+  tcp_porthash_remove(conn);
   conn->lport = htons(port);
   net_ipv6addr_copy(conn->u.ipv6.laddr, addr->sin6_addr.in6_u.u6_addr16);
 
@@ -567,6 +777,7 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
       return ret;
     }
 
+  tcp_porthash_add(conn);
   net_unlock();
   return OK;
 }
@@ -594,6 +805,11 @@ void tcp_initialize(void)
   dq_init(&g_free_tcp_connections);
   dq_init(&g_active_tcp_connections);
 
+#ifdef CONFIG_NET_TCP_HASH
+  memset(g_tcp_hash, 0, sizeof(g_tcp_hash));
+  memset(g_tcp_porthash, 0, sizeof(g_tcp_porthash));
+#endif
+
   /* Now initialize each connection structure */
 
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
@@ -773,8 +989,11 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       dq_rem(&conn->node, &g_active_tcp_connections);
+      tcp_hash_remove(conn);
     }
 
+  tcp_porthash_remove(conn);
+
 #ifdef CONFIG_NET_TCP_READAHEAD
   /* Release any read-ahead buffers attached to the connection */
 
@@ -1038,6 +1257,8 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        */
 
       dq_addlast(&conn->node, &g_active_tcp_connections);
+      tcp_hash_add(conn);
+      tcp_porthash_add(conn);
     }
 
   return conn;
@@ -1249,6 +1470,8 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   conn->rto        = TCP_RTO;
   conn->sa         = 0;
   conn->sv         = 16;   /* Initial value of the RTT variance. */
+
+  tcp_porthash_remove(conn);
   conn->lport      = htons((uint16_t)port);
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   conn->expired    = 0;
@@ -1273,6 +1496,8 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   /* And, finally, put the connection structure into the active list. */
 
   dq_addlast(&conn->node, &g_active_tcp_connections);
+  tcp_hash_add(conn);
+  tcp_porthash_add(conn);
   ret = OK;
 
 errout_with_lock:
@@ -0,0 +1,219 @@
+/****************************************************************************
+ * net/tcp/tcp_epoll_test.c
+ * Unit test driver for epoll on TCP sockets.  This is not part of the
+ * build:  Build it as an application for a configuration with the local
+ * loopback device (CONFIG_NET_LOOPBACK and CONFIG_NET_TCP), e.g. on the
+ * simulator.  It runs several epoll_wait() rounds on one connected TCP
+ * socket, level-triggered and edge-triggered, and checks that each round
+ * reports the data sent for it.
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define TEST_PORT    5471
+#define TEST_ROUNDS  4
+#define TEST_TIMEOUT 2000  /* Milliseconds */
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: connect_pair
+ *
+ * Description: Create a connected pair of TCP sockets over the loopback
+ *
+ ****************************************************************************/
+
+static int connect_pair(int port, FAR int *client, FAR int *server)
+{
+  struct sockaddr_in addr;
+  int listener;
+  int one = 1;
+
+  listener = socket(AF_INET, SOCK_STREAM, 0);
+  if (listener < 0)
+    {
+      return -1;
+    }
+
+  setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family      = AF_INET;
+  addr.sin_port        = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  if (bind(listener, (FAR struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+      listen(listener, 1) < 0)
+    {
+      close(listener);
+      return -1;
+    }
+
+  *client = socket(AF_INET, SOCK_STREAM, 0);
+  if (*client < 0 ||
+      connect(*client, (FAR struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+      close(listener);
+      return -1;
+    }
+
+  *server = accept(listener, NULL, NULL);
+  close(listener);
+  return *server < 0 ? -1 : 0;
+}
+
+/****************************************************************************
+ * Name: run_rounds
+ *
+ * Description:
+ *   Send one byte per round to the socket watched by epoll and check that
+ *   epoll_wait() reports it.  The byte is read before the next round, so
+ *   each round needs a new notification from the TCP stack.
+ *
+ ****************************************************************************/
+
+static int run_rounds(int events, int port)
+{
+  struct epoll_event ev;
+  int client;
+  int server;
+  int epfd;
+  int round;
+  int ret;
+  char ch;
+
+  if (connect_pair(port, &client, &server) < 0)
+    {
+      printf("connect_pair failed: %d\n", errno);
+      return -1;
+    }
+
+  epfd = epoll_create1(0);
+  if (epfd < 0)
+    {
+      printf("epoll_create1 failed: %d\n", errno);
+      return -1;
+    }
+
+  ev.events  = events;
+  ev.data.fd = server;
+  if (epoll_ctl(epfd, EPOLL_CTL_ADD, server, &ev) < 0)
+    {
+      printf("epoll_ctl failed: %d\n", errno);
+      return -1;
+    }
+
+  for (round = 0; round < TEST_ROUNDS; round++)
+    {
+      /* Nothing is pending, so the wait must time out */
+
+      ret = epoll_wait(epfd, &ev, 1, 100);
+      if (ret != 0)
+        {
+          printf("events %04x round %d: idle wait returned %d\n",
+                 events, round, ret);
+          return -1;
+        }
+
+      ch = 'a' + round;
+      if (write(client, &ch, 1) != 1)
+        {
+          printf("write failed: %d\n", errno);
+          return -1;
+        }
+
+      ret = epoll_wait(epfd, &ev, 1, TEST_TIMEOUT);
+      if (ret != 1 || (ev.events & EPOLLIN) == 0 || ev.data.fd != server)
+        {
+          printf("events %04x round %d: epoll_wait returned %d\n",
+                 events, round, ret);
+          return -1;
+        }
+
+      if (read(server, &ch, 1) != 1 || ch != 'a' + round)
+        {
+          printf("events %04x round %d: bad data\n", events, round);
+          return -1;
+        }
+    }
+
+  close(epfd);
+  close(server);
+  close(client);
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  int ret = 0;
+
+  if (run_rounds(EPOLLIN, TEST_PORT) < 0)
+    {
+      ret = 1;
+    }
+
+  if (run_rounds(EPOLLIN | EPOLLET, TEST_PORT + 1) < 0)
+    {
+      ret = 1;
+    }
+
+  printf("%s\n", ret == 0 ? "PASSED" : "FAILED");
+  return ret;
+}
@@ -373,6 +373,9 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
             }
 
           dev->d_sndlen = sndlen;
+#ifndef CONFIG_NET_ARCH_CHKSUM
+          dev->d_sndchksumvalid = false;
+#endif
 
           /* Set the sequence number for this packet.  NOTE:  The network
            * updates sndseq on recept of ACK *before* this function is
@@ -42,6 +42,8 @@
 #ifdef CONFIG_NET
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
 #include <debug.h>
 
 #include <nuttx/net/netconfig.h>
@@ -58,6 +60,212 @@
 #define IPv4BUF   ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF   ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/* The checksum is accumulated in native byte order a word at a time.  With
+ * 64-bit integers, 32-bit words are summed; 65535 bytes of data cannot
+ * overflow the accumulator.  Otherwise 16-bit words are summed into a 32-bit
+ * accumulator which cannot overflow either.
+ */
+
+#ifdef CONFIG_HAVE_LONG_LONG
+#  define CHKSUM_ALIGNMASK 3
+#else
+#  define CHKSUM_ALIGNMASK 1
+#endif
+
+#define CHKSUM_SWAP(s)     ((uint16_t)(((s) << 8) | ((s) >> 8)))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_HAVE_LONG_LONG
+typedef uint64_t chksum_acc_t;
+#else
+typedef uint32_t chksum_acc_t;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: chksum_partial
+ *
+ * Description:
+ *   Return the one's complement sum of the data as a host order value (as
+ *   if the data were summed as big-endian 16-bit words).  If dest is not
+ *   NULL, the data is also copied to dest which must have the same
+ *   alignment as src (modulo CHKSUM_ALIGNMASK + 1).
+ *
+ *   The data is read a word at a time in native byte order.  If src is at
+ *   an odd address, the bytes of the sum are swapped at the end, and on
+ *   little-endian machines the native sum is byte-swapped to get the host
+ *   order value (see RFC 1071).
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_ARCH_CHKSUM
+static inline uint16_t chksum_partial(FAR uint8_t *dest,
+                                      FAR const uint8_t *src, uint16_t len)
+{
+  chksum_acc_t acc = 0;
+  uint16_t tmp;
+  bool odd;
+
+  /* Sum a leading byte at an odd address as the second byte of a word */
+
+  odd = ((uintptr_t)src & 1) != 0;
+  if (odd && len > 0)
+    {
+      tmp = 0;
+      ((FAR uint8_t *)&tmp)[1] = *src;
+      acc += tmp;
+
+      if (dest != NULL)
+        {
+          *dest++ = *src;
+        }
+
+      src++;
+      len--;
+    }
+
+#ifdef CONFIG_HAVE_LONG_LONG
+  /* Then a 16-bit word to get to a 32-bit boundary */
+
+  if (((uintptr_t)src & 2) != 0 && len >= 2)
+    {
+      tmp = *(FAR const uint16_t *)src;
+      acc += tmp;
+
+      if (dest != NULL)
+        {
+          *(FAR uint16_t *)dest = tmp;
+          dest += 2;
+        }
+
+      src += 2;
+      len -= 2;
+    }
+
+  /* Sum (and copy) four 32-bit words per iteration */
+
+  while (len >= 16)
+    {
+      FAR const uint32_t *s32 = (FAR const uint32_t *)src;
+      uint32_t w0 = s32[0];
+      uint32_t w1 = s32[1];
+      uint32_t w2 = s32[2];
+      uint32_t w3 = s32[3];
+
+      if (dest != NULL)
+        {
+          FAR uint32_t *d32 = (FAR uint32_t *)dest;
+
+          d32[0] = w0;
+          d32[1] = w1;
+          d32[2] = w2;
+          d32[3] = w3;
+          dest  += 16;
+        }
+
+      acc += (chksum_acc_t)w0 + w1 + w2 + w3;
+      src += 16;
+      len -= 16;
+    }
+
+  while (len >= 4)
+    {
+      uint32_t w = *(FAR const uint32_t *)src;
+
+      if (dest != NULL)
+        {
+          *(FAR uint32_t *)dest = w;
+          dest += 4;
+        }
+
+      acc += w;
+      src += 4;
+      len -= 4;
+    }
+#else
+  /* Sum (and copy) four 16-bit words per iteration */
+
+  while (len >= 8)
+    {
+      FAR const uint16_t *s16 = (FAR const uint16_t *)src;
+      uint16_t w0 = s16[0];
+      uint16_t w1 = s16[1];
+      uint16_t w2 = s16[2];
+      uint16_t w3 = s16[3];
+
+      if (dest != NULL)
+        {
+          FAR uint16_t *d16 = (FAR uint16_t *)dest;
+
+          d16[0] = w0;
+          d16[1] = w1;
+          d16[2] = w2;
+          d16[3] = w3;
+          dest  += 8;
+        }
+
+      acc += (chksum_acc_t)w0 + w1 + w2 + w3;
+      src += 8;
+      len -= 8;
+    }
+#endif
+
+  while (len >= 2)
+    {
+      tmp = *(FAR const uint16_t *)src;
+
+      if (dest != NULL)
+        {
+          *(FAR uint16_t *)dest = tmp;
+          dest += 2;
+        }
+
+      acc += tmp;
+      src += 2;
+      len -= 2;
+    }
+
+  /* Sum a trailing byte as the first byte of a word */
+
+  if (len > 0)
+    {
+      tmp = 0;
+      ((FAR uint8_t *)&tmp)[0] = *src;
+      acc += tmp;
+
+      if (dest != NULL)
+        {
+          *dest = *src;
+        }
+    }
+
+  /* Fold the accumulator to 16 bits */
+
+  while ((acc >> 16) != 0)
+    {
+      acc = (acc & 0xffff) + (acc >> 16);
+    }
+
+  tmp = (uint16_t)acc;
+  if (odd)
+    {
+      tmp = CHKSUM_SWAP(tmp);
+    }
+
+#ifndef CONFIG_ENDIAN_BIG
+  tmp = CHKSUM_SWAP(tmp);
+#endif
+
+  return tmp;
+}
+#endif /* CONFIG_NET_ARCH_CHKSUM */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -84,40 +292,62 @@
 #ifndef CONFIG_NET_ARCH_CHKSUM
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
+  return chksum_add(sum, chksum_partial(NULL, data, len));
+}
 
-  dataptr = data;
-  last_byte = data + len - 1;
+/****************************************************************************
+ * Name: chksum_add
+ *
+ * Description:
+ *   Add two partial checksums using one's complement addition.
+ *
+ ****************************************************************************/
 
-  while (dataptr < last_byte)
+uint16_t chksum_add(uint16_t sum, uint16_t part)
+{
+  sum += part;
+  if (sum < part)
     {
-      /* At least two more bytes */
+      sum++; /* carry */
+    }
 
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+  return sum;
+}
 
-      dataptr += 2;
-    }
+/****************************************************************************
+ * Name: chksum_copy
+ *
+ * Description:
+ *   Copy data and calculate its checksum in the same pass.  This is
+ *   equivalent to memcpy() followed by chksum() but touches the data only
+ *   once.
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call to
+ *          chksum().
+ *   dest - The location to copy the data to.
+ *   src  - Beginning of the data to copy and include in the checksum.
+ *   len  - Length of the data.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+uint16_t chksum_copy(uint16_t sum, FAR uint8_t *dest,
+                     FAR const uint8_t *src, uint16_t len)
+{
+  /* Word copies are only possible if both buffers have the same
+   * alignment.
+   */
 
-  if (dataptr == last_byte)
+  if ((((uintptr_t)dest ^ (uintptr_t)src) & CHKSUM_ALIGNMASK) != 0)
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+      memcpy(dest, src, len);
+      return chksum(sum, dest, len);
     }
 
-  /* Return sum in host byte order. */
-
-  return sum;
+  return chksum_add(sum, chksum_partial(dest, src, len));
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
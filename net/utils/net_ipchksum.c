@@ -58,6 +58,47 @@
 #define IPv4BUF  ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF  ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: upperlayer_chksum
+ *
+ * Description:
+ *   Sum the upper layer header and payload.  If the payload is the data
+ *   most recently copied by devif_send() or devif_iob_send(), then only the
+ *   header is summed and the checksum calculated during the copy is added.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_ARCH_CHKSUM
+static uint16_t upperlayer_chksum(FAR struct net_driver_s *dev, uint16_t sum,
+                                  FAR uint8_t *upper, uint16_t upperlen)
+{
+  uint16_t hdrlen;
+
+  if (dev->d_sndchksumvalid)
+    {
+      /* The checksum is used only once */
+
+      dev->d_sndchksumvalid = false;
+
+      /* The header length must be even for the partial sums to combine */
+
+      hdrlen = upperlen - dev->d_sndlen;
+      if (dev->d_sndlen > 0 && dev->d_sndlen <= upperlen &&
+          (hdrlen & 1) == 0 && dev->d_appdata == upper + hdrlen)
+        {
+          sum = chksum(sum, upper, hdrlen);
+          return chksum_add(sum, dev->d_sndchksum);
+        }
+    }
+
+  return chksum(sum, upper, upperlen);
+}
+#endif /* !CONFIG_NET_ARCH_CHKSUM */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -118,7 +159,9 @@ uint16_t ipv4_upperlayer_chksum(FAR struct net_driver_s *dev, uint8_t proto)
 
   /* Sum IP payload data. */
 
-  sum = chksum(sum, &dev->d_buf[iphdrlen + NET_LL_HDRLEN(dev)], upperlen);
+  sum = upperlayer_chksum(dev, sum,
+                          &dev->d_buf[iphdrlen + NET_LL_HDRLEN(dev)],
+                          upperlen);
   return (sum == 0) ? 0xffff : htons(sum);
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
@@ -185,7 +228,8 @@ uint16_t ipv6_upperlayer_chksum(FAR struct net_driver_s *dev,
 
   /* Sum IP payload data. */
 
-  sum = chksum(sum, &dev->d_buf[NET_LL_HDRLEN(dev) + iplen], upperlen);
+  sum = upperlayer_chksum(dev, sum,
+                          &dev->d_buf[NET_LL_HDRLEN(dev) + iplen], upperlen);
   return (sum == 0) ? 0xffff : htons(sum);
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
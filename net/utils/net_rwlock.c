@@ -0,0 +1,199 @@
+/****************************************************************************
+ * net/utils/net_rwlock.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/net/net.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_rwtakesem
+ *
+ * Description:
+ *   Take the lock semaphore, waiting indefinitely and ignoring signals.
+ *
+ ****************************************************************************/
+
+static int net_rwtakesem(FAR struct net_rwlock_s *rwlock)
+{
+  int ret;
+
+  do
+    {
+      ret = nxsem_wait(&rwlock->rw_sem);
+      DEBUGASSERT(ret == OK || ret == -EINTR || ret == -ECANCELED);
+    }
+  while (ret == -EINTR);
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_rwlock_init
+ *
+ * Description:
+ *   Initialize a reader-writer lock.
+ *
+ ****************************************************************************/
+
+void net_rwlock_init(FAR struct net_rwlock_s *rwlock)
+{
+  nxsem_init(&rwlock->rw_sem, 0, 1);
+
+  /* The semaphore is taken on behalf of all readers and may be released by
+   * a different reader than the one that took it.  Priority inheritance
+   * cannot work in that case.
+   */
+
+  nxsem_setprotocol(&rwlock->rw_sem, SEM_PRIO_NONE);
+  rwlock->rw_readers = 0;
+}
+
+/****************************************************************************
+ * Name: net_rdlock
+ *
+ * Description:
+ *   Take the lock for reading.  Any number of readers may hold the lock at
+ *   the same time and a reader may take the lock recursively.  Readers
+ *   only wait while a writer holds the lock.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure (probably -ECANCELED).
+ *
+ ****************************************************************************/
+
+int net_rdlock(FAR struct net_rwlock_s *rwlock)
+{
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+
+  /* The first reader takes the semaphore on behalf of all readers */
+
+  if (rwlock->rw_readers == 0)
+    {
+      ret = net_rwtakesem(rwlock);
+    }
+
+  if (ret >= 0)
+    {
+      DEBUGASSERT(rwlock->rw_readers < UINT16_MAX);
+      rwlock->rw_readers++;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: net_rdunlock
+ *
+ * Description:
+ *   Release a lock taken by net_rdlock().  This must not be called if
+ *   net_rdlock() failed:  The lock was not taken in that case.
+ *
+ ****************************************************************************/
+
+void net_rdunlock(FAR struct net_rwlock_s *rwlock)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  DEBUGASSERT(rwlock->rw_readers > 0);
+
+  /* The last reader releases the semaphore */
+
+  if (--rwlock->rw_readers == 0)
+    {
+      (void)nxsem_post(&rwlock->rw_sem);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: net_wrlock
+ *
+ * Description:
+ *   Take the lock for writing, waiting until there are no readers or other
+ *   writers.  The write lock is not recursive.
+ *
+ *   The writers update the lists in short sections that have no way to back
+ *   out, so the wait is neither interrupted by signals nor canceled.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned only
+ *   if the semaphore is invalid.
+ *
+ ****************************************************************************/
+
+int net_wrlock(FAR struct net_rwlock_s *rwlock)
+{
+  return nxsem_wait_uninterruptible(&rwlock->rw_sem);
+}
+
+/****************************************************************************
+ * Name: net_wrunlock
+ *
+ * Description:
+ *   Release a lock taken by net_wrlock().
+ *
+ ****************************************************************************/
+
+void net_wrunlock(FAR struct net_rwlock_s *rwlock)
+{
+  DEBUGASSERT(rwlock->rw_readers == 0);
+  (void)nxsem_post(&rwlock->rw_sem);
+}
@@ -238,6 +238,50 @@ void net_ipv6_pref2mask(uint8_t preflen, net_ipv6addr_t mask);
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len);
 #endif
 
+/****************************************************************************
+ * Name: chksum_add
+ *
+ * Description:
+ *   Add two partial checksums using one's complement addition.
+ *
+ * Input Parameters:
+ *   sum  - Partial checksum, as returned by chksum().
+ *   part - Partial checksum to be added.  Its data must follow the data of
+ *          'sum' at an even offset.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_ARCH_CHKSUM
+uint16_t chksum_add(uint16_t sum, uint16_t part);
+#endif
+
+/****************************************************************************
+ * Name: chksum_copy
+ *
+ * Description:
+ *   Copy data and calculate its checksum in one pass.  The result is the
+ *   same as memcpy() followed by chksum().
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call to
+ *          chksum().  This should be zero on the first call.
+ *   dest - The location to copy the data to.
+ *   src  - Beginning of the data to copy and include in the checksum.
+ *   len  - Length of the data.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_ARCH_CHKSUM
+uint16_t chksum_copy(uint16_t sum, FAR uint8_t *dest,
+                     FAR const uint8_t *src, uint16_t len);
+#endif
+
 /****************************************************************************
  * Name: net_chksum
  *
@@ -413,6 +413,10 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
 void sched_mergeprioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
                             uint8_t task_state);
 bool sched_mergepending(void);
+#ifdef CONFIG_SCHED_PRIOBITMAP
+bool sched_priobitmap_add(FAR struct tcb_s *tcb);
+void sched_priobitmap_remove(FAR struct tcb_s *tcb);
+#endif
 void sched_addblocked(FAR struct tcb_s *btcb, tstate_t task_state);
 void sched_removeblocked(FAR struct tcb_s *btcb);
 int  nxsched_setpriority(FAR struct tcb_s *tcb, int sched_priority);
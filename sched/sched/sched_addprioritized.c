@@ -87,6 +87,17 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
 
   DEBUGASSERT(sched_priority >= SCHED_PRIORITY_MIN);
 
+#ifdef CONFIG_SCHED_PRIOBITMAP
+  /* The position in the ready-to-run list is found using the priority
+   * bitmap;  there is no need to search the list.
+   */
+
+  if (list == (FAR dq_queue_t *)&g_readytorun)
+    {
+      return sched_priobitmap_add(tcb);
+    }
+#endif
+
   /* Search the list to find the location to insert the new Tcb.
    * Each is list is maintained in descending sched_priority order.
    */
@@ -84,7 +84,38 @@
  *
  ****************************************************************************/
 
-#ifndef CONFIG_SMP
+#if !defined(CONFIG_SMP) && defined(CONFIG_SCHED_PRIOBITMAP)
+bool sched_mergepending(void)
+{
+  FAR struct tcb_s *ptcb;
+  FAR struct tcb_s *rtcb;
+  bool ret = false;
+
+  /* Move each TCB from the g_pendingtasks list to the ready-to-run list.
+   * The insertion point is found in constant time using the priority
+   * bitmap.
+   */
+
+  while ((ptcb = (FAR struct tcb_s *)
+                 dq_remfirst((FAR dq_queue_t *)&g_pendingtasks)) != NULL)
+    {
+      rtcb             = this_task();
+      ptcb->task_state = TSTATE_TASK_READYTORUN;
+
+      if (sched_priobitmap_add(ptcb))
+        {
+          /* The ptcb was added at the head of the ready-to-run list */
+
+          rtcb->task_state = TSTATE_TASK_READYTORUN;
+          ptcb->task_state = TSTATE_TASK_RUNNING;
+          ret              = true;
+        }
+    }
+
+  return ret;
+}
+
+#elif !defined(CONFIG_SMP)
 bool sched_mergepending(void)
 {
   FAR struct tcb_s *ptcb;
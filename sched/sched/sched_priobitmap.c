@@ -0,0 +1,233 @@
+/****************************************************************************
+ * sched/sched/sched_priobitmap.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+#include <queue.h>
+#include <assert.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_PRIOBITMAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NPRIORITIES  (SCHED_PRIORITY_MAX + 1)
+#define NMAPWORDS    ((NPRIORITIES + 31) >> 5)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Bit (n & 31) of g_priomap[n >> 5] is set if there is at least one task
+ * of priority n in the g_readytorun list.  Bit n of g_priosummary is set
+ * if g_priomap[n] is non-zero.
+ */
+
+static uint32_t g_priomap[NMAPWORDS];
+static uint32_t g_priosummary;
+
+/* The last (i.e., most recently added) task of each priority in the
+ * g_readytorun list.  A new task of the same priority goes after it.
+ */
+
+static FAR struct tcb_s *g_priolast[NPRIORITIES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_priobitmap_above
+ *
+ * Description:
+ *   Find the lowest priority in the g_readytorun list that is strictly
+ *   higher than 'priority'.
+ *
+ * Input Parameters:
+ *   priority - The reference priority
+ *
+ * Returned Value:
+ *   The priority found or -1 if no task has a higher priority.
+ *
+ ****************************************************************************/
+
+static inline int sched_priobitmap_above(int priority)
+{
+  uint32_t bits;
+  int ndx = priority >> 5;
+
+  /* Check for higher priorities in the same bitmap word */
+
+  bits = g_priomap[ndx] & ~(((uint32_t)2 << (priority & 31)) - 1);
+  if (bits != 0)
+    {
+      return (ndx << 5) + ffs((int)bits) - 1;
+    }
+
+  /* Then for the first non-empty word above this one */
+
+  bits = g_priosummary & ~(((uint32_t)2 << ndx) - 1);
+  if (bits == 0)
+    {
+      return -1;
+    }
+
+  ndx = ffs((int)bits) - 1;
+  return (ndx << 5) + ffs((int)g_priomap[ndx]) - 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_priobitmap_add
+ *
+ * Description:
+ *   Add a TCB to the g_readytorun list after all other tasks of the same or
+ *   higher priority.  This is the same position that sched_addprioritized()
+ *   would select, but it is found in constant time.
+ *
+ * Input Parameters:
+ *   tcb - Points to the TCB to add to the g_readytorun list
+ *
+ * Returned Value:
+ *   true if the head of the list has changed.
+ *
+ * Assumptions:
+ * - The caller has established a critical section.
+ * - The caller has already removed the input tcb from whatever list it
+ *   was in and handles the task_state of the TCB.
+ *
+ ****************************************************************************/
+
+bool sched_priobitmap_add(FAR struct tcb_s *tcb)
+{
+  FAR dq_queue_t *list = (FAR dq_queue_t *)&g_readytorun;
+  FAR struct tcb_s *prev;
+  int priority = tcb->sched_priority;
+  int higher;
+
+  /* The new TCB goes after the last TCB of the same priority.  If there is
+   * none, it goes after the last TCB of the next higher priority.
+   */
+
+  prev = g_priolast[priority];
+  if (prev == NULL)
+    {
+      higher = sched_priobitmap_above(priority);
+      if (higher >= 0)
+        {
+          prev = g_priolast[higher];
+          DEBUGASSERT(prev != NULL);
+        }
+
+      g_priomap[priority >> 5] |= (uint32_t)1 << (priority & 31);
+      g_priosummary            |= (uint32_t)1 << (priority >> 5);
+    }
+
+  g_priolast[priority] = tcb;
+
+  if (prev == NULL)
+    {
+      /* No task has the same or a higher priority */
+
+      dq_addfirst((FAR dq_entry_t *)tcb, list);
+      return true;
+    }
+
+  dq_addafter((FAR dq_entry_t *)prev, (FAR dq_entry_t *)tcb, list);
+  return false;
+}
+
+/****************************************************************************
+ * Name: sched_priobitmap_remove
+ *
+ * Description:
+ *   Remove a TCB from the g_readytorun list.
+ *
+ * Input Parameters:
+ *   tcb - Points to the TCB to remove from the g_readytorun list
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ * - The caller has established a critical section.
+ * - The priority of the TCB has not changed since it was added to the
+ *   list.
+ *
+ ****************************************************************************/
+
+void sched_priobitmap_remove(FAR struct tcb_s *tcb)
+{
+  FAR struct tcb_s *prev = (FAR struct tcb_s *)tcb->blink;
+  int priority = tcb->sched_priority;
+
+  if (g_priolast[priority] == tcb)
+    {
+      if (prev != NULL && prev->sched_priority == priority)
+        {
+          /* The previous TCB is now the last one of this priority */
+
+          g_priolast[priority] = prev;
+        }
+      else
+        {
+          /* This was the only TCB of this priority */
+
+          g_priolast[priority] = NULL;
+          g_priomap[priority >> 5] &= ~((uint32_t)1 << (priority & 31));
+          if (g_priomap[priority >> 5] == 0)
+            {
+              g_priosummary &= ~((uint32_t)1 << (priority >> 5));
+            }
+        }
+    }
+
+  dq_rem((FAR dq_entry_t *)tcb, (FAR dq_queue_t *)&g_readytorun);
+}
+
+#endif /* CONFIG_SCHED_PRIOBITMAP */
@@ -101,7 +101,11 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
    * is always the g_readytorun list.
    */
 
+#ifdef CONFIG_SCHED_PRIOBITMAP
+  sched_priobitmap_remove(rtcb);
+#else
   dq_rem((FAR dq_entry_t *)rtcb, (FAR dq_queue_t *)&g_readytorun);
+#endif
 
   /* Since the TCB is not in any list, it is now invalid */
 
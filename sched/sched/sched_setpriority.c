@@ -49,6 +49,7 @@
 
 #include "irq/irq.h"
 #include "sched/sched.h"
+#include "semaphore/semaphore.h"
 
 /****************************************************************************
  * Private Functions
@@ -165,9 +166,19 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
 
   else
     {
+#ifdef CONFIG_SCHED_PRIOBITMAP
+      /* The task remains at the head of the ready-to-run list, but the
+       * priority bitmap must follow the change of priority.
+       */
+
+      sched_priobitmap_remove(tcb);
+      tcb->sched_priority = (uint8_t)sched_priority;
+      (void)sched_priobitmap_add(tcb);
+#else
       /* Change the task priority */
 
       tcb->sched_priority = (uint8_t)sched_priority;
+#endif
     }
 }
 
@@ -299,6 +310,17 @@ static inline void nxsched_blocked_setpriority(FAR struct tcb_s *tcb,
       /* Put it back into the prioritized list at the correct position. */
 
       sched_addprioritized(tcb, tasklist);
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+      /* A thread waiting for a semaphore is also in the priority ordered
+       * list of waiters of that semaphore.
+       */
+
+      if (task_state == TSTATE_WAIT_SEM)
+        {
+          nxsem_reorderwaiter(tcb);
+        }
+#endif
     }
 
   /* CASE 3b. The task resides in a non-prioritized list. */
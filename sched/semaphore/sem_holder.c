@@ -45,6 +45,7 @@
 #include <assert.h>
 #include <debug.h>
 #include <nuttx/arch.h>
+#include <nuttx/semaphore.h>
 
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
@@ -68,6 +69,24 @@
 typedef int (*holderhandler_t)(FAR struct semholder_s *pholder,
                                FAR sem_t *sem, FAR void *arg);
 
+/* Argument passed through nxsem_foreachholder() when propagating a
+ * priority change along a chain.
+ */
+
+struct semchain_s
+{
+  uint8_t prio;             /* Priority to boost to */
+  uint8_t depth;            /* Links followed so far */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void nxsem_boostholder(FAR struct tcb_s *htcb, uint8_t prio,
+                              int depth);
+static void nxsem_setholderprio(FAR struct tcb_s *htcb, int depth);
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -83,7 +102,8 @@ static FAR struct semholder_s *g_freeholders;
  * Name: nxsem_allocholder
  ****************************************************************************/
 
-static inline FAR struct semholder_s *nxsem_allocholder(sem_t *sem)
+static inline FAR struct semholder_s *
+nxsem_allocholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
 {
   FAR struct semholder_s *pholder;
 
@@ -103,21 +123,15 @@ static inline FAR struct semholder_s *nxsem_allocholder(sem_t *sem)
       g_freeholders    = pholder->flink;
       pholder->flink   = sem->hhead;
       sem->hhead       = pholder;
-
-      /* Make sure the initial count is zero */
-
-      pholder->counts  = 0;
     }
 #else
   if (sem->holder[0].htcb == NULL)
     {
       pholder          = &sem->holder[0];
-      pholder->counts  = 0;
     }
   else if (sem->holder[1].htcb == NULL)
     {
       pholder          = &sem->holder[1];
-      pholder->counts  = 0;
     }
 #endif
   else
@@ -127,6 +141,26 @@ static inline FAR struct semholder_s *nxsem_allocholder(sem_t *sem)
     }
 
   DEBUGASSERT(pholder != NULL);
+  if (pholder != NULL)
+    {
+      /* Make sure the initial count is zero */
+
+      pholder->sem     = sem;
+      pholder->htcb    = htcb;
+      pholder->counts  = 0;
+
+      /* Add the holder to the list of counts held by the thread */
+
+      pholder->tblink  = NULL;
+      pholder->tlink   = htcb->holdsem;
+      if (htcb->holdsem != NULL)
+        {
+          htcb->holdsem->tblink = pholder;
+        }
+
+      htcb->holdsem    = pholder;
+    }
+
   return pholder;
 }
 
@@ -134,7 +168,7 @@ static inline FAR struct semholder_s *nxsem_allocholder(sem_t *sem)
  * Name: nxsem_findholder
  ****************************************************************************/
 
-static FAR struct semholder_s *nxsem_findholder(sem_t *sem,
+static FAR struct semholder_s *nxsem_findholder(FAR sem_t *sem,
                                                 FAR struct tcb_s *htcb)
 {
   FAR struct semholder_s *pholder;
@@ -181,12 +215,12 @@ static FAR struct semholder_s *nxsem_findholder(sem_t *sem,
  ****************************************************************************/
 
 static inline FAR struct semholder_s *
-nxsem_findorallocateholder(sem_t *sem, FAR struct tcb_s *htcb)
+nxsem_findorallocateholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
 {
   FAR struct semholder_s *pholder = nxsem_findholder(sem, htcb);
   if (!pholder)
     {
-      pholder = nxsem_allocholder(sem);
+      pholder = nxsem_allocholder(sem, htcb);
     }
 
   return pholder;
@@ -196,7 +230,7 @@ nxsem_findorallocateholder(sem_t *sem, FAR struct tcb_s *htcb)
  * Name: nxsem_freeholder
  ****************************************************************************/
 
-static inline void nxsem_freeholder(sem_t *sem,
+static inline void nxsem_freeholder(FAR sem_t *sem,
                                     FAR struct semholder_s *pholder)
 {
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
@@ -204,8 +238,29 @@ static inline void nxsem_freeholder(sem_t *sem,
   FAR struct semholder_s *prev;
 #endif
 
+  /* Remove the holder from the list of counts held by the thread */
+
+  if (pholder->htcb != NULL)
+    {
+      if (pholder->tblink != NULL)
+        {
+          pholder->tblink->tlink = pholder->tlink;
+        }
+      else
+        {
+          pholder->htcb->holdsem = pholder->tlink;
+        }
+
+      if (pholder->tlink != NULL)
+        {
+          pholder->tlink->tblink = pholder->tblink;
+        }
+    }
+
   /* Release the holder and counts */
 
+  pholder->tlink  = NULL;
+  pholder->tblink = NULL;
   pholder->htcb   = NULL;
   pholder->counts = 0;
 
@@ -241,7 +296,8 @@ static inline void nxsem_freeholder(sem_t *sem,
  * Name: nxsem_findandfreeholder
  ****************************************************************************/
 
-static inline void nxsem_findandfreeholder(sem_t *sem, FAR struct tcb_s *htcb)
+static inline void nxsem_findandfreeholder(FAR sem_t *sem,
+                                           FAR struct tcb_s *htcb)
 {
   FAR struct semholder_s *pholder = nxsem_findholder(sem, htcb);
 
@@ -290,7 +346,7 @@ static int nxsem_foreachholder(FAR sem_t *sem, holderhandler_t handler,
 
   /* We have two hard-allocated holder structures in sem_t */
 
-  for (i = 0; i < 2; i++)
+  for (i = 0; i < 2 && ret == 0; i++)
     {
       pholder = &sem->holder[i];
 
@@ -312,529 +368,279 @@ static int nxsem_foreachholder(FAR sem_t *sem, holderhandler_t handler,
  * Name: nxsem_recoverholders
  ****************************************************************************/
 
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
 static int nxsem_recoverholders(FAR struct semholder_s *pholder,
                                 FAR sem_t *sem, FAR void *arg)
 {
   nxsem_freeholder(sem, pholder);
   return 0;
 }
-#endif
 
 /****************************************************************************
- * Name: nxsem_boostholderprio
+ * Name: nxsem_addwaiter
+ *
+ * Description:
+ *   Add a thread to the list of threads waiting for a semaphore.  The list
+ *   is kept in priority order, threads of equal priority in FIFO order as
+ *   in g_waitingforsemaphore, so the first entry is the highest priority
+ *   waiter.
+ *
  ****************************************************************************/
 
-static int nxsem_boostholderprio(FAR struct semholder_s *pholder,
-                                 FAR sem_t *sem, FAR void *arg)
+static void nxsem_addwaiter(FAR sem_t *sem, FAR struct tcb_s *wtcb)
 {
-  FAR struct tcb_s *htcb = (FAR struct tcb_s *)pholder->htcb;
-  FAR struct tcb_s *rtcb = (FAR struct tcb_s *)arg;
+  FAR struct tcb_s *prev = NULL;
+  FAR struct tcb_s *next;
 
-  /* Make sure that the holder thread is still active.  If it exited without
-   * releasing its counts, then that would be a bad thing.  But we can take
-   * no real action because we don't know know that the program is doing.
-   * Perhaps its plan is to kill a thread, then destroy the semaphore.
-   */
+  for (next = sem->whead;
+       next != NULL && next->sched_priority >= wtcb->sched_priority;
+       prev = next, next = next->waitflink);
+
+  wtcb->waitflink = next;
+  wtcb->waitblink = prev;
 
-  if (!sched_verifytcb(htcb))
+  if (next != NULL)
     {
-#if 0  /* DSA: sometimes crashes when Telnet calls external cmd (i.e. 'i2c') */
-      serr("ERROR: TCB 0x%08x is a stale handle, counts lost\n", htcb);
-      DEBUGPANIC();
-#endif
-      nxsem_freeholder(sem, pholder);
+      next->waitblink = wtcb;
     }
 
-#if CONFIG_SEM_NNESTPRIO > 0
-  /* If the priority of the thread that is waiting for a count is greater
-   * than the base priority of the thread holding a count, then we may need
-   * to adjust the holder's priority now or later to that priority.
-   */
-
-  else if (rtcb->sched_priority > htcb->base_priority)
+  if (prev != NULL)
     {
-      /* If the new priority is greater than the current, possibly already
-       * boosted priority of the holder thread, then we will have to raise
-       * the holder's priority now.
-       */
-
-      if (rtcb->sched_priority > htcb->sched_priority)
-        {
-          /* If the current priority of holder thread has already been
-           * boosted, then add the boost priority to the list of restoration
-           * priorities.  When the higher priority waiter thread gets its
-           * count, then we need to revert the holder thread to this saved
-           * priority (not to its base priority).
-           */
-
-          if (htcb->sched_priority > htcb->base_priority)
-            {
-              /* Save the current, boosted priority of the holder thread. */
-
-              if (htcb->npend_reprio < CONFIG_SEM_NNESTPRIO)
-                {
-                  htcb->pend_reprios[htcb->npend_reprio] = htcb->sched_priority;
-                  htcb->npend_reprio++;
-                }
-              else
-                {
-                  serr("ERROR: CONFIG_SEM_NNESTPRIO exceeded\n");
-                  DEBUGASSERT(htcb->npend_reprio < CONFIG_SEM_NNESTPRIO);
-                }
-            }
-
-          /* Raise the priority of the thread holding of the semaphore.
-           * This cannot cause a context switch because we have preemption
-           * disabled.  The holder thread may be marked "pending" and the
-           * switch may occur during up_block_task() processing.
-           */
-
-          (void)nxsched_setpriority(htcb, rtcb->sched_priority);
-        }
-      else
-        {
-          /* The new priority is above the base priority of the holder,
-           * but not as high as its current working priority.  Just put it
-           * in the list of pending restoration priorities so that when the
-           * higher priority thread gets its count, we can revert to this
-           * saved priority and not to the base priority.
-           */
-
-          if (htcb->npend_reprio < CONFIG_SEM_NNESTPRIO)
-            {
-              htcb->pend_reprios[htcb->npend_reprio] = rtcb->sched_priority;
-              htcb->npend_reprio++;
-            }
-          else
-            {
-              serr("ERROR: CONFIG_SEM_NNESTPRIO exceeded\n");
-              DEBUGASSERT(htcb->npend_reprio < CONFIG_SEM_NNESTPRIO);
-            }
-        }
+      prev->waitflink = wtcb;
     }
-
-#else
-  /* If the priority of the thread that is waiting for a count is less than
-   * of equal to the priority of the thread holding a count, then do nothing
-   * because the thread is already running at a sufficient priority.
-   */
-
-  else if (rtcb->sched_priority > htcb->sched_priority)
+  else
     {
-      /* Raise the priority of the holder of the semaphore.  This
-       * cannot cause a context switch because we have preemption
-       * disabled.  The task will be marked "pending" and the switch
-       * will occur during up_block_task() processing.
-       */
-
-      (void)nxsched_setpriority(htcb, rtcb->sched_priority);
+      sem->whead      = wtcb;
     }
-#endif
-
-  return 0;
 }
 
 /****************************************************************************
- * Name: nxsem_verifyholder
+ * Name: nxsem_remwaiter
+ *
+ * Description:
+ *   Remove a thread from the list of threads waiting for a semaphore.  This
+ *   does nothing if the thread is not in the list.
+ *
  ****************************************************************************/
 
-#ifdef CONFIG_DEBUG_ASSERTIONS
-static int nxsem_verifyholder(FAR struct semholder_s *pholder,
-                              FAR sem_t *sem, FAR void *arg)
+static void nxsem_remwaiter(FAR sem_t *sem, FAR struct tcb_s *wtcb)
 {
-#if 0 /* Need to revisit this, but these assumptions seem to be untrue -- \
-       * OR there is a bug??? */
-  FAR struct tcb_s *htcb = (FAR struct tcb_s *)pholder->htcb;
-
-  /* Called after a semaphore has been released (incremented), the semaphore
-   * could is non-negative, and there is no thread waiting for the count.
-   * In this case, the priority of the holder should not be boosted.
-   */
-
-#if CONFIG_SEM_NNESTPRIO > 0
-  DEBUGASSERT(htcb->npend_reprio == 0);
-#endif
-  DEBUGASSERT(htcb->sched_priority == htcb->base_priority);
-#endif
-  return 0;
-}
-#endif
+  if (wtcb->waitblink != NULL)
+    {
+      wtcb->waitblink->waitflink = wtcb->waitflink;
+    }
+  else if (sem->whead == wtcb)
+    {
+      sem->whead = wtcb->waitflink;
+    }
+  else
+    {
+      return;
+    }
 
-/****************************************************************************
- * Name: nxsem_dumpholder
- ****************************************************************************/
+  if (wtcb->waitflink != NULL)
+    {
+      wtcb->waitflink->waitblink = wtcb->waitblink;
+    }
 
-#if defined(CONFIG_DEBUG_INFO) && defined(CONFIG_SEM_PHDEBUG)
-static int nxsem_dumpholder(FAR struct semholder_s *pholder, FAR sem_t *sem,
-                            FAR void *arg)
-{
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
-  _info("  %08x: %08x %08x %04x\n",
-        pholder, pholder->flink, pholder->htcb, pholder->counts);
-#else
-  _info("  %08x: %08x %04x\n", pholder, pholder->htcb, pholder->counts);
-#endif
-  return 0;
+  wtcb->waitflink = NULL;
+  wtcb->waitblink = NULL;
 }
-#endif
 
 /****************************************************************************
- * Name: nxsem_restoreholderprio
+ * Name: nxsem_holderprio
+ *
+ * Description:
+ *   Compute the priority that a thread should run at:  The highest of its
+ *   base priority, any pending work queue priority boosts and the priority
+ *   of the highest priority thread waiting for a semaphore that it holds.
+ *
+ *   Each semaphore keeps its waiters in priority order, so only the first
+ *   waiter of each semaphore held by the thread is examined.  The cost is
+ *   O(semaphores held by the thread) and does not depend on the number of
+ *   threads waiting elsewhere in the system.
+ *
+ * Input Parameters:
+ *   htcb - The thread whose priority is computed
+ *
  ****************************************************************************/
 
-static int nxsem_restoreholderprio(FAR struct tcb_s *htcb,
-                                   FAR sem_t *sem, FAR void *arg)
+static uint8_t nxsem_holderprio(FAR struct tcb_s *htcb)
 {
-  FAR struct semholder_s *pholder = 0;
+  FAR struct semholder_s *pholder;
+  FAR struct tcb_s *wtcb;
+  uint8_t prio = htcb->base_priority;
 #if CONFIG_SEM_NNESTPRIO > 0
-  FAR struct tcb_s *stcb = (FAR struct tcb_s *)arg;
-  int rpriority;
   int i;
-  int j;
-#endif
-
-  /* Make sure that the holder thread is still active.  If it exited without
-   * releasing its counts, then that would be a bad thing.  But we can take
-   * no real action because we don't know know that the program is doing.
-   * Perhaps its plan is to kill a thread, then destroy the semaphore.
-   */
 
-  if (!sched_verifytcb(htcb))
+  for (i = 0; i < htcb->npend_reprio; i++)
     {
-      serr("ERROR: TCB 0x%08x is a stale handle, counts lost\n", htcb);
-      DEBUGPANIC();
-      pholder = nxsem_findholder(sem, htcb);
-      if (pholder != NULL)
+      if (htcb->pend_reprios[i] > prio)
         {
-          nxsem_freeholder(sem, pholder);
+          prio = htcb->pend_reprios[i];
         }
     }
+#endif
 
-  /* Was the priority of the holder thread boosted? If so, then drop its
-   * priority back to the correct level.  What is the correct level?
-   */
-
-  else if (htcb->sched_priority != htcb->base_priority)
+  for (pholder = htcb->holdsem; pholder != NULL; pholder = pholder->tlink)
     {
-#if CONFIG_SEM_NNESTPRIO > 0
-      /* Are there other, pending priority levels to revert to? */
-
-      if (htcb->npend_reprio < 1)
+      wtcb = pholder->sem->whead;
+      if (wtcb != NULL && wtcb->sched_priority > prio)
         {
-          /* No... the holder thread has only been boosted once.
-           * npend_reprio should be 0 and the boosted priority should be the
-           * priority of the task that just got the semaphore
-           * (stcb->sched_priority)
-           *
-           * That latter assumption may not be true if the stcb's priority
-           * was also boosted so that it no longer matches the htcb's
-           * sched_priority.  Or if CONFIG_SEM_NNESTPRIO is too small (so
-           * that we do not have a proper record of the reprioritizations).
-           */
-
-          DEBUGASSERT(/* htcb->sched_priority == stcb->sched_priority && */
-            htcb->npend_reprio == 0);
-
-          /* Reset the holder's priority back to the base priority. */
-
-          (void)nxsched_reprioritize(htcb, htcb->base_priority);
+          prio = wtcb->sched_priority;
         }
+    }
 
-      /* There are multiple pending priority levels. The holder thread's
-       * "boosted" priority could greater than or equal to
-       * "stcb->sched_priority" (it could be greater if its priority we
-       * boosted because it also holds another semaphore).
-       */
+  return prio;
+}
 
-      else if (htcb->sched_priority <= stcb->sched_priority)
-        {
-          /* The holder thread has been boosted to the same priority as the
-           * waiter thread that just received the count.  We will simply
-           * reprioritize to the next highest priority that we have in
-           * rpriority.
-           */
-
-          /* Find the highest pending priority and remove it from the list */
-
-          for (i = 1, j = 0; i < htcb->npend_reprio; i++)
-            {
-              if (htcb->pend_reprios[i] > htcb->pend_reprios[j])
-                {
-                  j = i;
-                }
-            }
-
-          /* Remove the highest priority pending priority from the list */
-
-          rpriority = htcb->pend_reprios[j];
-          i = htcb->npend_reprio - 1;
-          if (i > 0)
-            {
-              htcb->pend_reprios[j] = htcb->pend_reprios[i];
-            }
-
-          htcb->npend_reprio = i;
-
-          /* And apply that priority to the thread (while retaining the
-           * base_priority)
-           */
-
-          nxsched_setpriority(htcb, rpriority);
-        }
-      else
-        {
-          /* The holder thread has been boosted to a higher priority than the
-           * waiter task.  The pending priority should be in the list (unless
-           * it was lost because of of list overflow or because the holder
-           * was reprioritized again unbeknownst to the priority inheritance
-           * logic).
-           *
-           * Search the list for the matching priority.
-           */
-
-          for (i = 0; i < htcb->npend_reprio; i++)
-            {
-              /* Does this pending priority match the priority of the thread
-               * that just received the count?
-               */
-
-              if (htcb->pend_reprios[i] == stcb->sched_priority)
-                {
-                  /* Yes, remove it from the list */
-
-                  j = htcb->npend_reprio - 1;
-                  if (j > 0)
-                    {
-                      htcb->pend_reprios[i] = htcb->pend_reprios[j];
-                    }
-
-                  htcb->npend_reprio = j;
-                  break;
-                }
-            }
-        }
-#else
-      /* There is no alternative restore priorities, drop the priority
-       * of the holder thread all the way back to the threads "base"
-       * priority.
-       */
+/****************************************************************************
+ * Name: nxsem_boostchain
+ ****************************************************************************/
 
-      (void)nxsched_reprioritize(htcb, htcb->base_priority);
-#endif
-    }
+static int nxsem_boostchain(FAR struct semholder_s *pholder,
+                            FAR sem_t *sem, FAR void *arg)
+{
+  FAR struct semchain_s *chain = (FAR struct semchain_s *)arg;
 
+  nxsem_boostholder(pholder->htcb, chain->prio, chain->depth + 1);
   return 0;
 }
 
 /****************************************************************************
- * Name: nxsem_restoreholderprioall
+ * Name: nxsem_boostholder
  *
  * Description:
- *   Reprioritize all holders
+ *   Raise the priority of a holder thread to at least prio.  If the holder
+ *   is itself waiting for a semaphore, then the holders of that semaphore
+ *   are boosted in turn.
  *
  ****************************************************************************/
 
-static int nxsem_restoreholderprioall(FAR struct semholder_s *pholder,
-                                      FAR sem_t *sem, FAR void *arg)
+static void nxsem_boostholder(FAR struct tcb_s *htcb, uint8_t prio,
+                              int depth)
 {
-  return nxsem_restoreholderprio(pholder->htcb, sem, arg);
+  struct semchain_s chain;
+
+  /* If the priority of the thread that is waiting for a count is less than
+   * or equal to the priority of the thread holding a count, then do nothing
+   * because the thread is already running at a sufficient priority.
+   */
+
+  if (prio > htcb->sched_priority)
+    {
+      /* Raise the priority of the holder of the semaphore.  This cannot
+       * cause a context switch because we have preemption disabled.  The
+       * task will be marked "pending" and the switch will occur during
+       * up_block_task() processing.
+       */
+
+      (void)nxsched_setpriority(htcb, prio);
+
+      /* If the holder is blocked on another semaphore, pass the boost on */
+
+      if (htcb->waitsem != NULL && depth < SEM_MAXCHAIN)
+        {
+          chain.prio  = prio;
+          chain.depth = depth;
+
+          (void)nxsem_foreachholder(htcb->waitsem, nxsem_boostchain,
+                                    &chain);
+        }
+    }
 }
 
 /****************************************************************************
- * Name: nxsem_restoreholderprioA
- *
- * Description:
- *   Reprioritize all holders except the currently executing task
- *
+ * Name: nxsem_restorechain
  ****************************************************************************/
 
-static int nxsem_restoreholderprioA(FAR struct semholder_s *pholder,
-                                    FAR sem_t *sem, FAR void *arg)
+static int nxsem_restorechain(FAR struct semholder_s *pholder,
+                              FAR sem_t *sem, FAR void *arg)
 {
-  FAR struct tcb_s *rtcb = this_task();
-  if (pholder->htcb != rtcb)
-    {
-      return nxsem_restoreholderprio(pholder->htcb, sem, arg);
-    }
+  FAR struct semchain_s *chain = (FAR struct semchain_s *)arg;
 
+  nxsem_setholderprio(pholder->htcb, chain->depth + 1);
   return 0;
 }
 
 /****************************************************************************
- * Name: nxsem_restoreholderprioB
+ * Name: nxsem_setholderprio
  *
  * Description:
- *   Reprioritize only the currently executing task
+ *   Set the priority of a holder thread to the value computed by
+ *   nxsem_holderprio().  If that changes the priority and the holder is
+ *   itself waiting for a semaphore, then the priorities of the holders of
+ *   that semaphore are recomputed in turn.
  *
  ****************************************************************************/
 
-static int nxsem_restoreholderprioB(FAR struct semholder_s *pholder,
-                                    FAR sem_t *sem, FAR void *arg)
+static void nxsem_setholderprio(FAR struct tcb_s *htcb, int depth)
 {
-  FAR struct tcb_s *rtcb = this_task();
+  struct semchain_s chain;
+  uint8_t prio;
 
-  if (pholder->htcb == rtcb)
+  prio = nxsem_holderprio(htcb);
+  if (prio != htcb->sched_priority)
     {
-      /* The running task has given up a count on the semaphore */
+      (void)nxsched_setpriority(htcb, prio);
 
-#if CONFIG_SEM_PREALLOCHOLDERS == 0
-      /* In the case where there are only 2 holders. This step
-       * is necessary to insure we have space. Release the holder
-       * if all counts have been given up. before reprioritizing
-       * causes a context switch.
-       */
+      if (htcb->waitsem != NULL && depth < SEM_MAXCHAIN)
+        {
+          chain.prio  = prio;
+          chain.depth = depth;
 
-      nxsem_findandfreeholder(sem, rtcb);
-#endif
-      (void)nxsem_restoreholderprio(rtcb, sem, arg);
-      return 1;
+          (void)nxsem_foreachholder(htcb->waitsem, nxsem_restorechain,
+                                    &chain);
+        }
     }
+}
 
+/****************************************************************************
+ * Name: nxsem_restoreholderprio
+ ****************************************************************************/
+
+static int nxsem_restoreholderprio(FAR struct semholder_s *pholder,
+                                   FAR sem_t *sem, FAR void *arg)
+{
+  nxsem_setholderprio(pholder->htcb, 0);
   return 0;
 }
 
 /****************************************************************************
- * Name: nxsem_restorebaseprio_irq
+ * Name: nxsem_restoreholderprioA
  *
  * Description:
- *   This function is called after the an interrupt handler posts a count on
- *   the semaphore.  It will check if we need to drop the priority of any
- *   threads holding a count on the semaphore.  Their priority could have
- *   been boosted while they held the count.
- *
- * Input Parameters:
- *   stcb - The TCB of the task that was just started (if any).  If the
- *     post action caused a count to be given to another thread, then stcb
- *     is the TCB that received the count.  Note, just because stcb received
- *     the count, it does not mean that it it is higher priority than other
- *     threads.
- *   sem - A reference to the semaphore being posted.
- *     - If the semaphore count is <0 then there are still threads waiting
- *       for a count.  stcb should be non-null and will be higher priority
- *       than all of the other threads still waiting.
- *     - If it is ==0 then stcb refers to the thread that got the last count;
- *       no other threads are waiting.
- *     - If it is >0 then there should be no threads waiting for counts and
- *       stcb should be null.
- *
- * Returned Value:
- *   None
- *
- * Assumptions:
- *   The scheduler is locked.
+ *   Reprioritize all holders except the currently executing task
  *
  ****************************************************************************/
 
-static inline void nxsem_restorebaseprio_irq(FAR struct tcb_s *stcb,
-                                             FAR sem_t *sem)
+static int nxsem_restoreholderprioA(FAR struct semholder_s *pholder,
+                                    FAR sem_t *sem, FAR void *arg)
 {
-  /* Perform the following actions only if a new thread was given a count.
-   * The thread that received the count should be the highest priority
-   * of all threads waiting for a count from the semaphore.  So in that
-   * case, the priority of all holder threads should be dropped to the
-   * next highest pending priority.
-   */
-
-  if (stcb != NULL)
+  if (pholder->htcb != this_task())
     {
-      /* Drop the priority of all holder threads */
-
-      (void)nxsem_foreachholder(sem, nxsem_restoreholderprioall, stcb);
+      nxsem_setholderprio(pholder->htcb, 0);
     }
 
-  /* If there are no tasks waiting for available counts, then all holders
-   * should be at their base priority.
-   */
-
-#ifdef CONFIG_DEBUG_ASSERTIONS
-  else
-    {
-      (void)nxsem_foreachholder(sem, nxsem_verifyholder, NULL);
-    }
-#endif
+  return 0;
 }
 
 /****************************************************************************
- * Name: nxsem_restorebaseprio_task
- *
- * Description:
- *   This function is called after the current running task releases a
- *   count on the semaphore.  It will check if we need to drop the priority
- *   of any threads holding a count on the semaphore.  Their priority could
- *   have been boosted while they held the count.
- *
- * Input Parameters:
- *   stcb - The TCB of the task that was just started (if any).  If the
- *     post action caused a count to be given to another thread, then stcb
- *     is the TCB that received the count.  Note, just because stcb received
- *     the count, it does not mean that it it is higher priority than other
- *     threads.
- *   sem - A reference to the semaphore being posted.
- *     - If the semaphore count is <0 then there are still threads waiting
- *       for a count.  stcb should be non-null and will be higher priority
- *       than all of the other threads still waiting.
- *     - If it is ==0 then stcb refers to the thread that got the last count;
- *       no other threads are waiting.
- *     - If it is >0 then there should be no threads waiting for counts and
- *       stcb should be null.
- *
- * Returned Value:
- *   None
- *
- * Assumptions:
- *   The scheduler is locked.
- *
+ * Name: nxsem_dumpholder
  ****************************************************************************/
 
-static inline void nxsem_restorebaseprio_task(FAR struct tcb_s *stcb,
-                                              FAR sem_t *sem)
+#if defined(CONFIG_DEBUG_INFO) && defined(CONFIG_SEM_PHDEBUG)
+static int nxsem_dumpholder(FAR struct semholder_s *pholder, FAR sem_t *sem,
+                            FAR void *arg)
 {
-  FAR struct tcb_s *rtcb = this_task();
-
-  /* Perform the following actions only if a new thread was given a count.
-   * The thread that received the count should be the highest priority
-   * of all threads waiting for a count from the semaphore.  So in that
-   * case, the priority of all holder threads should be dropped to the
-   * next highest pending priority.
-   */
-
-  if (stcb != NULL)
-    {
-      /* The currently executed thread should be the lower priority
-       * thread that just posted the count and caused this action.
-       * However, we cannot drop the priority of the currently running
-       * thread -- because that will cause it to be suspended.
-       *
-       * So, do this in two passes.  First, reprioritizing all holders
-       * except for the running thread.
-       */
-
-      (void)nxsem_foreachholder(sem, nxsem_restoreholderprioA, stcb);
-
-      /* Now, find an reprioritize only the ready to run task */
-
-      (void)nxsem_foreachholder(sem, nxsem_restoreholderprioB, stcb);
-    }
-
-  /* If there are no tasks waiting for available counts, then all holders
-   * should be at their base priority.
-   */
-
-#ifdef CONFIG_DEBUG_ASSERTIONS
-  else
-    {
-      (void)nxsem_foreachholder(sem, nxsem_verifyholder, NULL);
-    }
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
+  _info("  %08x: %08x %08x %04x\n",
+        pholder, pholder->flink, pholder->htcb, pholder->counts);
+#else
+  _info("  %08x: %08x %04x\n", pholder, pholder->htcb, pholder->counts);
 #endif
-
-  /* In any case, the currently executing task should have an entry in the
-   * list.  Its counts were previously decremented; if it now holds no
-   * counts, then we need to remove it from the list of holders.
-   */
-
-  nxsem_findandfreeholder(sem, rtcb);
+  return 0;
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -906,27 +712,27 @@ void nxsem_destroyholder(FAR sem_t *sem)
    * Therefore, we cannot make any assumptions about the state of the
    * semaphore or the state of any of the holder threads.  So just recover
    * any stranded holders and hope the task knows what it is doing.
+   *
+   * This must be done before the memory of the semaphore is released or
+   * reused:  The records of the holders are linked into the lists of
+   * counts held by the holder threads until they are freed here.
    */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  if (sem->hhead != NULL)
-    {
-      /* There may be an issue if there are multiple holders of
-       * the semaphore.
-       */
-
-      DEBUGASSERT(sem->hhead->flink == NULL);
-      (void)nxsem_foreachholder(sem, nxsem_recoverholders, NULL);
-    }
+  /* There may be an issue if there are multiple holders of the semaphore. */
 
+  DEBUGASSERT(sem->hhead == NULL || sem->hhead->flink == NULL);
 #else
   /* There may be an issue if there are multiple holders of the semaphore. */
 
   DEBUGASSERT(sem->holder[0].htcb == NULL || sem->holder[1].htcb == NULL);
-
-  sem->holder[0].htcb = NULL;
-  sem->holder[1].htcb = NULL;
 #endif
+
+  /* Free the holders, also removing them from the lists of the holder
+   * threads.
+   */
+
+  (void)nxsem_foreachholder(sem, nxsem_recoverholders, NULL);
 }
 
 /****************************************************************************
@@ -964,11 +770,8 @@ void nxsem_addholder_tcb(FAR struct tcb_s *htcb, FAR sem_t *sem)
       pholder = nxsem_findorallocateholder(sem, htcb);
       if (pholder != NULL)
         {
-          /* Then set the holder and increment the number of counts held by this
-           * holder
-           */
+          /* Then increment the number of counts held by this holder */
 
-          pholder->htcb = htcb;
           pholder->counts++;
         }
     }
@@ -1000,28 +803,42 @@ void nxsem_addholder(FAR sem_t *sem)
  * Name: void nxsem_boostpriority(sem_t *sem)
  *
  * Description:
- *
+ *   Called from nxsem_wait() just before the calling thread blocks waiting
+ *   for a count on the semaphore.  The calling thread is added to the
+ *   waiters of the semaphore and the priority of every thread holding a
+ *   count is raised to at least the priority of the calling thread.  If a
+ *   holder is itself blocked on a semaphore, the boost is passed on along
+ *   that chain.
  *
  * Input Parameters:
- *   None
+ *   sem - A reference to the semaphore being waited for
  *
  * Returned Value:
- *   0 (OK) or -1 (ERROR) if unsuccessful
+ *   None
  *
  * Assumptions:
+ *   Interrupts are disabled and the scheduler is locked.
  *
  ****************************************************************************/
 
 void nxsem_boostpriority(FAR sem_t *sem)
 {
   FAR struct tcb_s *rtcb = this_task();
+  struct semchain_s chain;
+
+  /* The calling thread is now a waiter for the semaphore */
+
+  nxsem_addwaiter(sem, rtcb);
 
   /* Boost the priority of every thread holding counts on this semaphore
    * that are lower in priority than the new thread that is waiting for a
    * count.
    */
 
-  (void)nxsem_foreachholder(sem, nxsem_boostholderprio, rtcb);
+  chain.prio  = rtcb->sched_priority;
+  chain.depth = 0;
+
+  (void)nxsem_foreachholder(sem, nxsem_boostchain, &chain);
 }
 
 /****************************************************************************
@@ -1094,12 +911,7 @@ void nxsem_releaseholder(FAR sem_t *sem)
 
 void nxsem_restorebaseprio(FAR struct tcb_s *stcb, FAR sem_t *sem)
 {
-#if 0  /* DSA: sometimes crashes when Telnet calls external cmd (i.e. 'i2c') */
-  /* Check our assumptions */
-
-  DEBUGASSERT((sem->semcount > 0  && stcb == NULL) ||
-              (sem->semcount <= 0 && stcb != NULL));
-#endif
+  FAR struct tcb_s *rtcb = NULL;
 
   /* Handler semaphore counts posed from an interrupt handler differently
    * from interrupts posted from threads.  The primary difference is that
@@ -1109,13 +921,40 @@ void nxsem_restorebaseprio(FAR struct tcb_s *stcb, FAR sem_t *sem)
    * itself.
    */
 
-  if (up_interrupt_context())
+  if (!up_interrupt_context())
     {
-      nxsem_restorebaseprio_irq(stcb, sem);
+      /* The currently executing task should have an entry in the list.
+       * Its counts were previously decremented; if it now holds no counts,
+       * then we need to remove it from the list of holders before its
+       * priority is recomputed.
+       */
+
+      rtcb = this_task();
+      nxsem_findandfreeholder(sem, rtcb);
     }
-  else
+
+  /* The thread that received the count (if any) was the highest priority
+   * waiter and is no longer waiting.  The priority of the remaining
+   * holders, including stcb itself, must now be recomputed.  If no thread
+   * received the count, then there are no waiters and the priority of the
+   * holders cannot have been raised by this semaphore.
+   */
+
+  if (stcb != NULL)
     {
-      nxsem_restorebaseprio_task(stcb, sem);
+      nxsem_remwaiter(sem, stcb);
+
+      /* We cannot drop the priority of the currently running thread
+       * first -- because that would cause it to be suspended.  So do all
+       * other holders first, then the running thread.
+       */
+
+      (void)nxsem_foreachholder(sem, nxsem_restoreholderprioA, NULL);
+
+      if (rtcb != NULL)
+        {
+          nxsem_setholderprio(rtcb, 0);
+        }
     }
 }
 
@@ -1129,7 +968,8 @@ void nxsem_restorebaseprio(FAR struct tcb_s *stcb, FAR sem_t *sem)
  *   holder of the semaphore.
  *
  * Input Parameters:
- *   sem - A reference to the semaphore no longer being waited for
+ *   stcb - The TCB of the thread that is no longer waiting
+ *   sem  - A reference to the semaphore no longer being waited for
  *
  * Returned Value:
  *   None
@@ -1144,9 +984,143 @@ void nxsem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem)
 
   DEBUGASSERT(sem->semcount <= 0);
 
-  /* Adjust the priority of every holder as necessary */
+  /* stcb no longer waits for the semaphore.  Then adjust the priority of
+   * every holder as necessary.
+   */
+
+  nxsem_remwaiter(sem, stcb);
+  (void)nxsem_foreachholder(sem, nxsem_restoreholderprio, NULL);
+}
+
+/****************************************************************************
+ * Name: nxsem_reorderwaiter
+ *
+ * Description:
+ *   Called from nxsched_setpriority() after the priority of a thread that
+ *   is waiting for a semaphore has changed, to keep the waiters of the
+ *   semaphore in priority order.
+ *
+ * Input Parameters:
+ *   wtcb - The TCB of the waiting thread
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void nxsem_reorderwaiter(FAR struct tcb_s *wtcb)
+{
+  FAR sem_t *sem = wtcb->waitsem;
+
+  if (sem != NULL)
+    {
+      nxsem_remwaiter(sem, wtcb);
+      nxsem_addwaiter(sem, wtcb);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsem_restoreprio
+ *
+ * Description:
+ *   Recompute the priority of a thread after some other reason for boosting
+ *   it (such as a work queue priority boost) has gone away.  The thread
+ *   keeps the priority of the highest priority waiter for any semaphore
+ *   that it holds.
+ *
+ * Input Parameters:
+ *   htcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled and the scheduler is locked.
+ *
+ ****************************************************************************/
+
+void nxsem_restoreprio(FAR struct tcb_s *htcb)
+{
+  nxsem_setholderprio(htcb, 0);
+}
+
+/****************************************************************************
+ * Name: nxsem_freeholders
+ *
+ * Description:
+ *   Called when a thread exits to release the holder records of all counts
+ *   that it still holds, so that the semaphores no longer refer to its TCB.
+ *   The counts themselves are lost.
+ *
+ *   Every record, whether from the pool or embedded in sem_t, is in the
+ *   list of counts held by the thread and is freed here.  The semaphores
+ *   are accessed, so a semaphore on which a count is held must not be
+ *   freed or reused without nxsem_destroy().
+ *
+ * Input Parameters:
+ *   htcb - The TCB of the exiting thread
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void nxsem_freeholders(FAR struct tcb_s *htcb)
+{
+  FAR struct semholder_s *pholder;
+
+  while ((pholder = htcb->holdsem) != NULL)
+    {
+      swarn("WARNING: Thread %d exits holding %d counts on %p\n",
+            htcb->pid, pholder->counts, pholder->sem);
+
+      nxsem_freeholder(pholder->sem, pholder);
+    }
+}
 
-  (void)nxsem_foreachholder(sem, nxsem_restoreholderprioall, stcb);
+/****************************************************************************
+ * Name: nxsem_getholder
+ *
+ * Description:
+ *   Return the TCB of one of the threads holding counts on a semaphore.
+ *
+ * Input Parameters:
+ *   sem   - A reference to the semaphore
+ *   index - Which holder to return, starting from zero
+ *
+ * Returned Value:
+ *   The TCB of the holder or NULL if there are not that many holders.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *nxsem_getholder(FAR sem_t *sem, int index)
+{
+  FAR struct semholder_s *pholder;
+
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
+  for (pholder = sem->hhead; pholder != NULL; pholder = pholder->flink)
+#else
+  int i;
+
+  for (i = 0, pholder = &sem->holder[0]; i < 2; i++, pholder++)
+#endif
+    {
+      if (pholder->htcb != NULL && index-- == 0)
+        {
+          return pholder->htcb;
+        }
+    }
+
+  return NULL;
 }
 
 /****************************************************************************
@@ -88,8 +88,21 @@ int nxsem_post(FAR sem_t *sem)
 {
   FAR struct tcb_s *stcb = NULL;
   irqstate_t flags;
+  int16_t semcount;
   int ret = -EINVAL;
 
+#ifdef CONFIG_SEM_FASTPATH
+  /* If no thread is waiting for the semaphore and no holders need to be
+   * released, just give the count back without entering the critical
+   * section.
+   */
+
+  if (sem != NULL && nxsem_noholders(sem) && nxsem_tryincrement(sem))
+    {
+      return OK;
+    }
+#endif
+
   /* Make sure we were supplied with a valid semaphore. */
 
   if (sem != NULL)
@@ -120,7 +133,7 @@ int nxsem_post(FAR sem_t *sem)
 
       DEBUGASSERT(sem->semcount < SEM_VALUE_MAX);
       nxsem_releaseholder(sem);
-      sem->semcount++;
+      semcount = nxsem_addcount(sem, 1);
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
       /* Don't let any unblocked tasks run until we complete any priority
@@ -137,7 +150,7 @@ int nxsem_post(FAR sem_t *sem)
        * there must be some task waiting for the semaphore.
        */
 
-      if (sem->semcount <= 0)
+      if (semcount <= 0)
         {
           /* Check if there are any tasks in the waiting for semaphore
            * task list that are waiting for this semaphore. This is a
@@ -53,16 +53,14 @@
  * Name: nxsem_recover
  *
  * Description:
- *   This function is called from nxtask_recover() when a task is deleted via
- *   task_delete() or via pthread_cancel().  It current only checks on the
+ *   This function is called from nxtask_recover() when a task exits or is
+ *   deleted via task_delete() or via pthread_cancel().  It checks on the
  *   case where a task is waiting for semaphore at the time that is was
- *   killed.
+ *   killed and, if priority inheritance is enabled, releases the holder
+ *   records of all semaphore counts still held by the task (see
+ *   nxsem_freeholders()).
  *
- *   REVISIT:  A more complete implementation would release counts on all
- *   semaphores held by the thread.  That would, however, require some
- *   significant extension to the semaphore data structures because given
- *   only the task, there is not mechanism to traverse all of the semaphores
- *   with counts held by the task.
+ *   REVISIT:  The counts themselves are not returned to the semaphores.
  *
  * Input Parameters:
  *   tcb - The TCB of the terminated task or thread
@@ -110,7 +108,7 @@ void nxsem_recover(FAR struct tcb_s *tcb)
        * place.
        */
 
-      sem->semcount++;
+      (void)nxsem_addcount(sem, 1);
 
       /* Clear the semaphore to assure that it is not reused.  But leave the
        * state as TSTATE_WAIT_SEM.  This is necessary because this is a
@@ -121,5 +119,8 @@ void nxsem_recover(FAR struct tcb_s *tcb)
       tcb->waitsem = NULL;
     }
 
+  /* Make sure that no semaphore still refers to this TCB as a holder */
+
+  nxsem_freeholders(tcb);
   leave_critical_section(flags);
 }
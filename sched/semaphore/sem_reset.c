@@ -112,10 +112,7 @@ int nxsem_reset(FAR sem_t *sem, int16_t count)
    * value of sem->semcount is already correct in this case.
    */
 
-  if (sem->semcount >= 0)
-    {
-      sem->semcount = count;
-    }
+  nxsem_setcount(sem, count);
 
   /* Allow any pending context switches to occur now */
 
@@ -88,6 +88,15 @@ int nxsem_trywait(FAR sem_t *sem)
 
   DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
 
+#ifdef CONFIG_SEM_FASTPATH
+  /* Take an uncontended count without entering the critical section */
+
+  if (sem != NULL && nxsem_noholders(sem) && nxsem_trydecrement(sem))
+    {
+      return OK;
+    }
+#endif
+
   if (sem != NULL)
     {
       /* The following operations must be performed with interrupts disabled
@@ -98,11 +107,10 @@ int nxsem_trywait(FAR sem_t *sem)
 
       /* If the semaphore is available, give it to the requesting task */
 
-      if (sem->semcount > 0)
+      if (nxsem_trydecrement(sem))
         {
-          /* It is, let the task take the semaphore */
+          /* It was, the task has taken the semaphore */
 
-          sem->semcount--;
           rtcb->waitsem = NULL;
           ret = OK;
         }
@@ -93,6 +93,17 @@ int nxsem_wait(FAR sem_t *sem)
 
   DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
 
+#ifdef CONFIG_SEM_FASTPATH
+  /* If the semaphore is not contended and no holders need to be recorded,
+   * just take the count without entering the critical section.
+   */
+
+  if (sem != NULL && nxsem_noholders(sem) && nxsem_trydecrement(sem))
+    {
+      return OK;
+    }
+#endif
+
   /* The following operations must be performed with interrupts
    * disabled because nxsem_post() may be called from an interrupt
    * handler.
@@ -104,13 +115,12 @@ int nxsem_wait(FAR sem_t *sem)
 
   if (sem != NULL)
     {
-      /* Check if the lock is available */
+      /* Take a count.  Check if the lock was available */
 
-      if (sem->semcount > 0)
+      if (nxsem_addcount(sem, -1) >= 0)
         {
-          /* It is, let the task take the semaphore. */
+          /* It was, let the task take the semaphore. */
 
-          sem->semcount--;
           nxsem_addholder(sem);
           rtcb->waitsem = NULL;
           ret = OK;
@@ -130,11 +140,10 @@ int nxsem_wait(FAR sem_t *sem)
 
           DEBUGASSERT(rtcb->waitsem == NULL);
 
-          /* Handle the POSIX semaphore (but don't set the owner yet) */
-
-          sem->semcount--;
-
-          /* Save the waited on semaphore in the TCB */
+          /* The count taken above made the semaphore count negative (but
+           * don't set the owner yet).  Save the waited on semaphore in the
+           * TCB.
+           */
 
           rtcb->waitsem = sem;
 
@@ -42,12 +42,125 @@
 
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
+#include <nuttx/semaphore.h>
 
 #include <stdint.h>
 #include <stdbool.h>
 #include <semaphore.h>
 #include <sched.h>
 #include <queue.h>
+#include <limits.h>
+#include <assert.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Only semaphores whose holders are not tracked may use the fast path */
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+#  define nxsem_noholders(sem) \
+     (((sem)->flags & PRIOINHERIT_FLAGS_DISABLE) != 0)
+#else
+#  define nxsem_noholders(sem) true
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_trydecrement
+ *
+ * Description:
+ *   Take one count from the semaphore if the count is positive.  Returns
+ *   true if the count was taken.
+ *
+ ****************************************************************************/
+
+static inline bool nxsem_trydecrement(FAR sem_t *sem)
+{
+#ifdef CONFIG_SEM_FASTPATH
+  int16_t count = sem->semcount;
+
+  /* nxsem_cmpxchg() reloads count if it fails */
+
+  while (count > 0)
+    {
+      if (nxsem_cmpxchg(sem, count, count - 1))
+        {
+          return true;
+        }
+    }
+
+  return false;
+#else
+  if (sem->semcount > 0)
+    {
+      sem->semcount--;
+      return true;
+    }
+
+  return false;
+#endif
+}
+
+/****************************************************************************
+ * Name: nxsem_tryincrement
+ *
+ * Description:
+ *   Give one count back to the semaphore if no thread is waiting for it.
+ *   Returns true if the count was given back.  Returns false, leaving the
+ *   count unchanged, if a waiting thread must be awakened instead.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_FASTPATH
+static inline bool nxsem_tryincrement(FAR sem_t *sem)
+{
+  int16_t count = sem->semcount;
+
+  while (count >= 0)
+    {
+      DEBUGASSERT(count < SEM_VALUE_MAX);
+      if (nxsem_cmpxchg(sem, count, count + 1))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif
+
+/****************************************************************************
+ * Name: nxsem_setcount
+ *
+ * Description:
+ *   Set the semaphore count to 'count' unless threads are waiting for the
+ *   semaphore, i.e., unless the count is negative.
+ *
+ ****************************************************************************/
+
+static inline void nxsem_setcount(FAR sem_t *sem, int16_t count)
+{
+#ifdef CONFIG_SEM_FASTPATH
+  int16_t semcount = sem->semcount;
+
+  while (semcount >= 0)
+    {
+      if (nxsem_cmpxchg(sem, semcount, count))
+        {
+          break;
+        }
+    }
+#else
+  if (sem->semcount >= 0)
+    {
+      sem->semcount = count;
+    }
+#endif
+}
 
 /****************************************************************************
  * Public Function Prototypes
@@ -94,6 +207,9 @@ void nxsem_boostpriority(FAR sem_t *sem);
 void nxsem_releaseholder(FAR sem_t *sem);
 void nxsem_restorebaseprio(FAR struct tcb_s *stcb, FAR sem_t *sem);
 void nxsem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
+void nxsem_reorderwaiter(FAR struct tcb_s *wtcb);
+void nxsem_restoreprio(FAR struct tcb_s *htcb);
+void nxsem_freeholders(FAR struct tcb_s *htcb);
 #else
 #  define nxsem_initholders()
 #  define nxsem_destroyholder(sem)
@@ -103,6 +219,9 @@ void nxsem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
 #  define nxsem_releaseholder(sem)
 #  define nxsem_restorebaseprio(stcb,sem)
 #  define nxsem_canceled(stcb,sem)
+#  define nxsem_reorderwaiter(wtcb)
+#  define nxsem_restoreprio(htcb)
+#  define nxsem_freeholders(htcb)
 #endif
 
 #undef EXTERN
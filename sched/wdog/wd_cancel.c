@@ -73,8 +73,10 @@
 
 int wd_cancel(WDOG_ID wdog)
 {
+#ifndef CONFIG_WDOG_TIMERWHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
+#endif
   irqstate_t flags;
   int ret = -EINVAL;
 
@@ -90,6 +92,22 @@ int wd_cancel(WDOG_ID wdog)
 
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+      /* Unlink the watchdog from its wheel slot */
+
+      wd_wheel_remove(wdog);
+
+#ifdef CONFIG_SCHED_TICKLESS
+      /* If the interval timer was programmed for this watchdog, reassess
+       * the interval timer that will generate the next interval event.
+       */
+
+      if (wdog->expire == g_wdwheel.next)
+        {
+          sched_timer_reassess();
+        }
+#endif
+#else
       /* Search the g_wdactivelist for the target FCB.  We can't use sq_rem
        * to do this because there are additional operations that need to be
        * done.
@@ -140,9 +158,11 @@ int wd_cancel(WDOG_ID wdog)
           sched_timer_reassess();
         }
 
+      wdog->next = NULL;
+#endif /* CONFIG_WDOG_TIMERWHEEL */
+
       /* Mark the watchdog inactive */
 
-      wdog->next = NULL;
       WDOG_CLRACTIVE(wdog);
 
       /* Return success */
@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <string.h>
 #include <queue.h>
 
 #include "wdog/wdog.h"
@@ -53,12 +54,20 @@
 
 sq_queue_t g_wdfreelist;
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+/* g_wdwheel holds all active watchdogs, hashed by expiration time into the
+ * slots of the hierarchical timing wheel.
+ */
+
+struct wd_wheel_s g_wdwheel;
+#else
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 sq_queue_t g_wdactivelist;
+#endif
 
 /* This is the number of free, pre-allocated watchdog structures in the
  * g_wdfreelist.  This value is used to enforce a reserve for interrupt
@@ -116,7 +125,11 @@ void wd_initialize(void)
   /* Initialize watchdog lists */
 
   sq_init(&g_wdfreelist);
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  memset(&g_wdwheel, 0, sizeof(struct wd_wheel_s));
+#else
   sq_init(&g_wdactivelist);
+#endif
 
   /* The g_wdfreelist must be loaded at initialization time to hold the
    * configured number of watchdogs.
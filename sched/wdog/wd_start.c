@@ -71,6 +71,45 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: wd_execute
+ *
+ * Description:
+ *   Execute the function associated with an expired watchdog.
+ *
+ * Input Parameters:
+ *   wdog - The expired watchdog.  It has already been removed from the
+ *          active watchdogs and marked inactive.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static inline void wd_execute(FAR struct wdog_s *wdog)
+{
+  up_setpicbase(wdog->picbase);
+
+#if CONFIG_MAX_WDOGPARMS == 0
+  wdog->func(0);
+#elif CONFIG_MAX_WDOGPARMS == 1
+  wdog->func((int)wdog->argc,
+             wdog->parm[0]);
+#elif CONFIG_MAX_WDOGPARMS == 2
+  wdog->func((int)wdog->argc,
+             wdog->parm[0], wdog->parm[1]);
+#elif CONFIG_MAX_WDOGPARMS == 3
+  wdog->func((int)wdog->argc,
+             wdog->parm[0], wdog->parm[1], wdog->parm[2]);
+#elif CONFIG_MAX_WDOGPARMS == 4
+  wdog->func((int)wdog->argc,
+             wdog->parm[0], wdog->parm[1], wdog->parm[2],
+             wdog->parm[3]);
+#else
+#  error Missing support
+#endif
+}
+
 /****************************************************************************
  * Name: wd_expiration
  *
@@ -78,6 +117,10 @@
  *   Check if the timer for the watchdog at the head of list is ready to
  *   run.  If so, remove the watchdog from the list and execute it.
  *
+ *   With the timing wheel, the wheel time has just been advanced:  Cascade
+ *   the upper levels whose slot boundary was reached, then execute every
+ *   watchdog in the current level 0 slot.
+ *
  * Input Parameters:
  *   None
  *
@@ -86,6 +129,51 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+static inline void wd_expiration(void)
+{
+  FAR struct wdog_s *wdog;
+  int level;
+  int ndx;
+
+  /* Cascade the upper levels, lowest first.  Level n reaches a slot
+   * boundary only if all of the levels below it also did.
+   */
+
+  for (level = 1; level < WDOG_WHEEL_NLEVELS; level++)
+    {
+      clock_t mask = ((clock_t)1 << WDOG_WHEEL_LSHIFT(level)) - 1;
+
+      if ((g_wdwheel.now & mask) != 0)
+        {
+          break;
+        }
+
+      wd_wheel_cascade(level);
+    }
+
+  /* Every watchdog in the current level 0 slot expires now.  A watchdog
+   * re-started by one of the handlers always lands in a different slot.
+   */
+
+  ndx = (int)g_wdwheel.now & WDOG_WHEEL_MASK;
+  while ((wdog = g_wdwheel.slot[0][ndx]) != NULL)
+    {
+      DEBUGASSERT(wdog->expire == g_wdwheel.now);
+
+      /* Remove the watchdog from the wheel and indicate that it is no
+       * longer active.
+       */
+
+      wd_wheel_remove(wdog);
+      WDOG_CLRACTIVE(wdog);
+
+      /* Execute the watchdog function */
+
+      wd_execute(wdog);
+    }
+}
+#else
 static inline void wd_expiration(void)
 {
   FAR struct wdog_s *wdog;
@@ -120,29 +208,11 @@ static inline void wd_expiration(void)
 
           /* Execute the watchdog function */
 
-          up_setpicbase(wdog->picbase);
-
-#if CONFIG_MAX_WDOGPARMS == 0
-          wdog->func(0);
-#elif CONFIG_MAX_WDOGPARMS == 1
-          wdog->func((int)wdog->argc,
-                     wdog->parm[0]);
-#elif CONFIG_MAX_WDOGPARMS == 2
-          wdog->func((int)wdog->argc,
-                     wdog->parm[0], wdog->parm[1]);
-#elif CONFIG_MAX_WDOGPARMS == 3
-          wdog->func((int)wdog->argc,
-                     wdog->parm[0], wdog->parm[1], wdog->parm[2]);
-#elif CONFIG_MAX_WDOGPARMS == 4
-          wdog->func((int)wdog->argc,
-                     wdog->parm[0], wdog->parm[1], wdog->parm[2],
-                     wdog->parm[3]);
-#else
-#  error Missing support
-#endif
+          wd_execute(wdog);
         }
     }
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -185,10 +255,12 @@ static inline void wd_expiration(void)
 int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
 {
   va_list ap;
+#ifndef CONFIG_WDOG_TIMERWHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
   FAR struct wdog_s *next;
   int32_t now;
+#endif
   irqstate_t flags;
   int i;
 
@@ -253,6 +325,22 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
   (void)sched_timer_cancel();
 #endif
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+#ifdef CONFIG_SCHED_TICKLESS
+  if (g_wdwheel.nactive == 0)
+    {
+      /* Update clock tickbase */
+
+      g_wdtickbase = clock_systimer();
+    }
+#endif
+
+  /* Hash the watchdog into the timing wheel by its expiration time */
+
+  wdog->expire = g_wdwheel.now + delay;
+  wd_wheel_insert(wdog);
+
+#else
   /* Do the easy case first -- when the watchdog timer queue is empty. */
 
   if (g_wdactivelist.head == NULL)
@@ -343,9 +431,13 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
         }
     }
 
-  /* Put the lag into the watchdog structure and mark it as active. */
+  /* Put the lag into the watchdog structure */
 
   wdog->lag = delay;
+#endif /* CONFIG_WDOG_TIMERWHEEL */
+
+  /* Mark the watchdog as active. */
+
   WDOG_SETACTIVE(wdog);
 
 #ifdef CONFIG_SCHED_TICKLESS
@@ -389,12 +481,16 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
 #ifdef CONFIG_SCHED_TICKLESS
 unsigned int wd_timer(int ticks)
 {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  clock_t next;
+#else
   FAR struct wdog_s *wdog;
+  int decr;
+#endif
 #ifdef CONFIG_SMP
   irqstate_t flags;
 #endif
   unsigned int ret;
-  int decr;
 
 #ifdef CONFIG_SMP
   /* We are in an interrupt handler as, as a consequence, interrupts are
@@ -409,6 +505,39 @@ unsigned int wd_timer(int ticks)
   flags = enter_critical_section();
 #endif
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* Step the wheel from event to event through the elapsed interval */
+
+  while (ticks > 0)
+    {
+      next = wd_wheel_nextevent();
+      if (next == 0 || next > (clock_t)ticks)
+        {
+          break;
+        }
+
+      g_wdwheel.now += next;
+      g_wdtickbase  += next;
+      ticks         -= (int)next;
+
+      /* Cascade and run any watchdogs that expire at this time */
+
+      wd_expiration();
+    }
+
+  /* Update the wheel time and the clock tickbase */
+
+  g_wdwheel.now += ticks;
+  g_wdtickbase  += ticks;
+
+  /* Return the delay to the next wheel event.  Remember when that is so
+   * that wd_cancel() can tell if the interval timer must be reassessed.
+   */
+
+  ret = (unsigned int)wd_wheel_nextevent();
+  g_wdwheel.next = g_wdwheel.now + ret;
+
+#else
   /* Check if there are any active watchdogs to process */
 
   while (g_wdactivelist.head != NULL && ticks > 0)
@@ -448,6 +577,7 @@ unsigned int wd_timer(int ticks)
 
   ret = g_wdactivelist.head ?
           ((FAR struct wdog_s *)g_wdactivelist.head)->lag : 0;
+#endif
 
 #ifdef CONFIG_SMP
   leave_critical_section(flags);
@@ -476,6 +606,17 @@ void wd_timer(void)
   flags = enter_critical_section();
 #endif
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* Advance the wheel time and check if there are any active watchdogs
+   * to process.
+   */
+
+  g_wdwheel.now++;
+  if (g_wdwheel.nactive > 0)
+    {
+      wd_expiration();
+    }
+#else
   /* Check if there are any active watchdogs to process */
 
   if (g_wdactivelist.head)
@@ -488,6 +629,7 @@ void wd_timer(void)
 
       wd_expiration();
     }
+#endif
 
 #ifdef CONFIG_SMP
   leave_critical_section(flags);
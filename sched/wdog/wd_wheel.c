@@ -0,0 +1,309 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add a watchdog to the timing wheel.  The expiration time must already
+ *   be set in the watchdog structure.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to be inserted
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog)
+{
+  FAR struct wdog_s **head;
+  clock_t delta;
+  int level;
+  int ndx;
+
+  /* Select the lowest level whose range covers the remaining delay */
+
+  delta = wdog->expire - g_wdwheel.now;
+  for (level = 0; level < WDOG_WHEEL_NLEVELS; level++)
+    {
+      if (delta < ((clock_t)1 << WDOG_WHEEL_LSHIFT(level + 1)))
+        {
+          break;
+        }
+    }
+
+  if (level < WDOG_WHEEL_NLEVELS)
+    {
+      ndx = (int)(wdog->expire >> WDOG_WHEEL_LSHIFT(level)) &
+            WDOG_WHEEL_MASK;
+    }
+  else
+    {
+      /* The delay is beyond the range of the wheel.  Park the watchdog in
+       * the top level slot that will be cascaded last; it will be
+       * re-inserted with the remaining delay at that time.
+       */
+
+      level = WDOG_WHEEL_NLEVELS - 1;
+      ndx   = (int)((g_wdwheel.now >> WDOG_WHEEL_LSHIFT(level)) - 1) &
+              WDOG_WHEEL_MASK;
+    }
+
+  /* Add the watchdog to the head of the slot list */
+
+  head       = &g_wdwheel.slot[level][ndx];
+  wdog->prev = NULL;
+  wdog->next = *head;
+
+  if (*head != NULL)
+    {
+      (*head)->prev = wdog;
+    }
+
+  *head      = wdog;
+  wdog->slot = (uint8_t)((level << WDOG_WHEEL_SHIFT) | ndx);
+
+  g_wdwheel.bitmap[level] |= (uint32_t)1 << ndx;
+  g_wdwheel.nactive++;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove a watchdog from the timing wheel.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to be removed
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+  int level = wdog->slot >> WDOG_WHEEL_SHIFT;
+  int ndx   = wdog->slot & WDOG_WHEEL_MASK;
+
+  DEBUGASSERT(g_wdwheel.nactive > 0);
+
+  if (wdog->prev != NULL)
+    {
+      wdog->prev->next = wdog->next;
+    }
+  else
+    {
+      /* The watchdog is at the head of the slot list */
+
+      DEBUGASSERT(g_wdwheel.slot[level][ndx] == wdog);
+
+      g_wdwheel.slot[level][ndx] = wdog->next;
+      if (wdog->next == NULL)
+        {
+          g_wdwheel.bitmap[level] &= ~((uint32_t)1 << ndx);
+        }
+    }
+
+  if (wdog->next != NULL)
+    {
+      wdog->next->prev = wdog->prev;
+    }
+
+  wdog->next = NULL;
+  wdog->prev = NULL;
+  g_wdwheel.nactive--;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Re-insert all of the watchdogs in the current slot of the given level.
+ *   This is called when the wheel time crosses a slot boundary of that
+ *   level and moves the watchdogs closer to the bottom of the wheel.
+ *
+ * Input Parameters:
+ *   level - The wheel level to cascade (1..WDOG_WHEEL_NLEVELS-1)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_cascade(int level)
+{
+  FAR struct wdog_s *wdog;
+  FAR struct wdog_s *next;
+  int ndx;
+
+  DEBUGASSERT(level > 0 && level < WDOG_WHEEL_NLEVELS);
+
+  ndx = (int)(g_wdwheel.now >> WDOG_WHEEL_LSHIFT(level)) & WDOG_WHEEL_MASK;
+  if ((g_wdwheel.bitmap[level] & ((uint32_t)1 << ndx)) == 0)
+    {
+      return;
+    }
+
+  /* Detach the whole slot list, then re-insert each watchdog relative to
+   * the current wheel time.
+   */
+
+  wdog = g_wdwheel.slot[level][ndx];
+  g_wdwheel.slot[level][ndx] = NULL;
+  g_wdwheel.bitmap[level] &= ~((uint32_t)1 << ndx);
+
+  while (wdog != NULL)
+    {
+      next = wdog->next;
+      g_wdwheel.nactive--;
+      wd_wheel_insert(wdog);
+      wdog = next;
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_nextevent
+ *
+ * Description:
+ *   Return the number of ticks from the current wheel time until the next
+ *   wheel event:  Either the expiration of a watchdog or the cascade of a
+ *   non-empty slot.  The result is a lower bound on the time until the
+ *   next watchdog expires.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The number of ticks until the next event.  Zero if the wheel is empty.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+clock_t wd_wheel_nextevent(void)
+{
+  clock_t period;
+  clock_t delay;
+  clock_t ret = ~(clock_t)0;
+  uint32_t bitmap;
+  int start;
+  int level;
+
+  if (g_wdwheel.nactive == 0)
+    {
+      return 0;
+    }
+
+  for (level = 0; level < WDOG_WHEEL_NLEVELS; level++)
+    {
+      if (g_wdwheel.bitmap[level] == 0)
+        {
+          continue;
+        }
+
+      /* Rotate the slot bitmap so that bit 0 corresponds to the first slot
+       * that can hold the next event at this level:  The current slot at
+       * level 0, the slot after the current one at the upper levels (the
+       * current slot of an upper level was already cascaded).
+       */
+
+      period = g_wdwheel.now >> WDOG_WHEEL_LSHIFT(level);
+      start  = (int)(level == 0 ? period : period + 1) & WDOG_WHEEL_MASK;
+      bitmap = g_wdwheel.bitmap[level];
+
+      if (start != 0)
+        {
+          bitmap = (bitmap >> start) |
+                   (bitmap << (WDOG_WHEEL_NSLOTS - start));
+        }
+
+      /* Level 0 slots hold the watchdogs expiring in the next
+       * WDOG_WHEEL_NSLOTS ticks, so the slot offset is the exact delay.
+       * An upper level slot is cascaded when its period begins.
+       */
+
+      if (level == 0)
+        {
+          delay = (clock_t)(ffs((int)bitmap) - 1);
+        }
+      else
+        {
+          delay = ((period + 1 + (clock_t)(ffs((int)bitmap) - 1)) <<
+                   WDOG_WHEEL_LSHIFT(level)) - g_wdwheel.now;
+        }
+
+      if (delay < ret)
+        {
+          ret = delay;
+        }
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_WDOG_TIMERWHEEL */
@@ -70,6 +70,39 @@
 #  define wd_elapse() (0)
 #endif
 
+/* Timing wheel geometry.  Each level has WDOG_WHEEL_NSLOTS slots and each
+ * slot at level n spans WDOG_WHEEL_NSLOTS^n ticks.  With five levels of 32
+ * slots, the wheel covers 2^25 ticks; longer delays are parked in the top
+ * level and re-inserted each time that they are cascaded.
+ */
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+#  define WDOG_WHEEL_SHIFT       5
+#  define WDOG_WHEEL_NSLOTS      (1 << WDOG_WHEEL_SHIFT)
+#  define WDOG_WHEEL_MASK        (WDOG_WHEEL_NSLOTS - 1)
+#  define WDOG_WHEEL_NLEVELS     5
+#  define WDOG_WHEEL_LSHIFT(l)   ((l) * WDOG_WHEEL_SHIFT)
+#endif
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+/* This structure describes the state of the watchdog timing wheel */
+
+struct wd_wheel_s
+{
+  clock_t  now;                  /* Current wheel time in ticks */
+#ifdef CONFIG_SCHED_TICKLESS
+  clock_t  next;                 /* Time of the last reported next event */
+#endif
+  unsigned int nactive;          /* Number of watchdogs in the wheel */
+  uint32_t bitmap[WDOG_WHEEL_NLEVELS];  /* Bit n set: slot n not empty */
+  FAR struct wdog_s *slot[WDOG_WHEEL_NLEVELS][WDOG_WHEEL_NSLOTS];
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -88,12 +121,20 @@ extern "C"
 
 extern sq_queue_t g_wdfreelist;
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+/* g_wdwheel holds all active watchdogs, hashed by expiration time into the
+ * slots of the hierarchical timing wheel.
+ */
+
+extern struct wd_wheel_s g_wdwheel;
+#else
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 extern sq_queue_t g_wdactivelist;
+#endif
 
 /* This is the number of free, pre-allocated watchdog structures in the
  * g_wdfreelist.  This value is used to enforce a reserve for interrupt
@@ -188,6 +229,90 @@ void wd_timer(void);
 struct tcb_s;
 void wd_recover(FAR struct tcb_s *tcb);
 
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add a watchdog to the timing wheel.  The expiration time must already
+ *   be set in the watchdog structure.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to be inserted
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+void wd_wheel_insert(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove a watchdog from the timing wheel.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to be removed
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Re-insert all of the watchdogs in the current slot of the given level.
+ *   This is called when the wheel time crosses a slot boundary of that
+ *   level and moves the watchdogs closer to the bottom of the wheel.
+ *
+ * Input Parameters:
+ *   level - The wheel level to cascade (1..WDOG_WHEEL_NLEVELS-1)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_cascade(int level);
+
+/****************************************************************************
+ * Name: wd_wheel_nextevent
+ *
+ * Description:
+ *   Return the number of ticks from the current wheel time until the next
+ *   wheel event:  Either the expiration of a watchdog or the cascade of a
+ *   non-empty slot.  The result is a lower bound on the time until the
+ *   next watchdog expires.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The number of ticks until the next event.  Zero if the wheel is empty.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+clock_t wd_wheel_nextevent(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
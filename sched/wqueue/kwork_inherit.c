@@ -45,6 +45,7 @@
 #include <nuttx/wqueue.h>
 
 #include "sched/sched.h"
+#include "semaphore/semaphore.h"
 #include "wqueue/wqueue.h"
 
 #if defined(CONFIG_SCHED_WORKQUEUE) && defined(CONFIG_SCHED_LPWORK) && \
@@ -81,72 +82,27 @@ static void lpwork_boostworker(pid_t wpid, uint8_t reqprio)
 
 #if CONFIG_SEM_NNESTPRIO > 0
   /* If the priority of the client thread that is greater than the base
-   * priority of the worker thread, then we may need to adjust the worker
-   * thread's priority now or later to that priority.
+   * priority of the worker thread, then remember the request.  The worker
+   * thread must not drop below this priority until the request is
+   * withdrawn by lpwork_restoreworker(), whatever happens to the priority
+   * inherited through the semaphores that it holds.
    */
 
   if (reqprio > wtcb->base_priority)
     {
-      /* If the new priority is greater than the current, possibly already
-       * boosted priority of the worker thread, then we will have to raise
-       * the worker thread's priority now.
-       */
-
-      if (reqprio > wtcb->sched_priority)
+      if (wtcb->npend_reprio < CONFIG_SEM_NNESTPRIO)
         {
-          /* If the current priority of worker thread has already been
-           * boosted, then add the boost priority to the list of restoration
-           * priorities.  When the higher priority waiter thread gets its
-           * count, then we need to revert the worker thread to this saved
-           * priority (not to its base priority).
-           */
-
-          if (wtcb->sched_priority > wtcb->base_priority)
-            {
-              /* Save the current, boosted priority of the worker thread. */
-
-              if (wtcb->npend_reprio < CONFIG_SEM_NNESTPRIO)
-                {
-                  wtcb->pend_reprios[wtcb->npend_reprio] = wtcb->sched_priority;
-                  wtcb->npend_reprio++;
-                }
-              else
-                {
-                  serr("ERROR: CONFIG_SEM_NNESTPRIO exceeded\n");
-                  DEBUGASSERT(wtcb->npend_reprio < CONFIG_SEM_NNESTPRIO);
-                }
-            }
-
-          /* Raise the priority of the worker.  This cannot cause a context
-           * switch because we have preemption disabled.  The worker thread
-           * may be marked "pending" and the switch may occur during
-           * sched_unblock() processing.
-           */
-
-          (void)nxsched_setpriority(wtcb, reqprio);
+          wtcb->pend_reprios[wtcb->npend_reprio] = reqprio;
+          wtcb->npend_reprio++;
         }
       else
         {
-          /* The new priority is above the base priority of the worker,
-           * but not as high as its current working priority.  Just put it
-           * in the list of pending restoration priorities so that when the
-           * higher priority thread gets its count, we can revert to this
-           * saved priority and not to the base priority.
-           */
-
-          if (wtcb->npend_reprio < CONFIG_SEM_NNESTPRIO)
-            {
-              wtcb->pend_reprios[wtcb->npend_reprio] = reqprio;
-              wtcb->npend_reprio++;
-            }
-          else
-            {
-              serr("ERROR: CONFIG_SEM_NNESTPRIO exceeded\n");
-              DEBUGASSERT(wtcb->npend_reprio < CONFIG_SEM_NNESTPRIO);
-            }
+          serr("ERROR: CONFIG_SEM_NNESTPRIO exceeded\n");
+          DEBUGASSERT(wtcb->npend_reprio < CONFIG_SEM_NNESTPRIO);
         }
     }
-#else
+#endif
+
   /* If the priority of the client thread that is less than of equal to the
    * priority of the worker thread, then do nothing because the thread is
    * already running at a sufficient priority.
@@ -162,7 +118,6 @@ static void lpwork_boostworker(pid_t wpid, uint8_t reqprio)
 
       (void)nxsched_setpriority(wtcb, reqprio);
     }
-#endif
 }
 
 /****************************************************************************
@@ -187,9 +142,8 @@ static void lpwork_restoreworker(pid_t wpid, uint8_t reqprio)
 {
   FAR struct tcb_s *wtcb;
 #if CONFIG_SEM_NNESTPRIO > 0
-  uint8_t wpriority;
   int index;
-  int selected;
+  int last;
 #endif
 
   /* Get the TCB of the low priority worker thread from the process ID. */
@@ -197,115 +151,32 @@ static void lpwork_restoreworker(pid_t wpid, uint8_t reqprio)
   wtcb = sched_gettcb(wpid);
   DEBUGASSERT(wtcb);
 
-  /* Was the priority of the worker thread boosted? If so, then drop its
-   * priority back to the correct level.  What is the correct level?
+#if CONFIG_SEM_NNESTPRIO > 0
+  /* Withdraw the matching request from the list of pending boosts.  The
+   * request may be missing if it was lost because of list overflow.
    */
 
-  if (wtcb->sched_priority != wtcb->base_priority)
+  for (index = 0; index < wtcb->npend_reprio; index++)
     {
-#if CONFIG_SEM_NNESTPRIO > 0
-      /* Are there other, pending priority levels to revert to? */
-
-      if (wtcb->npend_reprio < 1)
+      if (wtcb->pend_reprios[index] == reqprio)
         {
-          /* No... the worker thread has only been boosted once.
-           * npend_reprio should be 0 and the boosted priority should be the
-           * priority of the client task (reqprio)
-           *
-           * That latter assumption may not be true if the client's priority
-           * was also boosted so that it no longer matches the wtcb's
-           * sched_priority.  Or if CONFIG_SEM_NNESTPRIO is too small (so
-           * that we do not have a proper record of the reprioritizations).
-           */
-
-          DEBUGASSERT(/* wtcb->sched_priority == reqprio && */
-                      wtcb->npend_reprio == 0);
-
-          /* Reset the worker's priority back to the base priority. */
-
-          (void)nxsched_reprioritize(wtcb, wtcb->base_priority);
+          last = wtcb->npend_reprio - 1;
+          wtcb->pend_reprios[index] = wtcb->pend_reprios[last];
+          wtcb->npend_reprio = last;
+          break;
         }
+    }
+#endif
 
-      /* There are multiple pending priority levels. The worker thread's
-       * "boosted" priority could greater than or equal to "reqprio" (it could
-       * be greater if its priority we boosted because it also holds some
-       * semaphore).
-       */
-
-      else if (wtcb->sched_priority <= reqprio)
-        {
-          /* The worker thread has been boosted to the same priority as the
-           * waiter thread that just received the count.  We will simply
-           * reprioritize to the next highest pending priority.
-           */
-
-          /* Find the highest pending priority and remove it from the list */
-
-          for (index = 1, selected = 0; index < wtcb->npend_reprio; index++)
-            {
-              if (wtcb->pend_reprios[index] > wtcb->pend_reprios[selected])
-                {
-                  selected = index;
-                }
-            }
-
-          /* Remove the highest priority pending priority from the list */
-
-          wpriority = wtcb->pend_reprios[selected];
-          index = wtcb->npend_reprio - 1;
-          if (index > 0)
-            {
-              wtcb->pend_reprios[selected] = wtcb->pend_reprios[index];
-            }
-
-          wtcb->npend_reprio = index;
-
-          /* And apply that priority to the thread (while retaining the
-           * base_priority)
-           */
-
-          nxsched_setpriority(wtcb, wpriority);
-        }
-      else
-        {
-          /* The worker thread has been boosted to a higher priority than the
-           * waiter task.  The pending priority should be in the list (unless
-           * it was lost because of of list overflow or because the worker
-           * was reprioritized again unbeknownst to the priority inheritance
-           * logic).
-           *
-           * Search the list for the matching priority.
-           */
-
-          for (index = 0; index < wtcb->npend_reprio; index++)
-            {
-              /* Does this pending priority match the priority of the thread
-               * that just received the count?
-               */
-
-              if (wtcb->pend_reprios[index] == reqprio)
-                {
-                  /* Yes, remove it from the list */
-
-                  selected = wtcb->npend_reprio - 1;
-                  if (selected > 0)
-                    {
-                      wtcb->pend_reprios[index] = wtcb->pend_reprios[selected];
-                    }
-
-                  wtcb->npend_reprio = selected;
-                  break;
-                }
-            }
-        }
-#else
-      /* There is no alternative restore priorities, drop the priority
-       * of the worker thread all the way back to the threads "base"
-       * priority.
-       */
+  /* Was the priority of the worker thread boosted? If so, then drop its
+   * priority back to the correct level:  The highest of its base priority,
+   * the remaining boost requests and the priority inherited from the
+   * threads waiting for semaphores that the worker holds.
+   */
 
-      (void)nxsched_reprioritize(wtcb, wtcb->base_priority);
-#endif
+  if (wtcb->sched_priority != wtcb->base_priority)
+    {
+      nxsem_restoreprio(wtcb);
     }
 }
 
@@ -256,6 +256,7 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
   SYSCALL_LOOKUP(telldir,                  1, STUB_telldir)
 
 #if defined(CONFIG_FS_RAMMAP)
+  SYSCALL_LOOKUP(msync,                    3, STUB_msync)
   SYSCALL_LOOKUP(munmap,                   2, STUB_munmap)
 #endif
 
@@ -277,7 +278,7 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
   SYSCALL_LOOKUP(sched_getstreams,         0, STUB_sched_getstreams)
 #endif
 
-#if defined(CONFIG_NET_SENDFILE)
+#if defined(CONFIG_NET_SENDFILE) || defined(CONFIG_DEV_PIPE_SENDFILE)
   SYSCALL_LOOKUP(sendfile,                 4, STUB_fs_sendifile)
 #endif
 